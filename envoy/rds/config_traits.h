@@ -64,6 +64,25 @@ public:
   virtual ConfigConstSharedPtr createConfig(const Protobuf::Message& rc,
                                             Server::Configuration::ServerFactoryContext& context,
                                             bool validate_clusters_default) const PURE;
+
+  /**
+   * Create a config object to replace a previous one after the route configuration changed.
+   * Implementations may share the parts of the previous config whose configuration did not
+   * change rather than create them again. By default the config is created from scratch.
+   * @param rc supplies the new RouteConfiguration.
+   * @param previous_rc supplies the RouteConfiguration the previous config was created from.
+   * @param previous supplies the previous config. It may have been created by createNullConfig.
+   * @param context supplies the context of the server factory.
+   * @param validate_clusters_default see createConfig.
+   * @throw EnvoyException if the new config can't be applied of.
+   */
+  virtual ConfigConstSharedPtr
+  createUpdatedConfig(const Protobuf::Message& rc, const Protobuf::Message& /* previous_rc */,
+                      const ConfigConstSharedPtr& /* previous */,
+                      Server::Configuration::ServerFactoryContext& context,
+                      bool validate_clusters_default) const {
+    return createConfig(rc, context, validate_clusters_default);
+  }
 };
 
 } // namespace Rds
@@ -61,6 +61,27 @@ enum class DrainStrategy {
   Immediate,
 };
 
+/**
+ * What a write to an access log file does when the writing thread's buffer for the file is full.
+ */
+enum class FileBufferOverflowPolicy {
+  /**
+   * The write is buffered in an overflow buffer of the writing thread, which has no size limit,
+   * until the flush thread has drained the thread's buffer.
+   */
+  Unbounded,
+
+  /**
+   * The write waits until the file's flush thread has drained the buffer.
+   */
+  Block,
+
+  /**
+   * The write is dropped.
+   */
+  Drop,
+};
+
 using CommandLineOptionsPtr = std::unique_ptr<envoy::admin::v3::CommandLineOptions>;
 
 /**
@@ -217,6 +238,23 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return uint64_t the size in bytes of buffered log data at which a file is flushed without
+   *         waiting for the flush interval.
+   */
+  virtual uint64_t fileFlushMinSize() const PURE;
+
+  /**
+   * @return uint64_t the size in bytes of the buffer each thread writing to a log file fills
+   *         without taking a lock. 0 if writes always go through the file's shared buffer.
+   */
+  virtual uint64_t fileThreadBufferSize() const PURE;
+
+  /**
+   * @return FileBufferOverflowPolicy what a write does when its thread's buffer is full.
+   */
+  virtual FileBufferOverflowPolicy fileBufferOverflowPolicy() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
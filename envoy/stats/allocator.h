@@ -39,6 +39,19 @@ public:
   virtual CounterSharedPtr makeCounter(StatName name, StatName tag_extracted_name,
                                        const StatNameTagVector& stat_name_tags) PURE;
 
+  /**
+   * As makeCounter, but a newly created counter keeps a separate count for each thread which
+   * increments it, summed whenever the counter is read. This avoids contention between threads
+   * which increment the same counter at a high rate, at the cost of more memory per counter and
+   * slower reads. If the counter already exists it is returned as it is.
+   * @param name the full name of the stat.
+   * @param tag_extracted_name the name of the stat with tag-values stripped out.
+   * @param tags the tag values.
+   * @return CounterSharedPtr a counter.
+   */
+  virtual CounterSharedPtr makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                              const StatNameTagVector& stat_name_tags) PURE;
+
   /**
    * @param name the full name of the stat.
    * @param tag_extracted_name the name of the stat with tag-values stripped out.
@@ -109,6 +109,13 @@ public:
    * @param value the value of the sample.
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
+
+  /**
+   * @return whether flush() may be called on a thread other than the main thread. When the server
+   *         flushes stats on a dedicated thread, sinks returning false are still flushed on the
+   *         main thread, as are all sinks otherwise.
+   */
+  virtual bool flushOffMainThread() const { return false; }
 };
 
 using SinkPtr = std::unique_ptr<Sink>;
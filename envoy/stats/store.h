@@ -12,6 +12,8 @@
 #include "envoy/stats/stats_matcher.h"
 #include "envoy/stats/tag_producer.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Event {
 
@@ -202,6 +204,12 @@ public:
 
 using StorePtr = std::unique_ptr<Store>;
 
+/**
+ * Decides, from its full name, whether a counter is created sharded. See
+ * Allocator::makeShardedCounter.
+ */
+using ShardedCounterMatcher = std::function<bool(absl::string_view stat_name)>;
+
 /**
  * Callback invoked when a store's mergeHistogram() runs.
  */
@@ -235,6 +243,14 @@ public:
    */
   virtual void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) PURE;
 
+  /**
+   * Attach a matcher which selects the counters that are created sharded, so that workers
+   * incrementing them do not contend with each other. Counters created before the matcher is set
+   * are not affected.
+   * @param matcher returns true for the names of the counters to shard.
+   */
+  virtual void setShardedCounterMatcher(ShardedCounterMatcher&& matcher) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
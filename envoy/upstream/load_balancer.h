@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 
 #include "envoy/common/pure.h"
@@ -187,6 +188,23 @@ public:
 
 using LoadBalancerFactorySharedPtr = std::shared_ptr<LoadBalancerFactory>;
 
+/**
+ * A bounded set of background threads on which thread aware load balancers may build their
+ * initial load balancing structures, so that the main thread can go on initializing other
+ * clusters meanwhile.
+ */
+class LoadBalancerBuildPool {
+public:
+  virtual ~LoadBalancerBuildPool() = default;
+
+  /**
+   * Runs a task on one of the pool's threads. Tasks run in no particular order and must not use
+   * anything that is only safe to use on the main thread.
+   * @param task the task to run.
+   */
+  virtual void post(std::function<void()> task) PURE;
+};
+
 /**
  * A thread aware load balancer is a load balancer that is global to all workers on behalf of a
  * cluster. These load balancers are harder to write so not every load balancer has to be one.
@@ -230,6 +248,18 @@ public:
    * will do this at the appropriate time.
    */
   virtual absl::Status initialize() PURE;
+
+  /**
+   * Like initialize(), but the load balancer may build its initial structures on build_pool
+   * rather than on the calling thread. The factory's create() does not wait for them; load
+   * balancers it creates meanwhile wait for them on first use. Errors in the configuration must
+   * still be returned synchronously. Load balancers which have nothing expensive to build can rely
+   * on the default, which builds them synchronously.
+   * @param build_pool the pool to build the initial structures on.
+   */
+  virtual absl::Status initializeWithBuildPool(LoadBalancerBuildPool& /* build_pool */) {
+    return initialize();
+  }
 };
 
 using ThreadAwareLoadBalancerPtr = std::unique_ptr<ThreadAwareLoadBalancer>;
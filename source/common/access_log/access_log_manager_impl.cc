@@ -1,5 +1,6 @@
 #include "source/common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -9,6 +10,9 @@
 #include "source/common/common/lock_guard.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/numeric/bits.h"
 
 namespace Envoy {
 namespace AccessLog {
@@ -16,8 +20,24 @@ namespace {
 static constexpr Filesystem::FlagSet default_flags{1 << Filesystem::File::Operation::Write |
                                                    1 << Filesystem::File::Operation::Create |
                                                    1 << Filesystem::File::Operation::Append};
+
+std::atomic<uint64_t> next_file_id{0};
+
+// The ids of the files which have not been destroyed yet, and the number of files destroyed so
+// far, with which threads drop the buffers of destroyed files from their maps.
+Thread::MutexBasicLockable& liveFilesLock() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(Thread::MutexBasicLockable);
+}
+absl::flat_hash_set<uint64_t>& liveFiles() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(absl::flat_hash_set<uint64_t>);
+}
+std::atomic<uint64_t> destroyed_files{0};
 } // namespace
 
+thread_local absl::flat_hash_map<uint64_t, AccessLogFileImpl::ThreadBuffer*>
+    AccessLogFileImpl::calling_thread_buffers_;
+thread_local uint64_t AccessLogFileImpl::destroyed_files_seen_{0};
+
 AccessLogManagerImpl::~AccessLogManagerImpl() {
   for (auto& [log_key, log_file_ptr] : access_logs_) {
     ENVOY_LOG(debug, "destroying access logger {}", log_key);
@@ -46,23 +66,91 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
                                                   open_result.err_->getErrorDetails()));
   }
 
-  access_logs_[file_name] =
-      std::make_shared<AccessLogFileImpl>(std::move(file), dispatcher_, lock_, file_stats_,
-                                          file_flush_interval_msec_, api_.threadFactory());
+  access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
+      std::move(file), dispatcher_, lock_, file_stats_, file_flush_interval_msec_,
+      file_flush_min_size_, file_thread_buffer_size_, file_buffer_overflow_policy_,
+      api_.threadFactory());
   return access_logs_[file_name];
 }
 
+AccessLogFileImpl::ThreadBuffer::ThreadBuffer(uint64_t capacity)
+    : capacity_(capacity), data_(new char[capacity]) {
+  ASSERT(absl::has_single_bit(capacity));
+}
+
+bool AccessLogFileImpl::ThreadBuffer::tryWrite(absl::string_view data) {
+  if (overflowed_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  if (data.empty()) {
+    return true;
+  }
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+  if (capacity_ - (head - tail_.load(std::memory_order_acquire)) < data.size()) {
+    return false;
+  }
+  const uint64_t offset = head & (capacity_ - 1);
+  const uint64_t first = std::min<uint64_t>(data.size(), capacity_ - offset);
+  memcpy(data_.get() + offset, data.data(), first);
+  memcpy(data_.get(), data.data() + first, data.size() - first);
+  head_.store(head + data.size(), std::memory_order_release);
+  return true;
+}
+
+bool AccessLogFileImpl::ThreadBuffer::writeOverflow(absl::string_view data) {
+  Thread::LockGuard lock(overflow_lock_);
+  const bool was_overflowed = overflowed_.load(std::memory_order_relaxed);
+  overflowed_.store(true, std::memory_order_release);
+  overflow_.add(data);
+  return !was_overflowed;
+}
+
+void AccessLogFileImpl::ThreadBuffer::drainTo(Buffer::Instance& output) {
+  // Holding overflow_lock_ keeps the owning thread from writing to the ring buffer while the
+  // overflow buffer has data, so everything in the ring buffer up to head was written before
+  // everything in the overflow buffer.
+  Thread::LockGuard lock(overflow_lock_);
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  const uint64_t size = head_.load(std::memory_order_acquire) - tail;
+  if (size > 0) {
+    const uint64_t offset = tail & (capacity_ - 1);
+    const uint64_t first = std::min(size, capacity_ - offset);
+    output.add(data_.get() + offset, first);
+    if (size > first) {
+      output.add(data_.get(), size - first);
+    }
+    tail_.store(tail + size, std::memory_order_release);
+  }
+  output.move(overflow_);
+  overflowed_.store(false, std::memory_order_release);
+}
+
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
+                                     uint64_t flush_min_size, uint64_t thread_buffer_size,
+                                     Server::FileBufferOverflowPolicy overflow_policy,
                                      Thread::ThreadFactory& thread_factory)
     : file_(std::move(file)), file_lock_(lock),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
         flush_event_.notifyOne();
+        recordFlushTimes();
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec),
+      flush_min_size_(flush_min_size),
+      thread_buffer_capacity_(thread_buffer_size == 0 ? 0 : absl::bit_ceil(thread_buffer_size)),
+      // Thread buffers wake the flush thread by the time they are half full, so that they have room
+      // for the writes made while it drains them.
+      thread_buffer_flush_size_(
+          std::max<uint64_t>(1, std::min(flush_min_size, thread_buffer_capacity_ / 2))),
+      overflow_policy_(overflow_policy), id_(next_file_id++), time_source_(dispatcher.timeSource()),
+      stats_(stats) {
+  {
+    Thread::LockGuard lock(liveFilesLock());
+    liveFiles().insert(id_);
+  }
   flush_timer_->enableTimer(flush_interval_msec_);
 }
 
@@ -85,16 +173,79 @@ AccessLogFileImpl::~AccessLogFileImpl() {
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    {
+      Thread::LockGuard write_lock(write_lock_);
+      Thread::LockGuard flush_lock(flush_lock_);
+      moveBufferedData();
+    }
+    if (about_to_write_buffer_.length() > 0) {
+      doWrite(about_to_write_buffer_);
     }
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
                                              result.err_->getErrorDetails()));
   }
+
+  {
+    Thread::LockGuard lock(liveFilesLock());
+    liveFiles().erase(id_);
+  }
+  destroyed_files.fetch_add(1, std::memory_order_release);
+}
+
+AccessLogFileImpl::ThreadBuffer& AccessLogFileImpl::threadBuffer(bool& created) {
+  auto it = calling_thread_buffers_.find(id_);
+  created = it == calling_thread_buffers_.end();
+  if (!created) {
+    return *it->second;
+  }
+
+  // The files destroyed since this thread last started writing to a file have their entries
+  // dropped here, which keeps the entries of files which are removed or replaced from piling up
+  // without touching the map on every write.
+  const uint64_t destroyed = destroyed_files.load(std::memory_order_acquire);
+  if (destroyed != destroyed_files_seen_) {
+    destroyed_files_seen_ = destroyed;
+    Thread::LockGuard lock(liveFilesLock());
+    absl::erase_if(calling_thread_buffers_,
+                   [](const auto& entry) { return !liveFiles().contains(entry.first); });
+  }
+
+  Thread::LockGuard lock(write_lock_);
+  if (flush_thread_ == nullptr) {
+    createFlushStructures();
+  }
+  thread_buffers_.push_back(std::make_unique<ThreadBuffer>(thread_buffer_capacity_));
+  ThreadBuffer* buffer = thread_buffers_.back().get();
+  calling_thread_buffers_.emplace(id_, buffer);
+  return *buffer;
+}
+
+size_t AccessLogFileImpl::threadBuffersForTest() { return calling_thread_buffers_.size(); }
+
+bool AccessLogFileImpl::haveBufferedData() {
+  if (flush_buffer_.length() > 0) {
+    return true;
+  }
+  for (const auto& buffer : thread_buffers_) {
+    if (!buffer->empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AccessLogFileImpl::moveBufferedData() {
+  about_to_write_buffer_.move(flush_buffer_);
+  ASSERT(flush_buffer_.length() == 0);
+  for (const auto& buffer : thread_buffers_) {
+    buffer->drainTo(about_to_write_buffer_);
+  }
+  space_event_.notifyAll();
 }
 
 void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
+  const MonotonicTime start_time = time_source_.monotonicTime();
   Buffer::RawSliceVector slices = buffer.getRawSlices();
 
   // We must do the actual writes to disk under lock, so that we don't intermix chunks from
@@ -121,6 +272,24 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
 
   stats_.write_total_buffered_.sub(buffer.length());
   buffer.drain(buffer.length());
+
+  const auto flush_time = std::chrono::duration_cast<std::chrono::microseconds>(
+      time_source_.monotonicTime() - start_time);
+  Thread::LockGuard lock(flush_times_lock_);
+  if (pending_flush_times_us_.size() < MaxPendingFlushTimes) {
+    pending_flush_times_us_.push_back(flush_time.count());
+  }
+}
+
+void AccessLogFileImpl::recordFlushTimes() {
+  std::vector<uint64_t> flush_times_us;
+  {
+    Thread::LockGuard lock(flush_times_lock_);
+    flush_times_us.swap(pending_flush_times_us_);
+  }
+  for (const uint64_t flush_time_us : flush_times_us) {
+    stats_.flush_time_us_.recordValue(flush_time_us);
+  }
 }
 
 void AccessLogFileImpl::flushThreadFunc() {
@@ -136,13 +305,13 @@ void AccessLogFileImpl::flushThreadFunc() {
     {
       Thread::LockGuard write_lock(write_lock_);
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
+      // flush_event_ can be woken up either by large enough buffered data or by timer.
+      // In case it was timer, the buffers can be empty.
       //
       // Note: do not stop waiting when only `do_reopen` is true. In this case, we tried to
       // reopen and failed. We don't want to retry this in a tight loop, so wait for the next
       // event (timer or flush).
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
+      while (!haveBufferedData() && !flush_thread_exit_ && !reopen_file_) {
         // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
         flush_event_.wait(write_lock_);
       }
@@ -152,8 +321,7 @@ void AccessLogFileImpl::flushThreadFunc() {
       }
 
       flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
+      moveBufferedData();
 
       if (reopen_file_) {
         do_reopen = true;
@@ -187,37 +355,98 @@ void AccessLogFileImpl::flush() {
 
     // flush_lock_ must be held while checking this or else it is
     // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
+    // the buffers to about_to_write_buffer_, has unlocked write_lock_,
     // but has not yet completed doWrite(). This would allow flush() to
     // return before the pending data has actually been written to disk.
     flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
 
-    if (flush_buffer_.length() == 0) {
+    if (!haveBufferedData()) {
       return;
     }
 
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+    moveBufferedData();
   }
 
   doWrite(about_to_write_buffer_);
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
+  // Accounted for before the flush thread can see the data, so that the gauge never goes below 0.
+  stats_.write_total_buffered_.add(data.length());
+
+  if (thread_buffer_capacity_ == 0) {
+    writeShared(data);
+    stats_.write_buffered_.inc();
+    return;
+  }
+
+  bool created;
+  ThreadBuffer& buffer = threadBuffer(created);
+  if (buffer.tryWrite(data)) {
+    stats_.write_buffered_.inc();
+    // Besides the first write of a thread, only the write which fills the buffer past the flush
+    // size wakes the flush thread, which then keeps draining until the buffers are empty.
+    const uint64_t size = buffer.size();
+    if (created ||
+        (size >= thread_buffer_flush_size_ && size < thread_buffer_flush_size_ + data.length())) {
+      notifyFlushThread();
+    }
+    return;
+  }
+
+  // Only writes which do not fit because the ring buffer is full are dropped or blocked. Writes
+  // which could never fit in it, and writes queued behind them, go to the overflow buffer.
+  if (overflow_policy_ == Server::FileBufferOverflowPolicy::Unbounded ||
+      data.length() > thread_buffer_capacity_ ||
+      data.length() <= thread_buffer_capacity_ - buffer.size()) {
+    stats_.write_buffered_.inc();
+    if (buffer.writeOverflow(data)) {
+      notifyFlushThread();
+    }
+    return;
+  }
+
+  if (overflow_policy_ == Server::FileBufferOverflowPolicy::Drop) {
+    stats_.write_total_buffered_.sub(data.length());
+    // The write which filled the buffer has already woken the flush thread.
+    stats_.write_dropped_.inc();
+    return;
+  }
+
+  writeBlocking(buffer, data);
+  stats_.write_buffered_.inc();
+}
+
+void AccessLogFileImpl::writeShared(absl::string_view data) {
   Thread::LockGuard lock(write_lock_);
 
   if (flush_thread_ == nullptr) {
     createFlushStructures();
   }
 
-  stats_.write_buffered_.inc();
-  stats_.write_total_buffered_.add(data.length());
   flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
+  if (flush_buffer_.length() > flush_min_size_) {
     flush_event_.notifyOne();
   }
 }
 
+void AccessLogFileImpl::writeBlocking(ThreadBuffer& buffer, absl::string_view data) {
+  stats_.write_blocked_.inc();
+  Thread::LockGuard lock(write_lock_);
+  while (!buffer.tryWrite(data)) {
+    flush_event_.notifyOne();
+    // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+    space_event_.wait(write_lock_);
+  }
+}
+
+void AccessLogFileImpl::notifyFlushThread() {
+  // Notifying under write_lock_ ensures that the flush thread is either waiting, or has yet to
+  // check for buffered data.
+  Thread::LockGuard lock(write_lock_);
+  flush_event_.notifyOne();
+}
+
 void AccessLogFileImpl::createFlushStructures() {
   flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
                                                Thread::Options{"AccessLogFlush"});
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/filesystem/filesystem.h"
+#include "envoy/server/options.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/stats/store.h"
 
@@ -13,33 +17,45 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
 
-#define ACCESS_LOG_FILE_STATS(COUNTER, GAUGE)                                                      \
+#define ACCESS_LOG_FILE_STATS(COUNTER, GAUGE, HISTOGRAM)                                           \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
+  COUNTER(write_blocked)                                                                           \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
-  GAUGE(write_total_buffered, Accumulate)
+  GAUGE(write_total_buffered, Accumulate)                                                          \
+  HISTOGRAM(flush_time_us, Microseconds)
 
 struct AccessLogFileStats {
-  ACCESS_LOG_FILE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ACCESS_LOG_FILE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                        GENERATE_HISTOGRAM_STRUCT)
 };
 
 namespace AccessLog {
 
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
-  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
+  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec,
+                       uint64_t file_flush_min_size, uint64_t file_thread_buffer_size,
+                       Server::FileBufferOverflowPolicy file_buffer_overflow_policy, Api::Api& api,
                        Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
                        Stats::Store& stats_store)
-      : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
-        lock_(lock), file_stats_{
-                         ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
-                                               POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
+      : file_flush_interval_msec_(file_flush_interval_msec),
+        file_flush_min_size_(file_flush_min_size),
+        file_thread_buffer_size_(file_thread_buffer_size),
+        file_buffer_overflow_policy_(file_buffer_overflow_policy), api_(api),
+        dispatcher_(dispatcher), lock_(lock),
+        file_stats_{
+            ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
+                                  POOL_GAUGE_PREFIX(stats_store, "filesystem."),
+                                  POOL_HISTOGRAM_PREFIX(stats_store, "filesystem."))} {}
   ~AccessLogManagerImpl() override;
 
   // AccessLog::AccessLogManager
@@ -49,6 +65,9 @@ public:
 
 private:
   const std::chrono::milliseconds file_flush_interval_msec_;
+  const uint64_t file_flush_min_size_;
+  const uint64_t file_thread_buffer_size_;
+  const Server::FileBufferOverflowPolicy file_buffer_overflow_policy_;
   Api::Api& api_;
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
@@ -62,12 +81,19 @@ private:
  * This implementation uses a flush thread per file, with the idea there aren't that many
  * files. If this turns out to be a good implementation we can potentially have a single flush
  * thread that flushes all files, but we will start with this.
+ *
+ * Each thread writing to the file fills a buffer of its own without taking a lock, which the flush
+ * thread drains; writes which do not fit are handled as the overflow policy says. With a thread
+ * buffer size of 0, all threads append to a shared buffer under a lock instead. Writes from one
+ * thread are written out in order, but writes from different threads may be reordered by up to a
+ * flush.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
-                    std::chrono::milliseconds flush_interval_msec,
+                    std::chrono::milliseconds flush_interval_msec, uint64_t flush_min_size,
+                    uint64_t thread_buffer_size, Server::FileBufferOverflowPolicy overflow_policy,
                     Thread::ThreadFactory& thread_factory);
   ~AccessLogFileImpl() override;
 
@@ -82,20 +108,97 @@ public:
   void reopen() override;
   void flush() override;
 
+  /**
+   * @return the number of files the calling thread has a buffer for.
+   */
+  static size_t threadBuffersForTest();
+
 private:
+  /**
+   * The buffer of one thread writing to the file. Writes go to a ring buffer, which the writing
+   * thread fills without taking a lock, unless they do not fit in it, in which case they go to an
+   * overflow buffer until the ring buffer has been drained. The buffer is drained by whoever holds
+   * flush_lock_.
+   */
+  class ThreadBuffer {
+  public:
+    // capacity must be a power of two.
+    explicit ThreadBuffer(uint64_t capacity);
+
+    /**
+     * Appends data to the ring buffer if it fits and nothing is waiting in the overflow buffer.
+     * Only called by the thread owning the buffer.
+     * @return whether data was appended.
+     */
+    bool tryWrite(absl::string_view data);
+
+    /**
+     * Appends data to the overflow buffer, which has no size limit. Only called by the thread
+     * owning the buffer.
+     * @return whether the overflow buffer was empty.
+     */
+    bool writeOverflow(absl::string_view data);
+
+    /**
+     * @return the number of bytes in the ring buffer.
+     */
+    uint64_t size() const {
+      return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return whether nothing is buffered.
+     */
+    bool empty() const { return size() == 0 && !overflowed_.load(std::memory_order_acquire); }
+
+    /**
+     * Moves everything buffered to output, in the order it was written.
+     */
+    void drainTo(Buffer::Instance& output);
+
+  private:
+    const uint64_t capacity_;
+    const std::unique_ptr<char[]> data_;
+    // Total bytes ever appended to and drained from the ring buffer. Each is only advanced by one
+    // side, and the difference is the number of bytes buffered.
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> tail_{0};
+    // Set while overflow_ may hold data, so that later writes queue behind it.
+    std::atomic<bool> overflowed_{false};
+    Thread::MutexBasicLockable overflow_lock_;
+    Buffer::OwnedImpl overflow_ ABSL_GUARDED_BY(overflow_lock_);
+  };
+
+  // Sets created if the calling thread had no buffer yet.
+  ThreadBuffer& threadBuffer(bool& created);
+
+  // The calling thread's buffers, by the id of their file. The buffers of destroyed files are
+  // dropped the next time the thread creates a buffer.
+  static thread_local absl::flat_hash_map<uint64_t, ThreadBuffer*> calling_thread_buffers_;
+  // The number of files destroyed when the calling thread last dropped their buffers.
+  static thread_local uint64_t destroyed_files_seen_;
+
+  bool haveBufferedData() ABSL_EXCLUSIVE_LOCKS_REQUIRED(write_lock_);
+  void moveBufferedData() ABSL_EXCLUSIVE_LOCKS_REQUIRED(write_lock_);
+  void writeShared(absl::string_view data);
+  void writeBlocking(ThreadBuffer& buffer, absl::string_view data);
+  void notifyFlushThread();
   void doWrite(Buffer::Instance& buffer);
   void flushThreadFunc();
   void createFlushStructures();
+  void recordFlushTimes();
 
-  // Minimum size before the flush thread will be told to flush.
-  static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // Flush times waiting for the flush timer to record them on the dispatcher's thread, as
+  // histograms may not be recorded from the flush thread. Samples beyond this many are dropped.
+  static constexpr size_t MaxPendingFlushTimes = 1024;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
   //    1) write_lock_
   //    2) flush_lock_
-  //    3) file_lock_
+  //    3) file_lock_, or the overflow_lock_ of a thread buffer
+  //    4) flush_times_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -103,33 +206,51 @@ private:
   Thread::MutexBasicLockable flush_lock_; // This lock is used to prevent simultaneous flushes from
                                           // the flush thread and a synchronous flush. This protects
                                           // concurrent access to the about_to_write_buffer_, fd_,
-                                          // and all other data used during flushing and file
-                                          // re-opening.
+                                          // the draining side of the thread buffers, and all other
+                                          // data used during flushing and file re-opening.
   Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
+      write_lock_; // The lock is used when filling the shared flush buffer, when a thread creates
+                   // its buffer, and to wait for or signal the flush thread. It is always local to
+                   // the process.
   Thread::ThreadPtr flush_thread_;
   Thread::CondVar flush_event_;
+  Thread::CondVar space_event_; // Signalled when thread buffers have been drained, for writes
+                                // waiting for room under the Block overflow policy.
   bool flush_thread_exit_ ABSL_GUARDED_BY(write_lock_){false};
   bool reopen_file_ ABSL_GUARDED_BY(write_lock_){false};
   Buffer::OwnedImpl
       flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
                                                   // gets filled and then flushed either when max
                                                   // size is reached or when a timer fires.
+  // The buffers of the threads which have written to this file. Buffers are kept until the file is
+  // destroyed, so that data written by a thread which has exited is still flushed.
+  std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers_ ABSL_GUARDED_BY(write_lock_);
   // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
   // through the std::make_unique assignment. I do not believe it's possible to annotate this
   // properly now due to limitations in the clang thread annotation analysis.
   Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
+                                            // is moved from flush_buffer_ and the thread buffers
+                                            // under lock, and then the lock is released so that
+                                            // they can continue to fill. This buffer is then used
+                                            // for the final write to disk.
+  Thread::MutexBasicLockable flush_times_lock_;
+  std::vector<uint64_t> pending_flush_times_us_ ABSL_GUARDED_BY(flush_times_lock_);
   Event::TimerPtr flush_timer_;
   Thread::ThreadFactory& thread_factory_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
-                                                        // matter if it reached the MIN_FLUSH_SIZE
+                                                        // matter if it reached the flush_min_size_
                                                         // or not.
+  // Size of the shared buffer at which the flush thread is woken.
+  const uint64_t flush_min_size_;
+  // 0 if threads do not have buffers of their own.
+  const uint64_t thread_buffer_capacity_;
+  // Size of a thread buffer at which the flush thread is woken.
+  const uint64_t thread_buffer_flush_size_;
+  const Server::FileBufferOverflowPolicy overflow_policy_;
+  // Identifies the file in the threads' maps of their buffers. Unlike the address of the file, it
+  // is never reused.
+  const uint64_t id_;
+  TimeSource& time_source_;
   AccessLogFileStats& stats_;
 };
 
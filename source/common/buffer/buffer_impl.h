@@ -9,6 +9,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/http/stream_reset_handler.h"
 
+#include "source/common/buffer/slice_storage_pool.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/non_copyable.h"
 #include "source/common/common/utility.h"
@@ -37,7 +38,13 @@ namespace Buffer {
 class Slice {
 public:
   using Reservation = RawSlice;
-  using StoragePtr = std::unique_ptr<uint8_t[]>;
+
+  // Storage is returned to SliceStoragePool, which needs its size to find the right free list.
+  struct StorageDeleter {
+    void operator()(uint8_t* mem) const { SliceStoragePool::release(mem, size_); }
+    uint64_t size_{};
+  };
+  using StoragePtr = std::unique_ptr<uint8_t[], StorageDeleter>;
 
   struct SizedStorage {
     StoragePtr mem_{};
@@ -57,7 +64,7 @@ public:
    * @param account the account to charge.
    */
   Slice(uint64_t min_capacity, const BufferMemoryAccountSharedPtr& account)
-      : capacity_(sliceSize(min_capacity)), storage_(new uint8_t[capacity_]),
+      : capacity_(sliceSize(min_capacity)), storage_(allocateStorage(capacity_)),
         base_(storage_.get()) {
     if (account) {
       account->charge(capacity_);
@@ -385,7 +392,16 @@ public:
    */
   static inline SizedStorage newStorage(uint64_t min_capacity) {
     const uint64_t slice_size = sliceSize(min_capacity);
-    return {StoragePtr{new uint8_t[slice_size]}, static_cast<size_t>(slice_size)};
+    return {allocateStorage(slice_size), static_cast<size_t>(slice_size)};
+  }
+
+  /**
+   * Allocate backend storage, from the calling thread's SliceStoragePool if it is enabled.
+   * @param size the size of the storage, which must be a multiple of 4kb.
+   * @return the storage, which may be released on any thread.
+   */
+  static StoragePtr allocateStorage(uint64_t size) {
+    return StoragePtr(SliceStoragePool::allocate(size), StorageDeleter{size});
   }
 
 protected:
@@ -805,7 +821,7 @@ private:
         storage.mem_ = std::move(free_list_ref_.back());
         free_list_ref_.pop_back();
       } else {
-        storage.mem_.reset(new uint8_t[Slice::default_slice_size_]);
+        storage.mem_ = Slice::allocateStorage(Slice::default_slice_size_);
       }
 
       return storage;
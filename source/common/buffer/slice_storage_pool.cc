@@ -0,0 +1,162 @@
+#include "source/common/buffer/slice_storage_pool.h"
+
+#include <array>
+#include <vector>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Buffer {
+
+std::atomic<bool> SliceStoragePool::enabled_{false};
+std::atomic<uint64_t> SliceStoragePool::max_retained_bytes_per_thread_{
+    SliceStoragePool::DefaultMaxRetainedBytesPerThread};
+
+namespace {
+
+constexpr size_t NumSizeClasses = SliceStoragePool::MaxPooledSize / SliceStoragePool::PageSize;
+
+size_t sizeClass(uint64_t size) { return size / SliceStoragePool::PageSize - 1; }
+
+// Stats counters are only written by the thread which owns them, so a relaxed load and store is
+// enough; the atomic is so that stats() can read them from another thread.
+void add(std::atomic<uint64_t>& stat, uint64_t delta) {
+  stat.store(stat.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+void subtract(std::atomic<uint64_t>& stat, uint64_t delta) {
+  stat.store(stat.load(std::memory_order_relaxed) - delta, std::memory_order_relaxed);
+}
+
+class ThreadCache;
+
+// All live thread caches, so that stats() can sum them, and the totals of caches whose threads
+// have exited. Leaked, so that threads exiting during static destruction can still use it.
+struct Registry {
+  absl::Mutex mutex_;
+  absl::flat_hash_set<ThreadCache*> caches_ ABSL_GUARDED_BY(mutex_);
+  uint64_t retired_hits_ ABSL_GUARDED_BY(mutex_){};
+  uint64_t retired_misses_ ABSL_GUARDED_BY(mutex_){};
+};
+
+Registry& registry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Registry); }
+
+// Set once the calling thread's cache has been destroyed. Slices owned by other thread_local
+// objects may still be released after that, and must then bypass the pool.
+thread_local bool thread_cache_destroyed = false;
+
+class ThreadCache {
+public:
+  ThreadCache() {
+    Registry& r = registry();
+    absl::MutexLock lock(&r.mutex_);
+    r.caches_.insert(this);
+  }
+
+  ~ThreadCache() {
+    thread_cache_destroyed = true;
+    {
+      Registry& r = registry();
+      absl::MutexLock lock(&r.mutex_);
+      r.retired_hits_ += hits_.load(std::memory_order_relaxed);
+      r.retired_misses_ += misses_.load(std::memory_order_relaxed);
+      r.caches_.erase(this);
+    }
+    for (std::vector<uint8_t*>& free_list : free_lists_) {
+      for (uint8_t* mem : free_list) {
+        delete[] mem;
+      }
+    }
+  }
+
+  uint8_t* allocate(uint64_t size) {
+    if (size <= SliceStoragePool::MaxPooledSize) {
+      std::vector<uint8_t*>& free_list = free_lists_[sizeClass(size)];
+      if (!free_list.empty()) {
+        uint8_t* mem = free_list.back();
+        free_list.pop_back();
+        add(hits_, 1);
+        subtract(retained_bytes_, size);
+        return mem;
+      }
+    }
+    add(misses_, 1);
+    return nullptr;
+  }
+
+  bool release(uint8_t* mem, uint64_t size, uint64_t max_retained_bytes) {
+    if (size > SliceStoragePool::MaxPooledSize ||
+        retained_bytes_.load(std::memory_order_relaxed) + size > max_retained_bytes) {
+      return false;
+    }
+    free_lists_[sizeClass(size)].push_back(mem);
+    add(retained_bytes_, size);
+    return true;
+  }
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> retained_bytes_{0};
+
+private:
+  std::array<std::vector<uint8_t*>, NumSizeClasses> free_lists_;
+};
+
+ThreadCache* threadCache() {
+  if (thread_cache_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+} // namespace
+
+void SliceStoragePool::configure(bool enabled, uint64_t max_retained_bytes_per_thread) {
+  max_retained_bytes_per_thread_.store(max_retained_bytes_per_thread, std::memory_order_relaxed);
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+uint8_t* SliceStoragePool::allocate(uint64_t size) {
+  ASSERT(size > 0 && size % PageSize == 0);
+  if (enabled()) {
+    ThreadCache* cache = threadCache();
+    if (cache != nullptr) {
+      uint8_t* mem = cache->allocate(size);
+      if (mem != nullptr) {
+        return mem;
+      }
+    }
+  }
+  return new uint8_t[size];
+}
+
+void SliceStoragePool::release(uint8_t* mem, uint64_t size) {
+  ASSERT(size > 0 && size % PageSize == 0);
+  if (enabled()) {
+    ThreadCache* cache = threadCache();
+    if (cache != nullptr &&
+        cache->release(mem, size, max_retained_bytes_per_thread_.load(std::memory_order_relaxed))) {
+      return;
+    }
+  }
+  delete[] mem;
+}
+
+SliceStoragePool::Stats SliceStoragePool::stats() {
+  Registry& r = registry();
+  absl::MutexLock lock(&r.mutex_);
+  Stats stats{r.retired_hits_, r.retired_misses_, 0};
+  for (const ThreadCache* cache : r.caches_) {
+    stats.hits_ += cache->hits_.load(std::memory_order_relaxed);
+    stats.misses_ += cache->misses_.load(std::memory_order_relaxed);
+    stats.retained_bytes_ += cache->retained_bytes_.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+} // namespace Buffer
+} // namespace Envoy
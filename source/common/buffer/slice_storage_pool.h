@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * An optional per-thread pool of the heap blocks used as Slice storage. Slice sizes are always a
+ * whole number of 4KiB pages, so each page count up to MaxPooledSize is its own size class with
+ * its own free list. Storage released on a thread is kept for reuse by later allocations on the
+ * same thread, up to a bounded number of bytes per thread; anything beyond that, or larger than
+ * MaxPooledSize, goes straight back to the general-purpose allocator.
+ *
+ * Every block is allocated with new[], so storage may be released on a different thread from the
+ * one which allocated it, e.g. when an OwnedImpl is moved across threads. The block then joins
+ * the releasing thread's pool.
+ *
+ * The pool is disabled by default, in which case allocate and release are new[] and delete[].
+ */
+class SliceStoragePool {
+public:
+  static constexpr uint64_t PageSize = 4096;
+  static constexpr uint64_t MaxPooledSize = 16 * PageSize;
+  static constexpr uint64_t DefaultMaxRetainedBytesPerThread = 1024 * 1024;
+
+  struct Stats {
+    // Allocations satisfied from a free list.
+    uint64_t hits_{};
+    // Allocations made while the pool was enabled which went to the general-purpose allocator,
+    // either because the free list was empty or because the size is not pooled.
+    uint64_t misses_{};
+    // Bytes currently held in free lists, summed over all threads.
+    uint64_t retained_bytes_{};
+  };
+
+  /**
+   * Enables or disables the pool for all threads. Storage already retained is kept until reused
+   * or until its thread exits.
+   * @param enabled whether subsequent allocations and releases use the pool.
+   * @param max_retained_bytes_per_thread the most bytes each thread keeps in its free lists.
+   */
+  static void configure(bool enabled,
+                        uint64_t max_retained_bytes_per_thread = DefaultMaxRetainedBytesPerThread);
+
+  /**
+   * @return whether the pool is enabled.
+   */
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @param size the number of bytes to allocate, which must be a non-zero multiple of PageSize.
+   * @return storage which must be passed to release with the same size.
+   */
+  static uint8_t* allocate(uint64_t size);
+
+  /**
+   * @param mem storage returned by allocate, on any thread.
+   * @param size the size which was passed to allocate.
+   */
+  static void release(uint8_t* mem, uint64_t size);
+
+  /**
+   * @return the totals for all threads, including threads which have exited.
+   */
+  static Stats stats();
+
+private:
+  static std::atomic<bool> enabled_;
+  static std::atomic<uint64_t> max_retained_bytes_per_thread_;
+};
+
+} // namespace Buffer
+} // namespace Envoy
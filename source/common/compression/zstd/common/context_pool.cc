@@ -0,0 +1,106 @@
+#include "source/common/compression/zstd/common/context_pool.h"
+
+#include <vector>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Compression {
+namespace Zstd {
+namespace Common {
+
+namespace {
+
+// Set once the calling thread's pool has been destroyed. Contexts owned by other thread_local
+// objects may still be released after that, and must then be freed.
+thread_local bool thread_pool_destroyed = false;
+
+struct ThreadPool {
+  ~ThreadPool() {
+    thread_pool_destroyed = true;
+    for (ZSTD_CCtx* cctx : cctxs_) {
+      ZSTD_freeCCtx(cctx);
+    }
+    for (ZSTD_DCtx* dctx : dctxs_) {
+      ZSTD_freeDCtx(dctx);
+    }
+  }
+
+  std::vector<ZSTD_CCtx*> cctxs_;
+  std::vector<ZSTD_DCtx*> dctxs_;
+};
+
+ThreadPool* threadPool() {
+  if (thread_pool_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadPool pool;
+  return &pool;
+}
+
+size_t releaseCCtx(ZSTD_CCtx* cctx) {
+  if (cctx == nullptr) {
+    return 0;
+  }
+  ThreadPool* pool = threadPool();
+  if (pool == nullptr || pool->cctxs_.size() >= ContextPool::MaxPooledContexts ||
+      ZSTD_isError(ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters))) {
+    return ZSTD_freeCCtx(cctx);
+  }
+  pool->cctxs_.push_back(cctx);
+  return 0;
+}
+
+size_t releaseDCtx(ZSTD_DCtx* dctx) {
+  if (dctx == nullptr) {
+    return 0;
+  }
+  ThreadPool* pool = threadPool();
+  if (pool == nullptr || pool->dctxs_.size() >= ContextPool::MaxPooledContexts ||
+      ZSTD_isError(ZSTD_DCtx_reset(dctx, ZSTD_reset_session_and_parameters))) {
+    return ZSTD_freeDCtx(dctx);
+  }
+  pool->dctxs_.push_back(dctx);
+  return 0;
+}
+
+} // namespace
+
+CCtxPtr ContextPool::compressionContext() {
+  ThreadPool* pool = threadPool();
+  if (pool != nullptr && !pool->cctxs_.empty()) {
+    ZSTD_CCtx* cctx = pool->cctxs_.back();
+    pool->cctxs_.pop_back();
+    return {cctx, &releaseCCtx};
+  }
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  RELEASE_ASSERT(cctx != nullptr, "unable to create zstd compression context");
+  return {cctx, &releaseCCtx};
+}
+
+DCtxPtr ContextPool::decompressionContext() {
+  ThreadPool* pool = threadPool();
+  if (pool != nullptr && !pool->dctxs_.empty()) {
+    ZSTD_DCtx* dctx = pool->dctxs_.back();
+    pool->dctxs_.pop_back();
+    return {dctx, &releaseDCtx};
+  }
+  ZSTD_DCtx* dctx = ZSTD_createDCtx();
+  RELEASE_ASSERT(dctx != nullptr, "unable to create zstd decompression context");
+  return {dctx, &releaseDCtx};
+}
+
+size_t ContextPool::pooledCompressionContexts() {
+  ThreadPool* pool = threadPool();
+  return pool != nullptr ? pool->cctxs_.size() : 0;
+}
+
+size_t ContextPool::pooledDecompressionContexts() {
+  ThreadPool* pool = threadPool();
+  return pool != nullptr ? pool->dctxs_.size() : 0;
+}
+
+} // namespace Common
+} // namespace Zstd
+} // namespace Compression
+} // namespace Envoy
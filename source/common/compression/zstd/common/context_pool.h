@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "zstd.h"
+
+namespace Envoy {
+namespace Compression {
+namespace Zstd {
+namespace Common {
+
+using CCtxPtr = std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)>;
+using DCtxPtr = std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)>;
+
+/**
+ * A per-thread pool of `Zstd` compression and decompression contexts. Creating a context
+ * allocates its working memory, which for a small response can cost more than compressing it, so
+ * contexts released by a stream are reset and kept for the next stream on the same thread, i.e.
+ * the same worker. Each thread keeps at most MaxPooledContexts contexts of each kind.
+ *
+ * A context taken from the pool has no parameters or dictionary set, as if newly created.
+ */
+class ContextPool {
+public:
+  static constexpr size_t MaxPooledContexts = 4;
+
+  /**
+   * @return a compression context, which returns to the releasing thread's pool when destroyed.
+   */
+  static CCtxPtr compressionContext();
+
+  /**
+   * @return a decompression context, which returns to the releasing thread's pool when destroyed.
+   */
+  static DCtxPtr decompressionContext();
+
+  /**
+   * @return the number of compression contexts pooled on the calling thread.
+   */
+  static size_t pooledCompressionContexts();
+
+  /**
+   * @return the number of decompression contexts pooled on the calling thread.
+   */
+  static size_t pooledDecompressionContexts();
+};
+
+} // namespace Common
+} // namespace Zstd
+} // namespace Compression
+} // namespace Envoy
@@ -9,8 +9,13 @@ namespace Compressor {
 
 ZstdCompressorImplBase::ZstdCompressorImplBase(uint32_t compression_level, bool enable_checksum,
                                                uint32_t strategy, uint32_t chunk_size)
-    : Common::Base(chunk_size), cctx_(ZSTD_createCCtx(), &ZSTD_freeCCtx),
-      compression_level_(compression_level) {
+    : ZstdCompressorImplBase(Common::CCtxPtr(ZSTD_createCCtx(), &ZSTD_freeCCtx),
+                             compression_level, enable_checksum, strategy, chunk_size) {}
+
+ZstdCompressorImplBase::ZstdCompressorImplBase(Common::CCtxPtr cctx, uint32_t compression_level,
+                                               bool enable_checksum, uint32_t strategy,
+                                               uint32_t chunk_size)
+    : Common::Base(chunk_size), cctx_(std::move(cctx)), compression_level_(compression_level) {
   size_t result;
   result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_checksumFlag, enable_checksum);
   RELEASE_ASSERT(!ZSTD_isError(result), "");
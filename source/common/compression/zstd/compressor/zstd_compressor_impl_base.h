@@ -3,6 +3,7 @@
 #include "envoy/compression/compressor/compressor.h"
 
 #include "source/common/compression/zstd/common/base.h"
+#include "source/common/compression/zstd/common/context_pool.h"
 
 namespace Envoy {
 namespace Compression {
@@ -19,6 +20,13 @@ public:
   ZstdCompressorImplBase(uint32_t compression_level, bool enable_checksum, uint32_t strategy,
                          uint32_t chunk_size);
 
+  /**
+   * Compresses with the given context, which may have been used before but must have no
+   * parameters or dictionary set. @see Common::ContextPool.
+   */
+  ZstdCompressorImplBase(Common::CCtxPtr cctx, uint32_t compression_level, bool enable_checksum,
+                         uint32_t strategy, uint32_t chunk_size);
+
   // Compression::Compressor::Compressor
   void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
 
@@ -33,7 +41,7 @@ protected:
 
   virtual void compressPostprocess(Buffer::Instance& accumulation_buffer) PURE;
 
-  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx_;
+  Common::CCtxPtr cctx_;
   const uint32_t compression_level_;
 };
 
@@ -70,6 +70,11 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Thread::ThreadFactory& t
     : name_(name), thread_factory_(thread_factory), time_source_(time_source),
       file_system_(file_system), buffer_factory_(watermark_factory),
       scheduler_(time_system.createScheduler(base_scheduler_, base_scheduler_)),
+      timer_wheel_(Runtime::runtimeFeatureEnabled("envoy.restart_features.dispatcher_timer_wheel")
+                       ? std::make_unique<TimerWheel>(*scheduler_, *this, time_source_,
+                                                      std::chrono::milliseconds(10),
+                                                      std::chrono::seconds(1))
+                       : nullptr),
       thread_local_delete_cb_(
           base_scheduler_.createSchedulableCallback([this]() -> void { runThreadLocalDelete(); })),
       deferred_delete_cb_(base_scheduler_.createSchedulableCallback(
@@ -212,12 +217,15 @@ Event::SchedulableCallbackPtr DispatcherImpl::createSchedulableCallback(std::fun
 }
 
 TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
-  return scheduler_->createTimer(
-      [this, cb]() {
-        touchWatchdog();
-        cb();
-      },
-      *this);
+  TimerCb wrapped_cb = [this, cb]() {
+    touchWatchdog();
+    cb();
+  };
+  if (timer_wheel_ != nullptr) {
+    return std::make_unique<WheelTimerImpl>(*timer_wheel_, *scheduler_, std::move(wrapped_cb),
+                                            *this);
+  }
+  return scheduler_->createTimer(wrapped_cb, *this);
 }
 
 void DispatcherImpl::deferredDelete(DeferredDeletablePtr&& to_delete) {
@@ -0,0 +1,259 @@
+#include "source/common/event/timer_wheel.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/scope_tracker.h"
+
+#include "absl/numeric/bits.h"
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+
+constexpr uint64_t SlotMask = TimerWheel::Slots - 1;
+
+uint32_t shift(uint32_t level) { return TimerWheel::SlotBits * level; }
+
+} // namespace
+
+TimerWheel::TimerWheel(Scheduler& scheduler, Dispatcher& dispatcher, TimeSource& time_source,
+                       std::chrono::milliseconds tick, std::chrono::milliseconds min_duration)
+    : time_source_(time_source), tick_(tick), min_duration_(min_duration),
+      start_(time_source.monotonicTime()),
+      tick_timer_(scheduler.createTimer([this]() { onTickTimer(); }, dispatcher)) {
+  ASSERT(tick_.count() > 0);
+  for (uint32_t level = 0; level < Levels; level++) {
+    for (uint32_t index = 0; index < Slots; index++) {
+      slots_[level][index].level_ = level;
+      slots_[level][index].index_ = index;
+    }
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  for (auto& level : slots_) {
+    for (Slot& slot : level) {
+      for (Entry* entry = slot.head_; entry != nullptr; entry = entry->next_) {
+        entry->slot_ = nullptr;
+      }
+    }
+  }
+}
+
+void TimerWheel::add(Entry& entry, std::chrono::milliseconds duration) {
+  if (entry.armed()) {
+    unlink(entry);
+  }
+  const MonotonicTime now = time_source_.monotonicTime();
+  if (size_ == 0) {
+    // There is nothing to expire or cascade until now.
+    current_tick_ = std::max(current_tick_, tickAt(now));
+  }
+  // The tick after the one the duration ends in, so that the entry never expires early.
+  entry.expiry_tick_ = tickAt(now + duration) + 1;
+  link(entry);
+  if (!armed_tick_.has_value() || entry.expiry_tick_ < armed_tick_.value()) {
+    armTickTimer(entry.expiry_tick_);
+  }
+}
+
+void TimerWheel::remove(Entry& entry) {
+  if (!entry.armed()) {
+    return;
+  }
+  unlink(entry);
+  if (size_ == 0) {
+    tick_timer_->disableTimer();
+    armed_tick_.reset();
+  }
+}
+
+TimerWheel::Slot& TimerWheel::slotFor(uint64_t expiry_tick) {
+  // Entries expiring in the current tick only go into the wheel while it is cascaded, right before
+  // the current slot of the lowest level expires.
+  const uint64_t delta = expiry_tick > current_tick_ ? expiry_tick - current_tick_ : 0;
+  for (uint32_t level = 0; level < Levels - 1; level++) {
+    if (delta < (uint64_t{1} << shift(level + 1))) {
+      return slots_[level][(expiry_tick >> shift(level)) & SlotMask];
+    }
+  }
+  // Entries beyond the range of the wheel are parked in the top level slot cascaded last.
+  const uint64_t parked_tick =
+      std::min(expiry_tick, current_tick_ + (uint64_t{1} << shift(Levels)) - 1);
+  return slots_[Levels - 1][(parked_tick >> shift(Levels - 1)) & SlotMask];
+}
+
+void TimerWheel::link(Entry& entry) {
+  Slot& slot = slotFor(entry.expiry_tick_);
+  entry.slot_ = &slot;
+  entry.prev_ = nullptr;
+  entry.next_ = slot.head_;
+  if (slot.head_ != nullptr) {
+    slot.head_->prev_ = &entry;
+  } else {
+    occupied_[slot.level_] |= uint64_t{1} << slot.index_;
+  }
+  slot.head_ = &entry;
+  size_++;
+}
+
+void TimerWheel::unlink(Entry& entry) {
+  Slot& slot = *entry.slot_;
+  if (entry.prev_ != nullptr) {
+    entry.prev_->next_ = entry.next_;
+  } else {
+    slot.head_ = entry.next_;
+    if (slot.head_ == nullptr) {
+      occupied_[slot.level_] &= ~(uint64_t{1} << slot.index_);
+    }
+  }
+  if (entry.next_ != nullptr) {
+    entry.next_->prev_ = entry.prev_;
+  }
+  entry.slot_ = nullptr;
+  entry.prev_ = nullptr;
+  entry.next_ = nullptr;
+  size_--;
+}
+
+void TimerWheel::advanceTo(uint64_t tick) {
+  while (current_tick_ < tick) {
+    // Ticks which neither expire entries nor cascade an occupied slot are skipped.
+    current_tick_ = std::min(tick, nextTick());
+    cascade();
+    // Entries armed by the expired entries only go into this slot if the wheel emptied and moved on
+    // to now, in which case they expire in a later lap.
+    const uint64_t expired_tick = current_tick_;
+    Slot& slot = slots_[0][expired_tick & SlotMask];
+    while (slot.head_ != nullptr && slot.head_->expiry_tick_ == expired_tick) {
+      Entry& entry = *slot.head_;
+      unlink(entry);
+      entry.onExpired();
+    }
+  }
+}
+
+void TimerWheel::cascade() {
+  // Each level wraps around when the levels below it all have, and is cascaded before them, as its
+  // entries may go into the slots of the levels below which are cascaded in this same tick.
+  uint32_t levels = 1;
+  while (levels < Levels && (current_tick_ & ((uint64_t{1} << shift(levels)) - 1)) == 0) {
+    levels++;
+  }
+  for (uint32_t level = levels - 1; level > 0; level--) {
+    Slot& slot = slots_[level][(current_tick_ >> shift(level)) & SlotMask];
+    Entry* entry = slot.head_;
+    slot.head_ = nullptr;
+    occupied_[level] &= ~(uint64_t{1} << slot.index_);
+    while (entry != nullptr) {
+      Entry* next = entry->next_;
+      size_--;
+      link(*entry);
+      entry = next;
+    }
+  }
+}
+
+uint64_t TimerWheel::nextTick() const {
+  // The next tick which expires the entries of an occupied slot of the lowest level, or cascades
+  // an occupied slot of a level above. Slots are searched from the one after the current slot of
+  // each level; the current slot of a level above the lowest holds entries one lap ahead.
+  uint64_t next = UINT64_MAX;
+  for (uint32_t level = 0; level < Levels; level++) {
+    if (occupied_[level] == 0) {
+      continue;
+    }
+    const uint64_t position = (current_tick_ >> shift(level)) + 1;
+    const uint64_t distance = absl::countr_zero(absl::rotr(occupied_[level], position & SlotMask));
+    next = std::min(next, (position + distance) << shift(level));
+  }
+  return next;
+}
+
+void TimerWheel::armTickTimer(uint64_t tick) {
+  armed_tick_ = tick;
+  const MonotonicTime deadline = start_ + tick * tick_;
+  const MonotonicTime now = time_source_.monotonicTime();
+  tick_timer_->enableTimer(deadline > now
+                               ? std::chrono::ceil<std::chrono::milliseconds>(deadline - now)
+                               : std::chrono::milliseconds(0));
+}
+
+void TimerWheel::onTickTimer() {
+  armed_tick_.reset();
+  advanceTo(tickAt(time_source_.monotonicTime()));
+  if (size_ == 0) {
+    return;
+  }
+  // Entries armed by the expired entries may have armed the timer already, but only for their own
+  // expiry.
+  const uint64_t next_tick = nextTick();
+  if (!armed_tick_.has_value() || next_tick < armed_tick_.value()) {
+    armTickTimer(next_tick);
+  }
+}
+
+WheelTimerImpl::WheelTimerImpl(TimerWheel& wheel, Scheduler& scheduler, TimerCb cb,
+                               Dispatcher& dispatcher)
+    : wheel_(wheel), scheduler_(scheduler), cb_(std::move(cb)), dispatcher_(dispatcher) {
+  ASSERT(cb_);
+}
+
+WheelTimerImpl::~WheelTimerImpl() { wheel_.remove(*this); }
+
+void WheelTimerImpl::disableTimer() {
+  ASSERT(dispatcher_.isThreadSafe());
+  wheel_.remove(*this);
+  if (scheduler_timer_ != nullptr) {
+    scheduler_timer_->disableTimer();
+  }
+}
+
+void WheelTimerImpl::enableTimer(std::chrono::milliseconds d, const ScopeTrackedObject* object) {
+  ASSERT(dispatcher_.isThreadSafe());
+  if (d < wheel_.minDuration()) {
+    wheel_.remove(*this);
+    schedulerTimer().enableTimer(d, object);
+    return;
+  }
+  if (scheduler_timer_ != nullptr) {
+    scheduler_timer_->disableTimer();
+  }
+  object_ = object;
+  wheel_.add(*this, d);
+}
+
+void WheelTimerImpl::enableHRTimer(std::chrono::microseconds us,
+                                   const ScopeTrackedObject* object) {
+  ASSERT(dispatcher_.isThreadSafe());
+  // High resolution timers need the precision of the scheduler's timers.
+  wheel_.remove(*this);
+  schedulerTimer().enableHRTimer(us, object);
+}
+
+bool WheelTimerImpl::enabled() {
+  ASSERT(dispatcher_.isThreadSafe());
+  return armed() || (scheduler_timer_ != nullptr && scheduler_timer_->enabled());
+}
+
+void WheelTimerImpl::onExpired() {
+  if (object_ == nullptr) {
+    cb_();
+    return;
+  }
+  ScopeTrackerScopeState scope(object_, dispatcher_);
+  object_ = nullptr;
+  cb_();
+}
+
+Timer& WheelTimerImpl::schedulerTimer() {
+  if (scheduler_timer_ == nullptr) {
+    scheduler_timer_ = scheduler_.createTimer(cb_, dispatcher_);
+  }
+  return *scheduler_timer_;
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/scope_tracker.h"
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * A hierarchical timing wheel, for timers which may fire up to a tick late: timeouts of a second or
+ * more, like idle, stream and per-try timeouts, which are armed and disarmed far more often than
+ * they fire. Arming and disarming a timer in the wheel is O(1), where it is O(log n) in libevent's
+ * min-heap.
+ *
+ * Time is divided into ticks. The wheel has Levels levels of Slots slots, the slots of each level
+ * being Slots times as long as those of the level below. A timer goes into the lowest level whose
+ * range covers its expiry. Every time the lowest level wraps around, the next slot of the level
+ * above is cascaded into the levels below it, and so on up. Timers beyond the range of the wheel
+ * are parked in its top level, and placed again when their slot is cascaded.
+ *
+ * The wheel runs on one timer of the underlying scheduler, armed for the next tick which may expire
+ * timers or cascade a slot.
+ */
+class TimerWheel {
+private:
+  struct Slot;
+
+public:
+  static constexpr uint32_t SlotBits = 6;
+  static constexpr uint32_t Slots = 1 << SlotBits;
+  static constexpr uint32_t Levels = 4;
+
+  /**
+   * A timer in the wheel.
+   */
+  class Entry {
+  public:
+    virtual ~Entry() = default;
+
+    /**
+     * @return whether the entry is armed in a wheel.
+     */
+    bool armed() const { return slot_ != nullptr; }
+
+  protected:
+    /**
+     * Called when the entry expires, after it has been removed from the wheel.
+     */
+    virtual void onExpired() PURE;
+
+  private:
+    friend class TimerWheel;
+
+    Entry* prev_{};
+    Entry* next_{};
+    Slot* slot_{};
+    uint64_t expiry_tick_{};
+  };
+
+  /**
+   * @param scheduler supplies the scheduler whose timer drives the wheel.
+   * @param dispatcher supplies the dispatcher which runs the wheel.
+   * @param time_source supplies the time source.
+   * @param tick supplies the duration of a tick, the most a timer may fire late.
+   * @param min_duration supplies the shortest duration for which timers go into the wheel.
+   */
+  TimerWheel(Scheduler& scheduler, Dispatcher& dispatcher, TimeSource& time_source,
+             std::chrono::milliseconds tick, std::chrono::milliseconds min_duration);
+  ~TimerWheel();
+
+  /**
+   * Arms an entry to expire after a duration, or re-arms it if it is already armed.
+   */
+  void add(Entry& entry, std::chrono::milliseconds duration);
+
+  /**
+   * Disarms an entry, if it is armed.
+   */
+  void remove(Entry& entry);
+
+  /**
+   * @return the shortest duration for which timers go into the wheel.
+   */
+  std::chrono::milliseconds minDuration() const { return min_duration_; }
+
+  /**
+   * @return the number of armed entries.
+   */
+  uint64_t size() const { return size_; }
+
+private:
+  struct Slot {
+    Entry* head_{};
+    uint32_t level_{};
+    uint32_t index_{};
+  };
+
+  uint64_t tickAt(MonotonicTime time) const { return (time - start_) / tick_; }
+  Slot& slotFor(uint64_t expiry_tick);
+  void link(Entry& entry);
+  void unlink(Entry& entry);
+  void advanceTo(uint64_t tick);
+  void cascade();
+  uint64_t nextTick() const;
+  void armTickTimer(uint64_t tick);
+  void onTickTimer();
+
+  TimeSource& time_source_;
+  const std::chrono::milliseconds tick_;
+  const std::chrono::milliseconds min_duration_;
+  const MonotonicTime start_;
+  const TimerPtr tick_timer_;
+  std::array<std::array<Slot, Slots>, Levels> slots_;
+  // A bit per slot of each level, set when the slot has entries.
+  std::array<uint64_t, Levels> occupied_{};
+  // The last tick the wheel has expired the timers of.
+  uint64_t current_tick_{};
+  // The tick the tick timer is armed for.
+  absl::optional<uint64_t> armed_tick_;
+  uint64_t size_{};
+};
+
+/**
+ * A timer which is armed in a TimerWheel when enabled for at least the wheel's minimum duration,
+ * and in a timer of the underlying scheduler, created on first use, otherwise.
+ */
+class WheelTimerImpl : public Timer, TimerWheel::Entry {
+public:
+  WheelTimerImpl(TimerWheel& wheel, Scheduler& scheduler, TimerCb cb, Dispatcher& dispatcher);
+  ~WheelTimerImpl() override;
+
+  // Timer
+  void disableTimer() override;
+  void enableTimer(std::chrono::milliseconds d, const ScopeTrackedObject* object) override;
+  void enableHRTimer(std::chrono::microseconds us, const ScopeTrackedObject* object) override;
+  bool enabled() override;
+
+private:
+  // TimerWheel::Entry
+  void onExpired() override;
+
+  Timer& schedulerTimer();
+
+  TimerWheel& wheel_;
+  Scheduler& scheduler_;
+  TimerCb cb_;
+  Dispatcher& dispatcher_;
+  const ScopeTrackedObject* object_{};
+  TimerPtr scheduler_timer_;
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -272,6 +272,11 @@ public:
     return str_;
   }
 
+  /**
+   * @return the string literal.
+   */
+  const std::string& value() const { return str_.string_value(); }
+
 private:
   ProtobufWkt::Value str_;
 };
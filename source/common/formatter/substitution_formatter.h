@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <bitset>
+#include <cmath>
 #include <functional>
+#include <iterator>
 #include <list>
 #include <string>
 #include <vector>
@@ -15,8 +18,11 @@
 #include "source/common/formatter/http_specific_formatter.h"
 #include "source/common/formatter/stream_info_formatter.h"
 #include "source/common/json/json_loader.h"
+#include "source/common/json/json_sanitizer.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -142,31 +148,59 @@ public:
       : empty_value_string_(omit_empty_values ? absl::string_view{}
                                               : DefaultUnspecifiedValueStringView) {
     providers_ = SubstitutionFormatParser::parse<FormatterContext>(format);
+    compile();
   }
   CommonFormatterBaseImpl(const std::string& format, bool omit_empty_values,
                           const CommandParsers& command_parsers)
       : empty_value_string_(omit_empty_values ? absl::string_view{}
                                               : DefaultUnspecifiedValueStringView) {
     providers_ = SubstitutionFormatParser::parse<FormatterContext>(format, command_parsers);
+    compile();
   }
 
   // FormatterBase
   std::string formatWithContext(const FormatterContext& context,
                                 const StreamInfo::StreamInfo& stream_info) const override {
-    std::string log_line;
-    log_line.reserve(256);
+    // The values of the providers are gathered first, so that the line is built in a single
+    // allocation of its exact size. Literals are copied straight from the format.
+    absl::InlinedVector<absl::optional<std::string>, 16> values(providers_.size());
+    size_t size = literals_size_;
+    for (size_t i = 0; i < providers_.size(); ++i) {
+      if (literals_[i] == nullptr) {
+        values[i] = providers_[i]->formatWithContext(context, stream_info);
+        size += values[i].has_value() ? values[i]->size() : empty_value_string_.size();
+      }
+    }
 
-    for (const auto& provider : providers_) {
-      const auto bit = provider->formatWithContext(context, stream_info);
-      log_line += bit.value_or(empty_value_string_);
+    std::string log_line;
+    log_line.reserve(size);
+    for (size_t i = 0; i < providers_.size(); ++i) {
+      if (literals_[i] != nullptr) {
+        log_line += *literals_[i];
+      } else {
+        log_line += values[i].has_value() ? *values[i] : empty_value_string_;
+      }
     }
 
     return log_line;
   }
 
 private:
+  void compile() {
+    literals_.reserve(providers_.size());
+    for (const auto& provider : providers_) {
+      const auto* literal =
+          dynamic_cast<const CommonPlainStringFormatterBase<FormatterContext>*>(provider.get());
+      literals_.push_back(literal != nullptr ? &literal->value() : nullptr);
+      literals_size_ += literal != nullptr ? literal->value().size() : 0;
+    }
+  }
+
   const std::string empty_value_string_;
   std::vector<FormatterProviderBasePtr<FormatterContext>> providers_;
+  // For each provider, its string if it is a literal, or nullptr.
+  std::vector<const std::string*> literals_;
+  size_t literals_size_{0};
 };
 
 template <class FormatterContext>
@@ -212,6 +246,18 @@ public:
     return structFormatMapCallback(struct_output_format_, visitor).struct_value();
   }
 
+  /**
+   * Appends the log entry to out as JSON, as if formatWithContext() were serialized, but without
+   * building the Struct. Keys of the format are written in sorted order.
+   * @param sort_properties whether to also sort the keys of structs returned by typed values.
+   */
+  void formatJsonWithContext(const FormatterContext& context, const StreamInfo::StreamInfo& info,
+                             bool sort_properties, std::string& out) const {
+    if (!writeJsonMap(struct_output_format_, context, info, sort_properties, out)) {
+      out += "{}";
+    }
+  }
+
 private:
   struct StructFormatMapWrapper;
   struct StructFormatListWrapper;
@@ -371,6 +417,170 @@ private:
     return ValueUtil::listValue(output);
   }
 
+  // Methods for formatting straight to JSON. Each mirrors the callback above building the same
+  // part of the Struct, and returns false, having written nothing, where the callback would
+  // return a null value which is omitted.
+  bool writeJsonValue(const StructFormatValue& format_value, const FormatterContext& context,
+                      const StreamInfo::StreamInfo& info, bool sort_properties,
+                      std::string& out) const {
+    if (const auto* providers = absl::get_if<0>(&format_value)) {
+      return writeJsonProviders(*providers, context, info, sort_properties, out);
+    }
+    if (const auto* format_map = absl::get_if<1>(&format_value)) {
+      return writeJsonMap(*format_map, context, info, sort_properties, out);
+    }
+    writeJsonList(absl::get<2>(format_value), context, info, sort_properties, out);
+    return true;
+  }
+  bool writeJsonProviders(const std::vector<FormatterProviderBasePtr<FormatterContext>>& providers,
+                          const FormatterContext& context, const StreamInfo::StreamInfo& info,
+                          bool sort_properties, std::string& out) const {
+    ASSERT(!providers.empty());
+    if (providers.size() == 1) {
+      const auto& provider = providers.front();
+      if (preserve_types_) {
+        const ProtobufWkt::Value value = provider->formatValueWithContext(context, info);
+        if (omit_empty_values_ && value.kind_case() == ProtobufWkt::Value::kNullValue) {
+          return false;
+        }
+        writeJsonProtoValue(value, sort_properties, out);
+        return true;
+      }
+
+      const auto str = provider->formatWithContext(context, info);
+      if (omit_empty_values_ && !str.has_value()) {
+        return false;
+      }
+      writeJsonString(str.has_value() ? *str : empty_value_, out);
+      return true;
+    }
+    // Multiple providers forces string output.
+    std::string str;
+    for (const auto& provider : providers) {
+      const auto bit = provider->formatWithContext(context, info);
+      str += bit.value_or(empty_value_);
+    }
+    writeJsonString(str, out);
+    return true;
+  }
+  bool writeJsonMap(const StructFormatterBase::StructFormatMapWrapper& format_map,
+                    const FormatterContext& context, const StreamInfo::StreamInfo& info,
+                    bool sort_properties, std::string& out) const {
+    const size_t start = out.size();
+    bool empty = true;
+    out += '{';
+    for (const auto& pair : *format_map.value_) {
+      const size_t entry_start = out.size();
+      if (!empty) {
+        out += ',';
+      }
+      writeJsonString(pair.first, out);
+      out += ':';
+      if (!writeJsonValue(pair.second, context, info, sort_properties, out)) {
+        out.resize(entry_start);
+        continue;
+      }
+      empty = false;
+    }
+    if (omit_empty_values_ && empty) {
+      out.resize(start);
+      return false;
+    }
+    out += '}';
+    return true;
+  }
+  void writeJsonList(const StructFormatterBase::StructFormatListWrapper& format_list,
+                     const FormatterContext& context, const StreamInfo::StreamInfo& info,
+                     bool sort_properties, std::string& out) const {
+    bool empty = true;
+    out += '[';
+    for (const auto& val : *format_list.value_) {
+      const size_t entry_start = out.size();
+      if (!empty) {
+        out += ',';
+      }
+      if (!writeJsonValue(val, context, info, sort_properties, out)) {
+        out.resize(entry_start);
+        continue;
+      }
+      empty = false;
+    }
+    out += ']';
+  }
+  // Access logs are formatted on worker threads, so strings are escaped with
+  // Json::sanitizeUtf8(), which never throws, rather than Json::sanitize().
+  static void writeJsonString(absl::string_view str, std::string& out) {
+    out += '"';
+    if (Json::firstCharToSanitize(str) == str.size()) {
+      out.append(str.data(), str.size());
+    } else {
+      const size_t start = out.size();
+      out.resize(start + str.size() * Json::MaxEscapedCharSize);
+      out.resize(Json::sanitizeUtf8(str, out.data() + start) - out.data());
+    }
+    out += '"';
+  }
+  static void writeJsonProtoValue(const ProtobufWkt::Value& value, bool sort_properties,
+                                  std::string& out) {
+    switch (value.kind_case()) {
+    case ProtobufWkt::Value::kNumberValue:
+      // Integral values are written without a fraction, as the protobuf JSON printer does.
+      if (std::isfinite(value.number_value())) {
+        fmt::format_to(std::back_inserter(out), "{}", value.number_value());
+      } else {
+        out += "null";
+      }
+      return;
+    case ProtobufWkt::Value::kStringValue:
+      writeJsonString(value.string_value(), out);
+      return;
+    case ProtobufWkt::Value::kBoolValue:
+      out += value.bool_value() ? "true" : "false";
+      return;
+    case ProtobufWkt::Value::kStructValue: {
+      const auto& fields = value.struct_value().fields();
+      using Entry = std::remove_reference_t<decltype(*fields.begin())>;
+      std::vector<const Entry*> entries;
+      entries.reserve(fields.size());
+      for (const auto& field : fields) {
+        entries.push_back(&field);
+      }
+      if (sort_properties) {
+        std::sort(entries.begin(), entries.end(),
+                  [](const auto* a, const auto* b) { return a->first < b->first; });
+      }
+      out += '{';
+      for (size_t i = 0; i < entries.size(); ++i) {
+        if (i > 0) {
+          out += ',';
+        }
+        writeJsonString(entries[i]->first, out);
+        out += ':';
+        writeJsonProtoValue(entries[i]->second, sort_properties, out);
+      }
+      out += '}';
+      return;
+    }
+    case ProtobufWkt::Value::kListValue: {
+      out += '[';
+      bool first = true;
+      for (const auto& element : value.list_value().values()) {
+        if (!first) {
+          out += ',';
+        }
+        first = false;
+        writeJsonProtoValue(element, sort_properties, out);
+      }
+      out += ']';
+      return;
+    }
+    case ProtobufWkt::Value::kNullValue:
+    case ProtobufWkt::Value::KIND_NOT_SET:
+      out += "null";
+      return;
+    }
+  }
+
   const bool omit_empty_values_;
   const bool preserve_types_;
   const std::string empty_value_;
@@ -390,11 +600,21 @@ public:
                               bool omit_empty_values, bool sort_properties,
                               const CommandParsers& commands = {})
       : struct_formatter_(format_mapping, preserve_types, omit_empty_values, commands),
-        sort_properties_(sort_properties) {}
+        sort_properties_(sort_properties),
+        write_json_directly_(Runtime::runtimeFeatureEnabled(
+            "envoy.reloadable_features.logging_with_fast_json_formatter")) {}
 
   // FormatterBase
   std::string formatWithContext(const FormatterContext& context,
                                 const StreamInfo::StreamInfo& info) const override {
+    if (write_json_directly_) {
+      std::string log_line;
+      log_line.reserve(256);
+      struct_formatter_.formatJsonWithContext(context, info, sort_properties_, log_line);
+      log_line += '\n';
+      return log_line;
+    }
+
     const ProtobufWkt::Struct output_struct = struct_formatter_.formatWithContext(context, info);
 
     std::string log_line = "";
@@ -414,6 +634,9 @@ public:
 private:
   const StructFormatterBase<FormatterContext> struct_formatter_;
   const bool sort_properties_;
+  // Whether to write the JSON as the Struct is formatted, rather than building the Struct and
+  // then serializing it.
+  const bool write_json_directly_;
 };
 
 template <class FormatterContext>
@@ -0,0 +1,189 @@
+#include "source/common/http/character_set_validation.h"
+
+#include "source/common/common/assert.h"
+
+#include "absl/numeric/bits.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define ENVOY_CHARACTER_SCAN_X86 1
+#endif
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+using ScanFunction = size_t (*)(const CharacterSet& set, const char* data, size_t size);
+
+size_t findScalar(const CharacterSet& set, const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (!set.contains(data[i])) {
+      return i;
+    }
+  }
+  return size;
+}
+
+#ifdef ENVOY_CHARACTER_SCAN_X86
+
+// Each kernel tests a block of characters at once. For each character, the low nibble selects an
+// entry of the set's lookup table for its half of the character range, and the high nibble (mod 8)
+// selects the bit of that entry which says whether the character is in the set. Both lookups are a
+// single byte shuffle, so a block costs a fixed handful of instructions whatever the set.
+//
+// Strings which are not a whole number of blocks are finished with one last block that ends at the
+// end of the string and overlaps characters already known to be in the set, so that no character
+// is read outside of the string.
+
+__attribute__((target("sse4.2"))) inline uint32_t notInSetMaskSse42(__m128i block,
+                                                                    __m128i ascii_entries,
+                                                                    __m128i extended_entries,
+                                                                    __m128i bits) {
+  const __m128i low_nibble_mask = _mm_set1_epi8(0x0f);
+  const __m128i low_nibbles = _mm_and_si128(block, low_nibble_mask);
+  const __m128i high_nibbles = _mm_and_si128(_mm_srli_epi16(block, 4), low_nibble_mask);
+  // The top bit of each character picks the extended entry.
+  const __m128i entries = _mm_blendv_epi8(_mm_shuffle_epi8(ascii_entries, low_nibbles),
+                                          _mm_shuffle_epi8(extended_entries, low_nibbles), block);
+  const __m128i in_set = _mm_and_si128(entries, _mm_shuffle_epi8(bits, high_nibbles));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(in_set, _mm_setzero_si128()));
+}
+
+__attribute__((target("sse4.2"))) size_t findSse42(const CharacterSet& set, const char* data,
+                                                   size_t size) {
+  if (size < 16) {
+    return findScalar(set, data, size);
+  }
+  const __m128i ascii_entries =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.asciiByLowNibble().data()));
+  const __m128i extended_entries =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.extendedByLowNibble().data()));
+  const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+  size_t offset = 0;
+  for (;;) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+    const uint32_t mask = notInSetMaskSse42(block, ascii_entries, extended_entries, bits);
+    if (mask != 0) {
+      return offset + absl::countr_zero(mask);
+    }
+    if (offset + 16 == size) {
+      return size;
+    }
+    offset = offset + 32 <= size ? offset + 16 : size - 16;
+  }
+}
+
+__attribute__((target("avx2"))) inline uint32_t notInSetMaskAvx2(__m256i block,
+                                                                 __m256i ascii_entries,
+                                                                 __m256i extended_entries,
+                                                                 __m256i bits) {
+  const __m256i low_nibble_mask = _mm256_set1_epi8(0x0f);
+  const __m256i low_nibbles = _mm256_and_si256(block, low_nibble_mask);
+  const __m256i high_nibbles = _mm256_and_si256(_mm256_srli_epi16(block, 4), low_nibble_mask);
+  const __m256i entries =
+      _mm256_blendv_epi8(_mm256_shuffle_epi8(ascii_entries, low_nibbles),
+                         _mm256_shuffle_epi8(extended_entries, low_nibbles), block);
+  const __m256i in_set = _mm256_and_si256(entries, _mm256_shuffle_epi8(bits, high_nibbles));
+  return _mm256_movemask_epi8(_mm256_cmpeq_epi8(in_set, _mm256_setzero_si256()));
+}
+
+__attribute__((target("avx2"))) size_t findAvx2(const CharacterSet& set, const char* data,
+                                                size_t size) {
+  if (size < 32) {
+    return findSse42(set, data, size);
+  }
+  // Byte shuffles work within each 128 bit lane, so both lanes get a copy of each table.
+  const __m256i ascii_entries = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.asciiByLowNibble().data())));
+  const __m256i extended_entries = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.extendedByLowNibble().data())));
+  const __m256i bits = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+
+  size_t offset = 0;
+  for (;;) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+    const uint32_t mask = notInSetMaskAvx2(block, ascii_entries, extended_entries, bits);
+    if (mask != 0) {
+      return offset + absl::countr_zero(mask);
+    }
+    if (offset + 32 == size) {
+      return size;
+    }
+    offset = offset + 64 <= size ? offset + 32 : size - 32;
+  }
+}
+
+#endif
+
+ScanFunction scanFunction(CharacterScanKernel kernel) {
+  switch (kernel) {
+  case CharacterScanKernel::Scalar:
+    return findScalar;
+#ifdef ENVOY_CHARACTER_SCAN_X86
+  case CharacterScanKernel::Sse42:
+    return findSse42;
+  case CharacterScanKernel::Avx2:
+    return findAvx2;
+#else
+  case CharacterScanKernel::Sse42:
+  case CharacterScanKernel::Avx2:
+    break;
+#endif
+  }
+  PANIC("unsupported character scan kernel");
+}
+
+} // namespace
+
+bool characterScanKernelSupported(CharacterScanKernel kernel) {
+  switch (kernel) {
+  case CharacterScanKernel::Scalar:
+    return true;
+#ifdef ENVOY_CHARACTER_SCAN_X86
+  case CharacterScanKernel::Sse42:
+    return __builtin_cpu_supports("sse4.2");
+  case CharacterScanKernel::Avx2:
+    return __builtin_cpu_supports("avx2");
+#else
+  case CharacterScanKernel::Sse42:
+  case CharacterScanKernel::Avx2:
+    return false;
+#endif
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+CharacterScanKernel selectedCharacterScanKernel() {
+  static const CharacterScanKernel kernel = []() {
+    if (characterScanKernelSupported(CharacterScanKernel::Avx2)) {
+      return CharacterScanKernel::Avx2;
+    }
+    if (characterScanKernelSupported(CharacterScanKernel::Sse42)) {
+      return CharacterScanKernel::Sse42;
+    }
+    return CharacterScanKernel::Scalar;
+  }();
+  return kernel;
+}
+
+size_t findFirstCharNotInSet(const CharacterSet& set, absl::string_view value) {
+  // Most header names and many values are shorter than a block, for which the scalar loop is as
+  // fast as any kernel and avoids the indirect call.
+  if (value.size() < 16) {
+    return findScalar(set, value.data(), value.size());
+  }
+  static const ScanFunction scan = scanFunction(selectedCharacterScanKernel());
+  return scan(set, value.data(), value.size());
+}
+
+size_t findFirstCharNotInSet(CharacterScanKernel kernel, const CharacterSet& set,
+                             absl::string_view value) {
+  ASSERT(characterScanKernelSupported(kernel));
+  return scanFunction(kernel)(set, value.data(), value.size());
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
+#include "absl/strings/string_view.h"
+
 // A set of tables for validating that a character is in a specific
 // character set. Used to validate RFC compliance for various HTTP protocol elements.
 
@@ -72,5 +75,78 @@ inline constexpr std::array<uint32_t, 8> kUriQueryAndFragmentCharTable = {
     0b00000000000000000000000000000000,
 };
 
+/**
+ * A character set built from a table in the format used by testCharInTable, together with the
+ * lookup tables used to test 16 or 32 characters at a time in findFirstCharNotInSet. Instances
+ * are meant to be constexpr, so that building the lookup tables costs nothing at runtime.
+ */
+class CharacterSet {
+public:
+  constexpr explicit CharacterSet(const std::array<uint32_t, 8>& table) : table_(table) {
+    for (uint32_t c = 0; c < 256; ++c) {
+      if (testCharInTable(table, static_cast<char>(c))) {
+        // Bit (c >> 4) % 8 of the entry for the low nibble of c, in the table for its half of the
+        // character range.
+        uint8_t& entry = c < 128 ? ascii_by_low_nibble_[c & 0xf] : extended_by_low_nibble_[c & 0xf];
+        entry |= 1 << ((c >> 4) & 0x7);
+      }
+    }
+  }
+
+  constexpr bool contains(char c) const { return testCharInTable(table_, c); }
+  const std::array<uint32_t, 8>& table() const { return table_; }
+
+  // For each low nibble, a bit per high nibble in 0-7 (ascii) or 8-15 (extended) which is set
+  // if the character made of the two nibbles is in the set.
+  const std::array<uint8_t, 16>& asciiByLowNibble() const { return ascii_by_low_nibble_; }
+  const std::array<uint8_t, 16>& extendedByLowNibble() const { return extended_by_low_nibble_; }
+
+private:
+  std::array<uint32_t, 8> table_;
+  std::array<uint8_t, 16> ascii_by_low_nibble_{};
+  std::array<uint8_t, 16> extended_by_low_nibble_{};
+};
+
+inline constexpr CharacterSet kGenericHeaderNameCharSet{kGenericHeaderNameCharTable};
+inline constexpr CharacterSet kUriQueryAndFragmentCharSet{kUriQueryAndFragmentCharTable};
+
+/**
+ * The implementations of findFirstCharNotInSet. Scalar tests one character at a time with
+ * testCharInTable; the others need the named x86 instruction set extensions.
+ */
+enum class CharacterScanKernel { Scalar, Sse42, Avx2 };
+
+/**
+ * @return the fastest kernel supported by the CPU, which findFirstCharNotInSet uses.
+ */
+CharacterScanKernel selectedCharacterScanKernel();
+
+/**
+ * @return whether the CPU and the build support the kernel.
+ */
+bool characterScanKernelSupported(CharacterScanKernel kernel);
+
+/**
+ * @param set the characters to accept.
+ * @param value the string to scan.
+ * @return the offset of the first character of value which is not in set, or value.size() if
+ *         all of them are.
+ */
+size_t findFirstCharNotInSet(const CharacterSet& set, absl::string_view value);
+
+/**
+ * As findFirstCharNotInSet, but always using the given kernel, which must be supported. Intended
+ * for tests and benchmarks.
+ */
+size_t findFirstCharNotInSet(CharacterScanKernel kernel, const CharacterSet& set,
+                             absl::string_view value);
+
+/**
+ * @return whether every character of value is in set.
+ */
+inline bool allCharsInSet(const CharacterSet& set, absl::string_view value) {
+  return findFirstCharNotInSet(set, value) == value.size();
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -5,6 +5,7 @@
 #include <cstdint>
 
 #include "source/common/common/assert.h"
+#include "source/common/http/character_set_validation.h"
 #include "source/common/http/headers.h"
 
 #include "absl/strings/ascii.h"
@@ -27,10 +28,24 @@ constexpr absl::string_view kHttpVersionPrefix = "HTTP/";
 // Allowed characters for field names according to Section 5.1
 // and for methods according to Section 9.1 of RFC 9110:
 // https://www.rfc-editor.org/rfc/rfc9110.html
-constexpr absl::string_view kValidCharacters =
-    "!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~";
-constexpr absl::string_view::iterator kValidCharactersBegin = kValidCharacters.begin();
-constexpr absl::string_view::iterator kValidCharactersEnd = kValidCharacters.end();
+// Both are tokens, the characters of which are in kGenericHeaderNameCharSet.
+
+// Characters allowed in the path and query of a URL by http-parser: HTAB, FF and VCHAR.
+constexpr CharacterSet kPathQueryCharSet{{
+    // control characters
+    0b00000000010010000000000000000000,
+    // !"#$%&'()*+,-./0123456789:;<=>?
+    0b01111111111111111111111111111111,
+    //@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\]^_
+    0b11111111111111111111111111111111,
+    //`abcdefghijklmnopqrstuvwxyz{|}~
+    0b11111111111111111111111111111110,
+    // extended ascii
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+}};
 
 bool isFirstCharacterOfValidMethod(char c) {
   static constexpr char kValidFirstCharacters[] = {'A', 'B', 'C', 'D', 'G', 'H', 'L', 'M',
@@ -45,10 +60,7 @@ bool isFirstCharacterOfValidMethod(char c) {
 // enabled.
 bool isMethodValid(absl::string_view method, bool allow_custom_methods) {
   if (allow_custom_methods) {
-    return !method.empty() &&
-           std::all_of(method.begin(), method.end(), [](absl::string_view::value_type c) {
-             return std::binary_search(kValidCharactersBegin, kValidCharactersEnd, c);
-           });
+    return !method.empty() && allCharsInSet(kGenericHeaderNameCharSet, method);
   }
 
   static constexpr absl::string_view kValidMethods[] = {
@@ -69,15 +81,9 @@ bool isUrlValid(absl::string_view url, bool is_connect) {
     return false;
   }
 
-  // Same set of characters are allowed for path and query.
-  const auto is_valid_path_query_char = [](char c) {
-    return c == 9 || c == 12 || ('!' <= c && c <= 126);
-  };
-
   // The URL may start with a path.
-  if (auto it = url.begin(); *it == '/' || *it == '*') {
-    ++it;
-    return std::all_of(it, url.end(), is_valid_path_query_char);
+  if (url[0] == '/' || url[0] == '*') {
+    return allCharsInSet(kPathQueryCharSet, url.substr(1));
   }
 
   // If method is not CONNECT, parse scheme.
@@ -118,7 +124,7 @@ bool isUrlValid(absl::string_view url, bool is_connect) {
   // Match http-parser's quirk of allowing any number of '@' characters in host
   // as long as they are not consecutive.
   return std::all_of(host.begin(), host.end(), valid_host_char) && !absl::StrContains(host, "@@") &&
-         std::all_of(path_query.begin(), path_query.end(), is_valid_path_query_char);
+         allCharsInSet(kPathQueryCharSet, path_query);
 }
 
 // Returns true if `version_input` is a valid HTTP version string as defined at
@@ -139,9 +145,7 @@ bool isVersionValid(absl::string_view version_input) {
 }
 
 bool isHeaderNameValid(absl::string_view name) {
-  return std::all_of(name.begin(), name.end(), [](absl::string_view::value_type c) {
-    return std::binary_search(kValidCharactersBegin, kValidCharactersEnd, c);
-  });
+  return allCharsInSet(kGenericHeaderNameCharSet, name);
 }
 
 } // anonymous namespace
@@ -4,8 +4,17 @@
 #include "source/common/common/thread.h"
 #include "source/common/json/json_internal.h"
 
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_format.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ENVOY_JSON_SANITIZER_SSE2 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define ENVOY_JSON_SANITIZER_NEON 1
+#endif
+
 namespace Envoy {
 namespace Json {
 
@@ -47,31 +56,243 @@ static constexpr uint32_t needs_slow_sanitizer[256] = {
 // SPELLCHECKER(on)
 // clang-format on
 
+namespace {
+
+// The number of characters scanned at once by the SIMD kernels.
+constexpr size_t BlockSize = 16;
+
+#if defined(ENVOY_JSON_SANITIZER_SSE2)
+
+// @return a mask with a bit set for each character of the block in needs_slow_sanitizer.
+inline uint32_t needsSlowSanitizerMask(const char* block) {
+  const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+  // The comparison is signed, so characters >= 0x80 are negative and below space too.
+  const __m128i control_or_high = _mm_cmplt_epi8(chars, _mm_set1_epi8(' '));
+  const __m128i quote = _mm_cmpeq_epi8(chars, _mm_set1_epi8('"'));
+  const __m128i backslash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('\\'));
+  const __m128i del = _mm_cmpeq_epi8(chars, _mm_set1_epi8('\177'));
+  return _mm_movemask_epi8(
+      _mm_or_si128(_mm_or_si128(control_or_high, quote), _mm_or_si128(backslash, del)));
+}
+
+#elif defined(ENVOY_JSON_SANITIZER_NEON)
+
+// @return a mask with four bits set for each character of the block in needs_slow_sanitizer.
+inline uint64_t needsSlowSanitizerMask(const char* block) {
+  const uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8_t*>(block));
+  const uint8x16_t control = vcltq_u8(chars, vdupq_n_u8(' '));
+  const uint8x16_t del_or_high = vcgeq_u8(chars, vdupq_n_u8(0x7f));
+  const uint8x16_t quote = vceqq_u8(chars, vdupq_n_u8('"'));
+  const uint8x16_t backslash = vceqq_u8(chars, vdupq_n_u8('\\'));
+  const uint8x16_t matches =
+      vorrq_u8(vorrq_u8(control, del_or_high), vorrq_u8(quote, backslash));
+  // Narrowing each 16 bit lane by 4 bits leaves a nibble per character.
+  return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+}
+
+#endif
+
+size_t firstCharToSanitize(const char* data, size_t size) {
+  size_t pos = 0;
+#if defined(ENVOY_JSON_SANITIZER_SSE2)
+  for (; pos + BlockSize <= size; pos += BlockSize) {
+    const uint32_t mask = needsSlowSanitizerMask(data + pos);
+    if (mask != 0) {
+      return pos + absl::countr_zero(mask);
+    }
+  }
+#elif defined(ENVOY_JSON_SANITIZER_NEON)
+  for (; pos + BlockSize <= size; pos += BlockSize) {
+    const uint64_t mask = needsSlowSanitizerMask(data + pos);
+    if (mask != 0) {
+      return pos + absl::countr_zero(mask) / 4;
+    }
+  }
+#endif
+  for (; pos < size; ++pos) {
+    if (needs_slow_sanitizer[static_cast<uint8_t>(data[pos])]) {
+      return pos;
+    }
+  }
+  return size;
+}
+
+} // namespace
+
+size_t firstCharToSanitize(absl::string_view str) {
+  static_assert(ARRAY_SIZE(needs_slow_sanitizer) == 256);
+  return firstCharToSanitize(str.data(), str.size());
+}
+
+namespace {
+
+// Writes the escape of a 7-bit ASCII character at which firstCharToSanitize() stops. The escapes
+// match what the Nlohmann serializer produces.
+inline char* escapeAscii(uint8_t c, char* out) {
+  static constexpr char HexDigits[] = "0123456789abcdef";
+  switch (c) {
+  case '"':
+  case '\\':
+    *out++ = '\\';
+    *out++ = c;
+    break;
+  case '\b':
+    *out++ = '\\';
+    *out++ = 'b';
+    break;
+  case '\f':
+    *out++ = '\\';
+    *out++ = 'f';
+    break;
+  case '\n':
+    *out++ = '\\';
+    *out++ = 'n';
+    break;
+  case '\r':
+    *out++ = '\\';
+    *out++ = 'r';
+    break;
+  case '\t':
+    *out++ = '\\';
+    *out++ = 't';
+    break;
+  case 0x7f:
+    *out++ = c;
+    break;
+  default:
+    *out++ = '\\';
+    *out++ = 'u';
+    *out++ = '0';
+    *out++ = '0';
+    *out++ = HexDigits[c >> 4];
+    *out++ = HexDigits[c & 0xf];
+    break;
+  }
+  return out;
+}
+
+// @return the size of the valid utf-8 sequence starting at data, or 0 if it does not start with
+//   one. As for the Nlohmann serializer, overlong encodings, surrogates and code points beyond
+//   U+10FFFF are invalid.
+size_t utf8SequenceSize(const uint8_t* data, size_t size) {
+  const uint8_t lead = data[0];
+  size_t sequence_size;
+  // The range of the second byte, which is narrower than that of a plain continuation byte after
+  // the lead bytes which could otherwise start an invalid sequence.
+  uint8_t second_min = 0x80;
+  uint8_t second_max = 0xbf;
+  if (lead >= 0xc2 && lead <= 0xdf) {
+    sequence_size = 2;
+  } else if (lead >= 0xe0 && lead <= 0xef) {
+    sequence_size = 3;
+    if (lead == 0xe0) {
+      second_min = 0xa0;
+    } else if (lead == 0xed) {
+      second_max = 0x9f;
+    }
+  } else if (lead >= 0xf0 && lead <= 0xf4) {
+    sequence_size = 4;
+    if (lead == 0xf0) {
+      second_min = 0x90;
+    } else if (lead == 0xf4) {
+      second_max = 0x8f;
+    }
+  } else {
+    return 0;
+  }
+  if (size < sequence_size || data[1] < second_min || data[1] > second_max) {
+    return 0;
+  }
+  for (size_t i = 2; i < sequence_size; ++i) {
+    if ((data[i] & 0xc0) != 0x80) {
+      return 0;
+    }
+  }
+  return sequence_size;
+}
+
+} // namespace
+
+char* sanitizeAscii(absl::string_view str, char* out) {
+  const char* data = str.data();
+  const char* const end = data + str.size();
+  while (data < end) {
+    // Copy the run of characters needing no escape, then escape the one ending it.
+    const size_t run = firstCharToSanitize(data, end - data);
+    memcpy(out, data, run); // NOLINT(safe-memcpy)
+    out += run;
+    data += run;
+    if (data == end) {
+      break;
+    }
+    const uint8_t c = static_cast<uint8_t>(*data++);
+    if (c >= 0x80) {
+      return nullptr;
+    }
+    out = escapeAscii(c, out);
+  }
+  return out;
+}
+
+char* sanitizeUtf8(absl::string_view str, char* out) {
+  const char* data = str.data();
+  const char* const end = data + str.size();
+  while (data < end) {
+    const size_t run = firstCharToSanitize(data, end - data);
+    memcpy(out, data, run); // NOLINT(safe-memcpy)
+    out += run;
+    data += run;
+    if (data == end) {
+      break;
+    }
+    const uint8_t c = static_cast<uint8_t>(*data);
+    if (c < 0x80) {
+      out = escapeAscii(c, out);
+      ++data;
+      continue;
+    }
+    const size_t sequence_size =
+        utf8SequenceSize(reinterpret_cast<const uint8_t*>(data), end - data);
+    if (sequence_size == 0) {
+      // Replace each byte which is not part of a valid sequence with U+FFFD, the replacement
+      // character, keeping the output valid JSON.
+      memcpy(out, "\\ufffd", MaxEscapedCharSize); // NOLINT(safe-memcpy)
+      out += MaxEscapedCharSize;
+      ++data;
+    } else {
+      memcpy(out, data, sequence_size); // NOLINT(safe-memcpy)
+      out += sequence_size;
+      data += sequence_size;
+    }
+  }
+  return out;
+}
+
 absl::string_view sanitize(std::string& buffer, absl::string_view str) {
   // Fast-path to see whether any escapes or utf-encoding are needed. If str has
   // only unescaped ascii characters, we can simply return it.
-  //
-  // Benchmarks show it's faster to just rip through the string with no
-  // conditionals, so we only check the arithmetically ORed condition after the
-  // loop. This avoids branches and allows simpler loop unrolling by the
-  // compiler.
-  static_assert(ARRAY_SIZE(needs_slow_sanitizer) == 256);
-  uint32_t need_slow = 0;
-  for (char c : str) {
-    // We need to escape control characters, characters >= 127, and double-quote
-    // and backslash.
-    need_slow |= needs_slow_sanitizer[static_cast<uint8_t>(c)];
-  }
-  if (need_slow == 0) {
+  const size_t clean = firstCharToSanitize(str);
+  if (clean == str.size()) {
     return str; // Fast path, should be executed most of the time.
   }
+
+  // Strings of 7-bit ASCII only need a handful of escapes, which are cheap to do here.
+  buffer.resize(clean + (str.size() - clean) * MaxEscapedCharSize);
+  memcpy(buffer.data(), str.data(), clean); // NOLINT(safe-memcpy)
+  const char* end = sanitizeAscii(str.substr(clean), buffer.data() + clean);
+  if (end != nullptr) {
+    buffer.resize(end - buffer.data());
+    return buffer;
+  }
+
   TRY_ASSERT_MAIN_THREAD {
-    // The Nlohmann JSON library supports serialization and is not too slow. A
-    // hand-rolled sanitizer can be a little over 2x faster at the cost of added
-    // production complexity. The main drawback is that this code cannot be used
-    // in the data plane as it throws exceptions. Should this become an issue,
-    // #20428 can be revived which is faster and doesn't throw exceptions, but
-    // adds complexity to the production code base.
+    // Other strings need their utf-8 encoding validated. The Nlohmann JSON
+    // library supports serialization and is not too slow. A hand-rolled utf-8
+    // sanitizer can be a little over 2x faster at the cost of added production
+    // complexity. The main drawback is that this code cannot be used in the
+    // data plane as it throws exceptions. Should this become an issue, #20428
+    // can be revived which is faster and doesn't throw exceptions, but adds
+    // complexity to the production code base.
     buffer = Nlohmann::Factory::serialize(str);
     return stripDoubleQuotes(buffer);
   }
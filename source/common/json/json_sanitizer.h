@@ -11,15 +11,12 @@ namespace Json {
 /**
  * Sanitizes a string so it is suitable for JSON. The buffer is
  * used if any of the characters in str need to be escaped. Performance
- * is good if there are no characters requiring escaping or utf-8 decode.
- *
- * --------------------------------------------------------------------
- * Benchmark                          Time             CPU   Iterations
- * --------------------------------------------------------------------
- * BM_ProtoEncoderNoEscape         1445 ns         1444 ns       455727
- * BM_NlohmannNoEscape             9.79 ns         9.79 ns     71449511
- * BM_ProtoEncoderWithEscape       1521 ns         1521 ns       462697
- * BM_NlohmannWithEscape            215 ns          215 ns      3264218
+ * is good if there are no characters requiring escaping or utf-8 decode:
+ * the string is scanned a block of characters at a time, and returned as-is.
+ * Strings of 7-bit ASCII needing escapes are escaped by copying the runs of
+ * characters between escapes in bulk; only strings with characters outside
+ * 7-bit ASCII are passed to the Nlohmann serializer for utf-8 validation.
+ * See test/common/json/json_sanitizer_speed_test.cc for benchmarks.
  *
  * The returned string is suitable for including in a double-quoted JSON
  * context, but does not include the surrounding double-quotes. The primary
@@ -37,6 +34,46 @@ namespace Json {
  */
 absl::string_view sanitize(std::string& buffer, absl::string_view str);
 
+/**
+ * The longest escape sequence of a character, for control characters escaped as \u00XX.
+ */
+constexpr size_t MaxEscapedCharSize = 6;
+
+/**
+ * Finds the first character of str which sanitize() does not pass through as-is: one which must
+ * be escaped, or one outside 7-bit ASCII which needs utf-8 validation. Blocks of characters are
+ * scanned at once where the platform has SIMD instructions for it.
+ *
+ * @param str the string to scan.
+ * @return the position of the first such character, or str.size() if there are none.
+ */
+size_t firstCharToSanitize(absl::string_view str);
+
+/**
+ * Writes str, escaped for a double-quoted JSON context, to out. Runs of characters which need no
+ * escape are copied in bulk. Only 7-bit ASCII strings are handled; others need utf-8 validation,
+ * which sanitize() provides.
+ *
+ * @param str the string to escape.
+ * @param out the output, which must have room for str.size() * MaxEscapedCharSize characters.
+ * @return the end of the escaped output, or nullptr if str has characters outside 7-bit ASCII, in
+ *   which case the contents of out are unspecified.
+ */
+char* sanitizeAscii(absl::string_view str, char* out);
+
+/**
+ * Writes str, escaped for a double-quoted JSON context, to out. Valid utf-8 sequences are copied
+ * as-is, and each byte which is not part of one is written as the escaped replacement character
+ * U+FFFD, so the output is always valid JSON. Unlike sanitize(), this neither throws nor calls the
+ * Nlohmann serializer, so it is safe to use in the data plane, e.g. when formatting access logs on
+ * worker threads.
+ *
+ * @param str the string to escape.
+ * @param out the output, which must have room for str.size() * MaxEscapedCharSize characters.
+ * @return the end of the escaped output.
+ */
+char* sanitizeUtf8(absl::string_view str, char* out);
+
 /**
  * Strips double-quotes on first and last characters of str. It's a
  * precondition to call this on a string that is surrounded by double-quotes.
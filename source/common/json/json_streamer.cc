@@ -1,5 +1,6 @@
 #include "source/common/json/json_streamer.h"
 
+#include <charconv>
 #include <type_traits>
 
 #include "source/common/buffer/buffer_util.h"
@@ -183,9 +184,17 @@ void Streamer::addNumber(double number) {
   }
 }
 
-void Streamer::addNumber(uint64_t number) { response_.addFragments({absl::StrCat(number)}); }
+template <class Integer> void Streamer::addInteger(Integer number) {
+  // Enough for the 20 digits of the largest uint64_t, or the sign and 19 digits of an int64_t.
+  char buf[20];
+  const std::to_chars_result result = std::to_chars(buf, buf + sizeof(buf), number);
+  ASSERT(result.ec == std::errc{});
+  response_.addFragments({absl::string_view(buf, result.ptr - buf)});
+}
+
+void Streamer::addNumber(uint64_t number) { addInteger(number); }
 
-void Streamer::addNumber(int64_t number) { response_.addFragments({absl::StrCat(number)}); }
+void Streamer::addNumber(int64_t number) { addInteger(number); }
 
 void Streamer::addBool(bool b) { response_.addFragments({b ? "true" : "false"}); }
 
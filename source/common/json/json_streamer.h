@@ -204,11 +204,13 @@ private:
   void addSanitized(absl::string_view prefix, absl::string_view token, absl::string_view suffix);
 
   /**
-   * Serializes a number.
+   * Serializes a number. Integers are formatted on the stack and copied straight into the buffer,
+   * rather than through a temporary string.
    */
   void addNumber(double d);
   void addNumber(uint64_t u);
   void addNumber(int64_t i);
+  template <class Integer> void addInteger(Integer number);
   void addBool(bool b);
 
   /**
@@ -782,7 +782,8 @@ Api::IoErrorPtr Utility::readPacketsFromSocket(IoHandle& handle,
                                                const Address::Instance& local_address,
                                                UdpPacketProcessor& udp_packet_processor,
                                                TimeSource& time_source, bool allow_gro,
-                                               bool allow_mmsg, uint32_t& packets_dropped) {
+                                               bool allow_mmsg, uint32_t& packets_dropped,
+                                               uint32_t* num_receives) {
   UdpRecvMsgMethod recv_msg_method = UdpRecvMsgMethod::RecvMsg;
   if (allow_gro && handle.supportsUdpGro()) {
     recv_msg_method = UdpRecvMsgMethod::RecvMsgWithGro;
@@ -828,6 +829,9 @@ Api::IoErrorPtr Utility::readPacketsFromSocket(IoHandle& handle,
       // No more to read or encountered a system error.
       return std::move(result.err_);
     }
+    if (num_receives != nullptr) {
+      ++*num_receives;
+    }
 
     if (packets_dropped != old_packets_dropped) {
       // The kernel tracks SO_RXQ_OVFL as a uint32 which can overflow to a smaller
@@ -391,6 +391,8 @@ public:
    * check the IoHandle to ensure the platform supports recvmmsg before using it. If `allow_gro` is
    * true and the platform supports GRO, then it will take precedence over using recvmmsg.
    * @param packets_dropped is the output parameter for number of packets dropped in kernel.
+   * @param num_receives if not nullptr, is incremented for each receive system call (recvmsg or
+   * recvmmsg) which returned datagrams.
    * Return the io error encountered or nullptr if no io error but read stopped
    * because of MAX_NUM_PACKETS_PER_EVENT_LOOP.
    *
@@ -405,7 +407,8 @@ public:
                                                const Address::Instance& local_address,
                                                UdpPacketProcessor& udp_packet_processor,
                                                TimeSource& time_source, bool allow_gro,
-                                               bool allow_mmsg, uint32_t& packets_dropped);
+                                               bool allow_mmsg, uint32_t& packets_dropped,
+                                               uint32_t* num_receives = nullptr);
 
 private:
   static void throwWithMalformedIp(absl::string_view ip_address);
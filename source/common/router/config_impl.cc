@@ -53,6 +53,7 @@
 #include "source/extensions/path/match/uri_template/uri_template_match.h"
 #include "source/extensions/path/rewrite/uri_template/uri_template_rewrite.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/match.h"
 
 namespace Envoy {
@@ -239,6 +240,22 @@ createRedirectConfig(const envoy::config::route::v3::Route& route, Regex::Engine
   return redirect_config;
 }
 
+bool sameConfigExceptVirtualHosts(const envoy::config::route::v3::RouteConfiguration& lhs,
+                                  const envoy::config::route::v3::RouteConfiguration& rhs) {
+#if defined(ENVOY_ENABLE_FULL_PROTOS)
+  Protobuf::util::MessageDifferencer differencer;
+  differencer.IgnoreField(
+      envoy::config::route::v3::RouteConfiguration::GetDescriptor()->FindFieldByName(
+          "virtual_hosts"));
+  return differencer.Compare(lhs, rhs);
+#else
+  UNREFERENCED_PARAMETER(lhs);
+  UNREFERENCED_PARAMETER(rhs);
+  // Without message reflection, err on the side of rebuilding everything.
+  return false;
+#endif
+}
+
 } // namespace
 
 const std::string& OriginalConnectPort::key() {
@@ -1885,6 +1902,18 @@ VirtualHostImpl::VirtualHostImpl(
       SET_AND_RETURN_IF_NOT_OK(route_or_error.status(), creation_status);
       routes_.emplace_back(route_or_error.value());
     }
+    if (routes_.size() >= MinRoutesForPathIndex &&
+        Runtime::runtimeFeatureEnabled("envoy.reloadable_features.router_path_index")) {
+      auto path_index = std::make_unique<RoutePathIndex>();
+      for (uint32_t i = 0; i < routes_.size(); ++i) {
+        routes_[i]->addToPathIndex(i, *path_index);
+      }
+      // When most routes are candidates for every path, the index saves little over evaluating
+      // them all.
+      if (path_index->unindexedRoutes() <= routes_.size() / 2) {
+        path_index_ = std::move(path_index);
+      }
+    }
   }
 }
 
@@ -1894,13 +1923,17 @@ const std::shared_ptr<const SslRedirectRoute> VirtualHostImpl::SSL_REDIRECT_ROUT
 RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
     const RouteCallback& cb, const Http::RequestHeaderMap& headers,
     const StreamInfo::StreamInfo& stream_info, uint64_t random_value,
-    absl::Span<const RouteEntryImplBaseConstSharedPtr> routes) const {
-  for (auto route = routes.begin(); route != routes.end(); ++route) {
-    if (!headers.Path() && !(*route)->supportsPathlessHeaders()) {
+    absl::Span<const RouteEntryImplBaseConstSharedPtr> routes,
+    const RoutePathIndex::Candidates* candidates) const {
+  const size_t count = candidates != nullptr ? candidates->size() : routes.size();
+  for (size_t i = 0; i < count; ++i) {
+    const size_t position = candidates != nullptr ? (*candidates)[i] : i;
+    const RouteEntryImplBaseConstSharedPtr& route = routes[position];
+    if (!headers.Path() && !route->supportsPathlessHeaders()) {
       continue;
     }
 
-    RouteConstSharedPtr route_entry = (*route)->matches(headers, stream_info, random_value);
+    RouteConstSharedPtr route_entry = route->matches(headers, stream_info, random_value);
     if (route_entry == nullptr) {
       continue;
     }
@@ -1909,7 +1942,9 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
       return route_entry;
     }
 
-    RouteEvalStatus eval_status = (std::next(route) == routes.end())
+    // Whether there are more routes depends on the position of the route in the virtual host,
+    // not among the candidates, so that the callback sees the same as without the index.
+    RouteEvalStatus eval_status = (position + 1 == routes.size())
                                       ? RouteEvalStatus::NoMoreRoutes
                                       : RouteEvalStatus::HasMoreRoutes;
     RouteMatchStatus match_status = cb(route_entry, eval_status);
@@ -1976,6 +2011,19 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return nullptr;
   }
 
+  if (path_index_ != nullptr) {
+    // Only routes whose path match accepts the path can match, so only those are evaluated. Path
+    // matches compare the path without the query string and fragment, and without path
+    // parameters if so configured.
+    absl::string_view path = Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+    if (shared_virtual_host_->globalRouteConfig().ignorePathParametersInPathMatching()) {
+      path = path.substr(0, path.find(';'));
+    }
+    RoutePathIndex::Candidates candidates;
+    path_index_->findCandidates(path, candidates);
+    return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_, &candidates);
+  }
+
   // Check for a route that matches the request.
   return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_);
 }
@@ -2005,11 +2053,12 @@ absl::StatusOr<std::unique_ptr<RouteMatcher>>
 RouteMatcher::create(const envoy::config::route::v3::RouteConfiguration& route_config,
                      const CommonConfigSharedPtr& global_route_config,
                      Server::Configuration::ServerFactoryContext& factory_context,
-                     ProtobufMessage::ValidationVisitor& validator, bool validate_clusters) {
+                     ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+                     const Previous* previous) {
   absl::Status creation_status = absl::OkStatus();
-  auto ret = std::unique_ptr<RouteMatcher>{new RouteMatcher(route_config, global_route_config,
-                                                            factory_context, validator,
-                                                            validate_clusters, creation_status)};
+  auto ret = std::unique_ptr<RouteMatcher>{
+      new RouteMatcher(route_config, global_route_config, factory_context, validator,
+                       validate_clusters, previous, creation_status)};
   RETURN_IF_NOT_OK(creation_status);
   return ret;
 }
@@ -2017,7 +2066,7 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
                            const CommonConfigSharedPtr& global_route_config,
                            Server::Configuration::ServerFactoryContext& factory_context,
                            ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
-                           absl::Status& creation_status)
+                           const Previous* previous, absl::Status& creation_status)
     : vhost_scope_(factory_context.scope().scopeFromStatName(
           factory_context.routerContext().virtualClusterStatNames().vhost_)),
       ignore_port_in_host_matching_(route_config.ignore_port_in_host_matching()) {
@@ -2025,11 +2074,37 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
   if (validate_clusters) {
     validation_clusters = factory_context.clusterManager().clusters();
   }
+  // Positions of the previous virtual hosts by name. Should names repeat, comparing the
+  // configuration of the first one with the same name still decides correctly whether to reuse it.
+  absl::flat_hash_map<absl::string_view, int> previous_positions;
+  if (previous != nullptr) {
+    ASSERT(previous->config_.virtual_hosts_size() ==
+           static_cast<int>(previous->matcher_.virtual_hosts_by_position_.size()));
+    previous_positions.reserve(previous->config_.virtual_hosts_size());
+    for (int i = 0; i < previous->config_.virtual_hosts_size(); ++i) {
+      previous_positions.emplace(previous->config_.virtual_hosts(i).name(), i);
+    }
+  }
+  virtual_hosts_by_position_.reserve(route_config.virtual_hosts_size());
   for (const auto& virtual_host_config : route_config.virtual_hosts()) {
-    VirtualHostSharedPtr virtual_host = std::make_shared<VirtualHostImpl>(
-        virtual_host_config, global_route_config, factory_context, *vhost_scope_, validator,
-        validation_clusters, creation_status);
-    SET_AND_RETURN_IF_NOT_OK(creation_status, creation_status);
+    VirtualHostSharedPtr virtual_host;
+    if (previous != nullptr) {
+      const auto it = previous_positions.find(virtual_host_config.name());
+      if (it != previous_positions.end() &&
+          Protobuf::util::MessageDifferencer::Equals(previous->config_.virtual_hosts(it->second),
+                                                     virtual_host_config)) {
+        virtual_host = previous->matcher_.virtual_hosts_by_position_[it->second];
+        ++virtual_hosts_reused_;
+      }
+    }
+    if (virtual_host == nullptr) {
+      virtual_host = std::make_shared<VirtualHostImpl>(virtual_host_config, global_route_config,
+                                                       factory_context, *vhost_scope_, validator,
+                                                       validation_clusters, creation_status);
+      SET_AND_RETURN_IF_NOT_OK(creation_status, creation_status);
+      ++virtual_hosts_built_;
+    }
+    virtual_hosts_by_position_.push_back(virtual_host);
     for (const std::string& domain_name : virtual_host_config.domains()) {
       const Http::LowerCaseString lower_case_domain_name(domain_name);
       absl::string_view domain = lower_case_domain_name;
@@ -2210,15 +2285,47 @@ const Envoy::Config::TypedMetadata& CommonConfigImpl::typedMetadata() const {
 ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
                        Server::Configuration::ServerFactoryContext& factory_context,
                        ProtobufMessage::ValidationVisitor& validator,
-                       bool validate_clusters_default) {
+                       bool validate_clusters_default)
+    : ConfigImpl(config, nullptr, nullptr, factory_context, validator, validate_clusters_default) {
+}
+
+ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
+                       const envoy::config::route::v3::RouteConfiguration& previous_config,
+                       const ConfigImpl& previous,
+                       Server::Configuration::ServerFactoryContext& factory_context,
+                       ProtobufMessage::ValidationVisitor& validator,
+                       bool validate_clusters_default)
+    : ConfigImpl(config, &previous_config, &previous, factory_context, validator,
+                 validate_clusters_default) {}
 
-  shared_config_ = std::make_shared<CommonConfigImpl>(config, factory_context, validator);
+ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
+                       const envoy::config::route::v3::RouteConfiguration* previous_config,
+                       const ConfigImpl* previous,
+                       Server::Configuration::ServerFactoryContext& factory_context,
+                       ProtobufMessage::ValidationVisitor& validator,
+                       bool validate_clusters_default) {
+  const MonotonicTime start = factory_context.timeSource().monotonicTime();
+  const bool validate_clusters =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default);
+
+  // Virtual hosts refer to the shared config, so they can only be reused along with it. They are
+  // not reused when clusters are validated, as the clusters they refer to may have gone since.
+  absl::optional<RouteMatcher::Previous> reusable;
+  if (previous != nullptr && !validate_clusters &&
+      sameConfigExceptVirtualHosts(config, *previous_config)) {
+    shared_config_ = previous->shared_config_;
+    reusable.emplace(RouteMatcher::Previous{*previous->route_matcher_, *previous_config});
+  } else {
+    shared_config_ = std::make_shared<CommonConfigImpl>(config, factory_context, validator);
+  }
 
-  auto matcher_or_error = RouteMatcher::create(
-      config, shared_config_, factory_context, validator,
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
+  auto matcher_or_error =
+      RouteMatcher::create(config, shared_config_, factory_context, validator, validate_clusters,
+                           reusable.has_value() ? &reusable.value() : nullptr);
   THROW_IF_STATUS_NOT_OK(matcher_or_error, throw);
   route_matcher_ = std::move(matcher_or_error.value());
+  build_time_ = std::chrono::duration_cast<std::chrono::microseconds>(
+      factory_context.timeSource().monotonicTime() - start);
 }
 
 RouteConstSharedPtr ConfigImpl::route(const RouteCallback& cb,
@@ -31,6 +31,7 @@
 #include "source/common/router/config_utility.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/router/metadatamatchcriteria_impl.h"
+#include "source/common/router/route_path_index.h"
 #include "source/common/router/router_ratelimit.h"
 #include "source/common/router/tls_context_match_criteria_impl.h"
 #include "source/common/stats/symbol_table.h"
@@ -385,10 +386,19 @@ public:
                                           const StreamInfo::StreamInfo& stream_info,
                                           uint64_t random_value) const;
 
+  /**
+   * Evaluates routes in order and returns the first which matches and is accepted by cb.
+   * @param candidates if not null, the positions of the only routes to evaluate, in ascending
+   * order. Routes which are not candidates are skipped as though they did not match.
+   */
   RouteConstSharedPtr
   getRouteFromRoutes(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                      const StreamInfo::StreamInfo& stream_info, uint64_t random_value,
-                     absl::Span<const RouteEntryImplBaseConstSharedPtr> routes) const;
+                     absl::Span<const RouteEntryImplBaseConstSharedPtr> routes,
+                     const RoutePathIndex::Candidates* candidates = nullptr) const;
+
+  // Virtual hosts with at least this many routes index them by path.
+  static constexpr uint32_t MinRoutesForPathIndex = 32;
 
 private:
   enum class SslRequirements : uint8_t { None, ExternalOnly, All };
@@ -400,6 +410,7 @@ private:
   SslRequirements ssl_requirements_;
 
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  std::unique_ptr<const RoutePathIndex> path_index_;
   Matcher::MatchTreeSharedPtr<Http::HttpMatchingData> matcher_;
 };
 
@@ -654,6 +665,15 @@ public:
 
   bool matchRoute(const Http::RequestHeaderMap& headers, const StreamInfo::StreamInfo& stream_info,
                   uint64_t random_value) const;
+  /**
+   * Adds this route to the path index of its virtual host. Routes whose path match the index does
+   * not understand are candidates for every path.
+   * @param position the position of this route in its virtual host.
+   * @param index the index to add the route to.
+   */
+  virtual void addToPathIndex(uint32_t position, RoutePathIndex& index) const {
+    index.addUnindexed(position);
+  }
   absl::Status
   validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const;
 
@@ -1291,6 +1311,11 @@ public:
   }
   PathMatchType matchType() const override { return PathMatchType::Prefix; }
 
+  // RouteEntryImplBase
+  void addToPathIndex(uint32_t position, RoutePathIndex& index) const override {
+    index.addPrefix(position, matcher(), !case_sensitive());
+  }
+
   // Router::Matchable
   RouteConstSharedPtr matches(const Http::RequestHeaderMap& headers,
                               const StreamInfo::StreamInfo& stream_info,
@@ -1326,6 +1351,11 @@ public:
   }
   PathMatchType matchType() const override { return PathMatchType::Exact; }
 
+  // RouteEntryImplBase
+  void addToPathIndex(uint32_t position, RoutePathIndex& index) const override {
+    index.addExact(position, matcher(), !case_sensitive());
+  }
+
   // Router::Matchable
   RouteConstSharedPtr matches(const Http::RequestHeaderMap& headers,
                               const StreamInfo::StreamInfo& stream_info,
@@ -1427,6 +1457,11 @@ public:
   }
   PathMatchType matchType() const override { return PathMatchType::PathSeparatedPrefix; }
 
+  // RouteEntryImplBase
+  void addToPathIndex(uint32_t position, RoutePathIndex& index) const override {
+    index.addPrefix(position, matcher(), !case_sensitive());
+  }
+
   // Router::Matchable
   RouteConstSharedPtr matches(const Http::RequestHeaderMap& headers,
                               const StreamInfo::StreamInfo& stream_info,
@@ -1514,23 +1549,36 @@ DECLARE_FACTORY(RouteListMatchActionFactory);
  */
 class RouteMatcher {
 public:
+  /**
+   * A route matcher being replaced, and the route configuration it was created from. Its virtual
+   * hosts are shared with the new matcher where their configuration did not change.
+   */
+  struct Previous {
+    const RouteMatcher& matcher_;
+    const envoy::config::route::v3::RouteConfiguration& config_;
+  };
+
   static absl::StatusOr<std::unique_ptr<RouteMatcher>>
   create(const envoy::config::route::v3::RouteConfiguration& config,
          const CommonConfigSharedPtr& global_route_config,
          Server::Configuration::ServerFactoryContext& factory_context,
-         ProtobufMessage::ValidationVisitor& validator, bool validate_clusters);
+         ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+         const Previous* previous = nullptr);
 
   RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                             const StreamInfo::StreamInfo& stream_info, uint64_t random_value) const;
 
   const VirtualHostImpl* findVirtualHost(const Http::RequestHeaderMap& headers) const;
 
+  uint32_t virtualHostsBuilt() const { return virtual_hosts_built_; }
+  uint32_t virtualHostsReused() const { return virtual_hosts_reused_; }
+
 private:
   RouteMatcher(const envoy::config::route::v3::RouteConfiguration& config,
                const CommonConfigSharedPtr& global_route_config,
                Server::Configuration::ServerFactoryContext& factory_context,
                ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
-               absl::Status& creation_status);
+               const Previous* previous, absl::Status& creation_status);
 
   using WildcardVirtualHosts =
       std::map<int64_t, absl::node_hash_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
@@ -1555,6 +1603,10 @@ private:
   WildcardVirtualHosts wildcard_virtual_host_prefixes_;
 
   VirtualHostSharedPtr default_virtual_host_;
+  // The virtual hosts in the order of the configuration, for a later matcher to reuse.
+  std::vector<VirtualHostSharedPtr> virtual_hosts_by_position_;
+  uint32_t virtual_hosts_built_{};
+  uint32_t virtual_hosts_reused_{};
   const bool ignore_port_in_host_matching_{false};
 };
 
@@ -1635,6 +1687,17 @@ public:
              Server::Configuration::ServerFactoryContext& factory_context,
              ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default);
 
+  /**
+   * Creates the config replacing previous, which was created from previous_config. Virtual hosts
+   * whose configuration did not change are shared with previous rather than built again, as long
+   * as the rest of the route configuration did not change either and clusters are not validated.
+   */
+  ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
+             const envoy::config::route::v3::RouteConfiguration& previous_config,
+             const ConfigImpl& previous,
+             Server::Configuration::ServerFactoryContext& factory_context,
+             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default);
+
   bool virtualHostExists(const Http::RequestHeaderMap& headers) const {
     return route_matcher_->findVirtualHost(headers) != nullptr;
   }
@@ -1672,9 +1735,20 @@ public:
     return shared_config_->typedMetadata();
   }
 
+  uint32_t virtualHostsBuilt() const { return route_matcher_->virtualHostsBuilt(); }
+  uint32_t virtualHostsReused() const { return route_matcher_->virtualHostsReused(); }
+  std::chrono::microseconds buildTime() const { return build_time_; }
+
 private:
+  ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
+             const envoy::config::route::v3::RouteConfiguration* previous_config,
+             const ConfigImpl* previous,
+             Server::Configuration::ServerFactoryContext& factory_context,
+             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default);
+
   CommonConfigSharedPtr shared_config_;
   std::unique_ptr<RouteMatcher> route_matcher_;
+  std::chrono::microseconds build_time_{};
 };
 
 /**
@@ -34,7 +34,9 @@ RdsRouteConfigSubscription::RdsRouteConfigSubscription(
                                       manager_identifier, factory_context, stat_prefix + "rds.",
                                       "RDS", route_config_provider_manager),
       config_update_info_(static_cast<RouteConfigUpdateReceiver*>(
-          Rds::RdsRouteConfigSubscription::config_update_info_.get())) {}
+          Rds::RdsRouteConfigSubscription::config_update_info_.get())),
+      build_stats_({ALL_ROUTE_CONFIG_BUILD_STATS(POOL_COUNTER(*scope_), POOL_HISTOGRAM(*scope_))}) {
+}
 
 RdsRouteConfigSubscription::~RdsRouteConfigSubscription() { config_update_info_.release(); }
 
@@ -88,6 +90,12 @@ void RdsRouteConfigSubscription::maybeCreateInitManager(
   }
 }
 
+void RdsRouteConfigSubscription::onConfigBuilt(const ConfigImpl& config) {
+  build_stats_.virtual_hosts_built_.add(config.virtualHostsBuilt());
+  build_stats_.virtual_hosts_reused_.add(config.virtualHostsReused());
+  build_stats_.config_build_time_us_.recordValue(config.buildTime().count());
+}
+
 void RdsRouteConfigSubscription::updateOnDemand(const std::string& aliases) {
   if (vhds_subscription_.get() == nullptr) {
     return;
@@ -116,14 +124,16 @@ absl::Status RdsRouteConfigProviderImpl::onConfigUpdate() {
     return status;
   }
 
+  const auto config =
+      std::static_pointer_cast<const ConfigImpl>(config_update_info_->parsedConfiguration());
+  subscription().onConfigBuilt(*config);
+
   const auto aliases = config_update_info_->resourceIdsInLastVhdsUpdate();
   // Regular (non-VHDS) RDS updates don't populate aliases fields in resources.
   if (aliases.empty()) {
     return absl::OkStatus();
   }
 
-  const auto config =
-      std::static_pointer_cast<const ConfigImpl>(config_update_info_->parsedConfiguration());
   // Notifies connections that RouteConfiguration update has been propagated.
   // Callbacks processing is performed in FIFO order. The callback is skipped if alias used in
   // the VHDS update request do not match the aliases in the update response
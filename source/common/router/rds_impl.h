@@ -22,6 +22,7 @@
 #include "envoy/service/discovery/v3/discovery.pb.h"
 #include "envoy/singleton/instance.h"
 #include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/common/callback_impl.h"
@@ -47,6 +48,22 @@ namespace Router {
 
 // For friend class declaration in RdsRouteConfigSubscription.
 class ScopedRdsConfigSubscription;
+class ConfigImpl;
+
+/**
+ * All stats for building route configurations received over RDS and VHDS. @see stats_macros.h
+ */
+#define ALL_ROUTE_CONFIG_BUILD_STATS(COUNTER, HISTOGRAM)                                           \
+  COUNTER(virtual_hosts_built)                                                                     \
+  COUNTER(virtual_hosts_reused)                                                                    \
+  HISTOGRAM(config_build_time_us, Microseconds)
+
+/**
+ * Struct definition for all route configuration build stats. @see stats_macros.h
+ */
+struct RouteConfigBuildStats {
+  ALL_ROUTE_CONFIG_BUILD_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
 
 /**
  * A class that fetches the route configuration dynamically using the RDS API and updates them to
@@ -69,6 +86,7 @@ public:
   void maybeCreateInitManager(const std::string& version_info,
                               std::unique_ptr<Init::ManagerImpl>& init_manager,
                               std::unique_ptr<Cleanup>& resume_rds);
+  void onConfigBuilt(const ConfigImpl& config);
 
 private:
   absl::Status beforeProviderUpdate(std::unique_ptr<Init::ManagerImpl>& noop_init_manager,
@@ -83,6 +101,7 @@ private:
   VhdsSubscriptionPtr vhds_subscription_;
   RouteConfigUpdatePtr config_update_info_;
   Common::CallbackManager<> update_callback_manager_;
+  RouteConfigBuildStats build_stats_;
 
   // Access to addUpdateCallback
   friend class ScopedRdsConfigSubscription;
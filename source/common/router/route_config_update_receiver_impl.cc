@@ -12,6 +12,7 @@
 #include "source/common/config/resource_name.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/router/config_impl.h"
+#include "source/common/runtime/runtime_features.h"
 
 namespace Envoy {
 namespace Router {
@@ -49,6 +50,26 @@ ConfigTraitsImpl::createConfig(const Protobuf::Message& rc,
       validator_, validate_clusters_default);
 }
 
+Rds::ConfigConstSharedPtr ConfigTraitsImpl::createUpdatedConfig(
+    const Protobuf::Message& rc, const Protobuf::Message& previous_rc,
+    const Rds::ConfigConstSharedPtr& previous,
+    Server::Configuration::ServerFactoryContext& factory_context,
+    bool validate_clusters_default) const {
+  // The previous config is a NullConfigImpl until the first update.
+  auto previous_config = std::dynamic_pointer_cast<const ConfigImpl>(previous);
+  if (previous_config == nullptr ||
+      !Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.route_config_reuse_virtual_hosts")) {
+    return createConfig(rc, factory_context, validate_clusters_default);
+  }
+  ASSERT(dynamic_cast<const envoy::config::route::v3::RouteConfiguration*>(&rc));
+  ASSERT(dynamic_cast<const envoy::config::route::v3::RouteConfiguration*>(&previous_rc));
+  return std::make_shared<ConfigImpl>(
+      static_cast<const envoy::config::route::v3::RouteConfiguration&>(rc),
+      static_cast<const envoy::config::route::v3::RouteConfiguration&>(previous_rc),
+      *previous_config, factory_context, validator_, validate_clusters_default);
+}
+
 bool RouteConfigUpdateReceiverImpl::onRdsUpdate(const Protobuf::Message& rc,
                                                 const std::string& version_info) {
   uint64_t new_hash = base_.getHash(rc);
@@ -26,6 +26,11 @@ public:
   Rds::ConfigConstSharedPtr createConfig(const Protobuf::Message& rc,
                                          Server::Configuration::ServerFactoryContext& context,
                                          bool validate_clusters_default) const override;
+  Rds::ConfigConstSharedPtr
+  createUpdatedConfig(const Protobuf::Message& rc, const Protobuf::Message& previous_rc,
+                      const Rds::ConfigConstSharedPtr& previous,
+                      Server::Configuration::ServerFactoryContext& context,
+                      bool validate_clusters_default) const override;
 
 private:
   ProtobufMessage::ValidationVisitor& validator_;
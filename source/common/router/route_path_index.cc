@@ -0,0 +1,83 @@
+#include "source/common/router/route_path_index.h"
+
+#include <algorithm>
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+RoutePathIndex::Node& RoutePathIndex::Trie::insert(absl::string_view key) {
+  uint32_t current = 0;
+  for (const char c : key) {
+    auto& children = nodes_[current].children_;
+    auto child = std::lower_bound(
+        children.begin(), children.end(), c,
+        [](const std::pair<char, uint32_t>& entry, char value) { return entry.first < value; });
+    if (child != children.end() && child->first == c) {
+      current = child->second;
+      continue;
+    }
+    const uint32_t next = nodes_.size();
+    children.emplace(child, c, next);
+    // Adding the node may move the parent, so it is only looked up again on the next iteration.
+    nodes_.emplace_back();
+    current = next;
+  }
+  return nodes_[current];
+}
+
+template <bool IgnoreCase>
+void RoutePathIndex::Trie::collect(absl::string_view path, Candidates& candidates) const {
+  const Node* node = &nodes_[0];
+  candidates.insert(candidates.end(), node->prefix_routes_.begin(), node->prefix_routes_.end());
+  for (char c : path) {
+    if constexpr (IgnoreCase) {
+      c = absl::ascii_tolower(c);
+    }
+    const auto& children = node->children_;
+    auto child = std::lower_bound(
+        children.begin(), children.end(), c,
+        [](const std::pair<char, uint32_t>& entry, char value) { return entry.first < value; });
+    if (child == children.end() || child->first != c) {
+      return;
+    }
+    node = &nodes_[child->second];
+    candidates.insert(candidates.end(), node->prefix_routes_.begin(), node->prefix_routes_.end());
+  }
+  candidates.insert(candidates.end(), node->exact_routes_.begin(), node->exact_routes_.end());
+}
+
+void RoutePathIndex::addPrefix(uint32_t position, absl::string_view prefix, bool ignore_case) {
+  if (ignore_case) {
+    ignore_case_.insert(absl::AsciiStrToLower(prefix)).prefix_routes_.push_back(position);
+  } else {
+    case_sensitive_.insert(prefix).prefix_routes_.push_back(position);
+  }
+}
+
+void RoutePathIndex::addExact(uint32_t position, absl::string_view path, bool ignore_case) {
+  if (ignore_case) {
+    ignore_case_.insert(absl::AsciiStrToLower(path)).exact_routes_.push_back(position);
+  } else {
+    case_sensitive_.insert(path).exact_routes_.push_back(position);
+  }
+}
+
+void RoutePathIndex::addUnindexed(uint32_t position) { unindexed_.push_back(position); }
+
+void RoutePathIndex::findCandidates(absl::string_view path, Candidates& candidates) const {
+  Candidates indexed;
+  case_sensitive_.collect<false>(path, indexed);
+  ignore_case_.collect<true>(path, indexed);
+  // Routes on a longer prefix may come before routes on a shorter one.
+  std::sort(indexed.begin(), indexed.end());
+
+  candidates.clear();
+  candidates.reserve(indexed.size() + unindexed_.size());
+  std::merge(indexed.begin(), indexed.end(), unindexed_.begin(), unindexed_.end(),
+             std::back_inserter(candidates));
+}
+
+} // namespace Router
+} // namespace Envoy
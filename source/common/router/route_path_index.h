@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * An index from request paths to the routes of a virtual host which may match them, built when
+ * the route configuration is loaded. Routes are identified by their position in the virtual host.
+ *
+ * Prefix and exact path routes are indexed in a trie keyed on the path, one for case-sensitive
+ * routes and one, keyed on the lowercased path, for the others. Looking up a path walks each trie
+ * once, collecting the prefix routes on every node it passes and the exact routes on the node it
+ * ends on. Routes with any other kind of path match are not indexed and are candidates for every
+ * path.
+ *
+ * The index only considers the path, so a route it returns may still fail to match on headers,
+ * query parameters, runtime and so on; but a route it does not return cannot match. Evaluating the
+ * candidates in order therefore finds the same route as evaluating every route in order.
+ */
+class RoutePathIndex {
+public:
+  // Positions of routes, in ascending order.
+  using Candidates = absl::InlinedVector<uint32_t, 8>;
+
+  /**
+   * Adds a route which matches paths starting with prefix. Path separated prefix routes are added
+   * as prefix routes, as the index only needs to be no more selective than the route.
+   * @param position the position of the route in its virtual host.
+   * @param prefix the path prefix.
+   * @param ignore_case whether the prefix is matched ignoring ASCII case.
+   */
+  void addPrefix(uint32_t position, absl::string_view prefix, bool ignore_case);
+
+  /**
+   * Adds a route which matches a path exactly.
+   * @param position the position of the route in its virtual host.
+   * @param path the path.
+   * @param ignore_case whether the path is matched ignoring ASCII case.
+   */
+  void addExact(uint32_t position, absl::string_view path, bool ignore_case);
+
+  /**
+   * Adds a route which is a candidate for every path.
+   * @param position the position of the route in its virtual host.
+   */
+  void addUnindexed(uint32_t position);
+
+  /**
+   * @param path the path, as compared by the routes: without the query string and fragment.
+   * @param candidates receives the positions of the routes which may match path, in ascending
+   * order.
+   */
+  void findCandidates(absl::string_view path, Candidates& candidates) const;
+
+  /**
+   * @return the number of routes which are candidates for every path.
+   */
+  size_t unindexedRoutes() const { return unindexed_.size(); }
+
+private:
+  struct Node {
+    // Children sorted by character, which keeps nodes small; most have one or two children.
+    std::vector<std::pair<char, uint32_t>> children_;
+    std::vector<uint32_t> prefix_routes_;
+    std::vector<uint32_t> exact_routes_;
+  };
+
+  class Trie {
+  public:
+    Trie() : nodes_(1) {}
+
+    Node& insert(absl::string_view key);
+    template <bool IgnoreCase> void collect(absl::string_view path, Candidates& candidates) const;
+
+  private:
+    std::vector<Node> nodes_;
+  };
+
+  Trie case_sensitive_;
+  Trie ignore_case_;
+  std::vector<uint32_t> unindexed_;
+};
+
+} // namespace Router
+} // namespace Envoy
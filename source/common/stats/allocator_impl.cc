@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <thread>
 
 #include "envoy/stats/sink.h"
 #include "envoy/stats/stats.h"
@@ -166,6 +167,90 @@ private:
   std::atomic<uint64_t> pending_increment_{0};
 };
 
+namespace {
+
+// The number of shards of each ShardedCounterImpl: enough for each hardware thread to have one to
+// itself, up to a limit which bounds the memory used by each counter.
+uint32_t counterShardCount() {
+  static const uint32_t count = []() {
+    constexpr uint32_t MaxShards = 64;
+    const uint32_t concurrency = std::max(1U, std::thread::hardware_concurrency());
+    uint32_t shards = 1;
+    while (shards < concurrency && shards < MaxShards) {
+      shards *= 2;
+    }
+    return shards;
+  }();
+  return count;
+}
+
+// Threads are numbered in the order in which they first increment a sharded counter, so that
+// workers, which start together, each get a shard of their own while there are enough.
+uint32_t counterShardIndex() {
+  static std::atomic<uint32_t> next_index{0};
+  thread_local const uint32_t index = next_index++;
+  return index;
+}
+
+} // namespace
+
+// A counter which keeps its count in one shard per thread, each on its own cache line, so that
+// threads incrementing it do not contend for a single cache line. Reads sum the shards, so they
+// see every increment which a read of CounterImpl would.
+class ShardedCounterImpl : public StatsSharedImpl<Counter> {
+public:
+  ShardedCounterImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
+                     const StatNameTagVector& stat_name_tags)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags),
+        shard_mask_(counterShardCount() - 1), shards_(new Shard[counterShardCount()]) {}
+
+  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
+    const size_t count = alloc_.counters_.erase(statName());
+    ASSERT(count == 1);
+    alloc_.sinked_counters_.erase(this);
+  }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    Shard& shard = shards_[counterShardIndex() & shard_mask_];
+    shard.value_.fetch_add(amount, std::memory_order_relaxed);
+    shard.pending_increment_.fetch_add(amount, std::memory_order_relaxed);
+    // Only write the flags, which share a cache line with the rest of the stat, the first time.
+    if (!(flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    uint64_t pending_increment = 0;
+    for (uint32_t i = 0; i <= shard_mask_; ++i) {
+      pending_increment += shards_[i].pending_increment_.exchange(0);
+    }
+    return pending_increment;
+  }
+  void reset() override {
+    for (uint32_t i = 0; i <= shard_mask_; ++i) {
+      shards_[i].value_ = 0;
+    }
+  }
+  uint64_t value() const override {
+    uint64_t value = 0;
+    for (uint32_t i = 0; i <= shard_mask_; ++i) {
+      value += shards_[i].value_.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_{0};
+    std::atomic<uint64_t> pending_increment_{0};
+  };
+
+  const uint32_t shard_mask_;
+  const std::unique_ptr<Shard[]> shards_;
+};
+
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
@@ -298,6 +383,17 @@ private:
 
 CounterSharedPtr AllocatorImpl::makeCounter(StatName name, StatName tag_extracted_name,
                                             const StatNameTagVector& stat_name_tags) {
+  return makeCounterHelper(name, tag_extracted_name, stat_name_tags, false);
+}
+
+CounterSharedPtr AllocatorImpl::makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                                   const StatNameTagVector& stat_name_tags) {
+  return makeCounterHelper(name, tag_extracted_name, stat_name_tags, true);
+}
+
+CounterSharedPtr AllocatorImpl::makeCounterHelper(StatName name, StatName tag_extracted_name,
+                                                  const StatNameTagVector& stat_name_tags,
+                                                  bool sharded) {
   Thread::LockGuard lock(mutex_);
   ASSERT(gauges_.find(name) == gauges_.end());
   ASSERT(text_readouts_.find(name) == text_readouts_.end());
@@ -305,7 +401,9 @@ CounterSharedPtr AllocatorImpl::makeCounter(StatName name, StatName tag_extracte
   if (iter != counters_.end()) {
     return {*iter};
   }
-  auto counter = CounterSharedPtr(makeCounterInternal(name, tag_extracted_name, stat_name_tags));
+  auto counter = CounterSharedPtr(
+      sharded ? new ShardedCounterImpl(name, *this, tag_extracted_name, stat_name_tags)
+              : makeCounterInternal(name, tag_extracted_name, stat_name_tags));
   counters_.insert(counter.get());
   // Add counter to sinked_counters_ if it matches the sink predicate.
   if (sink_predicates_ != nullptr && sink_predicates_->includeCounter(*counter)) {
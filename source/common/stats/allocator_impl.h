@@ -26,6 +26,8 @@ public:
   // Allocator
   CounterSharedPtr makeCounter(StatName name, StatName tag_extracted_name,
                                const StatNameTagVector& stat_name_tags) override;
+  CounterSharedPtr makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                      const StatNameTagVector& stat_name_tags) override;
   GaugeSharedPtr makeGauge(StatName name, StatName tag_extracted_name,
                            const StatNameTagVector& stat_name_tags,
                            Gauge::ImportMode import_mode) override;
@@ -70,10 +72,14 @@ protected:
 private:
   template <class BaseClass> friend class StatsSharedImpl;
   friend class CounterImpl;
+  friend class ShardedCounterImpl;
   friend class GaugeImpl;
   friend class TextReadoutImpl;
   friend class NotifyingAllocatorImpl;
 
+  CounterSharedPtr makeCounterHelper(StatName name, StatName tag_extracted_name,
+                                     const StatNameTagVector& stat_name_tags, bool sharded);
+
   // A mutex is needed here to protect both the stats_ object from both
   // alloc() and free() operations. Although alloc() operations are called under existing locking,
   // free() operations are made from the destructors of the individual stat objects, which are not
@@ -129,5 +129,51 @@ const ConstSupportedBuckets& HistogramSettingsImpl::defaultBuckets() {
                           60000, 300000, 600000, 1800000, 3600000});
 }
 
+CompactHistogram::~CompactHistogram() {
+  if (overflow_ != nullptr) {
+    hist_free(overflow_);
+  }
+}
+
+void CompactHistogram::recordValue(uint64_t value) {
+  // This is the bucket hist_insert_intscale() records the value in.
+  const hist_bucket_t bucket = int_scale_to_hist_bucket(value, 0);
+  ++sample_count_;
+  for (uint32_t i = 0; i < num_buckets_; ++i) {
+    if (buckets_[i].val == bucket.val && buckets_[i].exp == bucket.exp) {
+      ++counts_[i];
+      return;
+    }
+  }
+  if (num_buckets_ < MaxBuckets) {
+    buckets_[num_buckets_] = bucket;
+    counts_[num_buckets_] = 1;
+    ++num_buckets_;
+    return;
+  }
+  if (overflow_ == nullptr) {
+    overflow_ = hist_alloc();
+  }
+  hist_insert_raw(overflow_, bucket, 1);
+  overflowed_ = true;
+}
+
+uint64_t CompactHistogram::mergeAndClear(histogram_t* target) {
+  for (uint32_t i = 0; i < num_buckets_; ++i) {
+    hist_insert_raw(target, buckets_[i], counts_[i]);
+  }
+  if (overflowed_) {
+    // The overflow histogram is kept for reuse, as a thread which recorded values across many
+    // buckets is likely to do so again.
+    hist_accumulate(target, &overflow_, 1);
+    hist_clear(overflow_);
+    overflowed_ = false;
+  }
+  const uint64_t sample_count = sample_count_;
+  num_buckets_ = 0;
+  sample_count_ = 0;
+  return sample_count;
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <string>
 
@@ -74,6 +75,42 @@ private:
   const Histogram::Unit unit_{Histogram::Unit::Unspecified};
 };
 
+/**
+ * Records values into a small fixed array of circllhist buckets, spilling over into a full
+ * circllhist, allocated on first use, only once values fall into more distinct buckets than that.
+ * Between merges, a per-thread histogram mostly sees values in a handful of buckets, so this is a
+ * fraction of the size of a histogram_t, and merging one which recorded nothing costs nothing.
+ */
+class CompactHistogram : NonCopyable {
+public:
+  static constexpr uint32_t MaxBuckets = 8;
+
+  CompactHistogram() = default;
+  ~CompactHistogram();
+
+  void recordValue(uint64_t value);
+
+  /**
+   * Adds the recorded values to a histogram, and clears them.
+   * @param target the histogram to add the values to.
+   * @return the number of values added.
+   */
+  uint64_t mergeAndClear(histogram_t* target);
+
+  /**
+   * @return the number of values recorded since the last merge.
+   */
+  uint64_t sampleCount() const { return sample_count_; }
+
+private:
+  std::array<hist_bucket_t, MaxBuckets> buckets_;
+  std::array<uint64_t, MaxBuckets> counts_;
+  uint32_t num_buckets_{0};
+  uint64_t sample_count_{0};
+  histogram_t* overflow_{nullptr};
+  bool overflowed_{false};
+};
+
 class HistogramImplHelper : public MetricImpl<Histogram> {
 public:
   HistogramImplHelper(StatName name, StatName tag_extracted_name,
@@ -88,7 +88,13 @@ public:
   explicit MetricImpl(SymbolTable& symbol_table)
       : MetricImpl(StatName(), StatName(), StatNameTagVector(), symbol_table) {}
 
-  TagVector tags() const override { return helper_.tags(constSymbolTable()); }
+  TagVector tags() const override {
+    const SymbolTable& symbol_table = constSymbolTable();
+    if (symbol_table.renderedNameCache().enabled()) {
+      return renderedNames(symbol_table)->tags_;
+    }
+    return helper_.tags(symbol_table);
+  }
   StatName statName() const override { return helper_.statName(); }
   StatName tagExtractedStatName() const override { return helper_.tagExtractedStatName(); }
   void iterateTagStatNames(const Metric::TagStatNameIterFn& fn) const override {
@@ -105,15 +111,40 @@ public:
     // provide const and non-const variants of a method.
     return const_cast<MetricImpl*>(this)->symbolTable();
   }
-  std::string name() const override { return constSymbolTable().toString(this->statName()); }
+  std::string name() const override {
+    const SymbolTable& symbol_table = constSymbolTable();
+    if (symbol_table.renderedNameCache().enabled()) {
+      return renderedNames(symbol_table)->name_;
+    }
+    return symbol_table.toString(this->statName());
+  }
   std::string tagExtractedName() const override {
-    return constSymbolTable().toString(this->tagExtractedStatName());
+    const SymbolTable& symbol_table = constSymbolTable();
+    if (symbol_table.renderedNameCache().enabled()) {
+      return renderedNames(symbol_table)->tag_extracted_name_;
+    }
+    return symbol_table.toString(this->tagExtractedStatName());
   }
 
 protected:
-  void clear(SymbolTable& symbol_table) { helper_.clear(symbol_table); }
+  void clear(SymbolTable& symbol_table) {
+    // The cache is keyed by address, so the entry must go before another
+    // metric can be allocated in our place.
+    symbol_table.renderedNameCache().erase(this);
+    helper_.clear(symbol_table);
+  }
 
 private:
+  // Returns the names of this metric from the SymbolTable's rendered-name
+  // cache, decoding them on first use.
+  RenderedNameCache::NamesConstSharedPtr renderedNames(const SymbolTable& symbol_table) const {
+    return symbol_table.renderedNameCache().find(this, [this, &symbol_table]() {
+      return RenderedNameCache::Names{symbol_table.toString(this->statName()),
+                                      symbol_table.toString(this->tagExtractedStatName()),
+                                      helper_.tags(symbol_table)};
+    });
+  }
+
   MetricHelper helper_;
 };
 
@@ -0,0 +1,85 @@
+#include "source/common/stats/rendered_name_cache.h"
+
+#include "source/common/common/lock_guard.h"
+
+#include "absl/hash/hash.h"
+
+namespace Envoy {
+namespace Stats {
+
+void RenderedNameCache::setEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+  if (!enabled) {
+    clear();
+  }
+}
+
+RenderedNameCache::Shard& RenderedNameCache::shardFor(const void* key) {
+  return shards_[absl::Hash<const void*>()(key) % NumShards];
+}
+
+RenderedNameCache::NamesConstSharedPtr RenderedNameCache::find(const void* key,
+                                                                const RenderFn& render) {
+  Shard& shard = shardFor(key);
+  {
+    Thread::LockGuard lock(shard.lock_);
+    auto iter = shard.map_.find(key);
+    if (iter != shard.map_.end()) {
+      return iter->second;
+    }
+  }
+
+  // Render without holding the shard lock, as rendering takes the SymbolTable
+  // lock. If another thread renders the same metric concurrently, the first
+  // one to insert wins and the other copy is dropped.
+  NamesConstSharedPtr names = std::make_shared<const Names>(render());
+  Thread::LockGuard lock(shard.lock_);
+  auto insertion = shard.map_.try_emplace(key, names);
+  if (insertion.second) {
+    size_.fetch_add(1, std::memory_order_relaxed);
+    memory_bytes_.fetch_add(bytesForNames(*names), std::memory_order_relaxed);
+  }
+  return insertion.first->second;
+}
+
+void RenderedNameCache::erase(const void* key) {
+  // Metrics are destroyed far more often than the cache is enabled, so avoid
+  // taking a shard lock when there is nothing to erase.
+  if (size() == 0) {
+    return;
+  }
+  Shard& shard = shardFor(key);
+  Thread::LockGuard lock(shard.lock_);
+  auto iter = shard.map_.find(key);
+  if (iter != shard.map_.end()) {
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    memory_bytes_.fetch_sub(bytesForNames(*iter->second), std::memory_order_relaxed);
+    shard.map_.erase(iter);
+  }
+}
+
+void RenderedNameCache::clear() {
+  for (Shard& shard : shards_) {
+    Thread::LockGuard lock(shard.lock_);
+    for (const auto& entry : shard.map_) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      memory_bytes_.fetch_sub(bytesForNames(*entry.second), std::memory_order_relaxed);
+    }
+    shard.map_.clear();
+  }
+}
+
+uint64_t RenderedNameCache::bytesForNames(const Names& names) {
+  // The map slot, and the Names object with the shared_ptr control block it is
+  // allocated with by make_shared.
+  uint64_t bytes = sizeof(const void*) + sizeof(NamesConstSharedPtr) + sizeof(Names) +
+                   2 * sizeof(void*) + names.name_.capacity() +
+                   names.tag_extracted_name_.capacity() + names.tags_.capacity() * sizeof(Tag);
+  for (const Tag& tag : names.tags_) {
+    bytes += tag.name_.capacity() + tag.value_.capacity();
+  }
+  return bytes;
+}
+
+} // namespace Stats
+} // namespace Envoy
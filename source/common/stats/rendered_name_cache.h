@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "envoy/stats/tag.h"
+
+#include "source/common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Holds the rendered forms of metric names -- the full name, the tag-extracted
+ * name and the tags -- so that sinks and admin handlers which ask for them on
+ * every flush need not decode the same StatNames, under the SymbolTable lock,
+ * each time.
+ *
+ * Entries are keyed by the address of the metric, populated lazily on first
+ * lookup, and live until the metric erases them on destruction. As a metric's
+ * names never change over its lifetime, no other invalidation is needed.
+ *
+ * The cache is sharded by key, so that lookups of different metrics from
+ * different threads rarely contend. It is disabled by default, in which case
+ * callers are expected to render the names directly.
+ */
+class RenderedNameCache {
+public:
+  struct Names {
+    std::string name_;
+    std::string tag_extracted_name_;
+    TagVector tags_;
+  };
+  using NamesConstSharedPtr = std::shared_ptr<const Names>;
+  using RenderFn = std::function<Names()>;
+
+  /**
+   * Enables or disables the cache. Disabling it drops all entries.
+   *
+   * @param enabled whether lookups should be cached.
+   */
+  void setEnabled(bool enabled);
+
+  /**
+   * @return whether lookups should be cached.
+   */
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * Finds the names for a metric, rendering and caching them on first lookup.
+   *
+   * @param key the address of the metric.
+   * @param render called to render the names if they are not cached.
+   * @return the cached names.
+   */
+  NamesConstSharedPtr find(const void* key, const RenderFn& render);
+
+  /**
+   * Drops the names for a metric, if cached. This must be called when a metric
+   * is destroyed, as another metric may later be allocated at the same address.
+   *
+   * @param key the address of the metric.
+   */
+  void erase(const void* key);
+
+  /**
+   * @return the number of metrics with cached names.
+   */
+  uint64_t size() const { return size_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return an estimate of the bytes held by cached names, including the strings
+   *         they own and the per-entry overhead of the cache itself.
+   */
+  uint64_t memoryBytes() const { return memory_bytes_.load(std::memory_order_relaxed); }
+
+  static uint64_t bytesForNames(const Names& names);
+
+private:
+  static constexpr uint32_t NumShards = 16;
+
+  struct Shard {
+    mutable Thread::MutexBasicLockable lock_;
+    absl::flat_hash_map<const void*, NamesConstSharedPtr> map_ ABSL_GUARDED_BY(lock_);
+  };
+
+  Shard& shardFor(const void* key);
+  void clear();
+
+  std::array<Shard, NumShards> shards_;
+  std::atomic<bool> enabled_{false};
+  std::atomic<uint64_t> size_{0};
+  std::atomic<uint64_t> memory_bytes_{0};
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -13,6 +13,7 @@
 #include "source/common/common/thread.h"
 #include "source/common/common/utility.h"
 #include "source/common/stats/recent_lookups.h"
+#include "source/common/stats/rendered_name_cache.h"
 
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
@@ -311,6 +312,12 @@ public:
    */
   uint64_t recentLookupCapacity() const;
 
+  /**
+   * @return The cache of rendered metric names for metrics using this table.
+   *         It is internally synchronized, so is mutable via a const table.
+   */
+  RenderedNameCache& renderedNameCache() const { return rendered_name_cache_; }
+
   /**
    * Identifies the dynamic components of a stat_name into an array of integer
    * pairs, indicating the begin/end of spans of tokens in the stat-name that
@@ -475,6 +482,7 @@ private:
   // using an Envoy::IntervalSet.
   std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
   RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+  mutable RenderedNameCache rendered_name_cache_;
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
@@ -556,8 +556,13 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatNameWithTags(
   return safeMakeStat<Counter>(
       final_stat_name, joiner.tagExtractedName(), stat_name_tags, central_cache->counters_,
       fast_reject_result, central_cache->rejected_stats_,
-      [](Allocator& allocator, StatName name, StatName tag_extracted_name,
-         const StatNameTagVector& tags) -> CounterSharedPtr {
+      [this](Allocator& allocator, StatName name, StatName tag_extracted_name,
+             const StatNameTagVector& tags) -> CounterSharedPtr {
+        const ShardedCounterMatcher& sharded_counter_matcher = parent_.sharded_counter_matcher_;
+        if (sharded_counter_matcher != nullptr &&
+            sharded_counter_matcher(symbolTable().toString(name))) {
+          return allocator.makeShardedCounter(name, tag_extracted_name, tags);
+        }
         return allocator.makeCounter(name, tag_extracted_name, tags);
       },
       tls_cache, tls_rejected_stats, parent_.null_counter_);
@@ -803,27 +808,18 @@ ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Uni
                                                    const StatNameTagVector& stat_name_tags,
                                                    SymbolTable& symbol_table)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
-      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {
-  histograms_[0] = hist_alloc();
-  histograms_[1] = hist_alloc();
-}
+      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {}
 
-ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
-  MetricImpl::clear(symbol_table_);
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
-}
+ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() { MetricImpl::clear(symbol_table_); }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  histograms_[current_active_].recordValue(value);
   used_ = true;
 }
 
-void ThreadLocalHistogramImpl::merge(histogram_t* target) {
-  histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
-  hist_accumulate(target, other_histogram, 1);
-  hist_clear(*other_histogram);
+uint64_t ThreadLocalHistogramImpl::merge(histogram_t* target) {
+  return histograms_[otherHistogramIndex()].mergeAndClear(target);
 }
 
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
@@ -911,19 +907,30 @@ bool ParentHistogramImpl::hidden() const { return false; }
 void ParentHistogramImpl::merge() {
   Thread::ReleasableLockGuard lock(merge_lock_);
   if (merged_ || usedLockHeld()) {
-    hist_clear(interval_histogram_);
+    if (!interval_empty_) {
+      hist_clear(interval_histogram_);
+    }
     // Here we could copy all the pointers to TLS histograms in the tls_histogram_ list,
     // then release the lock before we do the actual merge. However it is not a big deal
     // because the tls_histogram merge is not that expensive as it is a single histogram
-    // merge and adding TLS histograms is rare.
+    // merge and adding TLS histograms is rare. A TLS histogram which recorded nothing since the
+    // last merge adds nothing.
+    uint64_t merged_samples = 0;
     for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
-      tls_histogram->merge(interval_histogram_);
+      merged_samples += tls_histogram->merge(interval_histogram_);
     }
     // Since TLS merge is done, we can release the lock here.
     lock.release();
-    hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
-    cumulative_statistics_.refresh(cumulative_histogram_);
+    if (merged_ && interval_empty_ && merged_samples == 0) {
+      // Neither the interval nor the cumulative histogram changed since the last merge.
+      return;
+    }
+    if (merged_samples > 0 || !merged_) {
+      hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
+      cumulative_statistics_.refresh(cumulative_histogram_);
+    }
     interval_statistics_.refresh(interval_histogram_);
+    interval_empty_ = merged_samples == 0;
     merged_ = true;
   }
 }
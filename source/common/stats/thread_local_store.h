@@ -28,8 +28,8 @@ namespace Stats {
 
 /**
  * A histogram that is stored in TLS and used to record values per thread. This holds two
- * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * compact histograms, one to collect the values and other as backup that is used for merge
+ * process. The swap happens during the merge process.
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
@@ -37,7 +37,12 @@ public:
                            const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table);
   ~ThreadLocalHistogramImpl() override;
 
-  void merge(histogram_t* target);
+  /**
+   * Adds the values recorded before the last beginMerge() to a histogram.
+   * @param target the histogram to add the values to.
+   * @return the number of values added, which is zero if the histogram was not touched.
+   */
+  uint64_t merge(histogram_t* target);
 
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
@@ -66,7 +71,7 @@ private:
   Histogram::Unit unit_;
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_{0};
-  histogram_t* histograms_[2];
+  CompactHistogram histograms_[2];
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -141,6 +146,9 @@ private:
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ ABSL_GUARDED_BY(merge_lock_);
   bool merged_{false};
+  // Whether interval_histogram_ is known to hold no values, in which case a merge that collects
+  // nothing from the TLS histograms leaves both statistics unchanged and can skip refreshing them.
+  bool interval_empty_{true};
   std::atomic<bool> shutting_down_{false};
   std::atomic<uint32_t> ref_count_{0};
   const uint64_t id_; // Index into TlsCache::histogram_cache_.
@@ -191,6 +199,9 @@ public:
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
   void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) override;
+  void setShardedCounterMatcher(ShardedCounterMatcher&& matcher) override {
+    sharded_counter_matcher_ = std::move(matcher);
+  }
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
@@ -517,6 +528,7 @@ private:
   TagProducerPtr tag_producer_;
   StatsMatcherPtr stats_matcher_;
   HistogramSettingsConstPtr histogram_settings_;
+  ShardedCounterMatcher sharded_counter_matcher_;
   std::atomic<bool> threading_ever_initialized_{};
   std::atomic<bool> shutting_down_{};
   std::atomic<bool> merge_in_progress_{};
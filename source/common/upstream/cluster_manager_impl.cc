@@ -1,10 +1,12 @@
 #include "source/common/upstream/cluster_manager_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "envoy/admin/v3/config_dump.pb.h"
@@ -55,6 +57,10 @@ namespace Envoy {
 namespace Upstream {
 namespace {
 
+// Building the initial load balancers is CPU bound; more threads than this would mostly compete
+// with the main thread, which is still initializing clusters.
+constexpr uint32_t MaxLoadBalancerBuildThreads = 8;
+
 void addOptionsIfNotNull(Network::Socket::OptionsSharedPtr& options,
                          const Network::Socket::OptionsSharedPtr& to_add) {
   if (to_add != nullptr) {
@@ -332,6 +338,11 @@ ClusterManagerImpl::ClusterManagerImpl(
   }
   async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
       *this, tls, context, grpc_context.statNames(), bootstrap.grpc_async_client_manager_config());
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.parallel_initial_lb_build")) {
+    lb_build_pool_ = std::make_unique<LoadBalancerBuildPoolImpl>(
+        api.threadFactory(),
+        std::clamp<uint32_t>(std::thread::hardware_concurrency(), 1, MaxLoadBalancerBuildThreads));
+  }
   const auto& cm_config = bootstrap.cluster_manager();
   if (cm_config.has_outlier_detection()) {
     const std::string event_log_file_path = cm_config.outlier_detection().event_log_path();
@@ -587,6 +598,17 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::generateStats(Stats::Scope& s
   return {ALL_THREAD_LOCAL_CLUSTER_MANAGER_STATS(POOL_GAUGE_PREFIX(scope, final_prefix))};
 }
 
+void ClusterManagerImpl::setInitializedCb(InitializationCompleteCallback callback) {
+  init_helper_.setInitializedCb([this, callback = std::move(callback)]() {
+    // The initial load balancers built on the pool are waited for once, here, rather than by each
+    // load balancer on first use, so that workers never wait for them.
+    if (lb_build_pool_ != nullptr) {
+      lb_build_pool_->wait();
+    }
+    callback();
+  });
+}
+
 void ClusterManagerImpl::onClusterInit(ClusterManagerCluster& cm_cluster) {
   // This routine is called when a cluster has finished initializing. The cluster has not yet
   // been setup for cross-thread updates to avoid needless updates during initialization. The order
@@ -604,7 +626,17 @@ void ClusterManagerImpl::onClusterInit(ClusterManagerCluster& cm_cluster) {
   cluster_data = active_clusters_.find(cluster.info()->name());
 
   if (cluster_data->second->thread_aware_lb_ != nullptr) {
-    THROW_IF_NOT_OK(cluster_data->second->thread_aware_lb_->initialize());
+    // While the server is starting, the main thread initializes clusters one after another and
+    // workers do not serve traffic yet, so the initial load balancer of each cluster is built on
+    // the pool meanwhile, and setInitializedCb() waits for all of them at once. Later on, it is
+    // built here so that workers never wait for it.
+    if (lb_build_pool_ != nullptr &&
+        init_helper_.state() != ClusterManagerInitHelper::State::AllClustersInitialized) {
+      THROW_IF_NOT_OK(
+          cluster_data->second->thread_aware_lb_->initializeWithBuildPool(*lb_build_pool_));
+    } else {
+      THROW_IF_NOT_OK(cluster_data->second->thread_aware_lb_->initialize());
+    }
   }
 
   // Now setup for cross-thread updates.
@@ -37,6 +37,7 @@
 #include "source/common/tcp/async_tcp_client_impl.h"
 #include "source/common/upstream/cluster_discovery_manager.h"
 #include "source/common/upstream/host_utility.h"
+#include "source/common/upstream/load_balancer_build_pool.h"
 #include "source/common/upstream/load_stats_reporter.h"
 #include "source/common/upstream/od_cds_api_impl.h"
 #include "source/common/upstream/priority_conn_pool_map.h"
@@ -260,9 +261,7 @@ public:
     init_helper_.setPrimaryClustersInitializedCb(callback);
   }
 
-  void setInitializedCb(InitializationCompleteCallback callback) override {
-    init_helper_.setInitializedCb(callback);
-  }
+  void setInitializedCb(InitializationCompleteCallback callback) override;
 
   ClusterInfoMaps clusters() const override {
     ClusterInfoMaps clusters_maps;
@@ -925,6 +924,10 @@ private:
   std::unique_ptr<Config::XdsResourcesDelegate> xds_resources_delegate_;
   std::unique_ptr<Config::XdsConfigTracker> xds_config_tracker_;
 
+  // Builds the initial state of thread aware load balancers while the server is starting. Null
+  // when envoy.reloadable_features.parallel_initial_lb_build is disabled.
+  std::unique_ptr<LoadBalancerBuildPoolImpl> lb_build_pool_;
+
   bool initialized_{};
   bool ads_mux_initialized_{};
   std::atomic<bool> shutdown_{};
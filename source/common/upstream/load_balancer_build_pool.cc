@@ -0,0 +1,76 @@
+#include "source/common/upstream/load_balancer_build_pool.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+LoadBalancerBuildPoolImpl::LoadBalancerBuildPoolImpl(Thread::ThreadFactory& thread_factory,
+                                                     uint32_t max_threads)
+    : thread_factory_(thread_factory), max_threads_(max_threads) {
+  ASSERT(max_threads_ > 0);
+}
+
+LoadBalancerBuildPoolImpl::~LoadBalancerBuildPoolImpl() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopping_ = true;
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void LoadBalancerBuildPoolImpl::post(std::function<void()> task) {
+  bool start_thread;
+  {
+    absl::MutexLock lock(&mutex_);
+    ASSERT(!stopping_);
+    tasks_.push_back(std::move(task));
+    // A thread which is idle will pick the task up; otherwise start another one if we may.
+    start_thread = tasks_.size() > idle_threads_ && threads_.size() < max_threads_;
+  }
+  if (start_thread) {
+    threads_.push_back(thread_factory_.createThread([this]() { runTasks(); },
+                                                    Thread::Options{"lb_build"}));
+  }
+}
+
+void LoadBalancerBuildPoolImpl::wait() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return tasks_.empty() && running_tasks_ == 0;
+  };
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(&condition));
+}
+
+void LoadBalancerBuildPoolImpl::runTasks() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !tasks_.empty() || stopping_;
+  };
+  bool ran_task = false;
+  while (true) {
+    std::function<void()> task;
+    {
+      absl::MutexLock lock(&mutex_);
+      // The previous task, including whatever it captured, is gone by now.
+      if (ran_task) {
+        --running_tasks_;
+      }
+      ++idle_threads_;
+      mutex_.Await(absl::Condition(&condition));
+      --idle_threads_;
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      ++running_tasks_;
+    }
+    task();
+    ran_task = true;
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
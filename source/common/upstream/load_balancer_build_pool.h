@@ -0,0 +1,53 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "envoy/thread/thread.h"
+#include "envoy/upstream/load_balancer.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * A LoadBalancerBuildPool which starts its threads as tasks are posted, up to a maximum, so that a
+ * process with no expensive load balancers to build starts none. Tasks which are still queued when
+ * the pool is destroyed are run before its threads exit.
+ */
+class LoadBalancerBuildPoolImpl : public LoadBalancerBuildPool {
+public:
+  LoadBalancerBuildPoolImpl(Thread::ThreadFactory& thread_factory, uint32_t max_threads);
+  ~LoadBalancerBuildPoolImpl() override;
+
+  // Upstream::LoadBalancerBuildPool
+  void post(std::function<void()> task) override;
+
+  /**
+   * Waits until every task posted so far has run.
+   */
+  void wait();
+
+  /**
+   * @return the number of threads started so far.
+   */
+  size_t threads() const { return threads_.size(); }
+
+private:
+  void runTasks();
+
+  Thread::ThreadFactory& thread_factory_;
+  const uint32_t max_threads_;
+  absl::Mutex mutex_;
+  std::deque<std::function<void()>> tasks_ ABSL_GUARDED_BY(mutex_);
+  uint32_t idle_threads_ ABSL_GUARDED_BY(mutex_){};
+  uint32_t running_tasks_ ABSL_GUARDED_BY(mutex_){};
+  bool stopping_ ABSL_GUARDED_BY(mutex_){};
+  // Only used by the thread which posts tasks.
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
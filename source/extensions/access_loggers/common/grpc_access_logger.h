@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 
 #include "envoy/config/core/v3/config_source.pb.h"
@@ -110,10 +111,16 @@ public:
       : client_(std::move(client)), buffer_flush_interval_msec_(PROTOBUF_GET_MS_OR_DEFAULT(
                                         config, buffer_flush_interval, 1000)),
         flush_timer_(dispatcher.createTimer([this]() {
-          flush();
+          onFlushTimer();
           flush_timer_->enableTimer(buffer_flush_interval_msec_);
         })),
-        max_buffer_size_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384)) {
+        min_buffer_size_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384)),
+        max_buffer_size_bytes_(std::max<uint64_t>(
+            min_buffer_size_bytes_,
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_buffer_size_bytes, 0))),
+        max_pending_buffer_bytes_(
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_pending_buffer_bytes, 0)),
+        buffer_size_bytes_(min_buffer_size_bytes_) {
     flush_timer_->enableTimer(buffer_flush_interval_msec_);
     if (access_log_prefix.has_value()) {
       stats_ = std::make_unique<GrpcAccessLoggerStats>(GrpcAccessLoggerStats{
@@ -123,23 +130,37 @@ public:
 
   void log(HttpLogProto&& entry) override {
     if (!canLogMore()) {
+      incLogsDroppedStats();
       return;
     }
+    incLogsWrittenStats();
     approximate_message_size_bytes_ += entry.ByteSizeLong();
     addEntry(std::move(entry));
-    if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
-      flush();
+    if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
+      flushFullBatch();
     }
   }
 
   void log(TcpLogProto&& entry) override {
+    // TCP entries are not counted in logs_written, but they are dropped and counted in logs_dropped
+    // like HTTP entries when too many are pending.
+    if (!canLogMore()) {
+      incLogsDroppedStats();
+      return;
+    }
     approximate_message_size_bytes_ += entry.ByteSizeLong();
     addEntry(std::move(entry));
-    if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
-      flush();
+    if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
+      flushFullBatch();
     }
   }
 
+  /**
+   * @return the current batch size limit in bytes, which adapts to the log rate between
+   * buffer_size_bytes and max_buffer_size_bytes.
+   */
+  uint64_t bufferSizeBytes() const { return buffer_size_bytes_; }
+
 protected:
   std::unique_ptr<GrpcAccessLogClient<LogRequest, LogResponse>> client_;
   LogRequest message_;
@@ -168,26 +189,37 @@ private:
     }
   }
 
-  // `canLogMore()` is only for streaming gRPC client only which could run into
-  // AboveWriteBufferHighWatermark during `flush()` so that we tracks the log entries dropped caused
-  // by that.
-  //
-  // For unary gRPC client, `canLogMore` always returns True[1][2] so `stats_` here is meaningless.
-  //
-  // [1]https://github.com/envoyproxy/envoy/blob/cd5ef906026160ec2cd766d8d18217e668c256d8/source/extensions/access_loggers/common/grpc_access_logger.h#L287.
-  // [2]https://github.com/envoyproxy/envoy/blob/cd5ef906026160ec2cd766d8d18217e668c256d8/source/extensions/access_loggers/common/grpc_access_logger.h#L126
-  bool canLogMore() {
-    if (max_buffer_size_bytes_ == 0 || approximate_message_size_bytes_ < max_buffer_size_bytes_) {
-      incLogsWrittenStats();
-      return true;
+  // A batch which fills up before the flush interval elapses means the log rate is high, so the
+  // next batches are allowed to grow, up to max_buffer_size_bytes, to send fewer, larger messages.
+  void flushFullBatch() {
+    flush();
+    if (approximate_message_size_bytes_ == 0) {
+      buffer_size_bytes_ = std::min(max_buffer_size_bytes_, buffer_size_bytes_ * 2);
+    }
+  }
+
+  // A batch which is less than half full when the flush interval elapses means the log rate has
+  // dropped, so the batch size shrinks back towards buffer_size_bytes.
+  void onFlushTimer() {
+    if (approximate_message_size_bytes_ < buffer_size_bytes_ / 2) {
+      buffer_size_bytes_ = std::max(min_buffer_size_bytes_, buffer_size_bytes_ / 2);
     }
     flush();
-    if (approximate_message_size_bytes_ < max_buffer_size_bytes_) {
-      incLogsWrittenStats();
+  }
+
+  // Entries stay buffered while the client can't send them, which only happens with the streaming
+  // gRPC client when the stream is above its write buffer high watermark; the unary client always
+  // sends. `canLogMore()` bounds the buffered entries to max_pending_buffer_bytes, or the batch
+  // size if that isn't set, trying to flush before giving up on the entry.
+  bool canLogMore() {
+    const uint64_t limit = max_pending_buffer_bytes_ != 0
+                               ? std::max(max_pending_buffer_bytes_, buffer_size_bytes_)
+                               : buffer_size_bytes_;
+    if (limit == 0 || approximate_message_size_bytes_ < limit) {
       return true;
     }
-    incLogsDroppedStats();
-    return false;
+    flush();
+    return approximate_message_size_bytes_ < limit;
   }
 
   void incLogsDroppedStats() {
@@ -204,7 +236,10 @@ private:
 
   const std::chrono::milliseconds buffer_flush_interval_msec_;
   const Event::TimerPtr flush_timer_;
+  const uint64_t min_buffer_size_bytes_;
   const uint64_t max_buffer_size_bytes_;
+  const uint64_t max_pending_buffer_bytes_;
+  uint64_t buffer_size_bytes_;
   uint64_t approximate_message_size_bytes_ = 0;
   std::unique_ptr<GrpcAccessLoggerStats> stats_ = nullptr;
 };
@@ -0,0 +1,320 @@
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+#include "source/extensions/common/async_files/async_file_context_base.h"
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+#include "source/extensions/common/async_files/mapped_file_range.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+// Accessors shared by the ring and synchronous actions on a file.
+template <typename Base> class FileActionIoUring : public Base {
+public:
+  template <typename T>
+  FileActionIoUring(AsyncFileHandle handle, std::function<void(T)> on_complete)
+      : Base(on_complete), handle_(std::move(handle)) {}
+
+protected:
+  int& fileDescriptor() { return context()->fileDescriptor(); }
+  AsyncFileContextIoUring* context() const {
+    return static_cast<AsyncFileContextIoUring*>(handle_.get());
+  }
+
+  Api::OsSysCalls& posix() const {
+    return static_cast<AsyncFileManagerIoUring&>(context()->manager()).posix();
+  }
+
+  AsyncFileHandle handle_;
+};
+
+// An action submitted to the ring.
+template <typename T>
+using AsyncFileActionIoUringContext = FileActionIoUring<AsyncFileActionIoUringWithResult<T>>;
+
+// An action performed synchronously on the ring thread.
+template <typename T>
+using AsyncFileActionSyncContext = FileActionIoUring<AsyncFileActionWithResult<T>>;
+
+class ActionStat : public AsyncFileActionIoUringContext<absl::StatusOr<struct stat>> {
+public:
+  ActionStat(AsyncFileHandle handle, std::function<void(absl::StatusOr<struct stat>)> on_complete)
+      : AsyncFileActionIoUringContext<absl::StatusOr<struct stat>>(handle, on_complete) {}
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    ASSERT(fileDescriptor() != -1);
+    io_uring_prep_statx(sqe, fileDescriptor(), "", AT_EMPTY_PATH, STATX_BASIC_STATS,
+                        &statx_result_);
+  }
+
+  absl::StatusOr<struct stat> resultImpl(int32_t result) override {
+    if (result < 0) {
+      return statusAfterFileError(-result);
+    }
+    return statFromStatx(statx_result_);
+  }
+
+private:
+  struct statx statx_result_ {};
+};
+
+class ActionCreateHardLink : public AsyncFileActionIoUringContext<absl::Status> {
+public:
+  ActionCreateHardLink(AsyncFileHandle handle, absl::string_view filename,
+                       std::function<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUringContext<absl::Status>(handle, on_complete), filename_(filename) {}
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    ASSERT(fileDescriptor() != -1);
+    procfile_ = absl::StrCat("/proc/self/fd/", fileDescriptor());
+    io_uring_prep_linkat(sqe, AT_FDCWD, procfile_.c_str(), AT_FDCWD, filename_.c_str(),
+                         AT_SYMLINK_FOLLOW);
+  }
+
+  absl::Status resultImpl(int32_t result) override {
+    if (result < 0) {
+      return statusAfterFileError(-result);
+    }
+    return absl::OkStatus();
+  }
+
+  void onCancelledBeforeCallback(absl::Status result) override {
+    if (result.ok()) {
+      posix().unlink(filename_.c_str());
+    }
+  }
+
+private:
+  const std::string filename_;
+  std::string procfile_;
+};
+
+class ActionCloseFile : public AsyncFileActionIoUringContext<absl::Status> {
+public:
+  // Here we take a copy of the AsyncFileContext's file descriptor, because the close function
+  // sets the AsyncFileContext's file descriptor to -1. This way there will be no race of trying
+  // to use the handle again while the close is in flight.
+  explicit ActionCloseFile(AsyncFileHandle handle, std::function<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUringContext<absl::Status>(handle, on_complete),
+        file_descriptor_(fileDescriptor()) {}
+
+  void prepare(struct io_uring_sqe* sqe) override { io_uring_prep_close(sqe, file_descriptor_); }
+
+  absl::Status resultImpl(int32_t result) override {
+    if (result < 0) {
+      return statusAfterFileError(-result);
+    }
+    return absl::OkStatus();
+  }
+
+private:
+  const int file_descriptor_;
+};
+
+class ActionReadFile : public AsyncFileActionIoUringContext<absl::StatusOr<Buffer::InstancePtr>> {
+public:
+  ActionReadFile(AsyncFileHandle handle, off_t offset, size_t length,
+                 std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : AsyncFileActionIoUringContext<absl::StatusOr<Buffer::InstancePtr>>(handle, on_complete),
+        offset_(offset), length_(length) {}
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    ASSERT(fileDescriptor() != -1);
+    reservation_.emplace(buffer_->reserveSingleSlice(length_));
+    io_uring_prep_read(sqe, fileDescriptor(), reservation_->slice().mem_, length_, offset_);
+  }
+
+  absl::StatusOr<Buffer::InstancePtr> resultImpl(int32_t result) override {
+    if (result < 0) {
+      return statusAfterFileError(-result);
+    }
+    if (static_cast<size_t>(result) != length_) {
+      return std::make_unique<Buffer::OwnedImpl>(reservation_->slice().mem_, result);
+    }
+    reservation_->commit(result);
+    return std::move(buffer_);
+  }
+
+private:
+  const off_t offset_;
+  const size_t length_;
+  std::unique_ptr<Buffer::OwnedImpl> buffer_ = std::make_unique<Buffer::OwnedImpl>();
+  absl::optional<Buffer::ReservationSingleSlice> reservation_;
+};
+
+class ActionReadMappedFile
+    : public AsyncFileActionSyncContext<absl::StatusOr<Buffer::InstancePtr>> {
+public:
+  ActionReadMappedFile(AsyncFileHandle handle, off_t offset, size_t length,
+                       std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : AsyncFileActionSyncContext<absl::StatusOr<Buffer::InstancePtr>>(handle, on_complete),
+        offset_(offset), length_(length) {}
+
+  absl::StatusOr<Buffer::InstancePtr> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    return readMappedFileRange(posix(), fileDescriptor(), offset_, length_);
+  }
+
+private:
+  const off_t offset_;
+  const size_t length_;
+};
+
+class ActionWriteFile : public AsyncFileActionIoUringContext<absl::StatusOr<size_t>> {
+public:
+  ActionWriteFile(AsyncFileHandle handle, Buffer::Instance& contents, off_t offset,
+                  std::function<void(absl::StatusOr<size_t>)> on_complete)
+      : AsyncFileActionIoUringContext<absl::StatusOr<size_t>>(handle, on_complete),
+        offset_(offset) {
+    contents_.move(contents);
+  }
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    ASSERT(fileDescriptor() != -1);
+    // A single writev can take at most IOV_MAX slices; any beyond that are written by
+    // resultImpl along with any remainder of a short write.
+    Buffer::RawSliceVector slices = contents_.getRawSlices(IOV_MAX);
+    iovecs_.reserve(slices.size());
+    for (const Buffer::RawSlice& slice : slices) {
+      iovecs_.push_back({slice.mem_, slice.len_});
+    }
+    io_uring_prep_writev(sqe, fileDescriptor(), iovecs_.data(),
+                         static_cast<unsigned>(iovecs_.size()), offset_);
+  }
+
+  absl::StatusOr<size_t> resultImpl(int32_t result) override {
+    if (result < 0) {
+      return statusAfterFileError(-result);
+    }
+    // Writes to regular files are only short in unusual circumstances (e.g. a full disk), so
+    // the rest is written synchronously rather than resubmitted.
+    size_t total_bytes_written = result;
+    contents_.drain(total_bytes_written);
+    for (const Buffer::RawSlice& slice : contents_.getRawSlices()) {
+      size_t slice_bytes_written = 0;
+      while (slice_bytes_written < slice.len_) {
+        auto bytes_just_written =
+            posix().pwrite(fileDescriptor(), static_cast<char*>(slice.mem_) + slice_bytes_written,
+                           slice.len_ - slice_bytes_written, offset_ + total_bytes_written);
+        if (bytes_just_written.return_value_ == -1) {
+          return statusAfterFileError(bytes_just_written);
+        }
+        slice_bytes_written += bytes_just_written.return_value_;
+        total_bytes_written += bytes_just_written.return_value_;
+      }
+    }
+    return total_bytes_written;
+  }
+
+private:
+  Buffer::OwnedImpl contents_;
+  const off_t offset_;
+  std::vector<struct iovec> iovecs_;
+};
+
+class ActionDuplicateFile : public AsyncFileActionSyncContext<absl::StatusOr<AsyncFileHandle>> {
+public:
+  ActionDuplicateFile(AsyncFileHandle handle,
+                      std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : AsyncFileActionSyncContext<absl::StatusOr<AsyncFileHandle>>(handle, on_complete) {}
+
+  absl::StatusOr<AsyncFileHandle> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    auto newfd = posix().duplicate(fileDescriptor());
+    if (newfd.return_value_ == -1) {
+      return statusAfterFileError(newfd);
+    }
+    return std::make_shared<AsyncFileContextIoUring>(context()->manager(), newfd.return_value_);
+  }
+
+  void onCancelledBeforeCallback(absl::StatusOr<AsyncFileHandle> result) override {
+    if (result.ok()) {
+      result.value()->close([](absl::Status) {}).IgnoreError();
+    }
+  }
+};
+
+} // namespace
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::stat(std::function<void(absl::StatusOr<struct stat>)> on_complete) {
+  return checkFileAndEnqueue(std::make_shared<ActionStat>(handle(), std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::createHardLink(absl::string_view filename,
+                                        std::function<void(absl::Status)> on_complete) {
+  return checkFileAndEnqueue(
+      std::make_shared<ActionCreateHardLink>(handle(), filename, std::move(on_complete)));
+}
+
+absl::Status AsyncFileContextIoUring::close(std::function<void(absl::Status)> on_complete) {
+  auto status =
+      checkFileAndEnqueue(std::make_shared<ActionCloseFile>(handle(), std::move(on_complete)))
+          .status();
+  fileDescriptor() = -1;
+  return status;
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::read(
+    off_t offset, size_t length,
+    std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return checkFileAndEnqueue(
+      std::make_shared<ActionReadFile>(handle(), offset, length, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::readMapped(
+    off_t offset, size_t length,
+    std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return checkFileAndEnqueue(
+      std::make_shared<ActionReadMappedFile>(handle(), offset, length, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::write(Buffer::Instance& contents, off_t offset,
+                               std::function<void(absl::StatusOr<size_t>)> on_complete) {
+  return checkFileAndEnqueue(
+      std::make_shared<ActionWriteFile>(handle(), contents, offset, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::duplicate(
+    std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return checkFileAndEnqueue(
+      std::make_shared<ActionDuplicateFile>(handle(), std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::checkFileAndEnqueue(std::shared_ptr<AsyncFileAction> action) {
+  if (fileDescriptor() == -1) {
+    return absl::FailedPreconditionError("file was already closed");
+  }
+  return enqueue(action);
+}
+
+AsyncFileContextIoUring::AsyncFileContextIoUring(AsyncFileManager& manager, int fd)
+    : AsyncFileContextBase(manager), file_descriptor_(fd) {}
+
+AsyncFileContextIoUring::~AsyncFileContextIoUring() { ASSERT(file_descriptor_ == -1); }
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -10,6 +10,7 @@
 #include "source/extensions/common/async_files/async_file_action.h"
 #include "source/extensions/common/async_files/async_file_context_base.h"
 #include "source/extensions/common/async_files/async_file_manager_thread_pool.h"
+#include "source/extensions/common/async_files/mapped_file_range.h"
 #include "source/extensions/common/async_files/status_after_file_error.h"
 
 namespace Envoy {
@@ -130,6 +131,24 @@ private:
   const size_t length_;
 };
 
+class ActionReadMappedFile
+    : public AsyncFileActionThreadPool<absl::StatusOr<Buffer::InstancePtr>> {
+public:
+  ActionReadMappedFile(AsyncFileHandle handle, off_t offset, size_t length,
+                       std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : AsyncFileActionThreadPool<absl::StatusOr<Buffer::InstancePtr>>(handle, on_complete),
+        offset_(offset), length_(length) {}
+
+  absl::StatusOr<Buffer::InstancePtr> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    return readMappedFileRange(posix(), fileDescriptor(), offset_, length_);
+  }
+
+private:
+  const off_t offset_;
+  const size_t length_;
+};
+
 class ActionWriteFile : public AsyncFileActionThreadPool<absl::StatusOr<size_t>> {
 public:
   ActionWriteFile(AsyncFileHandle handle, Buffer::Instance& contents, off_t offset,
@@ -214,6 +233,13 @@ absl::StatusOr<CancelFunction> AsyncFileContextThreadPool::read(
       std::make_shared<ActionReadFile>(handle(), offset, length, std::move(on_complete)));
 }
 
+absl::StatusOr<CancelFunction> AsyncFileContextThreadPool::readMapped(
+    off_t offset, size_t length,
+    std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return checkFileAndEnqueue(
+      std::make_shared<ActionReadMappedFile>(handle(), offset, length, std::move(on_complete)));
+}
+
 absl::StatusOr<CancelFunction>
 AsyncFileContextThreadPool::write(Buffer::Instance& contents, off_t offset,
                                   std::function<void(absl::StatusOr<size_t>)> on_complete) {
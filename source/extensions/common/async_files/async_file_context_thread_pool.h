@@ -31,6 +31,9 @@ public:
   read(off_t offset, size_t length,
        std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) override;
   absl::StatusOr<CancelFunction>
+  readMapped(off_t offset, size_t length,
+             std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) override;
+  absl::StatusOr<CancelFunction>
   write(Buffer::Instance& contents, off_t offset,
         std::function<void(absl::StatusOr<size_t>)> on_complete) override;
   absl::StatusOr<CancelFunction>
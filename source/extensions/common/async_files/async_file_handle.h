@@ -48,6 +48,15 @@ public:
   read(off_t offset, size_t length,
        std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) PURE;
 
+  // Like read, but rather than copying the requested range into the buffer passed to
+  // on_complete, maps it into memory and passes a buffer whose data references the mapping.
+  // This spares a copy through user space when the data is only going to be forwarded, e.g.
+  // written to a socket. The mapping is released when the buffer's data is drained, which may
+  // be after the file is closed. The file must not be truncated while the mapping is in use.
+  virtual absl::StatusOr<CancelFunction>
+  readMapped(off_t offset, size_t length,
+             std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) PURE;
+
   // Enqueues an action to write to the currently open file, at position offset, the bytes contained
   // by contents. It is an error to call write on an AsyncFileContext that does not have a file
   // open.
@@ -0,0 +1,397 @@
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "source/extensions/common/async_files/async_file_action.h"
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+// The ring size used if the config leaves it unset.
+constexpr uint32_t DefaultIoUringSize = 256;
+
+// ThreadRingManager is set on each manager's ring thread to that manager, and is null on all
+// other threads. If an action is enqueued from a callback it can go straight into the
+// manager's pending actions, which chains it without locking or waking the ring thread.
+thread_local const AsyncFileManagerIoUring* ThreadRingManager = nullptr;
+
+// The io_uring operations used by this manager and its file contexts.
+constexpr int RequiredOpcodes[] = {IORING_OP_NOP,    IORING_OP_READ,  IORING_OP_WRITEV,
+                                   IORING_OP_OPENAT, IORING_OP_CLOSE, IORING_OP_STATX,
+                                   IORING_OP_UNLINKAT, IORING_OP_LINKAT};
+
+bool supportsRequiredOpcodes(struct io_uring* ring) {
+  struct io_uring_probe* probe = io_uring_get_probe_ring(ring);
+  if (probe == nullptr) {
+    return false;
+  }
+  bool supported = true;
+  for (int opcode : RequiredOpcodes) {
+    supported = supported && io_uring_opcode_supported(probe, opcode);
+  }
+  io_uring_free_probe(probe);
+  return supported;
+}
+} // namespace
+
+struct stat statFromStatx(const struct statx& statx_result) {
+  struct stat ret {};
+  ret.st_dev = makedev(statx_result.stx_dev_major, statx_result.stx_dev_minor);
+  ret.st_ino = statx_result.stx_ino;
+  ret.st_mode = statx_result.stx_mode;
+  ret.st_nlink = statx_result.stx_nlink;
+  ret.st_uid = statx_result.stx_uid;
+  ret.st_gid = statx_result.stx_gid;
+  ret.st_rdev = makedev(statx_result.stx_rdev_major, statx_result.stx_rdev_minor);
+  ret.st_size = statx_result.stx_size;
+  ret.st_blksize = statx_result.stx_blksize;
+  ret.st_blocks = statx_result.stx_blocks;
+  ret.st_atim.tv_sec = statx_result.stx_atime.tv_sec;
+  ret.st_atim.tv_nsec = statx_result.stx_atime.tv_nsec;
+  ret.st_mtim.tv_sec = statx_result.stx_mtime.tv_sec;
+  ret.st_mtim.tv_nsec = statx_result.stx_mtime.tv_nsec;
+  ret.st_ctim.tv_sec = statx_result.stx_ctime.tv_sec;
+  ret.st_ctim.tv_nsec = statx_result.stx_ctime.tv_nsec;
+  return ret;
+}
+
+AsyncFileManagerIoUring::AsyncFileManagerIoUring(
+    const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+    Api::OsSysCalls& posix)
+    : io_uring_size_(config.io_uring().io_uring_size() == 0 ? DefaultIoUringSize
+                                                             : config.io_uring().io_uring_size()),
+      posix_(posix) {
+  if (!posix.supportsAllPosixFileOperations()) {
+    throw EnvoyException("AsyncFileManagerIoUring not supported");
+  }
+  int ret = io_uring_queue_init(io_uring_size_, &ring_, 0);
+  if (ret != 0) {
+    throw EnvoyException(
+        fmt::format("AsyncFileManagerIoUring not supported: {}", errorDetails(-ret)));
+  }
+  if (!supportsRequiredOpcodes(&ring_)) {
+    io_uring_queue_exit(&ring_);
+    throw EnvoyException("AsyncFileManagerIoUring not supported: kernel lacks file operations");
+  }
+  wakeup_fd_ = eventfd(0, EFD_CLOEXEC);
+  RELEASE_ASSERT(wakeup_fd_ != -1,
+                 fmt::format("unable to create eventfd: {}", errorDetails(errno)));
+  ENVOY_LOG(info, fmt::format("AsyncFileManagerIoUring created with id '{}', with ring size {}",
+                              config.id(), io_uring_size_));
+  thread_ = std::thread([this]() { worker(); });
+}
+
+AsyncFileManagerIoUring::~AsyncFileManagerIoUring() ABSL_LOCKS_EXCLUDED(queue_mutex_) {
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    terminate_ = true;
+  }
+  eventfd_write(wakeup_fd_, 1);
+  thread_.join();
+  io_uring_queue_exit(&ring_);
+  ::close(wakeup_fd_);
+}
+
+std::string AsyncFileManagerIoUring::describe() const {
+  return absl::StrCat("io_uring_size = ", io_uring_size_);
+}
+
+CancelFunction AsyncFileManagerIoUring::enqueue(std::shared_ptr<AsyncFileAction> action) {
+  auto cancel_func = [action]() { action->cancel(); };
+  if (ThreadRingManager == this) {
+    pending_.push_back(std::move(action));
+    return cancel_func;
+  }
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    queue_.push_back(std::move(action));
+  }
+  eventfd_write(wakeup_fd_, 1);
+  return cancel_func;
+}
+
+void AsyncFileManagerIoUring::worker() {
+  ThreadRingManager = this;
+  prepareWakeupRead();
+  bool terminating = false;
+  while (true) {
+    if (!terminating && !takeQueuedActions()) {
+      terminating = true;
+    }
+    if (terminating) {
+      // As with the thread pool, actions which have not started are dropped on termination,
+      // but those already submitted must complete before the buffers they use are released.
+      pending_.clear();
+      if (in_flight_ == 0) {
+        return;
+      }
+    }
+    preparePendingActions();
+    int ret = io_uring_submit_and_wait(&ring_, 1);
+    RELEASE_ASSERT(ret >= 0 || ret == -EINTR || ret == -EBUSY,
+                   fmt::format("unable to submit io_uring queue entries: {}", errorDetails(-ret)));
+    struct io_uring_cqe* cqe;
+    unsigned head;
+    unsigned count = 0;
+    io_uring_for_each_cqe(&ring_, head, cqe) {
+      ++count;
+      auto* action =
+          static_cast<std::shared_ptr<AsyncFileActionIoUring>*>(io_uring_cqe_get_data(cqe));
+      if (action == nullptr) {
+        // The wakeup read completed; there may be new actions in the queue.
+        if (!terminating) {
+          prepareWakeupRead();
+        }
+        continue;
+      }
+      --in_flight_;
+      (*action)->complete(cqe->res);
+      delete action;
+    }
+    io_uring_cq_advance(&ring_, count);
+  }
+}
+
+bool AsyncFileManagerIoUring::takeQueuedActions() {
+  absl::MutexLock lock(&queue_mutex_);
+  if (terminate_) {
+    return false;
+  }
+  while (!queue_.empty()) {
+    pending_.push_back(std::move(queue_.front()));
+    queue_.pop_front();
+  }
+  return true;
+}
+
+void AsyncFileManagerIoUring::preparePendingActions() {
+  // One entry is always held back for the wakeup read.
+  while (!pending_.empty() && in_flight_ + 1 < io_uring_size_) {
+    std::shared_ptr<AsyncFileAction> action = std::move(pending_.front());
+    pending_.pop_front();
+    auto ring_action = std::dynamic_pointer_cast<AsyncFileActionIoUring>(action);
+    if (ring_action == nullptr) {
+      // Actions with no io_uring equivalent are performed synchronously.
+      action->execute();
+      continue;
+    }
+    if (!ring_action->start()) {
+      continue;
+    }
+    struct io_uring_sqe* sqe = getSqe();
+    ring_action->prepare(sqe);
+    // The completion holds a reference to the action, so that anything the kernel reads or
+    // writes stays alive even if the action is cancelled and its other owners let go.
+    io_uring_sqe_set_data(sqe,
+                          new std::shared_ptr<AsyncFileActionIoUring>(std::move(ring_action)));
+    ++in_flight_;
+  }
+}
+
+void AsyncFileManagerIoUring::prepareWakeupRead() {
+  struct io_uring_sqe* sqe = getSqe();
+  io_uring_prep_read(sqe, wakeup_fd_, &wakeup_value_, sizeof(wakeup_value_), 0);
+  io_uring_sqe_set_data(sqe, nullptr);
+}
+
+struct io_uring_sqe* AsyncFileManagerIoUring::getSqe() {
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    // The submission queue is full of prepared entries; hand them to the kernel to make room.
+    io_uring_submit(&ring_);
+    sqe = io_uring_get_sqe(&ring_);
+  }
+  RELEASE_ASSERT(sqe != nullptr, "unable to get io_uring submission queue entry");
+  return sqe;
+}
+
+namespace {
+
+class ActionWithFileResult
+    : public AsyncFileActionIoUringWithResult<absl::StatusOr<AsyncFileHandle>> {
+public:
+  ActionWithFileResult(AsyncFileManagerIoUring& manager,
+                       std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : AsyncFileActionIoUringWithResult(on_complete), manager_(manager) {}
+
+protected:
+  void onCancelledBeforeCallback(absl::StatusOr<AsyncFileHandle> result) override {
+    if (result.ok()) {
+      result.value()->close([](absl::Status) {}).IgnoreError();
+    }
+  }
+  absl::StatusOr<AsyncFileHandle> handleFromResult(int32_t result) {
+    if (result < 0) {
+      return statusAfterFileError(-result);
+    }
+    return std::make_shared<AsyncFileContextIoUring>(manager_, result);
+  }
+  AsyncFileManagerIoUring& manager_;
+  Api::OsSysCalls& posix() { return manager_.posix(); }
+};
+
+class ActionCreateAnonymousFile : public ActionWithFileResult {
+public:
+  ActionCreateAnonymousFile(AsyncFileManagerIoUring& manager, absl::string_view path,
+                            std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : ActionWithFileResult(manager, on_complete), path_(path) {}
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    tried_o_tmpfile_ = manager_.supports_o_tmpfile_;
+    if (tried_o_tmpfile_) {
+      io_uring_prep_openat(sqe, AT_FDCWD, path_.c_str(), O_TMPFILE | O_RDWR, S_IRUSR | S_IWUSR);
+    } else {
+      io_uring_prep_nop(sqe);
+    }
+  }
+
+  absl::StatusOr<AsyncFileHandle> resultImpl(int32_t result) override {
+    if (tried_o_tmpfile_) {
+      if (result >= 0 || (result != -EOPNOTSUPP && result != -EISDIR && result != -EINVAL)) {
+        return handleFromResult(result);
+      }
+      // The filesystem does not support O_TMPFILE; don't try it again.
+      manager_.supports_o_tmpfile_ = false;
+    }
+    // Fall back to creating a named file and unlinking it. This is rare enough that it is
+    // done synchronously, as the thread pool does.
+    char filename[4096];
+    static const char file_suffix[] = "/buffer.XXXXXX";
+    if (path_.size() + sizeof(file_suffix) > sizeof(filename)) {
+      return absl::InvalidArgumentError(
+          "AsyncFileManagerIoUring::createAnonymousFile: pathname too long for tmpfile");
+    }
+    snprintf(filename, sizeof(filename), "%s%s", path_.c_str(), file_suffix);
+    Api::SysCallIntResult open_result = posix().mkstemp(filename);
+    if (open_result.return_value_ == -1) {
+      return statusAfterFileError(open_result);
+    }
+    if (posix().unlink(filename).return_value_ != 0) {
+      posix().close(open_result.return_value_);
+      posix().unlink(filename);
+      return absl::UnimplementedError("AsyncFileManagerIoUring::createAnonymousFile: not "
+                                      "supported for target filesystem (failed to unlink an "
+                                      "open file)");
+    }
+    return handleFromResult(open_result.return_value_);
+  }
+
+private:
+  const std::string path_;
+  bool tried_o_tmpfile_{false};
+};
+
+class ActionOpenExistingFile : public ActionWithFileResult {
+public:
+  ActionOpenExistingFile(AsyncFileManagerIoUring& manager, absl::string_view filename,
+                         AsyncFileManager::Mode mode,
+                         std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : ActionWithFileResult(manager, on_complete), filename_(filename), mode_(mode) {}
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    io_uring_prep_openat(sqe, AT_FDCWD, filename_.c_str(), openFlags(), 0);
+  }
+
+  absl::StatusOr<AsyncFileHandle> resultImpl(int32_t result) override {
+    return handleFromResult(result);
+  }
+
+private:
+  int openFlags() const {
+    switch (mode_) {
+    case AsyncFileManager::Mode::ReadOnly:
+      return O_RDONLY;
+    case AsyncFileManager::Mode::WriteOnly:
+      return O_WRONLY;
+    case AsyncFileManager::Mode::ReadWrite:
+      return O_RDWR;
+    }
+    PANIC_DUE_TO_CORRUPT_ENUM;
+  }
+  const std::string filename_;
+  const AsyncFileManager::Mode mode_;
+};
+
+class ActionStat : public AsyncFileActionIoUringWithResult<absl::StatusOr<struct stat>> {
+public:
+  ActionStat(absl::string_view filename,
+             std::function<void(absl::StatusOr<struct stat>)> on_complete)
+      : AsyncFileActionIoUringWithResult(on_complete), filename_(filename) {}
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    io_uring_prep_statx(sqe, AT_FDCWD, filename_.c_str(), 0, STATX_BASIC_STATS, &statx_result_);
+  }
+
+  absl::StatusOr<struct stat> resultImpl(int32_t result) override {
+    if (result < 0) {
+      return statusAfterFileError(-result);
+    }
+    return statFromStatx(statx_result_);
+  }
+
+private:
+  const std::string filename_;
+  struct statx statx_result_ {};
+};
+
+class ActionUnlink : public AsyncFileActionIoUringWithResult<absl::Status> {
+public:
+  ActionUnlink(absl::string_view filename, std::function<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUringWithResult(on_complete), filename_(filename) {}
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    io_uring_prep_unlinkat(sqe, AT_FDCWD, filename_.c_str(), 0);
+  }
+
+  absl::Status resultImpl(int32_t result) override {
+    if (result < 0) {
+      return statusAfterFileError(-result);
+    }
+    return absl::OkStatus();
+  }
+
+private:
+  const std::string filename_;
+};
+
+} // namespace
+
+CancelFunction AsyncFileManagerIoUring::createAnonymousFile(
+    absl::string_view path, std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return enqueue(std::make_shared<ActionCreateAnonymousFile>(*this, path, on_complete));
+}
+
+CancelFunction AsyncFileManagerIoUring::openExistingFile(
+    absl::string_view filename, Mode mode,
+    std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return enqueue(std::make_shared<ActionOpenExistingFile>(*this, filename, mode, on_complete));
+}
+
+CancelFunction
+AsyncFileManagerIoUring::stat(absl::string_view filename,
+                              std::function<void(absl::StatusOr<struct stat>)> on_complete) {
+  return enqueue(std::make_shared<ActionStat>(filename, on_complete));
+}
+
+CancelFunction AsyncFileManagerIoUring::unlink(absl::string_view filename,
+                                               std::function<void(absl::Status)> on_complete) {
+  return enqueue(std::make_shared<ActionUnlink>(filename, on_complete));
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
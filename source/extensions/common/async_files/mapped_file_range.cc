@@ -0,0 +1,56 @@
+#include "source/extensions/common/async_files/mapped_file_range.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+absl::StatusOr<Buffer::InstancePtr> readMappedFileRange(Api::OsSysCalls& posix, int fd,
+                                                        off_t offset, size_t length) {
+  auto result = std::make_unique<Buffer::OwnedImpl>();
+  // Touching a mapped page beyond the end of the file raises SIGBUS, so the length is
+  // clamped to the file size, which also gives the same short result as pread.
+  struct stat stat_result;
+  auto stat_status = posix.fstat(fd, &stat_result);
+  if (stat_status.return_value_ != 0) {
+    return statusAfterFileError(stat_status);
+  }
+  if (offset >= stat_result.st_size || length == 0) {
+    return result;
+  }
+  length = std::min<size_t>(length, stat_result.st_size - offset);
+  // The offset passed to mmap must be a multiple of the page size.
+  static const off_t page_size = sysconf(_SC_PAGESIZE);
+  const off_t map_offset = offset - (offset % page_size);
+  const size_t map_length = length + (offset - map_offset);
+  auto mapped = posix.mmap(nullptr, map_length, PROT_READ, MAP_SHARED, fd, map_offset);
+  if (mapped.return_value_ == MAP_FAILED) {
+    return statusAfterFileError(mapped);
+  }
+  void* const map_start = mapped.return_value_;
+  // The mapping outlives the file descriptor; it is released once the last reference to
+  // the returned data is drained.
+  auto fragment = new Buffer::BufferFragmentImpl(
+      static_cast<const char*>(map_start) + (offset - map_offset), length,
+      [map_start, map_length](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+        ::munmap(map_start, map_length);
+        delete fragment;
+      });
+  result->addBufferFragment(*fragment);
+  return result;
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/buffer/buffer.h"
+
+#include "absl/status/statusor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+// Maps up to length bytes of the open file fd, starting at offset, and returns a buffer whose
+// data references the mapping. The range is clamped to the size of the file, so reading past
+// the end gives a short (or empty) buffer rather than a mapping that faults when touched.
+// The mapping is released when the buffer's data is drained, which may be on any thread.
+absl::StatusOr<Buffer::InstancePtr> readMappedFileRange(Api::OsSysCalls& posix, int fd,
+                                                        off_t offset, size_t length);
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
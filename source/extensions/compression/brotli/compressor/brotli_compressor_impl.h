@@ -1,5 +1,8 @@
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include "envoy/compression/compressor/compressor.h"
 
 #include "source/extensions/compression/brotli/common/base.h"
@@ -12,6 +15,28 @@ namespace Compression {
 namespace Brotli {
 namespace Compressor {
 
+/**
+ * A raw shared dictionary prepared for the encoder, which can be attached to any number of
+ * encoders. The encoders read the dictionary data, so it is kept alongside.
+ */
+class PreparedDictionary : NonCopyable {
+public:
+  /**
+   * @param data the raw dictionary.
+   * @param quality the highest quality the dictionary is used at.
+   */
+  PreparedDictionary(std::string&& data, uint32_t quality);
+  ~PreparedDictionary();
+
+  const BrotliEncoderPreparedDictionary* get() const { return prepared_; }
+
+private:
+  const std::string data_;
+  BrotliEncoderPreparedDictionary* prepared_;
+};
+
+using PreparedDictionarySharedPtr = std::shared_ptr<const PreparedDictionary>;
+
 /**
  * Implementation of compressor's interface.
  */
@@ -44,10 +69,12 @@ public:
    * feature. This flag is a "decoding-speed vs compression ratio" trade-off.
    * @param mode tunes encoder for specific input. @see EncoderMode enum.
    * @param chunk_size amount of memory reserved for the compressor output.
+   * @param dictionary a shared dictionary to compress with, or nullptr.
    */
   BrotliCompressorImpl(const uint32_t quality, const uint32_t window_bits,
                        const uint32_t input_block_bits, const bool disable_literal_context_modeling,
-                       const EncoderMode mode, const uint32_t chunk_size);
+                       const EncoderMode mode, const uint32_t chunk_size,
+                       PreparedDictionarySharedPtr dictionary = nullptr);
 
   // Compression::Compressor::Compressor
   void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
@@ -57,6 +84,8 @@ private:
                const BrotliEncoderOperation op);
 
   const uint32_t chunk_size_;
+  // Outlives the encoder, which refers to it.
+  const PreparedDictionarySharedPtr dictionary_;
   std::unique_ptr<BrotliEncoderState, decltype(&BrotliEncoderDestroyInstance)> state_;
 };
 
@@ -1,5 +1,7 @@
 #include "source/extensions/compression/brotli/compressor/config.h"
 
+#include "source/common/config/datasource.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Compression {
@@ -7,19 +9,26 @@ namespace Brotli {
 namespace Compressor {
 
 BrotliCompressorFactory::BrotliCompressorFactory(
-    const envoy::extensions::compression::brotli::compressor::v3::Brotli& brotli)
+    const envoy::extensions::compression::brotli::compressor::v3::Brotli& brotli, Api::Api& api)
     : chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(brotli, chunk_size, DefaultChunkSize)),
       disable_literal_context_modeling_(brotli.disable_literal_context_modeling()),
       encoder_mode_(encoderModeEnum(brotli.encoder_mode())),
       input_block_bits_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(brotli, input_block_bits, DefaultInputBlockBits)),
       quality_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(brotli, quality, DefaultQuality)),
-      window_bits_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(brotli, window_bits, DefaultWindowBits)) {}
+      window_bits_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(brotli, window_bits, DefaultWindowBits)) {
+  if (brotli.has_dictionary()) {
+    dictionary_ = std::make_shared<const PreparedDictionary>(
+        THROW_OR_RETURN_VALUE(Config::DataSource::read(brotli.dictionary(), false, api),
+                              std::string),
+        quality_);
+  }
+}
 
 Envoy::Compression::Compressor::CompressorPtr BrotliCompressorFactory::createCompressor() {
   return std::make_unique<BrotliCompressorImpl>(quality_, window_bits_, input_block_bits_,
                                                 disable_literal_context_modeling_, encoder_mode_,
-                                                chunk_size_);
+                                                chunk_size_, dictionary_);
 }
 
 BrotliCompressorImpl::EncoderMode BrotliCompressorFactory::encoderModeEnum(
@@ -39,8 +48,9 @@ BrotliCompressorImpl::EncoderMode BrotliCompressorFactory::encoderModeEnum(
 Envoy::Compression::Compressor::CompressorFactoryPtr
 BrotliCompressorLibraryFactory::createCompressorFactoryFromProtoTyped(
     const envoy::extensions::compression::brotli::compressor::v3::Brotli& proto_config,
-    Server::Configuration::FactoryContext&) {
-  return std::make_unique<BrotliCompressorFactory>(proto_config);
+    Server::Configuration::FactoryContext& context) {
+  return std::make_unique<BrotliCompressorFactory>(proto_config,
+                                                   context.serverFactoryContext().api());
 }
 
 /**
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include "envoy/compression/decompressor/decompressor.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
@@ -37,9 +40,11 @@ public:
    * @param disable_ring_buffer_reallocation if true disables "canny" ring buffer allocation
    * strategy. Ring buffer is allocated according to window size, despite the real size of the
    * content.
+   * @param dictionary the raw shared dictionary the content was compressed with, or nullptr.
    */
   BrotliDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix,
-                         const uint32_t chunk_size, bool disable_ring_buffer_reallocation);
+                         const uint32_t chunk_size, bool disable_ring_buffer_reallocation,
+                         std::shared_ptr<const std::string> dictionary = nullptr);
 
   // Envoy::Compression::Decompressor::Decompressor
   void decompress(const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) override;
@@ -53,6 +58,8 @@ private:
   bool process(Common::BrotliContext& ctx, Buffer::Instance& output_buffer);
 
   const uint32_t chunk_size_;
+  // Outlives the decoder, which refers to it.
+  const std::shared_ptr<const std::string> dictionary_;
   std::unique_ptr<BrotliDecoderState, decltype(&BrotliDecoderDestroyInstance)> state_;
   const BrotliDecompressorStats stats_;
 };
@@ -10,6 +10,13 @@ Base::Base(uint64_t chunk_size, std::function<void(z_stream*)> zstream_deleter)
     : chunk_size_{chunk_size}, chunk_char_ptr_(new unsigned char[chunk_size]),
       zstream_ptr_(new z_stream(), zstream_deleter) {}
 
+Base::Base(uint64_t chunk_size, z_stream* zstream, std::function<void(z_stream*)> zstream_deleter)
+    : chunk_size_{chunk_size}, initialized_{true}, chunk_char_ptr_(new unsigned char[chunk_size]),
+      zstream_ptr_(zstream, std::move(zstream_deleter)) {
+  zstream_ptr_->avail_out = chunk_size_;
+  zstream_ptr_->next_out = chunk_char_ptr_.get();
+}
+
 uint64_t Base::checksum() { return zstream_ptr_->adler; }
 
 void Base::updateOutput(Buffer::Instance& output_buffer) {
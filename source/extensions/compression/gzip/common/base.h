@@ -19,6 +19,11 @@ class Base {
 public:
   Base(uint64_t chunk_size, std::function<void(z_stream*)> zstream_deleter);
 
+  /**
+   * Uses a stream which has already been initialized, e.g. one taken from a ZStreamPool.
+   */
+  Base(uint64_t chunk_size, z_stream* zstream, std::function<void(z_stream*)> zstream_deleter);
+
   /**
    * It returns the checksum of all output produced so far. Compressor's checksum at the end of
    * the stream has to match decompressor's checksum produced at the end of the decompression.
@@ -0,0 +1,131 @@
+#include "source/extensions/compression/gzip/common/zstream_pool.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Gzip {
+namespace Common {
+
+namespace {
+
+// The window size bits without the gzip (+16) or automatic header detection (+32) flags. Zero
+// means the window size of the stream's header, which may be the maximum.
+uint64_t windowSizeBits(int64_t window_bits) {
+  const int64_t bits = window_bits & 0xf;
+  return bits == 0 ? MAX_WBITS : bits;
+}
+
+// The memory used by the stream state itself, besides its window and hash tables.
+constexpr uint64_t StreamStateBytes = 8 * 1024;
+
+} // namespace
+
+ZStreamPool::ZStreamPool(ThreadLocal::SlotAllocator& tls, Server::OverloadManager& overload_manager,
+                         Stats::Scope& scope, const std::string& stats_prefix,
+                         uint64_t stream_bytes, Initializer initializer, Resetter resetter,
+                         Finalizer finalizer, uint64_t max_retained_bytes_per_thread)
+    : tls_(ThreadLocal::TypedSlot<ThreadLocalStreams>::makeUnique(tls)),
+      overload_manager_(overload_manager),
+      stats_{ALL_ZSTREAM_POOL_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix),
+                                    POOL_GAUGE_PREFIX(scope, stats_prefix))},
+      stream_bytes_(std::max<uint64_t>(stream_bytes, 1)),
+      max_pooled_streams_per_thread_(max_retained_bytes_per_thread / stream_bytes_),
+      initializer_(std::move(initializer)), resetter_(resetter), finalizer_(finalizer) {
+  tls_->set([finalizer](Event::Dispatcher&) {
+    return std::make_shared<ThreadLocalStreams>(finalizer);
+  });
+}
+
+ZStreamPool::~ZStreamPool() {
+  // Streams still pooled on the workers are freed along with their thread local storage.
+  stats_.retained_bytes_.sub(retained_streams_.load() * stream_bytes_);
+}
+
+ZStreamPool::ThreadLocalStreams::~ThreadLocalStreams() {
+  for (z_stream* stream : streams_) {
+    finalizer_(stream);
+    delete stream;
+  }
+}
+
+z_stream* ZStreamPool::acquire() {
+  OptRef<ThreadLocalStreams> streams = tls_->get();
+  if (streams.has_value() && !streams->streams_.empty()) {
+    z_stream* stream = streams->streams_.back();
+    streams->streams_.pop_back();
+    stats_.hits_.inc();
+    subRetained(1);
+    return stream;
+  }
+  stats_.misses_.inc();
+  z_stream* stream = new z_stream();
+  initializer_(*stream);
+  return stream;
+}
+
+void ZStreamPool::release(z_stream* stream) {
+  OptRef<ThreadLocalStreams> streams = tls_->get();
+  if (!streams.has_value()) {
+    free(stream);
+    return;
+  }
+  if (shrinkRequested()) {
+    free(stream);
+    for (z_stream* pooled : streams->streams_) {
+      free(pooled);
+    }
+    subRetained(streams->streams_.size());
+    streams->streams_.clear();
+    return;
+  }
+  if (streams->streams_.size() >= max_pooled_streams_per_thread_ || resetter_(stream) != Z_OK) {
+    free(stream);
+    return;
+  }
+  streams->streams_.push_back(stream);
+  addRetained(1);
+}
+
+void ZStreamPool::addRetained(uint64_t streams) {
+  retained_streams_ += streams;
+  stats_.retained_bytes_.add(streams * stream_bytes_);
+}
+
+void ZStreamPool::subRetained(uint64_t streams) {
+  retained_streams_ -= streams;
+  stats_.retained_bytes_.sub(streams * stream_bytes_);
+}
+
+size_t ZStreamPool::pooledStreams() const {
+  OptRef<ThreadLocalStreams> streams = tls_->get();
+  return streams.has_value() ? streams->streams_.size() : 0;
+}
+
+void ZStreamPool::free(z_stream* stream) {
+  stats_.discarded_.inc();
+  finalizer_(stream);
+  delete stream;
+}
+
+bool ZStreamPool::shrinkRequested() {
+  return overload_manager_.getThreadLocalOverloadState()
+      .getState(Server::OverloadActionNames::get().ShrinkHeap)
+      .isSaturated();
+}
+
+uint64_t ZStreamPool::deflateStreamBytes(int64_t window_bits, uint64_t memory_level) {
+  return (1ULL << (windowSizeBits(window_bits) + 2)) + (1ULL << (memory_level + 9)) +
+         StreamStateBytes;
+}
+
+uint64_t ZStreamPool::inflateStreamBytes(int64_t window_bits) {
+  return (1ULL << windowSizeBits(window_bits)) + StreamStateBytes;
+}
+
+} // namespace Common
+} // namespace Gzip
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "envoy/server/overload/overload_manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "zlib.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Gzip {
+namespace Common {
+
+/**
+ * All zlib stream pool stats. @see stats_macros.h
+ */
+#define ALL_ZSTREAM_POOL_STATS(COUNTER, GAUGE)                                                     \
+  COUNTER(hits)                                                                                    \
+  COUNTER(misses)                                                                                  \
+  COUNTER(discarded)                                                                               \
+  GAUGE(retained_bytes, Accumulate)
+
+/**
+ * Struct definition for zlib stream pool stats. @see stats_macros.h
+ */
+struct ZStreamPoolStats {
+  ALL_ZSTREAM_POOL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A per-worker pool of initialized zlib streams, all with the same parameters. Initializing a
+ * stream allocates its window and, for deflate, its hash tables, which for small bodies costs more
+ * than compressing them. Streams released by a compressor or decompressor are reset, which keeps
+ * their memory, and handed to the next one created on the same worker.
+ *
+ * Each worker keeps at most maxRetainedBytesPerThread() of pooled streams, as estimated from the
+ * stream parameters; streams released beyond that are freed. While the shrink heap overload
+ * action is saturated, released streams are freed along with those already pooled on the worker.
+ *
+ * The pool must outlive the streams acquired from it.
+ */
+class ZStreamPool {
+public:
+  static constexpr uint64_t DefaultMaxRetainedBytesPerThread = 2 * 1024 * 1024;
+
+  // Initializes a new stream, e.g. with deflateInit2.
+  using Initializer = std::function<void(z_stream&)>;
+  // deflateReset or inflateReset.
+  using Resetter = int (*)(z_stream*);
+  // deflateEnd or inflateEnd.
+  using Finalizer = int (*)(z_stream*);
+
+  /**
+   * @param stream_bytes the estimated memory used by each stream.
+   */
+  ZStreamPool(ThreadLocal::SlotAllocator& tls, Server::OverloadManager& overload_manager,
+              Stats::Scope& scope, const std::string& stats_prefix, uint64_t stream_bytes,
+              Initializer initializer, Resetter resetter, Finalizer finalizer,
+              uint64_t max_retained_bytes_per_thread = DefaultMaxRetainedBytesPerThread);
+  ~ZStreamPool();
+
+  /**
+   * @return an initialized stream, which must be passed to release on the same worker.
+   */
+  z_stream* acquire();
+
+  /**
+   * Resets the stream and keeps it for reuse, or frees it.
+   * @param stream a stream returned by acquire.
+   */
+  void release(z_stream* stream);
+
+  /**
+   * @return the number of streams pooled on the calling thread.
+   */
+  size_t pooledStreams() const;
+
+  /**
+   * @return the estimated memory used by a stream of the given parameters, @see zconf.h.
+   */
+  static uint64_t deflateStreamBytes(int64_t window_bits, uint64_t memory_level);
+  static uint64_t inflateStreamBytes(int64_t window_bits);
+
+private:
+  struct ThreadLocalStreams : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalStreams(Finalizer finalizer) : finalizer_(finalizer) {}
+    ~ThreadLocalStreams() override;
+
+    const Finalizer finalizer_;
+    std::vector<z_stream*> streams_;
+  };
+
+  void free(z_stream* stream);
+  bool shrinkRequested();
+  void addRetained(uint64_t streams);
+  void subRetained(uint64_t streams);
+
+  ThreadLocal::TypedSlotPtr<ThreadLocalStreams> tls_;
+  Server::OverloadManager& overload_manager_;
+  ZStreamPoolStats stats_;
+  const uint64_t stream_bytes_;
+  const uint64_t max_pooled_streams_per_thread_;
+  const Initializer initializer_;
+  const Resetter resetter_;
+  const Finalizer finalizer_;
+  // The number of streams pooled on all workers, whose bytes are taken out of the retained_bytes
+  // gauge when the pool is destroyed. The thread local streams are freed after the pool, when the
+  // stats scope may already be gone, so they cannot do it themselves.
+  std::atomic<uint64_t> retained_streams_{0};
+};
+
+using ZStreamPoolPtr = std::unique_ptr<ZStreamPool>;
+
+} // namespace Common
+} // namespace Gzip
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -1,5 +1,7 @@
 #include "source/extensions/compression/gzip/compressor/config.h"
 
+#include "source/common/common/assert.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Compression {
@@ -15,6 +17,22 @@ GzipCompressorFactory::GzipCompressorFactory(
                    GzipHeaderValue),
       chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, chunk_size, DefaultChunkSize)) {}
 
+GzipCompressorFactory::GzipCompressorFactory(
+    const envoy::extensions::compression::gzip::compressor::v3::Gzip& gzip,
+    ThreadLocal::SlotAllocator& tls, Server::OverloadManager& overload_manager, Stats::Scope& scope)
+    : GzipCompressorFactory(gzip) {
+  stream_pool_ = std::make_unique<Common::ZStreamPool>(
+      tls, overload_manager, scope, "gzip.compressor_stream_pool.",
+      Common::ZStreamPool::deflateStreamBytes(window_bits_, memory_level_),
+      [this](z_stream& stream) {
+        const int result = deflateInit2(&stream, static_cast<int64_t>(compression_level_),
+                                        Z_DEFLATED, window_bits_, memory_level_,
+                                        static_cast<uint64_t>(compression_strategy_));
+        RELEASE_ASSERT(result >= 0, "");
+      },
+      &deflateReset, &deflateEnd);
+}
+
 ZlibCompressorImpl::CompressionLevel GzipCompressorFactory::compressionLevelEnum(
     envoy::extensions::compression::gzip::compressor::v3::Gzip::CompressionLevel
         compression_level) {
@@ -60,6 +78,9 @@ ZlibCompressorImpl::CompressionStrategy GzipCompressorFactory::compressionStrate
 }
 
 Envoy::Compression::Compressor::CompressorPtr GzipCompressorFactory::createCompressor() {
+  if (stream_pool_ != nullptr) {
+    return std::make_unique<ZlibCompressorImpl>(chunk_size_, *stream_pool_);
+  }
   auto compressor = std::make_unique<ZlibCompressorImpl>(chunk_size_);
   compressor->init(compression_level_, compression_strategy_, window_bits_, memory_level_);
   return compressor;
@@ -68,8 +89,10 @@ Envoy::Compression::Compressor::CompressorPtr GzipCompressorFactory::createCompr
 Envoy::Compression::Compressor::CompressorFactoryPtr
 GzipCompressorLibraryFactory::createCompressorFactoryFromProtoTyped(
     const envoy::extensions::compression::gzip::compressor::v3::Gzip& proto_config,
-    Server::Configuration::FactoryContext&) {
-  return std::make_unique<GzipCompressorFactory>(proto_config);
+    Server::Configuration::FactoryContext& context) {
+  auto& server_context = context.serverFactoryContext();
+  return std::make_unique<GzipCompressorFactory>(proto_config, server_context.threadLocal(),
+                                                 server_context.overloadManager(), context.scope());
 }
 
 /**
@@ -40,6 +40,14 @@ class GzipCompressorFactory : public Envoy::Compression::Compressor::CompressorF
 public:
   GzipCompressorFactory(const envoy::extensions::compression::gzip::compressor::v3::Gzip& gzip);
 
+  /**
+   * Constructor for a factory whose compressors take their streams from a per-worker pool.
+   * @see Common::ZStreamPool.
+   */
+  GzipCompressorFactory(const envoy::extensions::compression::gzip::compressor::v3::Gzip& gzip,
+                        ThreadLocal::SlotAllocator& tls, Server::OverloadManager& overload_manager,
+                        Stats::Scope& scope);
+
   // Envoy::Compression::Compressor::CompressorFactory
   Envoy::Compression::Compressor::CompressorPtr createCompressor() override;
   const std::string& statsPrefix() const override { return gzipStatsPrefix(); }
@@ -60,6 +68,7 @@ private:
   const int32_t memory_level_;
   const int32_t window_bits_;
   const uint32_t chunk_size_;
+  Common::ZStreamPoolPtr stream_pool_;
 };
 
 class GzipCompressorLibraryFactory
@@ -28,6 +28,9 @@ ZlibCompressorImpl::ZlibCompressorImpl(uint64_t chunk_size)
   zstream_ptr_->next_out = chunk_char_ptr_.get();
 }
 
+ZlibCompressorImpl::ZlibCompressorImpl(uint64_t chunk_size, Common::ZStreamPool& pool)
+    : Common::Base(chunk_size, pool.acquire(), [&pool](z_stream* z) { pool.release(z); }) {}
+
 void ZlibCompressorImpl::init(CompressionLevel comp_level, CompressionStrategy comp_strategy,
                               int64_t window_bits, uint64_t memory_level = 8) {
   ASSERT(initialized_ == false);
@@ -3,6 +3,7 @@
 #include "envoy/compression/compressor/compressor.h"
 
 #include "source/extensions/compression/gzip/common/base.h"
+#include "source/extensions/compression/gzip/common/zstream_pool.h"
 
 #include "zlib.h"
 
@@ -29,6 +30,14 @@ public:
    */
   ZlibCompressorImpl(uint64_t chunk_size);
 
+  /**
+   * Constructor for a compressor using a stream from a pool, which is already initialized and to
+   * which the stream returns when the compressor is destroyed. init must not be called.
+   * @param chunk_size amount of memory reserved for the compressor output.
+   * @param pool the pool of deflate streams, which must outlive the compressor.
+   */
+  ZlibCompressorImpl(uint64_t chunk_size, Common::ZStreamPool& pool);
+
   /**
    * Enum values used to set compression level during initialization.
    * best: gives best compression.
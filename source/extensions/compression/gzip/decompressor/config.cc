@@ -1,5 +1,7 @@
 #include "source/extensions/compression/gzip/decompressor/config.h"
 
+#include "source/common/common/assert.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Compression {
@@ -24,8 +26,26 @@ GzipDecompressorFactory::GzipDecompressorFactory(
       max_inflate_ratio_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, max_inflate_ratio, DefaultMaxInflateRatio)) {}
 
+GzipDecompressorFactory::GzipDecompressorFactory(
+    const envoy::extensions::compression::gzip::decompressor::v3::Gzip& gzip, Stats::Scope& scope,
+    ThreadLocal::SlotAllocator& tls, Server::OverloadManager& overload_manager)
+    : GzipDecompressorFactory(gzip, scope) {
+  stream_pool_ = std::make_unique<Common::ZStreamPool>(
+      tls, overload_manager, scope, "gzip.decompressor_stream_pool.",
+      Common::ZStreamPool::inflateStreamBytes(window_bits_),
+      [this](z_stream& stream) {
+        const int result = inflateInit2(&stream, window_bits_);
+        RELEASE_ASSERT(result >= 0, "");
+      },
+      &inflateReset, &inflateEnd);
+}
+
 Envoy::Compression::Decompressor::DecompressorPtr
 GzipDecompressorFactory::createDecompressor(const std::string& stats_prefix) {
+  if (stream_pool_ != nullptr) {
+    return std::make_unique<ZlibDecompressorImpl>(scope_, stats_prefix, chunk_size_,
+                                                  max_inflate_ratio_, *stream_pool_);
+  }
   auto decompressor =
       std::make_unique<ZlibDecompressorImpl>(scope_, stats_prefix, chunk_size_, max_inflate_ratio_);
   decompressor->init(window_bits_);
@@ -36,7 +56,10 @@ Envoy::Compression::Decompressor::DecompressorFactoryPtr
 GzipDecompressorLibraryFactory::createDecompressorFactoryFromProtoTyped(
     const envoy::extensions::compression::gzip::decompressor::v3::Gzip& proto_config,
     Server::Configuration::FactoryContext& context) {
-  return std::make_unique<GzipDecompressorFactory>(proto_config, context.scope());
+  auto& server_context = context.serverFactoryContext();
+  return std::make_unique<GzipDecompressorFactory>(proto_config, context.scope(),
+                                                   server_context.threadLocal(),
+                                                   server_context.overloadManager());
 }
 
 /**
@@ -27,6 +27,14 @@ public:
   GzipDecompressorFactory(const envoy::extensions::compression::gzip::decompressor::v3::Gzip& gzip,
                           Stats::Scope& scope);
 
+  /**
+   * Constructor for a factory whose decompressors take their streams from a per-worker pool.
+   * @see Common::ZStreamPool.
+   */
+  GzipDecompressorFactory(const envoy::extensions::compression::gzip::decompressor::v3::Gzip& gzip,
+                          Stats::Scope& scope, ThreadLocal::SlotAllocator& tls,
+                          Server::OverloadManager& overload_manager);
+
   // Envoy::Compression::Decompressor::DecompressorFactory
   Envoy::Compression::Decompressor::DecompressorPtr
   createDecompressor(const std::string& stats_prefix) override;
@@ -40,6 +48,7 @@ private:
   const int32_t window_bits_;
   const uint32_t chunk_size_;
   const uint64_t max_inflate_ratio_;
+  Common::ZStreamPoolPtr stream_pool_;
 };
 
 class GzipDecompressorLibraryFactory
@@ -32,6 +32,12 @@ ZlibDecompressorImpl::ZlibDecompressorImpl(Stats::Scope& scope, const std::strin
   zstream_ptr_->next_out = chunk_char_ptr_.get();
 }
 
+ZlibDecompressorImpl::ZlibDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix,
+                                           uint64_t chunk_size, uint64_t max_inflate_ratio,
+                                           Common::ZStreamPool& pool)
+    : Common::Base(chunk_size, pool.acquire(), [&pool](z_stream* z) { pool.release(z); }),
+      stats_(generateStats(stats_prefix, scope)), max_inflate_ratio_(max_inflate_ratio) {}
+
 void ZlibDecompressorImpl::init(int64_t window_bits) {
   ASSERT(initialized_ == false);
   const int result = inflateInit2(zstream_ptr_.get(), window_bits);
@@ -6,6 +6,7 @@
 
 #include "source/common/common/logger.h"
 #include "source/extensions/compression/gzip/common/base.h"
+#include "source/extensions/compression/gzip/common/zstream_pool.h"
 
 #include "zlib.h"
 
@@ -51,6 +52,14 @@ public:
   ZlibDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix, uint64_t chunk_size,
                        uint64_t max_inflate_ratio);
 
+  /**
+   * Constructor for a decompressor using a stream from a pool, which is already initialized and to
+   * which the stream returns when the decompressor is destroyed. init must not be called.
+   * @param pool the pool of inflate streams, which must outlive the decompressor.
+   */
+  ZlibDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix, uint64_t chunk_size,
+                       uint64_t max_inflate_ratio, Common::ZStreamPool& pool);
+
   /**
    * Init must be called in order to initialize the decompressor. Once decompressor is initialized,
    * it cannot be initialized again. Init should run before decompressing any data.
@@ -9,7 +9,8 @@ namespace Compressor {
 ZstdCompressorImpl::ZstdCompressorImpl(uint32_t compression_level, bool enable_checksum,
                                        uint32_t strategy, const ZstdCDictManagerPtr& cdict_manager,
                                        uint32_t chunk_size)
-    : ZstdCompressorImplBase(compression_level, enable_checksum, strategy, chunk_size),
+    : ZstdCompressorImplBase(Envoy::Compression::Zstd::Common::ContextPool::compressionContext(),
+                             compression_level, enable_checksum, strategy, chunk_size),
       cdict_manager_(cdict_manager) {
   size_t result;
   if (cdict_manager_) {
@@ -6,6 +6,7 @@
 
 #include "source/common/common/logger.h"
 #include "source/common/compression/zstd/common/base.h"
+#include "source/common/compression/zstd/common/context_pool.h"
 #include "source/extensions/compression/zstd/common/dictionary_manager.h"
 
 #include "zstd_errors.h"
@@ -59,7 +60,7 @@ private:
   bool process(Buffer::Instance& output_buffer);
   bool isError(size_t result);
 
-  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx_;
+  Envoy::Compression::Zstd::Common::DCtxPtr dctx_;
   const ZstdDDictManagerPtr& ddict_manager_;
   const ZstdDecompressorStats stats_;
   bool is_dictionary_set_{false};
@@ -18,12 +18,13 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     const uint32_t tokens_per_fill, Event::Dispatcher& dispatcher,
     const Protobuf::RepeatedPtrField<
         envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
-    bool always_consume_default_token_bucket)
+    bool always_consume_default_token_bucket, uint32_t token_lease_size)
     : fill_timer_(fill_interval > std::chrono::milliseconds(0)
                       ? dispatcher.createTimer([this] { onFillTimer(); })
                       : nullptr),
       time_source_(dispatcher.timeSource()),
-      always_consume_default_token_bucket_(always_consume_default_token_bucket) {
+      always_consume_default_token_bucket_(always_consume_default_token_bucket),
+      token_lease_size_(std::min(token_lease_size, max_tokens)) {
   if (fill_timer_ && fill_interval < std::chrono::milliseconds(50)) {
     throw EnvoyException("local rate limit token bucket fill timer must be >= 50ms");
   }
@@ -33,6 +34,7 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
   token_bucket_.fill_interval_ = absl::FromChrono(fill_interval);
   tokens_.tokens_ = max_tokens;
   tokens_.fill_time_ = time_source_.monotonicTime();
+  initializeLeases(tokens_);
 
   if (fill_timer_) {
     fill_timer_->enableTimer(fill_interval);
@@ -62,6 +64,7 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     auto token_state = std::make_shared<TokenState>();
     token_state->tokens_ = per_descriptor_token_bucket.max_tokens_;
     token_state->fill_time_ = time_source_.monotonicTime();
+    initializeLeases(*token_state);
     new_descriptor.token_state_ = token_state;
 
     auto result = descriptors_.emplace(new_descriptor);
@@ -122,6 +125,9 @@ void LocalRateLimiterImpl::onFillTimerHelper(TokenState& tokens,
 
   // Update fill time at last.
   tokens.fill_time_ = time_source_.monotonicTime();
+  if (tokens.leases_ != nullptr) {
+    tokens.fill_generation_.fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
 void LocalRateLimiterImpl::onFillTimerDescriptorHelper() {
@@ -136,7 +142,67 @@ void LocalRateLimiterImpl::onFillTimerDescriptorHelper() {
   }
 }
 
+void LocalRateLimiterImpl::initializeLeases(TokenState& tokens) const {
+  if (token_lease_size_ > 0) {
+    tokens.leases_ = std::make_unique<TokenLease[]>(NumLeaseShards);
+  }
+}
+
+namespace {
+
+// Threads take consecutive shards in the order they first use a rate limiter, so that up to
+// NumLeaseShards workers each have a lease of their own.
+uint32_t threadLeaseShard() {
+  static std::atomic<uint32_t> next_shard{0};
+  static thread_local const uint32_t shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % LocalRateLimiterImpl::NumLeaseShards;
+  return shard;
+}
+
+} // namespace
+
+bool LocalRateLimiterImpl::leasedRequestAllowed(const TokenState& tokens) const {
+  TokenLease& lease = tokens.leases_[threadLeaseShard()];
+  const uint64_t generation = tokens.fill_generation_.load(std::memory_order_relaxed);
+  const auto leased_tokens = [generation](uint64_t state) -> uint64_t {
+    return (state >> 32) == generation ? state & 0xffffffff : 0;
+  };
+
+  // Take a token from this shard's lease while it is from the current fill.
+  uint64_t state = lease.state_.load(std::memory_order_relaxed);
+  while (leased_tokens(state) > 0) {
+    if (lease.state_.compare_exchange_weak(state, state - 1, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+
+  // Lease more tokens from the bucket, one of which is for this request.
+  uint32_t expected_tokens = tokens.tokens_.load(std::memory_order_relaxed);
+  uint32_t leased;
+  do {
+    if (expected_tokens == 0) {
+      return false;
+    }
+    leased = std::min(expected_tokens, token_lease_size_);
+  } while (!tokens.tokens_.compare_exchange_weak(expected_tokens, expected_tokens - leased,
+                                                 std::memory_order_relaxed));
+
+  // Another thread of the same shard may have leased tokens meanwhile, which are kept if they are
+  // from the current fill. Those of an earlier fill have expired.
+  state = lease.state_.load(std::memory_order_relaxed);
+  uint64_t new_state;
+  do {
+    const uint64_t left = std::min<uint64_t>(leased_tokens(state) + leased - 1, 0xffffffff);
+    new_state = (generation << 32) | left;
+  } while (!lease.state_.compare_exchange_weak(state, new_state, std::memory_order_relaxed));
+  return true;
+}
+
 bool LocalRateLimiterImpl::requestAllowedHelper(const TokenState& tokens) const {
+  if (tokens.leases_ != nullptr) {
+    return leasedRequestAllowed(tokens);
+  }
+
   // Relaxed consistency is used for all operations because we don't care about ordering, just the
   // final atomic correctness.
   uint32_t expected_tokens = tokens.tokens_.load(std::memory_order_relaxed);
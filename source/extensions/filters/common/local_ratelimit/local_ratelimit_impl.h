@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
@@ -18,12 +19,21 @@ namespace LocalRateLimit {
 
 class LocalRateLimiterImpl {
 public:
+  // Threads are spread over this many token leases per token bucket.
+  static constexpr uint32_t NumLeaseShards = 16;
+
+  /**
+   * @param token_lease_size when not zero, each thread takes tokens from a token bucket this many
+   * at a time into a lease of its own, and consumes tokens from its lease until it is empty or the
+   * bucket is filled again, which expires it. This keeps threads from contending on the bucket, at
+   * the cost of up to NumLeaseShards * token_lease_size tokens per fill going unused in leases.
+   */
   LocalRateLimiterImpl(
       const std::chrono::milliseconds fill_interval, const uint32_t max_tokens,
       const uint32_t tokens_per_fill, Event::Dispatcher& dispatcher,
       const Protobuf::RepeatedPtrField<
           envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
-      bool always_consume_default_token_bucket = true);
+      bool always_consume_default_token_bucket = true, uint32_t token_lease_size = 0);
   ~LocalRateLimiterImpl();
 
   bool requestAllowed(absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const;
@@ -33,9 +43,17 @@ public:
   remainingFillInterval(absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const;
 
 private:
+  // Tokens taken from a bucket by the threads of one shard, in the low 32 bits, and the fill
+  // generation of the bucket they were taken in, in the high 32 bits.
+  struct alignas(64) TokenLease {
+    std::atomic<uint64_t> state_{0};
+  };
   struct TokenState {
     mutable std::atomic<uint32_t> tokens_;
     MonotonicTime fill_time_;
+    // Incremented on every fill when leasing, which expires the leases taken before the fill.
+    std::atomic<uint32_t> fill_generation_{0};
+    std::unique_ptr<TokenLease[]> leases_;
   };
   // Refill counter is incremented per each refill timer hit.
   uint64_t refill_counter_{0};
@@ -76,6 +94,8 @@ private:
   OptRef<const LocalDescriptorImpl>
   descriptorHelper(absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const;
   bool requestAllowedHelper(const TokenState& tokens) const;
+  bool leasedRequestAllowed(const TokenState& tokens) const;
+  void initializeLeases(TokenState& tokens) const;
   int tokensFillPerSecond(LocalDescriptorImpl& descriptor);
 
   RateLimit::TokenBucket token_bucket_;
@@ -86,6 +106,7 @@ private:
   std::vector<LocalDescriptorImpl> sorted_descriptors_;
   mutable Thread::ThreadSynchronizer synchronizer_; // Used for testing only.
   const bool always_consume_default_token_bucket_{};
+  const uint32_t token_lease_size_;
 
   friend class LocalRateLimiterImplTest;
 };
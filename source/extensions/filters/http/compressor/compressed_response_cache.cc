@@ -0,0 +1,57 @@
+#include "source/extensions/filters/http/compressor/compressed_response_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+CompressedResponseCache::CompressedResponseCache(uint64_t max_cache_bytes,
+                                                 uint32_t max_response_bytes)
+    : max_cache_bytes_(max_cache_bytes), max_response_bytes_(max_response_bytes) {}
+
+CompressedResponseCache::Body CompressedResponseCache::lookup(absl::string_view key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->body_;
+}
+
+void CompressedResponseCache::insert(absl::string_view key, std::string&& body) {
+  if (body.size() > max_response_bytes_) {
+    return;
+  }
+  const uint64_t size = key.size() + body.size();
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    erase(it->second);
+  }
+  if (size > max_cache_bytes_) {
+    return;
+  }
+  while (bytes_ + size > max_cache_bytes_) {
+    erase(std::prev(entries_.end()));
+  }
+  entries_.push_front({std::string(key), std::make_shared<const std::string>(std::move(body))});
+  index_.emplace(entries_.front().key_, entries_.begin());
+  bytes_ += size;
+}
+
+uint64_t CompressedResponseCache::bytes() const {
+  absl::MutexLock lock(&mutex_);
+  return bytes_;
+}
+
+void CompressedResponseCache::erase(EntryList::iterator it) {
+  bytes_ -= it->key_.size() + it->body_->size();
+  index_.erase(it->key_);
+  entries_.erase(it);
+}
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
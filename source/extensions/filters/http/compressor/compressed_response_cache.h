@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+/**
+ * A cache of compressed response bodies, shared by all the workers using a compressor filter
+ * config. It holds at most a given number of bytes, evicting the least recently used bodies.
+ */
+class CompressedResponseCache {
+public:
+  using Body = std::shared_ptr<const std::string>;
+
+  CompressedResponseCache(uint64_t max_cache_bytes, uint32_t max_response_bytes);
+
+  /**
+   * @param key identifies the response.
+   * @return the compressed body of the response, or nullptr if it is not in the cache.
+   */
+  Body lookup(absl::string_view key);
+
+  /**
+   * Stores the compressed body of a response, replacing any body already stored for it. Bodies
+   * larger than maxResponseBytes() are not stored.
+   * @param key identifies the response.
+   * @param body the compressed body.
+   */
+  void insert(absl::string_view key, std::string&& body);
+
+  /**
+   * @return the size of the largest compressed body which is stored.
+   */
+  uint32_t maxResponseBytes() const { return max_response_bytes_; }
+
+  /**
+   * @return the total size of the keys and bodies in the cache.
+   */
+  uint64_t bytes() const;
+
+private:
+  struct Entry {
+    std::string key_;
+    Body body_;
+  };
+  using EntryList = std::list<Entry>;
+
+  void erase(EntryList::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const uint64_t max_cache_bytes_;
+  const uint32_t max_response_bytes_;
+  mutable absl::Mutex mutex_;
+  // Most recently used first.
+  EntryList entries_ ABSL_GUARDED_BY(mutex_);
+  // Keys point into the entries, whose addresses do not change.
+  absl::flat_hash_map<absl::string_view, EntryList::iterator> index_ ABSL_GUARDED_BY(mutex_);
+  uint64_t bytes_ ABSL_GUARDED_BY(mutex_){};
+};
+
+using CompressedResponseCachePtr = std::unique_ptr<CompressedResponseCache>;
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
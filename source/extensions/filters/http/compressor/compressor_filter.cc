@@ -1,8 +1,14 @@
 #include "source/extensions/filters/http/compressor/compressor_filter.h"
 
+#include "envoy/http/codes.h"
+
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/enum_to_int.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/match.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -30,6 +36,10 @@ Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::Respons
 // Default minimum length of an upstream response that allows compression.
 const uint64_t DefaultMinimumContentLength = 30;
 
+// Default bounds of the compressed response cache.
+const uint64_t DefaultMaxCompressedResponseCacheBytes = 32 * 1024 * 1024;
+const uint32_t DefaultMaxCompressedResponseBytes = 1024 * 1024;
+
 // Default content types will be used if any is provided by the user.
 const std::vector<std::string>& defaultContentEncoding() {
   CONSTRUCT_ON_FIRST_USE(std::vector<std::string>, {"text/html",
@@ -94,7 +104,17 @@ CompressorFilterConfig::CompressorFilterConfig(
       response_direction_config_(proto_config, common_stats_prefix_, scope, runtime),
       content_encoding_(compressor_factory->contentEncoding()),
       compressor_factory_(std::move(compressor_factory)),
-      choose_first_(proto_config.choose_first()) {}
+      choose_first_(proto_config.choose_first()),
+      compressed_response_cache_(
+          proto_config.response_direction_config().has_compressed_response_cache()
+              ? std::make_unique<CompressedResponseCache>(
+                    PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+                        proto_config.response_direction_config().compressed_response_cache(),
+                        max_cache_bytes, DefaultMaxCompressedResponseCacheBytes),
+                    PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+                        proto_config.response_direction_config().compressed_response_cache(),
+                        max_response_bytes, DefaultMaxCompressedResponseBytes))
+              : nullptr) {}
 
 StringUtil::CaseUnorderedSet CompressorFilterConfig::DirectionConfig::contentTypeSet(
     const Protobuf::RepeatedPtrField<std::string>& types) {
@@ -200,6 +220,9 @@ Http::FilterHeadersStatus CompressorFilter::decodeHeaders(Http::RequestHeaderMap
     // decision on compressing the corresponding HTTP response.
     accept_encoding_ = std::make_unique<std::string>(accept_encoding->value().getStringView());
   }
+  if (config_->compressedResponseCache() != nullptr) {
+    request_identity_ = absl::StrCat(headers.getHostValue(), "\n", headers.getPathValue());
+  }
 
   const auto& response_config = config_->responseDirectionConfig();
   const auto* per_route_config =
@@ -288,12 +311,19 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
       isEtagAllowed(headers) && !headers.getInline(response_content_encoding_handle.handle());
   if (!end_stream && isAcceptEncodingAllowed(isEnabledAndContentLengthBigEnough, headers) &&
       isCompressible && isTransferEncodingAllowed(headers)) {
+    if (config_->compressedResponseCache() != nullptr) {
+      lookupCompressedResponse(headers);
+    }
     sanitizeEtagHeader(headers);
     headers.removeContentLength();
     headers.setInline(response_content_encoding_handle.handle(), config_->contentEncoding());
     config.stats().compressed_.inc();
-    // Finally instantiate the compressor.
-    response_compressor_ = config_->makeCompressor();
+    if (cached_body_ != nullptr) {
+      headers.setContentLength(cached_body_->size());
+    } else {
+      // Finally instantiate the compressor.
+      response_compressor_ = config_->makeCompressor();
+    }
   } else {
     config.stats().not_compressed_.inc();
   }
@@ -309,21 +339,51 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
 }
 
 Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool end_stream) {
-  if (response_compressor_ != nullptr) {
+  if (cached_body_ != nullptr) {
+    // The whole compressed body is sent with the first data; the body from the upstream is only
+    // counted and discarded.
+    const CompressorStats& stats = config_->responseDirectionConfig().stats();
+    stats.total_uncompressed_bytes_.add(data.length());
+    data.drain(data.length());
+    if (!cached_body_sent_) {
+      addCachedBody(data);
+    }
+  } else if (response_compressor_ != nullptr) {
     compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
                            end_stream);
+    storeCompressedResponse(data, end_stream);
   }
   return Http::FilterDataStatus::Continue;
 }
 
+void CompressorFilter::addCachedBody(Buffer::Instance& data) {
+  ASSERT(cached_body_ != nullptr && !cached_body_sent_);
+  cached_body_sent_ = true;
+  config_->responseDirectionConfig().stats().total_compressed_bytes_.add(cached_body_->size());
+  data.addBufferFragment(*new Buffer::BufferFragmentImpl(
+      cached_body_->data(), cached_body_->size(),
+      [body = cached_body_](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+        delete fragment;
+      }));
+}
+
 Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTrailerMap&) {
-  if (response_compressor_ != nullptr) {
+  if (cached_body_ != nullptr) {
+    // Content-Length was set to the size of the cached body, which must be sent even if the
+    // upstream response had no data before its trailers.
+    if (!cached_body_sent_) {
+      Buffer::OwnedImpl body;
+      addCachedBody(body);
+      encoder_callbacks_->addEncodedData(body, true);
+    }
+  } else if (response_compressor_ != nullptr) {
     Buffer::OwnedImpl empty_buffer;
     // The presence of trailers means the stream is ended, but encodeData()
     // is never called with end_stream=true, thus let the compression library know
     // that the stream is ended.
     compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(),
                            empty_buffer, true);
+    storeCompressedResponse(empty_buffer, true);
     encoder_callbacks_->addEncodedData(empty_buffer, true);
   }
   return Http::FilterTrailersStatus::Continue;
@@ -624,6 +684,45 @@ void CompressorFilter::insertVaryHeader(Http::ResponseHeaderMap& headers) {
   }
 }
 
+// Only complete responses with a strong etag may be cached: a weak etag does not guarantee that
+// the bodies are the same, and the body of a partial response depends on the requested range.
+void CompressorFilter::lookupCompressedResponse(const Http::ResponseHeaderMap& headers) {
+  const Http::HeaderEntry* etag = headers.getInline(etag_handle.handle());
+  if (etag == nullptr || request_identity_.empty() ||
+      Http::Utility::getResponseStatus(headers) != enumToInt(Http::Code::OK)) {
+    return;
+  }
+  const absl::string_view value = etag->value().getStringView();
+  if (value.empty() || absl::StartsWithIgnoreCase(value, "W/")) {
+    return;
+  }
+  compressed_response_key_ = absl::StrCat(request_identity_, "\n", value);
+  cached_body_ = config_->compressedResponseCache()->lookup(compressed_response_key_);
+  const ResponseCompressorStats& stats = config_->responseDirectionConfig().responseStats();
+  if (cached_body_ != nullptr) {
+    stats.compressed_response_cache_hit_.inc();
+  } else {
+    stats.compressed_response_cache_miss_.inc();
+    body_to_store_ = std::make_unique<Buffer::OwnedImpl>();
+  }
+}
+
+void CompressorFilter::storeCompressedResponse(const Buffer::Instance& data, bool end_stream) {
+  if (body_to_store_ == nullptr) {
+    return;
+  }
+  CompressedResponseCache& cache = *config_->compressedResponseCache();
+  if (body_to_store_->length() + data.length() > cache.maxResponseBytes()) {
+    body_to_store_.reset();
+    return;
+  }
+  body_to_store_->add(data);
+  if (end_stream) {
+    cache.insert(compressed_response_key_, body_to_store_->toString());
+    body_to_store_.reset();
+  }
+}
+
 // TODO(gsagula): It seems that every proxy has a different opinion how to handle Etag. Some
 // discussions around this topic have been going on for over a decade, e.g.,
 // https://bz.apache.org/bugzilla/show_bug.cgi?id=45023
@@ -7,6 +7,7 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/runtime/runtime_protos.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
+#include "source/extensions/filters/http/compressor/compressed_response_cache.h"
 
 #include "absl/types/optional.h"
 
@@ -39,6 +40,9 @@ namespace Compressor {
  *
  * "header_gzip" is specific to the gzip filter and is deprecated since it duplicates
  * "header_compressor_used".
+ *
+ * "compressed_response_cache_hit" and "compressed_response_cache_miss" count the compressed
+ * responses which could be cached, depending on whether they were found in the cache.
  */
 #define RESPONSE_COMPRESSOR_STATS(COUNTER)                                                         \
   COUNTER(no_accept_header)                                                                        \
@@ -47,7 +51,9 @@ namespace Compressor {
   COUNTER(header_compressor_overshadowed)                                                          \
   COUNTER(header_wildcard)                                                                         \
   COUNTER(header_not_valid)                                                                        \
-  COUNTER(not_compressed_etag)
+  COUNTER(not_compressed_etag)                                                                     \
+  COUNTER(compressed_response_cache_hit)                                                           \
+  COUNTER(compressed_response_cache_miss)
 
 /**
  * Struct definitions for compressor stats. @see stats_macros.h
@@ -150,6 +156,10 @@ public:
   bool chooseFirst() const { return choose_first_; };
   const RequestDirectionConfig& requestDirectionConfig() { return request_direction_config_; }
   const ResponseDirectionConfig& responseDirectionConfig() { return response_direction_config_; }
+  // Null unless compressed responses are cached.
+  CompressedResponseCache* compressedResponseCache() const {
+    return compressed_response_cache_.get();
+  }
 
 private:
   const std::string common_stats_prefix_;
@@ -159,6 +169,7 @@ private:
   const std::string content_encoding_;
   const Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory_;
   const bool choose_first_;
+  const CompressedResponseCachePtr compressed_response_cache_;
 };
 using CompressorFilterConfigSharedPtr = std::shared_ptr<CompressorFilterConfig>;
 
@@ -209,6 +220,10 @@ private:
 
   void sanitizeEtagHeader(Http::ResponseHeaderMap& headers);
   void insertVaryHeader(Http::ResponseHeaderMap& headers);
+  void lookupCompressedResponse(const Http::ResponseHeaderMap& headers);
+  void storeCompressedResponse(const Buffer::Instance& data, bool end_stream);
+  // Adds the cached compressed body to data, and records that it has been sent.
+  void addCachedBody(Buffer::Instance& data);
 
   class EncodingDecision : public StreamInfo::FilterState::Object {
   public:
@@ -235,6 +250,15 @@ private:
   Envoy::Compression::Compressor::CompressorPtr request_compressor_;
   const CompressorFilterConfigSharedPtr config_;
   std::unique_ptr<std::string> accept_encoding_;
+  // The authority and path of the request, captured when compressed responses are cached.
+  std::string request_identity_;
+  // The key of the response in the compressed response cache, if it may be cached.
+  std::string compressed_response_key_;
+  // The cached compressed body served instead of compressing the response.
+  CompressedResponseCache::Body cached_body_;
+  bool cached_body_sent_{};
+  // The compressed body accumulated to be stored in the cache once it is complete.
+  Buffer::InstancePtr body_to_store_;
 };
 
 } // namespace Compressor
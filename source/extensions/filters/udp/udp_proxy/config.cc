@@ -123,6 +123,22 @@ UdpProxyFilterConfigImpl::UdpProxyFilterConfigImpl(
     tunneling_config_ = std::make_unique<TunnelingConfigImpl>(config.tunneling_config(), context);
   }
 
+  if (config.has_upstream_packet_writer_config()) {
+    auto& factory_factory =
+        Config::Utility::getAndCheckFactory<Network::UdpPacketWriterFactoryFactory>(
+            config.upstream_packet_writer_config());
+    upstream_packet_writer_factory_ =
+        factory_factory.createUdpPacketWriterFactory(config.upstream_packet_writer_config());
+    if (upstream_packet_writer_factory_ == nullptr) {
+      throw EnvoyException(
+          fmt::format("The upstream packet writer {} is not supported by this build.",
+                      config.upstream_packet_writer_config().name()));
+    }
+    // Writer stats are shared by all sessions of this filter.
+    upstream_packet_writer_scope_ = context.scope().createScope(
+        absl::StrCat("udp.", config.stat_prefix(), ".upstream_writer."));
+  }
+
   if (config.has_access_log_options()) {
     flush_access_log_on_tunnel_connected_ =
         config.access_log_options().flush_access_log_on_tunnel_connected();
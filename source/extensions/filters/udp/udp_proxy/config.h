@@ -148,6 +148,14 @@ public:
     return access_log_flush_interval_;
   }
   Random::RandomGenerator& randomGenerator() const override { return random_generator_; }
+  Network::UdpPacketWriterPtr
+  createUpstreamPacketWriter(Network::IoHandle& io_handle) const override {
+    if (upstream_packet_writer_factory_ == nullptr) {
+      return nullptr;
+    }
+    return upstream_packet_writer_factory_->createUdpPacketWriter(io_handle,
+                                                                   *upstream_packet_writer_scope_);
+  }
 
   // FilterChainFactory
   void createFilterChain(FilterChainFactoryCallbacks& callbacks) const override {
@@ -180,6 +188,8 @@ private:
   UdpTunnelingConfigPtr tunneling_config_;
   std::list<SessionFilters::FilterFactoryCb> filter_factories_;
   Random::RandomGenerator& random_generator_;
+  Network::UdpPacketWriterFactoryPtr upstream_packet_writer_factory_;
+  Stats::ScopeSharedPtr upstream_packet_writer_scope_;
 };
 
 /**
@@ -3,6 +3,7 @@
 #include "envoy/network/listener.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/io_socket_error_impl.h"
 #include "source/common/network/socket_option_factory.h"
 
 namespace Envoy {
@@ -303,6 +304,13 @@ UdpProxyFilter::UdpActiveSession::UdpActiveSession(
     : ActiveSession(cluster, std::move(addresses), std::move(host)),
       use_original_src_ip_(cluster.filter_.config_->usingOriginalSrcIp()) {}
 
+UdpProxyFilter::UdpActiveSession::~UdpActiveSession() {
+  // Datagrams still held by a batching writer are sent before the socket is closed.
+  if (flush_callback_ != nullptr) {
+    flushUpstream();
+  }
+}
+
 UdpProxyFilter::ActiveSession::~ActiveSession() {
   ENVOY_BUG(on_session_complete_called_, "onSessionComplete() not called");
 }
@@ -359,6 +367,10 @@ void UdpProxyFilter::ActiveSession::fillSessionStreamInfo() {
       ValueUtil::numberValue(session_stats_.downstream_sess_tx_datagrams_);
   fields_map["datagrams_received"] =
       ValueUtil::numberValue(session_stats_.downstream_sess_rx_datagrams_);
+  fields_map["upstream_write_batches"] =
+      ValueUtil::numberValue(session_stats_.upstream_sess_tx_batches_);
+  fields_map["upstream_read_batches"] =
+      ValueUtil::numberValue(session_stats_.upstream_sess_rx_batches_);
 
   udp_session_info_.setDynamicMetadata("udp.proxy.session", stats_obj);
 }
@@ -400,10 +412,13 @@ void UdpProxyFilter::UdpActiveSession::onReadReady() {
   // TODO(mattklein123): We should not be passing *addresses_.local_ to this function as we are
   //                     not trying to populate the local address for received packets.
   uint32_t packets_dropped = 0;
+  uint32_t num_receives = 0;
   const Api::IoErrorPtr result = Network::Utility::readPacketsFromSocket(
       udp_socket_->ioHandle(), *addresses_.local_, *this, cluster_.filter_.config_->timeSource(),
       cluster_.filter_.config_->upstreamSocketConfig().prefer_gro_, /*allow_mmsg=*/true,
-      packets_dropped);
+      packets_dropped, &num_receives);
+  cluster_.cluster_stats_.sess_rx_batches_.add(num_receives);
+  session_stats_.upstream_sess_rx_batches_ += num_receives;
   if (result == nullptr) {
     udp_socket_->ioHandle().activateFileEvents(Event::FileReadyType::Read);
     return;
@@ -501,15 +516,72 @@ void UdpProxyFilter::UdpActiveSession::writeUpstream(Network::UdpRecvData& data)
             host_->address()->asStringView());
 
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
-  Api::IoCallUint64Result rc = Network::Utility::writeToSocket(
-      udp_socket_->ioHandle(), *data.buffer_, local_ip, *host_->address());
+  Api::IoCallUint64Result rc = writeToSocket(*data.buffer_, local_ip);
 
   if (!rc.ok()) {
     cluster_.cluster_stats_.sess_tx_errors_.inc();
-  } else {
-    cluster_.cluster_stats_.sess_tx_datagrams_.inc();
-    cluster_.cluster_.info()->trafficStats()->upstream_cx_tx_bytes_total_.add(tx_buffer_length);
+    return;
+  }
+
+  cluster_.cluster_stats_.sess_tx_datagrams_.inc();
+  cluster_.cluster_.info()->trafficStats()->upstream_cx_tx_bytes_total_.add(tx_buffer_length);
+  if (flush_callback_ == nullptr) {
+    // Every datagram was sent on its own.
+    cluster_.cluster_stats_.sess_tx_batches_.inc();
+    ++session_stats_.upstream_sess_tx_batches_;
+    return;
   }
+
+  has_unflushed_datagrams_ = true;
+  if (!flush_callback_->enabled()) {
+    flush_callback_->scheduleCallbackCurrentIteration();
+  }
+}
+
+Api::IoCallUint64Result
+UdpProxyFilter::UdpActiveSession::writeToSocket(Buffer::Instance& buffer,
+                                                const Network::Address::Ip* local_ip) {
+  if (packet_writer_ == nullptr) {
+    return Network::Utility::writeToSocket(udp_socket_->ioHandle(), buffer, local_ip,
+                                           *host_->address());
+  }
+
+  if (packet_writer_->isWriteBlocked()) {
+    // The datagram is dropped, as it would be if the socket buffer were full.
+    return {0, Network::IoSocketError::getIoSocketEagainError()};
+  }
+  // Packet writers take each datagram as a single slice.
+  buffer.linearize(buffer.length());
+  return packet_writer_->writePacket(buffer, local_ip, *host_->address());
+}
+
+void UdpProxyFilter::UdpActiveSession::flushUpstream() {
+  if (!has_unflushed_datagrams_ || packet_writer_->isWriteBlocked()) {
+    return;
+  }
+
+  const Api::IoCallUint64Result rc = packet_writer_->flush();
+  if (packet_writer_->isWriteBlocked()) {
+    // The writer keeps the datagrams it could not send, which are flushed once the socket is
+    // writable again.
+    udp_socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read |
+                                             Event::FileReadyType::Write);
+    return;
+  }
+
+  has_unflushed_datagrams_ = false;
+  if (!rc.ok()) {
+    cluster_.cluster_stats_.sess_tx_errors_.inc();
+    return;
+  }
+  cluster_.cluster_stats_.sess_tx_batches_.inc();
+  ++session_stats_.upstream_sess_tx_batches_;
+}
+
+void UdpProxyFilter::UdpActiveSession::onWriteReady() {
+  udp_socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read);
+  packet_writer_->setWritable();
+  flushUpstream();
 }
 
 bool UdpProxyFilter::ActiveSession::onContinueFilterChain(ActiveReadFilter* filter) {
@@ -561,15 +633,26 @@ bool UdpProxyFilter::UdpActiveSession::createUpstream() {
 void UdpProxyFilter::UdpActiveSession::createUdpSocket(const Upstream::HostConstSharedPtr& host) {
   // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
   //       is bound until the first packet is sent to the upstream host.
+  Event::Dispatcher& dispatcher = cluster_.filter_.read_callbacks_->udpListener().dispatcher();
   udp_socket_ = cluster_.filter_.createUdpSocket(host);
   udp_socket_->ioHandle().initializeFileEvent(
-      cluster_.filter_.read_callbacks_->udpListener().dispatcher(),
-      [this](uint32_t) {
-        onReadReady();
+      dispatcher,
+      [this](uint32_t events) {
+        if (events & Event::FileReadyType::Write) {
+          onWriteReady();
+        }
+        if (events & Event::FileReadyType::Read) {
+          onReadReady();
+        }
         return absl::OkStatus();
       },
       Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
 
+  packet_writer_ = cluster_.filter_.config_->createUpstreamPacketWriter(udp_socket_->ioHandle());
+  if (packet_writer_ != nullptr && packet_writer_->isBatchMode()) {
+    flush_callback_ = dispatcher.createSchedulableCallback([this]() { flushUpstream(); });
+  }
+
   ENVOY_LOG(debug, "creating new session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host->address()->asStringView());
@@ -640,6 +723,7 @@ void UdpProxyFilter::UdpActiveSession::processPacket(
             host_ != nullptr ? host_->address()->asStringView() : "unknown");
 
   cluster_.cluster_stats_.sess_rx_datagrams_.inc();
+  ++session_stats_.upstream_sess_rx_datagrams_;
   cluster_.cluster_.info()->trafficStats()->upstream_cx_rx_bytes_total_.add(rx_buffer_length);
 
   Network::UdpRecvData recv_data{
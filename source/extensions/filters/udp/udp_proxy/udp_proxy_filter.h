@@ -9,6 +9,7 @@
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/http/header_evaluator.h"
 #include "envoy/network/filter.h"
+#include "envoy/network/udp_packet_writer_handler.h"
 #include "envoy/stream_info/stream_info.h"
 #include "envoy/stream_info/uint32_accessor.h"
 #include "envoy/upstream/cluster_manager.h"
@@ -70,9 +71,11 @@ struct UdpProxyDownstreamStats {
  * All UDP proxy upstream cluster stats. @see stats_macros.h
  */
 #define ALL_UDP_PROXY_UPSTREAM_STATS(COUNTER)                                                      \
+  COUNTER(sess_rx_batches)                                                                         \
   COUNTER(sess_rx_datagrams)                                                                       \
   COUNTER(sess_rx_datagrams_dropped)                                                               \
   COUNTER(sess_rx_errors)                                                                          \
+  COUNTER(sess_tx_batches)                                                                         \
   COUNTER(sess_tx_datagrams)                                                                       \
   COUNTER(sess_tunnel_success)                                                                     \
   COUNTER(sess_tunnel_failure)                                                                     \
@@ -139,6 +142,12 @@ public:
   virtual bool flushAccessLogOnTunnelConnected() const PURE;
   virtual const absl::optional<std::chrono::milliseconds>& accessLogFlushInterval() const PURE;
   virtual Random::RandomGenerator& randomGenerator() const PURE;
+  /**
+   * @return a packet writer for an upstream socket, or nullptr if datagrams should be written
+   *         directly to the socket.
+   */
+  virtual Network::UdpPacketWriterPtr
+  createUpstreamPacketWriter(Network::IoHandle& io_handle) const PURE;
 };
 
 using UdpProxyFilterConfigSharedPtr = std::shared_ptr<const UdpProxyFilterConfig>;
@@ -592,6 +601,9 @@ private:
       uint64_t downstream_sess_rx_errors_;
       uint64_t downstream_sess_tx_datagrams_;
       uint64_t downstream_sess_rx_datagrams_;
+      uint64_t upstream_sess_rx_datagrams_;
+      uint64_t upstream_sess_rx_batches_;
+      uint64_t upstream_sess_tx_batches_;
     };
 
     static std::atomic<uint64_t> next_global_session_id_;
@@ -628,7 +640,7 @@ private:
   public:
     UdpActiveSession(ClusterInfo& parent, Network::UdpRecvData::LocalPeerAddresses&& addresses,
                      const Upstream::HostConstSharedPtr& host);
-    ~UdpActiveSession() override = default;
+    ~UdpActiveSession() override;
 
     // ActiveSession
     bool createUpstream() override;
@@ -656,12 +668,22 @@ private:
 
   private:
     void onReadReady();
+    void onWriteReady();
     void createUdpSocket(const Upstream::HostConstSharedPtr& host);
+    Api::IoCallUint64Result writeToSocket(Buffer::Instance& buffer,
+                                          const Network::Address::Ip* local_ip);
+    void flushUpstream();
 
     // The socket is used for writing packets to the selected upstream host as well as receiving
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
     Network::SocketPtr udp_socket_;
+    // Writes datagrams to udp_socket_, if an upstream packet writer is configured.
+    Network::UdpPacketWriterPtr packet_writer_;
+    // Flushes a batching packet_writer_ at the end of each event loop iteration in which
+    // datagrams were written to it.
+    Event::SchedulableCallbackPtr flush_callback_;
+    bool has_unflushed_datagrams_{};
     // The socket has been connected to avoid port exhaustion.
     bool connected_{};
     const bool use_original_src_ip_;
@@ -127,19 +127,23 @@ void FileLookupContext::invalidateCacheEntry() {
 void FileLookupContext::getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) {
   absl::MutexLock lock(&mu_);
   ASSERT(!cancel_action_in_flight_);
-  auto queued = file_handle_->read(
-      header_block_.offsetToBody() + range.begin(), range.length(),
-      [this, cb, range](absl::StatusOr<Buffer::InstancePtr> read_result) {
-        absl::MutexLock lock(&mu_);
-        cancel_action_in_flight_ = nullptr;
-        if (!read_result.ok() || read_result.value()->length() != range.length()) {
-          invalidateCacheEntry();
-          // Calling callback with nullptr fails the request.
-          cb(nullptr);
-          return;
-        }
-        cb(std::move(read_result.value()));
-      });
+  auto on_read = [this, cb, range](absl::StatusOr<Buffer::InstancePtr> read_result) {
+    absl::MutexLock lock(&mu_);
+    cancel_action_in_flight_ = nullptr;
+    if (!read_result.ok() || read_result.value()->length() != range.length()) {
+      invalidateCacheEntry();
+      // Calling callback with nullptr fails the request.
+      cb(nullptr);
+      return;
+    }
+    cb(std::move(read_result.value()));
+  };
+  const off_t offset = header_block_.offsetToBody() + range.begin();
+  // Cache files are never modified in place (header updates write a new file), so a
+  // mapping of the body remains valid even if the entry is updated or evicted meanwhile.
+  auto queued = cache_.config().mmap_body_reads()
+                    ? file_handle_->readMapped(offset, range.length(), std::move(on_read))
+                    : file_handle_->read(offset, range.length(), std::move(on_read));
   ASSERT(queued.ok(), queued.status().ToString());
   cancel_action_in_flight_ = queued.value();
 }
@@ -0,0 +1,78 @@
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/http/cache/sharded_lru_http_cache/v3/sharded_lru_http_cache.pb.h"
+#include "envoy/extensions/http/cache/sharded_lru_http_cache/v3/sharded_lru_http_cache.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/sharded_lru_http_cache/sharded_lru_http_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace ShardedLruHttpCache {
+namespace {
+
+/**
+ * A singleton that acts as a factory for generating and looking up ShardedLruHttpCaches.
+ * Equivalent configs share a cache instance; different configs get different instances.
+ */
+class CacheSingleton : public Envoy::Singleton::Instance {
+public:
+  std::shared_ptr<ShardedLruHttpCache> get(const ConfigProto& config, Stats::Scope& stats_scope) {
+    absl::MutexLock lock(&mu_);
+    std::shared_ptr<ShardedLruHttpCache> cache;
+    auto it = caches_.find(config);
+    if (it != caches_.end()) {
+      cache = it->second.lock();
+    }
+    if (!cache) {
+      cache = std::make_shared<ShardedLruHttpCache>(config, stats_scope);
+      caches_[config] = cache;
+    }
+    return cache;
+  }
+
+private:
+  absl::Mutex mu_;
+  // We keep weak_ptr here so the caches can be destroyed if the config is updated to stop
+  // using that config of cache.
+  absl::flat_hash_map<ConfigProto, std::weak_ptr<ShardedLruHttpCache>, MessageUtil, MessageUtil>
+      caches_ ABSL_GUARDED_BY(mu_);
+};
+
+SINGLETON_MANAGER_REGISTRATION(sharded_lru_http_cache_singleton);
+
+class ShardedLruHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return std::string{ShardedLruHttpCache::name()}; }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<ConfigProto>();
+  }
+  // From HttpCacheFactory
+  std::shared_ptr<HttpCache>
+  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig& filter_config,
+           Server::Configuration::FactoryContext& context) override {
+    ConfigProto config;
+    THROW_IF_NOT_OK(MessageUtil::unpackTo(filter_config.typed_config(), config));
+    std::shared_ptr<CacheSingleton> caches =
+        context.serverFactoryContext().singletonManager().getTyped<CacheSingleton>(
+            SINGLETON_MANAGER_REGISTERED_NAME(sharded_lru_http_cache_singleton),
+            [] { return std::make_shared<CacheSingleton>(); });
+    // The cache outlives any one listener, so its stats live in the server scope.
+    return caches->get(config, context.serverFactoryContext().scope());
+  }
+};
+
+static Registry::RegisterFactory<ShardedLruHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace
+} // namespace ShardedLruHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,418 @@
+#include "source/extensions/http/cache/sharded_lru_http_cache/sharded_lru_http_cache.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace ShardedLruHttpCache {
+namespace {
+
+constexpr uint32_t DefaultShardCount = 16;
+
+std::string statPrefix(const ConfigProto& config) {
+  if (config.stat_prefix().empty()) {
+    return "cache.sharded_lru.";
+  }
+  return absl::StrCat("cache.sharded_lru.", config.stat_prefix(), ".");
+}
+
+ShardedLruHttpCacheStats generateStats(Stats::Scope& scope) {
+  return {ALL_SHARDED_LRU_HTTP_CACHE_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope))};
+}
+
+// Returns a Key with the vary identifier added to custom_fields, or nullopt if the vary
+// headers in the response are not compatible with the VaryAllowList in the request.
+absl::optional<Key> variedRequestKey(const LookupRequest& request,
+                                     const Http::ResponseHeaderMap& response_headers) {
+  absl::btree_set<absl::string_view> vary_header_values =
+      VaryHeaderUtils::getVaryValues(response_headers);
+  ASSERT(!vary_header_values.empty());
+  const absl::optional<std::string> vary_identifier = VaryHeaderUtils::createVaryIdentifier(
+      request.varyAllowList(), vary_header_values, request.requestHeaders());
+  if (!vary_identifier.has_value()) {
+    return absl::nullopt;
+  }
+  Key varied_request_key = request.key();
+  varied_request_key.add_custom_fields(vary_identifier.value());
+  return varied_request_key;
+}
+
+uint64_t entryCharge(const Key& key, const ShardedLruHttpCache::Entry& entry) {
+  return sizeof(ShardedLruHttpCache::Entry) + key.ByteSizeLong() +
+         entry.response_headers_->byteSize() + entry.body_->size() +
+         (entry.trailers_ ? entry.trailers_->byteSize() : 0);
+}
+
+// References a range of a cached body, keeping the body alive until the buffer
+// holding this fragment is drained, so that cache hits are served without a copy.
+class SharedBodyFragment : public Buffer::BufferFragment {
+public:
+  SharedBodyFragment(std::shared_ptr<const std::string> body, uint64_t offset, uint64_t length)
+      : body_(std::move(body)), offset_(offset), length_(length) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return body_->data() + offset_; }
+  size_t size() const override { return length_; }
+  void done() override { delete this; }
+
+private:
+  const std::shared_ptr<const std::string> body_;
+  const uint64_t offset_;
+  const uint64_t length_;
+};
+
+class ShardedLruLookupContext : public LookupContext {
+public:
+  ShardedLruLookupContext(ShardedLruHttpCache& cache, LookupRequest&& request)
+      : cache_(cache), request_(std::move(request)) {}
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    entry_ = cache_.lookup(request_);
+    if (entry_ == nullptr) {
+      cache_.stats().misses_.inc();
+      cb(LookupResult{});
+      return;
+    }
+    cache_.stats().hits_.inc();
+    ResponseMetadata metadata = entry_->metadata_;
+    cb(request_.makeLookupResult(
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry_->response_headers_),
+        std::move(metadata), entry_->body_->size(), entry_->trailers_ != nullptr));
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(entry_ != nullptr);
+    ASSERT(range.end() <= entry_->body_->size(), "Attempt to read past end of body.");
+    auto buffer = std::make_unique<Buffer::OwnedImpl>();
+    if (range.length() > 0) {
+      buffer->addBufferFragment(
+          *new SharedBodyFragment(entry_->body_, range.begin(), range.length()));
+    }
+    cb(std::move(buffer));
+  }
+
+  void getTrailers(LookupTrailersCallback&& cb) override {
+    ASSERT(entry_ != nullptr && entry_->trailers_ != nullptr);
+    cb(Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*entry_->trailers_));
+  }
+
+  const LookupRequest& request() const { return request_; }
+  void onDestroy() override {}
+
+private:
+  ShardedLruHttpCache& cache_;
+  const LookupRequest request_;
+  ShardedLruHttpCache::EntrySharedPtr entry_;
+};
+
+class ShardedLruInsertContext : public InsertContext {
+public:
+  ShardedLruInsertContext(const ShardedLruLookupContext& lookup_context, ShardedLruHttpCache& cache)
+      : key_(lookup_context.request().key()),
+        request_headers_(lookup_context.request().requestHeaders()),
+        vary_allow_list_(lookup_context.request().varyAllowList()), cache_(cache) {}
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, InsertCallback insert_success,
+                     bool end_stream) override {
+    ASSERT(!committed_);
+    response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    metadata_ = metadata;
+    if (end_stream) {
+      insert_success(commit());
+    } else {
+      insert_success(true);
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    body_.add(chunk);
+    if (end_stream) {
+      ready_for_next_chunk(commit());
+    } else {
+      ready_for_next_chunk(true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap& trailers,
+                      InsertCallback insert_complete) override {
+    ASSERT(!committed_);
+    trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+    insert_complete(commit());
+  }
+
+  void onDestroy() override {}
+
+private:
+  bool commit() {
+    committed_ = true;
+    if (VaryHeaderUtils::hasVary(*response_headers_)) {
+      return cache_.varyInsert(key_, std::move(response_headers_), std::move(metadata_),
+                               body_.toString(), request_headers_, vary_allow_list_,
+                               std::move(trailers_));
+    }
+    return cache_.insert(key_, std::move(response_headers_), std::move(metadata_),
+                         body_.toString(), std::move(trailers_));
+  }
+
+  Key key_;
+  const Http::RequestHeaderMap& request_headers_;
+  const VaryAllowList& vary_allow_list_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  ShardedLruHttpCache& cache_;
+  Buffer::OwnedImpl body_;
+  bool committed_ = false;
+  Http::ResponseTrailerMapPtr trailers_;
+};
+
+} // namespace
+
+ShardedLruHttpCache::ShardedLruHttpCache(ConfigProto config, Stats::Scope& stats_scope)
+    : config_(std::move(config)), stats_scope_(stats_scope.createScope(statPrefix(config_))),
+      stats_(generateStats(*stats_scope_)),
+      max_shard_size_bytes_(config_.has_max_cache_size_bytes()
+                                ? config_.max_cache_size_bytes().value() /
+                                      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, shard_count,
+                                                                      DefaultShardCount)
+                                : std::numeric_limits<uint64_t>::max()),
+      max_entry_size_bytes_(std::min(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, max_entry_size_bytes,
+                                          std::numeric_limits<uint64_t>::max()),
+          max_shard_size_bytes_)) {
+  const uint32_t shard_count =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, shard_count, DefaultShardCount);
+  shards_.reserve(shard_count);
+  for (uint32_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+ShardedLruHttpCache::~ShardedLruHttpCache() {
+  // Caches with the same stat prefix share their gauges, so only this cache's entries are
+  // taken out of them.
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    absl::MutexLock lock(&shard->mutex_);
+    stats_.size_bytes_.sub(shard->size_bytes_);
+    stats_.size_count_.sub(shard->map_.size());
+  }
+}
+
+ShardedLruHttpCache::Shard& ShardedLruHttpCache::shardFor(const Key& key) {
+  return *shards_[stableHashKey(key) % shards_.size()];
+}
+
+ShardedLruHttpCache::EntrySharedPtr ShardedLruHttpCache::find(const Key& key) {
+  Shard& shard = shardFor(key);
+  absl::ReaderMutexLock lock(&shard.mutex_);
+  auto it = shard.map_.find(key);
+  if (it == shard.map_.end()) {
+    return nullptr;
+  }
+  // Recency is recorded without the writer lock; the eviction hand is the only reader.
+  it->second.entry_->referenced_.store(true, std::memory_order_relaxed);
+  return it->second.entry_;
+}
+
+ShardedLruHttpCache::EntrySharedPtr ShardedLruHttpCache::lookup(const LookupRequest& request) {
+  EntrySharedPtr entry = find(request.key());
+  if (entry == nullptr || !VaryHeaderUtils::hasVary(*entry->response_headers_)) {
+    return entry;
+  }
+  absl::optional<Key> varied_key = variedRequestKey(request, *entry->response_headers_);
+  if (!varied_key.has_value()) {
+    return nullptr;
+  }
+  return find(varied_key.value());
+}
+
+bool ShardedLruHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+                                 ResponseMetadata&& metadata, std::string&& body,
+                                 Http::ResponseTrailerMapPtr&& trailers) {
+  auto entry = std::make_unique<Entry>();
+  entry->response_headers_ = std::move(response_headers);
+  entry->metadata_ = std::move(metadata);
+  entry->body_ = std::make_shared<const std::string>(std::move(body));
+  entry->trailers_ = std::move(trailers);
+  return publish(key, std::move(entry));
+}
+
+bool ShardedLruHttpCache::varyInsert(const Key& request_key,
+                                     Http::ResponseHeaderMapPtr&& response_headers,
+                                     ResponseMetadata&& metadata, std::string&& body,
+                                     const Http::RequestHeaderMap& request_headers,
+                                     const VaryAllowList& vary_allow_list,
+                                     Http::ResponseTrailerMapPtr&& trailers) {
+  absl::btree_set<absl::string_view> vary_header_values =
+      VaryHeaderUtils::getVaryValues(*response_headers);
+  ASSERT(!vary_header_values.empty());
+
+  const absl::optional<std::string> vary_identifier =
+      VaryHeaderUtils::createVaryIdentifier(vary_allow_list, vary_header_values, request_headers);
+  if (!vary_identifier.has_value()) {
+    // Skip the insert if we are unable to create a vary key.
+    return false;
+  }
+  Key varied_request_key = request_key;
+  varied_request_key.add_custom_fields(vary_identifier.value());
+
+  // The marker is built before response_headers is moved into the varied entry, since
+  // vary_header_values refers into it.
+  auto marker = std::make_unique<Entry>();
+  marker->response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+  marker->response_headers_->setCopy(Http::CustomHeaders::get().Vary,
+                                     absl::StrJoin(vary_header_values, ","));
+  marker->body_ = std::make_shared<const std::string>();
+
+  if (!insert(varied_request_key, std::move(response_headers), std::move(metadata),
+              std::move(body), std::move(trailers))) {
+    return false;
+  }
+  // The varied entry and its marker usually live in different shards. They are published
+  // one at a time so that no two shard locks are ever held together; a lookup that races
+  // with this insert simply misses. An existing marker is kept, but a plain response cached
+  // for request_key is replaced, as it would otherwise be served to every variant.
+  return publish(request_key, std::move(marker), /*keep_vary_marker=*/true);
+}
+
+bool ShardedLruHttpCache::publish(const Key& key, std::unique_ptr<Entry> entry,
+                                  bool keep_vary_marker) {
+  entry->charge_ = entryCharge(key, *entry);
+  if (entry->charge_ > max_entry_size_bytes_) {
+    stats_.inserts_rejected_.inc();
+    return false;
+  }
+  Shard& shard = shardFor(key);
+  absl::WriterMutexLock lock(&shard.mutex_);
+  auto it = shard.map_.find(key);
+  if (it != shard.map_.end()) {
+    // The existing entry is inspected without touching its referenced flag, so that an insert
+    // does not count as a use of it.
+    if (keep_vary_marker && VaryHeaderUtils::hasVary(*it->second.entry_->response_headers_)) {
+      return true;
+    }
+    erase(shard, it);
+  }
+  evict(shard, max_shard_size_bytes_ - entry->charge_);
+  shard.clock_.push_back(key);
+  const uint64_t charge = entry->charge_;
+  shard.map_.emplace(key, Slot{std::move(entry), std::prev(shard.clock_.end())});
+  shard.size_bytes_ += charge;
+  stats_.inserts_.inc();
+  stats_.size_bytes_.add(charge);
+  stats_.size_count_.inc();
+  return true;
+}
+
+void ShardedLruHttpCache::updateHeaders(const LookupContext& lookup_context,
+                                        const Http::ResponseHeaderMap& response_headers,
+                                        const ResponseMetadata& metadata,
+                                        std::function<void(bool)> on_complete) {
+  const auto& sharded_lookup_context = static_cast<const ShardedLruLookupContext&>(lookup_context);
+  const LookupRequest& request = sharded_lookup_context.request();
+  EntrySharedPtr entry = find(request.key());
+  if (entry == nullptr) {
+    on_complete(false);
+    return;
+  }
+  if (VaryHeaderUtils::hasVary(*entry->response_headers_)) {
+    absl::optional<Key> varied_key = variedRequestKey(request, *entry->response_headers_);
+    on_complete(varied_key.has_value() &&
+                replaceHeaders(varied_key.value(), response_headers, metadata));
+    return;
+  }
+  on_complete(replaceHeaders(request.key(), response_headers, metadata));
+}
+
+bool ShardedLruHttpCache::replaceHeaders(const Key& key,
+                                         const Http::ResponseHeaderMap& response_headers,
+                                         const ResponseMetadata& metadata) {
+  Shard& shard = shardFor(key);
+  absl::WriterMutexLock lock(&shard.mutex_);
+  auto it = shard.map_.find(key);
+  if (it == shard.map_.end()) {
+    return false;
+  }
+  // Entries are shared with in-flight lookups, so the update is applied to a copy that
+  // shares the original body.
+  const Entry& old_entry = *it->second.entry_;
+  auto entry = std::make_shared<Entry>();
+  entry->response_headers_ =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*old_entry.response_headers_);
+  applyHeaderUpdate(response_headers, *entry->response_headers_);
+  entry->metadata_ = metadata;
+  entry->body_ = old_entry.body_;
+  if (old_entry.trailers_ != nullptr) {
+    entry->trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*old_entry.trailers_);
+  }
+  entry->charge_ = entryCharge(key, *entry);
+  entry->referenced_.store(true, std::memory_order_relaxed);
+
+  shard.size_bytes_ = shard.size_bytes_ - old_entry.charge_ + entry->charge_;
+  stats_.size_bytes_.sub(old_entry.charge_);
+  stats_.size_bytes_.add(entry->charge_);
+  it->second.entry_ = std::move(entry);
+  return true;
+}
+
+void ShardedLruHttpCache::evict(Shard& shard, uint64_t target_bytes) {
+  // Every entry is visited at most twice: once to clear its referenced flag, and once more
+  // to evict it.
+  while (shard.size_bytes_ > target_bytes && !shard.clock_.empty()) {
+    auto it = shard.map_.find(shard.clock_.front());
+    ASSERT(it != shard.map_.end());
+    if (it->second.entry_->referenced_.exchange(false, std::memory_order_relaxed)) {
+      shard.clock_.splice(shard.clock_.end(), shard.clock_, shard.clock_.begin());
+      continue;
+    }
+    erase(shard, it);
+    stats_.evictions_.inc();
+  }
+}
+
+void ShardedLruHttpCache::erase(
+    Shard& shard, absl::flat_hash_map<Key, Slot, MessageUtil, MessageUtil>::iterator it) {
+  const uint64_t charge = it->second.entry_->charge_;
+  shard.clock_.erase(it->second.clock_position_);
+  shard.map_.erase(it);
+  shard.size_bytes_ -= charge;
+  stats_.size_bytes_.sub(charge);
+  stats_.size_count_.dec();
+}
+
+LookupContextPtr ShardedLruHttpCache::makeLookupContext(LookupRequest&& request,
+                                                        Http::StreamDecoderFilterCallbacks&) {
+  return std::make_unique<ShardedLruLookupContext>(*this, std::move(request));
+}
+
+InsertContextPtr ShardedLruHttpCache::makeInsertContext(LookupContextPtr&& lookup_context,
+                                                        Http::StreamEncoderFilterCallbacks&) {
+  ASSERT(lookup_context != nullptr);
+  return std::make_unique<ShardedLruInsertContext>(
+      static_cast<const ShardedLruLookupContext&>(*lookup_context), *this);
+}
+
+CacheInfo ShardedLruHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = name();
+  return cache_info;
+}
+
+} // namespace ShardedLruHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
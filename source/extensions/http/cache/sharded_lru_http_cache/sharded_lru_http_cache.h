@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/http/cache/sharded_lru_http_cache/v3/sharded_lru_http_cache.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace ShardedLruHttpCache {
+
+using ConfigProto =
+    envoy::extensions::http::cache::sharded_lru_http_cache::v3::ShardedLruHttpCacheConfig;
+
+/**
+ * All sharded LRU cache stats. @see stats_macros.h
+ *
+ * hits and misses count lookups for which an entry was or was not found; a hit may still
+ * require validation with the upstream before it can be served.
+ **/
+#define ALL_SHARDED_LRU_HTTP_CACHE_STATS(COUNTER, GAUGE)                                           \
+  COUNTER(evictions)                                                                               \
+  COUNTER(hits)                                                                                    \
+  COUNTER(inserts)                                                                                 \
+  COUNTER(inserts_rejected)                                                                        \
+  COUNTER(misses)                                                                                  \
+  GAUGE(size_bytes, NeverImport)                                                                   \
+  GAUGE(size_count, NeverImport)
+
+/**
+ * Struct definition for all sharded LRU cache stats. @see stats_macros.h
+ */
+struct ShardedLruHttpCacheStats {
+  ALL_SHARDED_LRU_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * An in-memory HttpCache shared by all workers, partitioned into shards by key hash.
+ *
+ * Entries are immutable once published to a shard. A lookup holds its shard's reader lock
+ * only for as long as it takes to copy a shared_ptr to the entry, and then serves headers
+ * and body from that reference without further locking; replacing or evicting the entry
+ * does not affect lookups already holding it. Recency is recorded with a per-entry atomic
+ * flag, so that lookups never need the writer lock, and eviction uses the CLOCK (second
+ * chance) approximation of least-recently-used.
+ */
+class ShardedLruHttpCache : public HttpCache {
+public:
+  struct Entry {
+    Http::ResponseHeaderMapPtr response_headers_;
+    ResponseMetadata metadata_;
+    std::shared_ptr<const std::string> body_;
+    Http::ResponseTrailerMapPtr trailers_;
+    // The number of bytes charged to the shard for this entry, including its key.
+    uint64_t charge_{0};
+    // Set by lookups and cleared by the eviction hand; an entry found with this flag set is
+    // given a second chance rather than being evicted.
+    mutable std::atomic<bool> referenced_{false};
+  };
+  using EntrySharedPtr = std::shared_ptr<const Entry>;
+
+  ShardedLruHttpCache(ConfigProto config, Stats::Scope& stats_scope);
+  ~ShardedLruHttpCache() override;
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request,
+                                     Http::StreamDecoderFilterCallbacks& callbacks) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context,
+                                     Http::StreamEncoderFilterCallbacks& callbacks) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata,
+                     std::function<void(bool)> on_complete) override;
+  CacheInfo cacheInfo() const override;
+
+  /**
+   * @return the entry matching request, following a vary marker entry to the varied
+   *         response if necessary, or nullptr if there is none.
+   */
+  EntrySharedPtr lookup(const LookupRequest& request);
+
+  /**
+   * Inserts or replaces the entry for key, evicting other entries from its shard as needed.
+   * @return false if the entry is too large to be cached.
+   */
+  bool insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+              ResponseMetadata&& metadata, std::string&& body,
+              Http::ResponseTrailerMapPtr&& trailers);
+
+  /**
+   * Inserts a response that has been varied on request headers, along with a marker entry
+   * under request_key that records which headers the response varies on.
+   * @return false if no vary key could be created or the entry is too large to be cached.
+   */
+  bool varyInsert(const Key& request_key, Http::ResponseHeaderMapPtr&& response_headers,
+                  ResponseMetadata&& metadata, std::string&& body,
+                  const Http::RequestHeaderMap& request_headers,
+                  const VaryAllowList& vary_allow_list, Http::ResponseTrailerMapPtr&& trailers);
+
+  const ConfigProto& config() const { return config_; }
+  ShardedLruHttpCacheStats& stats() { return stats_; }
+  size_t shardCount() const { return shards_.size(); }
+
+  static absl::string_view name() { return "envoy.extensions.http.cache.sharded_lru"; }
+
+private:
+  struct Slot {
+    EntrySharedPtr entry_;
+    // Position of the key in the shard's clock_ list.
+    std::list<Key>::iterator clock_position_;
+  };
+
+  struct Shard {
+    absl::Mutex mutex_;
+    absl::flat_hash_map<Key, Slot, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+    // Keys in the order the eviction hand visits them; the front is examined next.
+    std::list<Key> clock_ ABSL_GUARDED_BY(mutex_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_){0};
+  };
+
+  Shard& shardFor(const Key& key);
+  EntrySharedPtr find(const Key& key);
+  // Inserts or replaces the entry for key. If keep_vary_marker is set, an existing entry whose
+  // headers have a Vary header is kept instead.
+  bool publish(const Key& key, std::unique_ptr<Entry> entry, bool keep_vary_marker = false);
+  bool replaceHeaders(const Key& key, const Http::ResponseHeaderMap& response_headers,
+                      const ResponseMetadata& metadata);
+  // Evicts entries from shard until it holds at most target_bytes.
+  void evict(Shard& shard, uint64_t target_bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+  void erase(Shard& shard, absl::flat_hash_map<Key, Slot, MessageUtil, MessageUtil>::iterator it)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  const ConfigProto config_;
+  // The scope of this cache's stats, which lives as long as the cache.
+  const Stats::ScopeSharedPtr stats_scope_;
+  ShardedLruHttpCacheStats stats_;
+  const uint64_t max_shard_size_bytes_;
+  const uint64_t max_entry_size_bytes_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace ShardedLruHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
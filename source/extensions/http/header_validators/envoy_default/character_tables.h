@@ -40,6 +40,9 @@ inline constexpr std::array<uint32_t, 8> kGenericHeaderValueCharTable = {
     0b11111111111111111111111111111111,
 };
 
+inline constexpr ::Envoy::Http::CharacterSet kGenericHeaderValueCharSet{
+    kGenericHeaderValueCharTable};
+
 // :method header character table.
 // From RFC 9110: https://www.rfc-editor.org/rfc/rfc9110.html#section-9.1
 //
@@ -104,6 +107,8 @@ inline constexpr std::array<uint32_t, 8> kPathHeaderCharTable = {
     0b00000000000000000000000000000000,
 };
 
+inline constexpr ::Envoy::Http::CharacterSet kPathHeaderCharSet{kPathHeaderCharTable};
+
 // Unreserved characters.
 // From RFC 3986: https://datatracker.ietf.org/doc/html/rfc3986#section-2.3
 //
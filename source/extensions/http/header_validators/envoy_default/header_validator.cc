@@ -29,6 +29,9 @@ using ::envoy::extensions::http::header_validators::envoy_default::v3::HeaderVal
 using ::Envoy::Http::HeaderString;
 using ::Envoy::Http::PathUtil;
 using ::Envoy::Http::Protocol;
+using ::Envoy::Http::allCharsInSet;
+using ::Envoy::Http::CharacterSet;
+using ::Envoy::Http::findFirstCharNotInSet;
 using ::Envoy::Http::testCharInTable;
 using ::Envoy::Http::UhvResponseCodeDetail;
 
@@ -193,26 +196,19 @@ HeaderValidator::validateGenericHeaderName(const HeaderString& name) {
 
   const bool reject_header_names_with_underscores =
       config_.headers_with_underscores_action() == HeaderValidatorConfig::REJECT_REQUEST;
-  bool is_valid = true;
-  bool reject_due_to_underscore = false;
-  char c = '\0';
-
-  for (auto iter = key_string_view.begin();
-       iter != key_string_view.end() && is_valid && !reject_due_to_underscore; ++iter) {
-    c = *iter;
-    if (c != '_') {
-      is_valid &= testCharInTable(::Envoy::Http::kGenericHeaderNameCharTable, c);
-    } else {
-      reject_due_to_underscore = reject_header_names_with_underscores;
-    }
-  }
-
-  if (!is_valid) {
+  // Whichever of an invalid character and a rejected underscore comes first decides the result.
+  const size_t invalid_offset =
+      findFirstCharNotInSet(::Envoy::Http::kGenericHeaderNameCharSet, key_string_view);
+  const size_t underscore_offset = reject_header_names_with_underscores
+                                       ? key_string_view.find('_')
+                                       : absl::string_view::npos;
+
+  if (invalid_offset < key_string_view.size() && invalid_offset < underscore_offset) {
     return {HeaderEntryValidationResult::Action::Reject,
             UhvResponseCodeDetail::get().InvalidNameCharacters};
   }
 
-  if (reject_due_to_underscore) {
+  if (underscore_offset != absl::string_view::npos) {
     stats_.incRequestsRejectedWithUnderscoresInHeaders();
     return {HeaderEntryValidationResult::Action::Reject,
             UhvResponseCodeDetail::get().InvalidUnderscore};
@@ -236,14 +232,7 @@ HeaderValidator::validateGenericHeaderValue(const HeaderString& value) {
   //
   // VCHAR          =  %x21-7E
   //                   ; visible (printing) characters
-  const auto& value_string_view = value.getStringView();
-  bool is_valid = true;
-
-  for (auto iter = value_string_view.begin(); iter != value_string_view.end() && is_valid; ++iter) {
-    is_valid &= testCharInTable(kGenericHeaderValueCharTable, *iter);
-  }
-
-  if (!is_valid) {
+  if (!allCharsInSet(kGenericHeaderValueCharSet, value.getStringView())) {
     return {HeaderValueValidationResult::Action::Reject,
             UhvResponseCodeDetail::get().InvalidValueCharacters};
   }
@@ -390,62 +379,48 @@ HeaderValidator::validateHostHeaderRegName(absl::string_view host) {
 
 HeaderValidator::HeaderValueValidationResult
 HeaderValidator::validatePathHeaderCharacters(const HeaderString& value) {
-  return validatePathHeaderCharacterSet(value, kPathHeaderCharTable,
-                                        ::Envoy::Http::kUriQueryAndFragmentCharTable);
+  return validatePathHeaderCharacterSet(value, kPathHeaderCharSet,
+                                        ::Envoy::Http::kUriQueryAndFragmentCharSet);
 }
 
 HeaderValidator::HeaderValueValidationResult HeaderValidator::validatePathHeaderCharacterSet(
-    const HeaderString& value, const std::array<uint32_t, 8>& allowed_path_chracters,
-    const std::array<uint32_t, 8>& allowed_query_fragment_characters) {
+    const HeaderString& value, const CharacterSet& allowed_path_characters,
+    const CharacterSet& allowed_query_fragment_characters) {
   static const HeaderValueValidationResult bad_path_result{
       HeaderValueValidationResult::Action::Reject, UhvResponseCodeDetail::get().InvalidUrl};
-  const auto& path = value.getStringView();
+  // The start of the query or fragment is found by the scan of the path component.
+  ASSERT(!allowed_path_characters.contains('?') && !allowed_path_characters.contains('#'));
+  absl::string_view path = value.getStringView();
   if (path.empty()) {
     return bad_path_result;
   }
 
-  auto iter = path.begin();
-  auto end = path.end();
-
   // Validate the path component of the URI
-  for (; iter != end; ++iter) {
-    if (*iter == '?' || *iter == '#') {
-      // This is the start of the query or fragment portion of the path which uses a different
-      // character table.
-      break;
-    }
-
-    if (!testCharInTable(allowed_path_chracters, *iter)) {
-      return bad_path_result;
-    }
+  path.remove_prefix(findFirstCharNotInSet(allowed_path_characters, path));
+  if (!path.empty() && path[0] != '?' && path[0] != '#') {
+    return bad_path_result;
   }
 
-  if (iter != end && *iter == '?') {
-    // Validate the query component of the URI
-    ++iter;
-    for (; iter != end; ++iter) {
-      if (*iter == '#') {
-        break;
-      }
-
-      if (!testCharInTable(allowed_query_fragment_characters, *iter)) {
-        return bad_path_result;
-      }
+  if (!path.empty() && path[0] == '?') {
+    // Validate the query component of the URI, which ends at the fragment, if any. The query
+    // character set may allow '#', so the end is found first.
+    path.remove_prefix(1);
+    const absl::string_view query = path.substr(0, path.find('#'));
+    if (!allCharsInSet(allowed_query_fragment_characters, query)) {
+      return bad_path_result;
     }
+    path.remove_prefix(query.size());
   }
 
-  if (iter != end) {
-    ASSERT(*iter == '#');
+  if (!path.empty()) {
+    ASSERT(path[0] == '#');
     if (!config_.strip_fragment_from_path()) {
       return {HeaderValueValidationResult::Action::Reject,
               UhvResponseCodeDetail::get().FragmentInUrlPath};
     }
     // Validate the fragment component of the URI
-    ++iter;
-    for (; iter != end; ++iter) {
-      if (!testCharInTable(allowed_query_fragment_characters, *iter)) {
-        return bad_path_result;
-      }
+    if (!allCharsInSet(allowed_query_fragment_characters, path.substr(1))) {
+      return bad_path_result;
     }
   }
 
@@ -97,9 +97,13 @@ Http1HeaderValidator::validatePathHeaderWithAdditionalCharacters(
       0b00000000000000000000000000000000,
       0b00000000000000000000000000000000,
   };
+  static constexpr ::Envoy::Http::CharacterSet kPathHeaderCharSetWithAdditionalCharacters{
+      kPathHeaderCharTableWithAdditionalCharacters};
+  static constexpr ::Envoy::Http::CharacterSet kQueryAndFragmentCharSetWithAdditionalCharacters{
+      kQueryAndFragmentCharTableWithAdditionalCharacters};
   return HeaderValidator::validatePathHeaderCharacterSet(
-      path_header_value, kPathHeaderCharTableWithAdditionalCharacters,
-      kQueryAndFragmentCharTableWithAdditionalCharacters);
+      path_header_value, kPathHeaderCharSetWithAdditionalCharacters,
+      kQueryAndFragmentCharSetWithAdditionalCharacters);
 }
 
 HeaderValidator::HeaderEntryValidationResult
@@ -24,7 +24,6 @@ using ::envoy::extensions::http::header_validators::envoy_default::v3::HeaderVal
 using ::Envoy::Http::HeaderString;
 using ::Envoy::Http::HeaderUtility;
 using ::Envoy::Http::Protocol;
-using ::Envoy::Http::testCharInTable;
 using ::Envoy::Http::UhvResponseCodeDetail;
 using ValidationResult = ::Envoy::Http::HeaderValidator::ValidationResult;
 
@@ -152,9 +151,13 @@ Http2HeaderValidator::validatePathHeaderWithAdditionalCharactersHttp2(
       0b11111111111111111111111111111111,
       0b11111111111111111111111111111111,
   };
+  static constexpr ::Envoy::Http::CharacterSet kPathHeaderCharSetWithAdditionalCharacters{
+      kPathHeaderCharTableWithAdditionalCharacters};
+  static constexpr ::Envoy::Http::CharacterSet kQueryAndFragmentCharSetWithAdditionalCharacters{
+      kQueryAndFragmentCharTableWithAdditionalCharacters};
   return HeaderValidator::validatePathHeaderCharacterSet(
-      path_header_value, kPathHeaderCharTableWithAdditionalCharacters,
-      kQueryAndFragmentCharTableWithAdditionalCharacters);
+      path_header_value, kPathHeaderCharSetWithAdditionalCharacters,
+      kQueryAndFragmentCharSetWithAdditionalCharacters);
 }
 
 HeaderValidator::HeaderValueValidationResult
@@ -200,9 +203,13 @@ Http2HeaderValidator::validatePathHeaderWithAdditionalCharactersHttp3(
       0b00000000000000000000000000000000,
       0b00000000000000000000000000000000,
   };
+  static constexpr ::Envoy::Http::CharacterSet kPathHeaderCharSetWithAdditionalCharacters{
+      kPathHeaderCharTableWithAdditionalCharacters};
+  static constexpr ::Envoy::Http::CharacterSet kQueryAndFragmentCharSetWithAdditionalCharacters{
+      kQueryAndFragmentCharTableWithAdditionalCharacters};
   return HeaderValidator::validatePathHeaderCharacterSet(
-      path_header_value, kPathHeaderCharTableWithAdditionalCharacters,
-      kQueryAndFragmentCharTableWithAdditionalCharacters);
+      path_header_value, kPathHeaderCharSetWithAdditionalCharacters,
+      kQueryAndFragmentCharSetWithAdditionalCharacters);
 }
 
 ValidationResult
@@ -471,35 +478,45 @@ Http2HeaderValidator::validateGenericHeaderName(const HeaderString& name) {
             Http2ResponseCodeDetail::get().ConnectionHeaderSanitization};
   }
 
-  const bool reject_header_names_with_underscores =
-      config_.headers_with_underscores_action() == HeaderValidatorConfig::REJECT_REQUEST;
-  bool is_valid = true;
-  char c = '\0';
-  bool reject_due_to_underscore = false;
-
   // Verify that the header name is all lowercase. From RFC 9113,
   // https://www.rfc-editor.org/rfc/rfc9113#section-8.2.1:
   //
   // A field name MUST NOT contain characters in the ranges 0x00-0x20, 0x41-0x5a, or 0x7f-0xff (all
   // ranges inclusive). This specifically excludes all non-visible ASCII characters, ASCII SP
   // (0x20), and uppercase characters ('A' to 'Z', ASCII 0x41 to 0x5a).
-  for (auto iter = key_string_view.begin();
-       iter != key_string_view.end() && is_valid && !reject_due_to_underscore; ++iter) {
-    c = *iter;
-    if (c != '_') {
-      is_valid &=
-          testCharInTable(::Envoy::Http::kGenericHeaderNameCharTable, c) && (c < 'A' || c > 'Z');
-    } else {
-      reject_due_to_underscore = reject_header_names_with_underscores;
-    }
-  }
+  //
+  // The table is kGenericHeaderNameCharTable without the uppercase characters.
+  static constexpr ::Envoy::Http::CharacterSet kLowercaseHeaderNameCharSet{{
+      // control characters
+      0b00000000000000000000000000000000,
+      // !"#$%&'()*+,-./0123456789:;<=>?
+      0b01011111001101101111111111000000,
+      //@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\]^_
+      0b00000000000000000000000000000011,
+      //`abcdefghijklmnopqrstuvwxyz{|}~
+      0b11111111111111111111111111101010,
+      // extended ascii
+      0b00000000000000000000000000000000,
+      0b00000000000000000000000000000000,
+      0b00000000000000000000000000000000,
+      0b00000000000000000000000000000000,
+  }};
 
-  if (!is_valid) {
+  const bool reject_header_names_with_underscores =
+      config_.headers_with_underscores_action() == HeaderValidatorConfig::REJECT_REQUEST;
+  // Whichever of an invalid character and a rejected underscore comes first decides the result.
+  const size_t invalid_offset =
+      ::Envoy::Http::findFirstCharNotInSet(kLowercaseHeaderNameCharSet, key_string_view);
+  const size_t underscore_offset = reject_header_names_with_underscores
+                                       ? key_string_view.find('_')
+                                       : absl::string_view::npos;
+
+  if (invalid_offset < key_string_view.size() && invalid_offset < underscore_offset) {
     return {HeaderEntryValidationResult::Action::Reject,
             UhvResponseCodeDetail::get().InvalidNameCharacters};
   }
 
-  if (reject_due_to_underscore) {
+  if (underscore_offset != absl::string_view::npos) {
     stats_.incRequestsRejectedWithUnderscoresInHeaders();
     return {HeaderEntryValidationResult::Action::Reject,
             UhvResponseCodeDetail::get().InvalidUnderscore};
@@ -108,9 +108,37 @@ absl::Status ThreadAwareLoadBalancerBase::initialize() {
   return refresh();
 }
 
-absl::Status ThreadAwareLoadBalancerBase::refresh() {
+absl::Status
+ThreadAwareLoadBalancerBase::initializeWithBuildPool(LoadBalancerBuildPool& build_pool) {
+  // Only the initial build goes to the pool: until it is published, load balancers created by the
+  // factory wait for it on first use, which is harmless while the server is starting but would
+  // stall traffic on updates.
+  priority_update_cb_ = priority_set_.addPriorityUpdateCb(
+      [this](uint32_t, const HostVector&, const HostVector&) -> absl::Status { return refresh(); });
+
+  return refresh(&build_pool);
+}
+
+void ThreadAwareLoadBalancerBase::cancelBuild() {
+  // Make sure that no build on the pool starts from now on and wait for one which is running.
+  LoadBalancerFactoryImpl& factory = *factory_;
+  const auto condition = [&factory]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(factory.mutex_) {
+    return !factory.building_;
+  };
+  absl::MutexLock lock(&factory.mutex_);
+  ++factory.generation_;
+  factory.ready_ = true;
+  factory.mutex_.Await(absl::Condition(&condition));
+}
+
+absl::Status ThreadAwareLoadBalancerBase::refresh(LoadBalancerBuildPool* build_pool) {
   auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
       priority_set_.hostSetsPerPriority().size());
+  std::shared_ptr<std::vector<PerPriorityStatePtr>> previous_per_priority_state_vector;
+  {
+    absl::ReaderMutexLock lock(&factory_->mutex_);
+    previous_per_priority_state_vector = factory_->per_priority_state_;
+  }
   auto healthy_per_priority_load =
       std::make_shared<HealthyLoad>(per_priority_load_.healthy_priority_load_);
   auto degraded_per_priority_load =
@@ -125,28 +153,98 @@ absl::Status ThreadAwareLoadBalancerBase::refresh() {
     per_priority_state->global_panic_ = per_priority_panic_[priority];
 
     // Normalize host and locality weights such that the sum of all normalized weights is 1.
-    NormalizedHostWeightVector normalized_host_weights;
-    double min_normalized_weight = 1.0;
-    double max_normalized_weight = 0.0;
-    absl::Status status = normalizeWeights(*host_set, per_priority_state->global_panic_,
-                                           normalized_host_weights, min_normalized_weight,
-                                           max_normalized_weight, locality_weighted_balancing_);
+    absl::Status status = normalizeWeights(
+        *host_set, per_priority_state->global_panic_, per_priority_state->normalized_host_weights_,
+        per_priority_state->min_normalized_weight_, per_priority_state->max_normalized_weight_,
+        locality_weighted_balancing_);
     RETURN_IF_NOT_OK(status);
-    per_priority_state->current_lb_ = createLoadBalancer(
-        std::move(normalized_host_weights), min_normalized_weight, max_normalized_weight);
+    per_priority_state->host_metadata_.reserve(per_priority_state->normalized_host_weights_.size());
+    for (const auto& host_weight : per_priority_state->normalized_host_weights_) {
+      per_priority_state->host_metadata_.push_back(host_weight.first->metadata());
+    }
+
+    // An update usually changes the hosts of one priority, or none at all when it only changes
+    // host attributes which don't matter here, so the load balancer of the other priorities is
+    // reused rather than built from the same inputs again.
+    if (previous_per_priority_state_vector != nullptr &&
+        priority < previous_per_priority_state_vector->size()) {
+      const PerPriorityState& previous = *(*previous_per_priority_state_vector)[priority];
+      if (per_priority_state->sameInputs(previous)) {
+        per_priority_state->current_lb_ = previous.current_lb_;
+      }
+    }
   }
 
-  {
+  if (build_pool == nullptr) {
+    buildLoadBalancers(*per_priority_state_vector);
     absl::WriterMutexLock lock(&factory_->mutex_);
+    ++factory_->generation_;
+    factory_->ready_ = true;
     factory_->healthy_per_priority_load_ = healthy_per_priority_load;
     factory_->degraded_per_priority_load_ = degraded_per_priority_load;
     factory_->per_priority_state_ = per_priority_state_vector;
+    return absl::OkStatus();
   }
+
+  uint64_t generation;
+  {
+    absl::WriterMutexLock lock(&factory_->mutex_);
+    generation = ++factory_->generation_;
+    factory_->ready_ = false;
+  }
+  build_pool->post([this, factory = factory_, generation,
+                    per_priority_state_vector = std::move(per_priority_state_vector),
+                    healthy_per_priority_load = std::move(healthy_per_priority_load),
+                    degraded_per_priority_load = std::move(degraded_per_priority_load)]() mutable {
+    {
+      // The load balancer may have been refreshed or destroyed since the build was posted.
+      absl::WriterMutexLock lock(&factory->mutex_);
+      if (factory->generation_ != generation) {
+        return;
+      }
+      factory->building_ = true;
+    }
+    buildLoadBalancers(*per_priority_state_vector);
+    absl::WriterMutexLock lock(&factory->mutex_);
+    factory->building_ = false;
+    if (factory->generation_ == generation) {
+      factory->ready_ = true;
+      factory->healthy_per_priority_load_ = std::move(healthy_per_priority_load);
+      factory->degraded_per_priority_load_ = std::move(degraded_per_priority_load);
+      factory->per_priority_state_ = std::move(per_priority_state_vector);
+    }
+  });
   return absl::OkStatus();
 }
 
+bool ThreadAwareLoadBalancerBase::PerPriorityState::sameInputs(
+    const PerPriorityState& other) const {
+  // Hosts are compared by identity, as a host whose address or hostname changes is a new host.
+  // Their metadata is compared by identity too, as it is replaced rather than modified.
+  return other.current_lb_ != nullptr && min_normalized_weight_ == other.min_normalized_weight_ &&
+         max_normalized_weight_ == other.max_normalized_weight_ &&
+         normalized_host_weights_ == other.normalized_host_weights_ &&
+         host_metadata_ == other.host_metadata_;
+}
+
+void ThreadAwareLoadBalancerBase::buildLoadBalancers(
+    std::vector<PerPriorityStatePtr>& per_priority_state) {
+  for (const PerPriorityStatePtr& state : per_priority_state) {
+    if (state->current_lb_ == nullptr) {
+      state->current_lb_ = createLoadBalancer(state->normalized_host_weights_,
+                                              state->min_normalized_weight_,
+                                              state->max_normalized_weight_);
+    }
+  }
+}
+
 HostConstSharedPtr
 ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* context) {
+  if (pending_factory_ != nullptr) {
+    pending_factory_->waitForState(*this);
+    pending_factory_.reset();
+  }
+
   // Make sure we correctly return nullptr for any early chooseHost() calls.
   if (per_priority_state_ == nullptr) {
     return nullptr;
@@ -190,12 +288,27 @@ LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create(Loa
   // We must protect current_lb_ via a RW lock since it is accessed and written to by multiple
   // threads. All complex processing has already been precalculated however.
   absl::ReaderMutexLock lock(&mutex_);
+  if (!ready_) {
+    // The initial state is still being built on a build pool. The main thread creates a load
+    // balancer as each cluster initializes, so waiting here would make it wait for the builds one
+    // after another instead of letting them overlap. The state is taken on first use instead.
+    lb->pending_factory_ = shared_from_this();
+    return lb;
+  }
   lb->healthy_per_priority_load_ = healthy_per_priority_load_;
   lb->degraded_per_priority_load_ = degraded_per_priority_load_;
   lb->per_priority_state_ = per_priority_state_;
   return lb;
 }
 
+void ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::waitForState(LoadBalancerImpl& lb) {
+  absl::ReaderMutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(&ready_));
+  lb.healthy_per_priority_load_ = healthy_per_priority_load_;
+  lb.degraded_per_priority_load_ = degraded_per_priority_load_;
+  lb.per_priority_state_ = per_priority_state_;
+}
+
 double ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::hostOverloadFactor(
     const Host& host, double weight) const {
   // TODO(scheler): This will not work if rq_active cluster stat is disabled, need to detect
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bitset>
+#include <memory>
 
 #include "envoy/common/callback.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -88,6 +89,7 @@ public:
   // Upstream::ThreadAwareLoadBalancer
   LoadBalancerFactorySharedPtr factory() override { return factory_; }
   absl::Status initialize() override;
+  absl::Status initializeWithBuildPool(LoadBalancerBuildPool& build_pool) override;
 
   // Upstream::LoadBalancer
   HostConstSharedPtr chooseHost(LoadBalancerContext*) override { return nullptr; }
@@ -112,14 +114,32 @@ protected:
       : LoadBalancerBase(priority_set, stats, runtime, random, healthy_panic_threshold),
         factory_(new LoadBalancerFactoryImpl(stats, random)),
         locality_weighted_balancing_(locality_weighted_balancing) {}
+  ~ThreadAwareLoadBalancerBase() override { cancelBuild(); }
+
+  /**
+   * Makes sure that no build posted by initializeWithBuildPool() is running or will run. A build
+   * calls createLoadBalancer(), so subclasses must call this first thing in their destructor.
+   */
+  void cancelBuild();
 
 private:
   struct PerPriorityState {
+    // Whether current_lb_ of other, if any, is built from the same hosts, weights and hash keys.
+    bool sameInputs(const PerPriorityState& other) const;
+
     std::shared_ptr<HashingLoadBalancer> current_lb_;
     bool global_panic_{};
+    // The inputs current_lb_ is built from. A refresh which leaves them unchanged reuses it.
+    NormalizedHostWeightVector normalized_host_weights_;
+    double min_normalized_weight_{1.0};
+    double max_normalized_weight_{0.0};
+    // The metadata of each host, which may supply its hash key.
+    std::vector<MetadataConstSharedPtr> host_metadata_;
   };
   using PerPriorityStatePtr = std::unique_ptr<PerPriorityState>;
 
+  struct LoadBalancerFactoryImpl;
+
   struct LoadBalancerImpl : public LoadBalancer {
     LoadBalancerImpl(ClusterLbStats& stats, Random::RandomGenerator& random)
         : stats_(stats), random_(random) {}
@@ -143,9 +163,13 @@ private:
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
     std::shared_ptr<HealthyLoad> healthy_per_priority_load_;
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_;
+    // Set when this was created while the initial state was still being built on a build pool.
+    // The state is then taken from the factory on first use.
+    std::shared_ptr<LoadBalancerFactoryImpl> pending_factory_;
   };
 
-  struct LoadBalancerFactoryImpl : public LoadBalancerFactory {
+  struct LoadBalancerFactoryImpl : public LoadBalancerFactory,
+                                   public std::enable_shared_from_this<LoadBalancerFactoryImpl> {
     LoadBalancerFactoryImpl(ClusterLbStats& stats, Random::RandomGenerator& random)
         : stats_(stats), random_(random) {}
 
@@ -153,6 +177,9 @@ private:
     // Ignore the params for the thread-aware LB.
     LoadBalancerPtr create(LoadBalancerParams) override;
 
+    // Waits for the initial state, if it is still being built, and hands it to lb.
+    void waitForState(LoadBalancerImpl& lb);
+
     ClusterLbStats& stats_;
     Random::RandomGenerator& random_;
     absl::Mutex mutex_;
@@ -160,12 +187,21 @@ private:
     // This is split out of PerPriorityState so LoadBalancerBase::ChoosePriority can be reused.
     std::shared_ptr<HealthyLoad> healthy_per_priority_load_ ABSL_GUARDED_BY(mutex_);
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_ ABSL_GUARDED_BY(mutex_);
+    // Incremented by every refresh and when the load balancer is destroyed, so that a build on the
+    // pool which has been overtaken does not publish its state.
+    uint64_t generation_ ABSL_GUARDED_BY(mutex_){};
+    // False while a build on the pool is pending. Load balancers created meanwhile wait for it on
+    // first use.
+    bool ready_ ABSL_GUARDED_BY(mutex_){true};
+    // True while a build on the pool is calling back into the load balancer.
+    bool building_ ABSL_GUARDED_BY(mutex_){};
   };
 
   virtual HashingLoadBalancerSharedPtr
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double max_normalized_weight) PURE;
-  absl::Status refresh();
+  absl::Status refresh(LoadBalancerBuildPool* build_pool = nullptr);
+  void buildLoadBalancers(std::vector<PerPriorityStatePtr>& per_priority_state);
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
   const bool locality_weighted_balancing_{};
@@ -144,6 +144,10 @@ void OriginalMaglevTable::constructImplementationInternals(
   // Size internal representation for maglev table correctly.
   table_.resize(table_size_);
 
+  // Track which entries of the table are taken in a bitmap, which is probed much faster than the
+  // table itself.
+  std::vector<bool> occupied(table_size_, false);
+
   // Iterate through the table build entries as many times as it takes to fill up the table.
   uint64_t table_index = 0;
   for (uint32_t iteration = 1; table_index < table_size_; ++iteration) {
@@ -157,14 +161,13 @@ void OriginalMaglevTable::constructImplementationInternals(
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
-        entry.next_++;
-        c = permutation(entry);
+      while (occupied[entry.permutation_]) {
+        nextPermutation(entry);
       }
 
-      table_[c] = entry.host_;
-      entry.next_++;
+      table_[entry.permutation_] = entry.host_;
+      occupied[entry.permutation_] = true;
+      nextPermutation(entry);
       entry.count_++;
       table_index++;
     }
@@ -207,19 +210,17 @@ void CompactMaglevTable::constructImplementationInternals(
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      // As we're using the compact implementation, our table size is limited to
-      // 32-bit, hence static_cast here should be safe.
-      uint32_t c = static_cast<uint32_t>(permutation(entry));
-      while (occupied[c]) {
-        entry.next_++;
-        c = static_cast<uint32_t>(permutation(entry));
+      while (occupied[entry.permutation_]) {
+        nextPermutation(entry);
       }
 
-      // Record the index of the given host.
+      // Record the index of the given host. As we're using the compact implementation, our table
+      // size is limited to 32-bit, hence static_cast here should be safe.
+      const uint32_t c = static_cast<uint32_t>(entry.permutation_);
       table_.set(c, i);
       occupied[c] = true;
 
-      entry.next_++;
+      nextPermutation(entry);
       entry.count_++;
       table_index++;
     }
@@ -282,10 +283,6 @@ HostConstSharedPtr CompactMaglevTable::chooseHost(uint64_t hash, uint32_t attemp
   return host_table_[index];
 }
 
-uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
-  return (entry.offset_ + (entry.skip_ * entry.next_)) % table_size_;
-}
-
 MaglevLoadBalancer::MaglevLoadBalancer(
     const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
     Runtime::Loader& runtime, Random::RandomGenerator& random,
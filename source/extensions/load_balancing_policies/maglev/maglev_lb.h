@@ -83,18 +83,29 @@ public:
 protected:
   struct TableBuildEntry {
     TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+        : host_(host), offset_(offset), skip_(skip), weight_(weight), permutation_(offset) {}
 
     HostConstSharedPtr host_;
     const uint64_t offset_;
     const uint64_t skip_;
     const double weight_;
     double target_weight_{};
-    uint64_t next_{};
+    // The next entry of the host's permutation, (offset_ + skip_ * next) % table_size_ for
+    // next = 0, 1, 2...
+    uint64_t permutation_;
     uint64_t count_{};
   };
 
-  uint64_t permutation(const TableBuildEntry& entry);
+  /**
+   * Advances the permutation of entry by one. Since offset_ and skip_ are less than the table size,
+   * this needs one addition and at most one subtraction rather than a 64 bit division.
+   */
+  void nextPermutation(TableBuildEntry& entry) const {
+    entry.permutation_ += entry.skip_;
+    if (entry.permutation_ >= table_size_) {
+      entry.permutation_ -= table_size_;
+    }
+  }
 
   /**
    * Template method for constructing the Maglev table.
@@ -188,6 +199,8 @@ public:
                      uint32_t healthy_panic_threshold,
                      const envoy::extensions::load_balancing_policies::maglev::v3::Maglev& config);
 
+  ~MaglevLoadBalancer() override { cancelBuild(); }
+
   const MaglevLoadBalancerStats& stats() const { return stats_; }
   uint64_t tableSize() const { return table_size_; }
 
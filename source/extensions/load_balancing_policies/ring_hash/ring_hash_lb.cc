@@ -1,5 +1,6 @@
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <string>
@@ -90,7 +91,7 @@ RingHashLoadBalancerStats RingHashLoadBalancer::generateStats(Stats::Scope& scop
 }
 
 HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t attempt) const {
-  if (ring_.empty()) {
+  if (hashes_.empty()) {
     return nullptr;
   }
 
@@ -99,18 +100,18 @@ HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t a
   // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
   //       change them!
   int64_t lowp = 0;
-  int64_t highp = ring_.size();
+  int64_t highp = hashes_.size();
   int64_t midp = 0;
   while (true) {
     midp = (lowp + highp) / 2;
 
-    if (midp == static_cast<int64_t>(ring_.size())) {
+    if (midp == static_cast<int64_t>(hashes_.size())) {
       midp = 0;
       break;
     }
 
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
+    uint64_t midval = hashes_[midp];
+    uint64_t midval1 = midp == 0 ? 0 : hashes_[midp - 1];
 
     if (h <= midval && h > midval1) {
       break;
@@ -129,13 +130,52 @@ HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t a
   }
 
   // If a retry host predicate is being applied, behave as if this host was not in the ring.
-  // Note that this does not guarantee a different host: e.g., attempt == ring_.size() or
+  // Note that this does not guarantee a different host: e.g., attempt == hashes_.size() or
   // when the offset causes us to select the same host at another location in the ring.
   if (attempt > 0) {
-    midp = (midp + attempt) % ring_.size();
+    midp = (midp + attempt) % hashes_.size();
   }
 
-  return ring_[midp].host_;
+  return hosts_[host_indexes_[midp]];
+}
+
+// Sorts the ring by hash with a least significant digit radix sort, 11 bits at a time. Rings have
+// up to millions of entries with uniformly distributed hashes, which this sorts several times
+// faster than a comparison sort. Entries with equal hashes keep their order, as they do when small
+// rings are sorted with a comparison sort, so the ring doesn't depend on how it is sorted.
+void RingHashLoadBalancer::Ring::sortRing(std::vector<RingEntry>& ring) {
+  constexpr uint32_t DigitBits = 11;
+  constexpr uint64_t DigitMask = (1 << DigitBits) - 1;
+  if (ring.size() <= DigitMask) {
+    std::stable_sort(ring.begin(), ring.end(),
+                     [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+                       return lhs.hash_ < rhs.hash_;
+                     });
+    return;
+  }
+
+  std::vector<RingEntry> buffer(ring.size());
+  std::vector<uint64_t> offsets(DigitMask + 1);
+  for (uint32_t shift = 0; shift < 64; shift += DigitBits) {
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for (const RingEntry& entry : ring) {
+      offsets[(entry.hash_ >> shift) & DigitMask]++;
+    }
+    // Skip the pass if every entry has the same digit.
+    if (offsets[(ring[0].hash_ >> shift) & DigitMask] == ring.size()) {
+      continue;
+    }
+    uint64_t offset = 0;
+    for (uint64_t& digit_offset : offsets) {
+      const uint64_t count = digit_offset;
+      digit_offset = offset;
+      offset += count;
+    }
+    for (const RingEntry& entry : ring) {
+      buffer[offsets[(entry.hash_ >> shift) & DigitMask]++] = entry;
+    }
+    ring.swap(buffer);
+  }
 }
 
 using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
@@ -162,7 +202,9 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
 
   // Reserve memory for the entire ring up front.
   const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
+  std::vector<RingEntry> ring;
+  ring.reserve(ring_size);
+  hosts_.reserve(normalized_host_weights.size());
 
   // Populate the hash ring by walking through the (host, weight) pairs in
   // normalized_host_weights, and generating (scale * weight) hashes for each host. Since these
@@ -189,6 +231,8 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   uint64_t max_hashes_per_host = 0;
   for (const auto& entry : normalized_host_weights) {
     const auto& host = entry.first;
+    const uint32_t host_index = hosts_.size();
+    hosts_.push_back(host);
     const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
     ASSERT(!key_to_hash.empty());
 
@@ -213,7 +257,7 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
               : HashUtil::xxHash64(hash_key);
 
       ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key, hash);
-      ring_.push_back({hash, host});
+      ring.push_back({hash, host_index});
       ++i;
       ++current_hashes;
       hash_key_buffer.erase(offset_start, hash_key_buffer.end());
@@ -222,12 +266,17 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     max_hashes_per_host = std::max(i, max_hashes_per_host);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-    return lhs.hash_ < rhs.hash_;
-  });
+  sortRing(ring);
+  hashes_.reserve(ring.size());
+  host_indexes_.reserve(ring.size());
+  for (const RingEntry& entry : ring) {
+    hashes_.push_back(entry.hash_);
+    host_indexes_.push_back(entry.host_index_);
+  }
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (const auto& entry : ring_) {
-      const absl::string_view key_to_hash = hashKey(entry.host_, use_hostname_for_hashing);
+    for (const auto& entry : ring) {
+      const absl::string_view key_to_hash =
+          hashKey(hosts_[entry.host_index_], use_hostname_for_hashing);
       ENVOY_LOG(trace, "ring hash: host={} hash={}", key_to_hash, entry.hash_);
     }
   }
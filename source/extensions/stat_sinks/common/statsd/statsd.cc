@@ -19,7 +19,6 @@
 #include "source/common/config/utility.h"
 #include "source/common/network/socket_interface.h"
 #include "source/common/network/utility.h"
-#include "source/common/stats/symbol_table.h"
 
 #include "absl/strings/str_join.h"
 
@@ -29,6 +28,102 @@ namespace StatSinks {
 namespace Common {
 namespace Statsd {
 
+DatagramBatchWriter::DatagramBatchWriter(Network::Address::InstanceConstSharedPtr address,
+                                         uint64_t max_datagram_size)
+    : DatagramBatchWriter(Network::ioHandleForAddr(Network::Socket::Type::Datagram, address, {}),
+                          address, max_datagram_size) {}
+
+DatagramBatchWriter::DatagramBatchWriter(Network::IoHandlePtr io_handle,
+                                         Network::Address::InstanceConstSharedPtr address,
+                                         uint64_t max_datagram_size)
+    : io_handle_(std::move(io_handle)), address_(std::move(address)),
+      max_datagram_size_(max_datagram_size),
+      pool_(new char[MaxDatagramsPerBatch * max_datagram_size_]) {
+  ASSERT(max_datagram_size_ > 0);
+}
+
+void DatagramBatchWriter::writeLine(absl::string_view head, absl::string_view value,
+                                    absl::string_view type, absl::string_view tail) {
+  const size_t line_size = head.size() + value.size() + type.size() + tail.size();
+  if (line_size > max_datagram_size_) {
+    // Keep the order of lines, then send this one on its own.
+    flush();
+    const std::string line = absl::StrCat(head, value, type, tail);
+    sendOne(line.data(), line.size());
+    return;
+  }
+  if (lengths_[current_] > 0) {
+    // Lines are separated by a newline within a datagram.
+    if (lengths_[current_] + 1 + line_size > max_datagram_size_) {
+      if (current_ + 1 == MaxDatagramsPerBatch) {
+        // The batch is full; send it, and write the next one into the same datagrams.
+        flush();
+      } else {
+        ++current_;
+      }
+    } else {
+      datagram(current_)[lengths_[current_]++] = '\n';
+    }
+  }
+  char* out = datagram(current_) + lengths_[current_];
+  for (absl::string_view part : {head, value, type, tail}) {
+    memcpy(out, part.data(), part.size()); // NOLINT(safe-memcpy)
+    out += part.size();
+  }
+  lengths_[current_] += line_size;
+}
+
+void DatagramBatchWriter::flush() {
+  const uint32_t count = lengths_[current_] > 0 ? current_ + 1 : current_;
+  if (count == 0) {
+    return;
+  }
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  if (os_sys_calls.supportsMmsg() && io_handle_->isOpen()) {
+    std::array<iovec, MaxDatagramsPerBatch> iovecs;
+    std::array<mmsghdr, MaxDatagramsPerBatch> headers;
+    memset(headers.data(), 0, count * sizeof(mmsghdr));
+    for (uint32_t i = 0; i < count; ++i) {
+      iovecs[i].iov_base = datagram(i);
+      iovecs[i].iov_len = lengths_[i];
+      msghdr& header = headers[i].msg_hdr;
+      header.msg_name = const_cast<sockaddr*>(address_->sockAddr());
+      header.msg_namelen = address_->sockAddrLen();
+      header.msg_iov = &iovecs[i];
+      header.msg_iovlen = 1;
+    }
+    uint32_t sent = 0;
+    while (sent < count) {
+      const Api::SysCallIntResult result =
+          os_sys_calls.sendmmsg(io_handle_->fdDoNotUse(), &headers[sent], count - sent, 0);
+      ++send_calls_;
+      if (result.return_value_ <= 0) {
+        // As with single writes, datagrams which cannot be sent are dropped.
+        break;
+      }
+      sent += result.return_value_;
+    }
+    datagrams_sent_ += sent;
+  } else {
+    for (uint32_t i = 0; i < count; ++i) {
+      sendOne(datagram(i), lengths_[i]);
+    }
+  }
+  lengths_.fill(0);
+  current_ = 0;
+}
+
+void DatagramBatchWriter::sendOne(const char* data, size_t length) {
+  Buffer::RawSlice slice{const_cast<char*>(data), length};
+  Network::Utility::writeToSocket(*io_handle_, &slice, 1, nullptr, *address_);
+  ++send_calls_;
+  ++datagrams_sent_;
+}
+
+void MetricLineCache::endFlush() {
+  absl::erase_if(entries_, [this](const auto& entry) { return entry.second.flush_ != flushes_; });
+}
+
 UdpStatsdSink::WriterImpl::WriterImpl(UdpStatsdSink& parent)
     : parent_(parent), io_handle_(Network::ioHandleForAddr(Network::Socket::Type::Datagram,
                                                            parent_.server_address_, {})) {}
@@ -47,16 +142,33 @@ void UdpStatsdSink::WriterImpl::writeBuffer(Buffer::Instance& data) {
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
                              const std::string& prefix, absl::optional<uint64_t> buffer_size,
-                             const Statsd::TagFormat& tag_format)
+                             const Statsd::TagFormat& tag_format, const bool batched_writes)
     : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag),
       prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
-      buffer_size_(buffer_size.value_or(0)), tag_format_(tag_format) {
+      buffer_size_(buffer_size.value_or(0)), tag_format_(tag_format),
+      batch_writer_(batched_writes
+                        ? std::make_unique<DatagramBatchWriter>(
+                              server_address_,
+                              buffer_size.value_or(DatagramBatchWriter::DefaultMaxDatagramSize))
+                        : nullptr) {
   tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<WriterImpl>(*this);
   });
 }
 
+UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
+                             std::unique_ptr<DatagramBatchWriter>&& batch_writer,
+                             const bool use_tag, const std::string& prefix,
+                             const Statsd::TagFormat& tag_format)
+    : tls_(tls.allocateSlot()), use_tag_(use_tag),
+      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix), buffer_size_(0),
+      tag_format_(tag_format), batch_writer_(std::move(batch_writer)) {}
+
 void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
+  if (batch_writer_ != nullptr) {
+    flushBatched(snapshot);
+    return;
+  }
   Writer& writer = tls_->getTyped<Writer>();
   Buffer::OwnedImpl buffer;
 
@@ -88,6 +200,62 @@ void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   // TODO(efimki): Add support of text readouts stats.
 }
 
+void UdpStatsdSink::flushBatched(Stats::MetricSnapshot& snapshot) {
+  metric_cache_.beginFlush();
+  char value[32];
+  for (const auto& counter : snapshot.counters()) {
+    if (counter.counter_.get().used()) {
+      const CachedMetric& cached = cachedMetric(counter.counter_.get());
+      const size_t size = StringUtil::itoa(value, sizeof(value), counter.delta_);
+      batch_writer_->writeLine(cached.head_, absl::string_view(value, size), "|c", cached.tail_);
+    }
+  }
+
+  for (const auto& counter : snapshot.hostCounters()) {
+    writeUncachedLine(counter, counter.delta(), "|c");
+  }
+
+  for (const auto& gauge : snapshot.gauges()) {
+    if (gauge.get().used()) {
+      const CachedMetric& cached = cachedMetric(gauge.get());
+      const size_t size = StringUtil::itoa(value, sizeof(value), gauge.get().value());
+      batch_writer_->writeLine(cached.head_, absl::string_view(value, size), "|g", cached.tail_);
+    }
+  }
+
+  for (const auto& gauge : snapshot.hostGauges()) {
+    writeUncachedLine(gauge, gauge.value(), "|g");
+  }
+
+  batch_writer_->flush();
+  metric_cache_.endFlush();
+}
+
+const MetricLineCache::Entry& UdpStatsdSink::cachedMetric(const Stats::Metric& metric) {
+  return metric_cache_.get(metric, [this](const Stats::Metric& uncached,
+                                          MetricLineCache::Entry& new_entry) {
+    const std::string tags = buildTagStr(uncached.tags());
+    switch (tag_format_.tag_position) {
+    case Statsd::TagPosition::TagAfterValue:
+      new_entry.head_ = absl::StrCat(prefix_, ".", getName(uncached), ":");
+      new_entry.tail_ = tags;
+      break;
+    case Statsd::TagPosition::TagAfterName:
+      new_entry.head_ = absl::StrCat(prefix_, ".", getName(uncached), tags, ":");
+      new_entry.tail_.clear();
+      break;
+    }
+  });
+}
+
+template <class StatType>
+void UdpStatsdSink::writeUncachedLine(const StatType& metric, uint64_t value,
+                                      absl::string_view type) {
+  // Host metrics are copied into each snapshot, so there is nothing to key a cache on.
+  const std::string line = buildMessage(metric, value, std::string(type));
+  batch_writer_->writeLine(line, "", "", "");
+}
+
 void UdpStatsdSink::writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer,
                                 const std::string& statsd_metric) const {
   if (statsd_metric.length() >= buffer_size_) {
@@ -189,11 +357,12 @@ const std::string UdpStatsdSink::buildTagStr(const std::vector<Stats::Tag>& tags
 TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
                              const std::string& cluster_name, ThreadLocal::SlotAllocator& tls,
                              Upstream::ClusterManager& cluster_manager, Stats::Scope& scope,
-                             const std::string& prefix)
+                             const std::string& prefix, const bool batched_writes)
     : prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix), tls_(tls.allocateSlot()),
       cluster_manager_(cluster_manager),
       cx_overflow_stat_(scope.counterFromStatName(
-          Stats::StatNameManagedStorage("statsd.cx_overflow", scope.symbolTable()).statName())) {
+          Stats::StatNameManagedStorage("statsd.cx_overflow", scope.symbolTable()).statName())),
+      metric_cache_(batched_writes ? std::make_unique<MetricLineCache>() : nullptr) {
   THROW_IF_NOT_OK(Config::Utility::checkLocalInfo("tcp statsd", local_info));
   const auto cluster_or_error =
       Config::Utility::checkCluster("tcp statsd", cluster_name, cluster_manager);
@@ -207,10 +376,13 @@ TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
 
 void TcpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   TlsSink& tls_sink = tls_->getTyped<TlsSink>();
+  if (metric_cache_ != nullptr) {
+    metric_cache_->beginFlush();
+  }
   tls_sink.beginFlush(true);
   for (const auto& counter : snapshot.counters()) {
     if (counter.counter_.get().used()) {
-      tls_sink.flushCounter(counter.counter_.get().name(), counter.delta_);
+      flushMetric(tls_sink, counter.counter_.get(), counter.delta_, 'c');
     }
   }
 
@@ -220,7 +392,7 @@ void TcpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
 
   for (const auto& gauge : snapshot.gauges()) {
     if (gauge.get().used()) {
-      tls_sink.flushGauge(gauge.get().name(), gauge.get().value());
+      flushMetric(tls_sink, gauge.get(), gauge.get().value(), 'g');
     }
 
     for (const auto& gauge : snapshot.hostGauges()) {
@@ -229,6 +401,22 @@ void TcpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   }
   // TODO(efimki): Add support of text readouts stats.
   tls_sink.endFlush(true);
+  if (metric_cache_ != nullptr) {
+    metric_cache_->endFlush();
+  }
+}
+
+void TcpStatsdSink::flushMetric(TlsSink& tls_sink, const Stats::Metric& metric, uint64_t value,
+                                char stat_type) {
+  if (metric_cache_ == nullptr) {
+    tls_sink.commonFlush(metric.name(), value, stat_type);
+    return;
+  }
+  const MetricLineCache::Entry& entry = metric_cache_->get(
+      metric, [this](const Stats::Metric& uncached, MetricLineCache::Entry& new_entry) {
+        new_entry.head_ = absl::StrCat(prefix_, ".", uncached.name(), ":");
+      });
+  tls_sink.flushLine(entry.head_, value, stat_type);
 }
 
 void TcpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
@@ -280,7 +468,7 @@ void TcpStatsdSink::TlsSink::commonFlush(const std::string& name, uint64_t value
   // This written this way for maximum perf since with a large number of stats and at a high flush
   // rate this can become expensive.
   const char* snapped_current = current_slice_mem_;
-  const std::string prefix = parent_.getPrefix();
+  const std::string& prefix = parent_.getPrefix();
   memcpy(current_slice_mem_, prefix.data(), prefix.size()); // NOLINT(safe-memcpy)
   current_slice_mem_ += prefix.size();
   *current_slice_mem_++ = '.';
@@ -296,6 +484,27 @@ void TcpStatsdSink::TlsSink::commonFlush(const std::string& name, uint64_t value
   ASSERT(static_cast<uint64_t>(current_slice_mem_ - snapped_current) < max_size);
 }
 
+void TcpStatsdSink::TlsSink::flushLine(absl::string_view head, uint64_t value, char stat_type) {
+  ASSERT(current_slice_mem_ != nullptr);
+  // 34 > 4 (postfix chars, e.g., "|ms\n") + 30 for number (bigger than it will ever be)
+  const uint32_t max_size = head.size() + 34;
+  if (current_buffer_reservation_->slice().len_ - usedBuffer() < max_size) {
+    endFlush(false);
+    beginFlush(false);
+  }
+
+  // Produces something like "envoy.{}:{}|c\n" from the cached "envoy.{}:".
+  const char* snapped_current = current_slice_mem_;
+  memcpy(current_slice_mem_, head.data(), head.size()); // NOLINT(safe-memcpy)
+  current_slice_mem_ += head.size();
+  current_slice_mem_ += StringUtil::itoa(current_slice_mem_, 30, value);
+  *current_slice_mem_++ = '|';
+  *current_slice_mem_++ = stat_type;
+  *current_slice_mem_++ = '\n';
+
+  ASSERT(static_cast<uint64_t>(current_slice_mem_ - snapped_current) < max_size);
+}
+
 void TcpStatsdSink::TlsSink::flushCounter(const std::string& name, uint64_t delta) {
   commonFlush(name, delta, 'c');
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <memory>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/platform.h"
 #include "envoy/local_info/local_info.h"
@@ -15,8 +18,11 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/macros.h"
 #include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/stats/symbol_table.h"
 #include "source/extensions/stat_sinks/common/statsd/tag_formats.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -27,6 +33,107 @@ namespace Statsd {
 
 static const std::string& getDefaultPrefix() { CONSTRUCT_ON_FIRST_USE(std::string, "envoy"); }
 
+/**
+ * Writes statsd lines into datagrams of up to a fixed size, and sends them a batch at a time with a
+ * single sendmmsg() where the platform supports it. The datagrams of a batch are preallocated and
+ * reused across flushes, so lines are formatted straight into the memory they are sent from.
+ */
+class DatagramBatchWriter {
+public:
+  // Roughly an Ethernet MTU less IP and UDP headers, with some room for tunnel overheads.
+  static constexpr uint64_t DefaultMaxDatagramSize = 1432;
+  static constexpr uint32_t MaxDatagramsPerBatch = 64;
+
+  DatagramBatchWriter(Network::Address::InstanceConstSharedPtr address,
+                      uint64_t max_datagram_size);
+  // For testing.
+  DatagramBatchWriter(Network::IoHandlePtr io_handle,
+                      Network::Address::InstanceConstSharedPtr address,
+                      uint64_t max_datagram_size);
+
+  /**
+   * Writes one line, the concatenation of the given parts, starting a new datagram if it does not
+   * fit in the current one. A line longer than a datagram is sent in a datagram of its own.
+   */
+  void writeLine(absl::string_view head, absl::string_view value, absl::string_view type,
+                 absl::string_view tail);
+
+  /**
+   * Sends the datagrams written so far.
+   */
+  void flush();
+
+  /**
+   * @return the number of datagrams sent, and of send calls made to send them, since creation.
+   */
+  uint64_t datagramsSent() const { return datagrams_sent_; }
+  uint64_t sendCalls() const { return send_calls_; }
+
+private:
+  char* datagram(uint32_t index) { return pool_.get() + index * max_datagram_size_; }
+  void sendOne(const char* data, size_t length);
+
+  const Network::IoHandlePtr io_handle_;
+  const Network::Address::InstanceConstSharedPtr address_;
+  const uint64_t max_datagram_size_;
+  std::unique_ptr<char[]> pool_;
+  std::array<size_t, MaxDatagramsPerBatch> lengths_{};
+  // Index of the datagram being written.
+  uint32_t current_{0};
+  uint64_t datagrams_sent_{0};
+  uint64_t send_calls_{0};
+};
+
+/**
+ * Caches the parts of the lines of counters and gauges other than their value and type across
+ * flushes, so that the names of metrics are not rendered from the symbol table on every flush.
+ * Entries are keyed by metric, and dropped after a flush which did not include their metric.
+ */
+class MetricLineCache {
+public:
+  struct Entry {
+    // The metric's encoded StatName, which tells apart a new metric allocated at the address of
+    // one which was deleted.
+    std::string stat_name_;
+    // The prefixed name, followed by the tags if they go before the value, and a colon.
+    std::string head_;
+    // The tags if they go after the value.
+    std::string tail_;
+    // The last flush which wrote the metric.
+    uint64_t flush_{};
+  };
+
+  void beginFlush() { ++flushes_; }
+
+  /**
+   * Drops the entries of the metrics which were not written since beginFlush(), which includes all
+   * deleted ones.
+   */
+  void endFlush();
+
+  /**
+   * @return the entry of metric, which build(metric, entry) fills in if it is not cached.
+   */
+  template <class BuildFn> const Entry& get(const Stats::Metric& metric, BuildFn build) {
+    const Stats::StatName stat_name = metric.statName();
+    const absl::string_view encoded(reinterpret_cast<const char*>(stat_name.dataIncludingSize()),
+                                    stat_name.size());
+    Entry& entry = entries_[&metric];
+    if (entry.flush_ == 0 || entry.stat_name_ != encoded) {
+      entry.stat_name_ = std::string(encoded);
+      build(metric, entry);
+    }
+    entry.flush_ = flushes_;
+    return entry;
+  }
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  absl::flat_hash_map<const Stats::Metric*, Entry> entries_;
+  uint64_t flushes_{0};
+};
+
 /**
  * Implementation of Sink that writes to a UDP statsd address.
  */
@@ -44,6 +151,11 @@ public:
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
                 const bool use_tag, const std::string& prefix = getDefaultPrefix(),
                 absl::optional<uint64_t> buffer_size = absl::nullopt,
+                const Statsd::TagFormat& tag_format = Statsd::getDefaultTagFormat(),
+                const bool batched_writes = false);
+  // For testing the batched mode.
+  UdpStatsdSink(ThreadLocal::SlotAllocator& tls, std::unique_ptr<DatagramBatchWriter>&& batch_writer,
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
                 const Statsd::TagFormat& tag_format = Statsd::getDefaultTagFormat());
   // For testing.
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
@@ -60,9 +172,13 @@ public:
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override;
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
+  // The batched mode writes to a socket of its own rather than a thread local one.
+  bool flushOffMainThread() const override { return batch_writer_ != nullptr; }
 
   bool getUseTagForTest() { return use_tag_; }
   uint64_t getBufferSizeForTest() { return buffer_size_; }
+  bool getBatchedWritesForTest() { return batch_writer_ != nullptr; }
+  size_t cachedMetricsForTest() const { return metric_cache_.size(); }
   const std::string& getPrefix() { return prefix_; }
 
 private:
@@ -84,6 +200,10 @@ private:
 
   void flushBuffer(Buffer::OwnedImpl& buffer, Writer& writer) const;
   void writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer, const std::string& data) const;
+  void flushBatched(Stats::MetricSnapshot& snapshot);
+  const MetricLineCache::Entry& cachedMetric(const Stats::Metric& metric);
+  template <class StatType> void writeUncachedLine(const StatType& metric, uint64_t value,
+                                                   absl::string_view type);
 
   template <class StatType, typename ValueType>
   const std::string buildMessage(const StatType& metric, ValueType value,
@@ -98,6 +218,9 @@ private:
   const std::string prefix_;
   const uint64_t buffer_size_;
   const Statsd::TagFormat tag_format_;
+  // Only set in the batched mode, and then only used by flush().
+  const std::unique_ptr<DatagramBatchWriter> batch_writer_;
+  MetricLineCache metric_cache_;
 };
 
 /**
@@ -107,13 +230,17 @@ class TcpStatsdSink : public Stats::Sink {
 public:
   TcpStatsdSink(const LocalInfo::LocalInfo& local_info, const std::string& cluster_name,
                 ThreadLocal::SlotAllocator& tls, Upstream::ClusterManager& cluster_manager,
-                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix());
+                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix(),
+                const bool batched_writes = false);
 
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override;
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
 
   const std::string& getPrefix() { return prefix_; }
+  size_t cachedMetricsForTest() const {
+    return metric_cache_ != nullptr ? metric_cache_->size() : 0;
+  }
 
 private:
   struct TlsSink : public ThreadLocal::ThreadLocalObject, public Network::ConnectionCallbacks {
@@ -122,6 +249,7 @@ private:
 
     void beginFlush(bool expect_empty_buffer);
     void commonFlush(const std::string& name, uint64_t value, char stat_type);
+    void flushLine(absl::string_view head, uint64_t value, char stat_type);
     void flushCounter(const std::string& name, uint64_t delta);
     void flushGauge(const std::string& name, uint64_t value);
     void endFlush(bool do_write);
@@ -149,6 +277,9 @@ private:
   // 16KiB intermediate buffer for flushing.
   static constexpr uint32_t FLUSH_SLICE_SIZE_BYTES = (1024 * 16);
 
+  void flushMetric(TlsSink& tls_sink, const Stats::Metric& metric, uint64_t value,
+                   char stat_type);
+
   // Prefix for all flushed stats.
   const std::string prefix_;
 
@@ -156,6 +287,8 @@ private:
   ThreadLocal::SlotPtr tls_;
   Upstream::ClusterManager& cluster_manager_;
   Stats::Counter& cx_overflow_stat_;
+  // Only set in the batched mode, and then only used by flush().
+  const std::unique_ptr<MetricLineCache> metric_cache_;
 };
 
 } // namespace Statsd
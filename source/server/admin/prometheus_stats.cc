@@ -1,11 +1,15 @@
 #include "source/server/admin/prometheus_stats.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <type_traits>
 
 #include "source/common/common/empty_string.h"
 #include "source/common/common/macros.h"
 #include "source/common/common/regex.h"
 #include "source/common/stats/histogram_impl.h"
+#include "source/common/stats/symbol_table.h"
 #include "source/common/upstream/host_utility.h"
 
 #include "absl/strings/str_cat.h"
@@ -305,6 +309,29 @@ std::string generateSummaryOutput(const Stats::ParentHistogram& histogram,
   return output;
 };
 
+/*
+ * Outputs the per-host counters and gauges.
+ *
+ * Note: This assumes that there is no overlap in stat name between per-endpoint stats and all
+ * other stats. If this is not true, then the counters/gauges for per-endpoint need to be combined
+ * with the other counters/gauges so that stats can be properly grouped.
+ */
+uint64_t outputHostStats(const Upstream::ClusterManager& cluster_manager,
+                         Buffer::Instance& response, const StatsParams& params,
+                         const Stats::CustomStatNamespaces& custom_namespaces) {
+  std::vector<Stats::PrimitiveCounterSnapshot> host_counters;
+  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges;
+  Upstream::HostUtility::forEachHostMetric(
+      cluster_manager,
+      [&](Stats::PrimitiveCounterSnapshot&& metric) {
+        host_counters.emplace_back(std::move(metric));
+      },
+      [&](Stats::PrimitiveGaugeSnapshot&& metric) { host_gauges.emplace_back(std::move(metric)); });
+
+  return outputPrimitiveStatType(response, params, host_counters, "counter", custom_namespaces) +
+         outputPrimitiveStatType(response, params, host_gauges, "gauge", custom_namespaces);
+}
+
 } // namespace
 
 std::string PrometheusStatsFormatter::formattedTags(const std::vector<Stats::Tag>& tags) {
@@ -397,25 +424,205 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     break;
   }
 
-  // Note: This assumes that there is no overlap in stat name between per-endpoint stats and all
-  // other stats. If this is not true, then the counters/gauges for per-endpoint need to be combined
-  // with the above counter/gauge calls so that stats can be properly grouped.
-  std::vector<Stats::PrimitiveCounterSnapshot> host_counters;
-  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges;
-  Upstream::HostUtility::forEachHostMetric(
-      cluster_manager,
-      [&](Stats::PrimitiveCounterSnapshot&& metric) {
-        host_counters.emplace_back(std::move(metric));
-      },
-      [&](Stats::PrimitiveGaugeSnapshot&& metric) { host_gauges.emplace_back(std::move(metric)); });
+  metric_name_count += outputHostStats(cluster_manager, response, params, custom_namespaces);
 
-  metric_name_count +=
-      outputPrimitiveStatType(response, params, host_counters, "counter", custom_namespaces);
+  return metric_name_count;
+}
 
-  metric_name_count +=
-      outputPrimitiveStatType(response, params, host_gauges, "gauge", custom_namespaces);
+PrometheusStatsRequest::PrometheusStatsRequest(Stats::Store& stats, const StatsParams& params,
+                                               const Stats::CustomStatNamespaces& custom_namespaces,
+                                               const Upstream::ClusterManager& cluster_manager)
+    : params_(params), stats_(stats), custom_namespaces_(custom_namespaces),
+      cluster_manager_(cluster_manager) {}
+
+Http::Code PrometheusStatsRequest::start(Http::ResponseHeaderMap&) {
+  // Hold onto all the scopes so that neither they nor their stats are deleted while the response
+  // is streamed out.
+  stats_.forEachScope(
+      [this](size_t s) { scopes_.reserve(s); },
+      [this](const Stats::Scope& scope) { scopes_.emplace_back(scope.getConstShared()); });
+  startPhase();
+  return Http::Code::OK;
+}
 
-  return metric_name_count;
+bool PrometheusStatsRequest::nextChunk(Buffer::Instance& response) {
+  // nextChunk's contract is to add up to chunk_size_ additional bytes. The
+  // caller is not required to drain the bytes after each call to nextChunk.
+  const uint64_t starting_response_length = response.length();
+  while (response.length() - starting_response_length < chunk_size_) {
+    if (next_family_ < families_.size()) {
+      renderFamily(families_[next_family_++], response);
+      continue;
+    }
+    switch (phase_) {
+    case Phase::Counters:
+      phase_ = Phase::Gauges;
+      break;
+    case Phase::Gauges:
+      phase_ = Phase::TextReadouts;
+      break;
+    case Phase::TextReadouts:
+      phase_ = Phase::Histograms;
+      break;
+    case Phase::Histograms:
+      phase_ = Phase::HostStats;
+      break;
+    case Phase::HostStats:
+      // There is no shared pointer to hold onto per-host stats while pausing between chunks, so
+      // like in StatsRequest they are rendered in one batch.
+      outputHostStats(cluster_manager_, response, params_, custom_namespaces_);
+      phase_ = Phase::Done;
+      break;
+    case Phase::Done:
+      return false;
+    }
+    startPhase();
+  }
+  return phase_ != Phase::Done || next_family_ < families_.size();
+}
+
+void PrometheusStatsRequest::startPhase() {
+  families_.clear();
+  next_family_ = 0;
+  switch (phase_) {
+  case Phase::Counters:
+    populateFamilies<Stats::Counter>();
+    break;
+  case Phase::Gauges:
+    populateFamilies<Stats::Gauge>();
+    break;
+  case Phase::TextReadouts:
+    if (params_.prometheus_text_readouts_) {
+      populateFamilies<Stats::TextReadout>();
+    }
+    break;
+  case Phase::Histograms:
+    populateFamilies<Stats::Histogram>();
+    break;
+  case Phase::HostStats:
+  case Phase::Done:
+    return;
+  }
+
+  // Only the families are sorted, taking the symbol table lock once. Tag-extracted names which
+  // are encoded differently, e.g. one with dynamic and one with symbolic tokens, are in separate
+  // families but sort next to each other, so they are merged afterwards.
+  const Stats::SymbolTable& symbol_table = stats_.constSymbolTable();
+  symbol_table.sortByStatNames<Family>(
+      families_.begin(), families_.end(),
+      [](const Family& family) -> Stats::StatName { return family.tag_extracted_name_; });
+  size_t merged = 0;
+  for (size_t i = 1; i < families_.size(); ++i) {
+    Family& family = families_[merged];
+    if (symbol_table.lessThan(family.tag_extracted_name_, families_[i].tag_extracted_name_)) {
+      if (++merged != i) {
+        families_[merged] = std::move(families_[i]);
+      }
+      continue;
+    }
+    std::move(families_[i].metrics_.begin(), families_[i].metrics_.end(),
+              std::back_inserter(family.metrics_));
+  }
+  if (!families_.empty()) {
+    families_.resize(merged + 1);
+  }
+}
+
+template <class StatType> void PrometheusStatsRequest::populateFamilies() {
+  Stats::StatNameHashMap<size_t> family_index;
+  Stats::IterateFn<StatType> add_stat = [this, &family_index](
+                                            const Stats::RefcountPtr<StatType>& stat) -> bool {
+    if (!params_.shouldShowMetric(*stat)) {
+      return true;
+    }
+    Stats::Metric* metric = stat.get();
+    if constexpr (std::is_same_v<StatType, Stats::Histogram>) {
+      // Only the parent histograms on the main thread have the merged statistics to render.
+      metric = dynamic_cast<Stats::ParentHistogram*>(stat.get());
+      if (metric == nullptr) {
+        return true;
+      }
+    }
+    const Stats::StatName tag_extracted_name = stat->tagExtractedStatName();
+    auto [iter, inserted] = family_index.try_emplace(tag_extracted_name, families_.size());
+    if (inserted) {
+      families_.push_back(Family{tag_extracted_name, {}});
+    }
+    families_[iter->second].metrics_.emplace_back(metric);
+    return true;
+  };
+  for (const Stats::ConstScopeSharedPtr& scope : scopes_) {
+    scope->iterate(add_stat);
+  }
+}
+
+void PrometheusStatsRequest::renderFamily(Family& family, Buffer::Instance& response) {
+  const Stats::SymbolTable& symbol_table = stats_.constSymbolTable();
+  const absl::optional<std::string> prefixed_tag_extracted_name =
+      PrometheusStatsFormatter::metricName(symbol_table.toString(family.tag_extracted_name_),
+                                           custom_namespaces_);
+  if (prefixed_tag_extracted_name.has_value()) {
+    absl::string_view type;
+    switch (phase_) {
+    case Phase::Counters:
+      type = "counter";
+      break;
+    case Phase::Gauges:
+    case Phase::TextReadouts:
+      // TextReadout stats are returned in gauge format, so "gauge" type is set intentionally.
+      type = "gauge";
+      break;
+    case Phase::Histograms:
+      type = params_.histogram_buckets_mode_ == Utility::HistogramBucketsMode::Summary
+                 ? "summary"
+                 : "histogram";
+      break;
+    case Phase::HostStats:
+    case Phase::Done:
+      IS_ENVOY_BUG("rendering a stat family outside of a stat phase");
+      return;
+    }
+    response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name.value(), type));
+
+    // Sort to satisfy the "preferred" ordering from the prometheus spec. Scopes with the same
+    // prefix may hold the same stat, which then sorts next to itself and is dropped.
+    std::vector<Stats::RefcountPtr<Stats::Metric>>& metrics = family.metrics_;
+    symbol_table.sortByStatNames<Stats::RefcountPtr<Stats::Metric>>(
+        metrics.begin(), metrics.end(),
+        [](const Stats::RefcountPtr<Stats::Metric>& metric) -> Stats::StatName {
+          return metric->statName();
+        });
+    metrics.erase(std::unique(metrics.begin(), metrics.end()), metrics.end());
+    for (const Stats::RefcountPtr<Stats::Metric>& metric : metrics) {
+      response.add(renderMetric(*metric, prefixed_tag_extracted_name.value()));
+    }
+  }
+
+  // Release the family's stats as soon as they are rendered.
+  family.metrics_ = {};
+}
+
+std::string PrometheusStatsRequest::renderMetric(const Stats::Metric& metric,
+                                                 const std::string& prefixed_name) const {
+  switch (phase_) {
+  case Phase::Counters:
+    return generateStatNumericOutput(static_cast<const Stats::Counter&>(metric), prefixed_name);
+  case Phase::Gauges:
+    return generateStatNumericOutput(static_cast<const Stats::Gauge&>(metric), prefixed_name);
+  case Phase::TextReadouts:
+    return generateTextReadoutOutput(static_cast<const Stats::TextReadout&>(metric),
+                                     prefixed_name);
+  case Phase::Histograms: {
+    const auto& histogram = static_cast<const Stats::ParentHistogram&>(metric);
+    return params_.histogram_buckets_mode_ == Utility::HistogramBucketsMode::Summary
+               ? generateSummaryOutput(histogram, prefixed_name)
+               : generateHistogramOutput(histogram, prefixed_name);
+  }
+  case Phase::HostStats:
+  case Phase::Done:
+    break;
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
 }
 
 } // namespace Server
@@ -4,9 +4,11 @@
 #include <string>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/server/admin.h"
 #include "envoy/stats/custom_stat_namespaces.h"
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/store.h"
 
 #include "source/server/admin/stats_params.h"
 
@@ -53,5 +55,61 @@ public:
              const Stats::CustomStatNamespaces& custom_namespace_factory);
 };
 
+/**
+ * Streams stats in the Prometheus exposition format, in chunks, with the same output as
+ * PrometheusStatsFormatter::statsAsPrometheus().
+ *
+ * Prometheus requires all the metrics with the same tag-extracted name to be rendered as one
+ * group, and tag extraction does not follow the scope hierarchy: "cluster.a.upstream_rq" and
+ * "cluster.b.upstream_rq" are both "cluster.upstream_rq". So each stat type is collected in turn
+ * from all the scopes, grouped by tag-extracted StatName, and the groups are rendered a chunk at a
+ * time and released as they are rendered. Only the group names are sorted; neither the stats nor
+ * their names are copied out of the store, and the response is never held in full.
+ */
+class PrometheusStatsRequest : public Admin::Request {
+public:
+  static constexpr uint64_t DefaultChunkSize = 2 * 1000 * 1000;
+
+  PrometheusStatsRequest(Stats::Store& stats, const StatsParams& params,
+                         const Stats::CustomStatNamespaces& custom_namespaces,
+                         const Upstream::ClusterManager& cluster_manager);
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override;
+  bool nextChunk(Buffer::Instance& response) override;
+
+  // Sets the chunk size.
+  void setChunkSize(uint64_t chunk_size) { chunk_size_ = chunk_size; }
+
+private:
+  // Ordered to match the output of statsAsPrometheus().
+  enum class Phase { Counters, Gauges, TextReadouts, Histograms, HostStats, Done };
+
+  // The metrics sharing a tag-extracted name.
+  struct Family {
+    Stats::StatName tag_extracted_name_;
+    std::vector<Stats::RefcountPtr<Stats::Metric>> metrics_;
+  };
+
+  // Collects and sorts the families of the current phase's stat type.
+  void startPhase();
+
+  // Collects the metrics of the templatized type from all the scopes into families_.
+  template <class StatType> void populateFamilies();
+
+  void renderFamily(Family& family, Buffer::Instance& response);
+  std::string renderMetric(const Stats::Metric& metric, const std::string& prefixed_name) const;
+
+  StatsParams params_;
+  Stats::Store& stats_;
+  const Stats::CustomStatNamespaces& custom_namespaces_;
+  const Upstream::ClusterManager& cluster_manager_;
+  std::vector<Stats::ConstScopeSharedPtr> scopes_;
+  Phase phase_{Phase::Counters};
+  std::vector<Family> families_;
+  size_t next_family_{0};
+  uint64_t chunk_size_{DefaultChunkSize};
+};
+
 } // namespace Server
 } // namespace Envoy
@@ -134,6 +134,19 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   TCLAP::ValueArg<uint32_t> file_flush_interval_msec("", "file-flush-interval-msec",
                                                      "Interval for log flushing in msec", false,
                                                      10000, "uint32_t", cmd);
+  TCLAP::ValueArg<uint32_t> file_flush_min_size_kb(
+      "", "file-flush-min-size-kb",
+      "Buffered log data in KiB at which a file is flushed before the flush interval", false, 64,
+      "uint32_t", cmd);
+  TCLAP::ValueArg<uint32_t> file_thread_buffer_size_kb(
+      "", "file-thread-buffer-size-kb",
+      "Size in KiB of each thread's buffer for a log file, or 0 to only use a shared buffer", false,
+      64, "uint32_t", cmd);
+  TCLAP::ValueArg<std::string> file_buffer_overflow(
+      "", "file-buffer-overflow",
+      "What a log write does when its thread's buffer is full, one of 'unbounded' (default), "
+      "'block' or 'drop'.",
+      false, "unbounded", "string", cmd);
   TCLAP::ValueArg<uint32_t> drain_time_s("", "drain-time-s",
                                          "Hot restart and LDS removal drain time in seconds", false,
                                          600, "uint32_t", cmd);
@@ -280,6 +293,8 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   service_node_ = service_node.getValue();
   service_zone_ = service_zone.getValue();
   file_flush_interval_msec_ = std::chrono::milliseconds(file_flush_interval_msec.getValue());
+  file_flush_min_size_ = static_cast<uint64_t>(file_flush_min_size_kb.getValue()) * 1024;
+  file_thread_buffer_size_ = static_cast<uint64_t>(file_thread_buffer_size_kb.getValue()) * 1024;
   drain_time_ = std::chrono::seconds(drain_time_s.getValue());
   parent_shutdown_time_ = std::chrono::seconds(parent_shutdown_time_s.getValue());
   socket_path_ = socket_path.getValue();
@@ -304,6 +319,17 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
         fmt::format("error: unknown drain-strategy '{}'", mode.getValue()));
   }
 
+  if (file_buffer_overflow.getValue() == "unbounded") {
+    file_buffer_overflow_policy_ = Server::FileBufferOverflowPolicy::Unbounded;
+  } else if (file_buffer_overflow.getValue() == "block") {
+    file_buffer_overflow_policy_ = Server::FileBufferOverflowPolicy::Block;
+  } else if (file_buffer_overflow.getValue() == "drop") {
+    file_buffer_overflow_policy_ = Server::FileBufferOverflowPolicy::Drop;
+  } else {
+    throw MalformedArgvException(fmt::format("error: unknown file-buffer-overflow '{}'",
+                                             file_buffer_overflow.getValue()));
+  }
+
   if (hot_restart_version_option.getValue()) {
     std::cerr << hot_restart_version_cb(!hot_restart_disabled_);
     throw NoServingException("NoServingException");
@@ -420,6 +446,19 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   }
   command_line_options->mutable_file_flush_interval()->MergeFrom(
       Protobuf::util::TimeUtil::MillisecondsToDuration(fileFlushIntervalMsec().count()));
+  command_line_options->set_file_flush_min_size_kb(fileFlushMinSize() / 1024);
+  command_line_options->set_file_thread_buffer_size_kb(fileThreadBufferSize() / 1024);
+  switch (fileBufferOverflowPolicy()) {
+  case Server::FileBufferOverflowPolicy::Unbounded:
+    command_line_options->set_file_buffer_overflow(envoy::admin::v3::CommandLineOptions::Unbounded);
+    break;
+  case Server::FileBufferOverflowPolicy::Block:
+    command_line_options->set_file_buffer_overflow(envoy::admin::v3::CommandLineOptions::Block);
+    break;
+  case Server::FileBufferOverflowPolicy::Drop:
+    command_line_options->set_file_buffer_overflow(envoy::admin::v3::CommandLineOptions::Drop);
+    break;
+  }
 
   command_line_options->mutable_drain_time()->MergeFrom(
       Protobuf::util::TimeUtil::SecondsToDuration(drainTime().count()));
@@ -67,6 +67,15 @@ public:
   void setFileFlushIntervalMsec(std::chrono::milliseconds file_flush_interval_msec) {
     file_flush_interval_msec_ = file_flush_interval_msec;
   }
+  void setFileFlushMinSize(uint64_t file_flush_min_size) {
+    file_flush_min_size_ = file_flush_min_size;
+  }
+  void setFileThreadBufferSize(uint64_t file_thread_buffer_size) {
+    file_thread_buffer_size_ = file_thread_buffer_size;
+  }
+  void setFileBufferOverflowPolicy(Server::FileBufferOverflowPolicy policy) {
+    file_buffer_overflow_policy_ = policy;
+  }
   void setServiceClusterName(const std::string& service_cluster) {
     service_cluster_ = service_cluster;
   }
@@ -133,6 +142,11 @@ public:
   std::chrono::milliseconds fileFlushIntervalMsec() const override {
     return file_flush_interval_msec_;
   }
+  uint64_t fileFlushMinSize() const override { return file_flush_min_size_; }
+  uint64_t fileThreadBufferSize() const override { return file_thread_buffer_size_; }
+  Server::FileBufferOverflowPolicy fileBufferOverflowPolicy() const override {
+    return file_buffer_overflow_policy_;
+  }
   const std::string& serviceClusterName() const override { return service_cluster_; }
   const std::string& serviceNodeName() const override { return service_node_; }
   const std::string& serviceZone() const override { return service_zone_; }
@@ -196,6 +210,10 @@ private:
   std::string service_node_;
   std::string service_zone_;
   std::chrono::milliseconds file_flush_interval_msec_{10000};
+  uint64_t file_flush_min_size_{64 * 1024};
+  uint64_t file_thread_buffer_size_{64 * 1024};
+  Server::FileBufferOverflowPolicy file_buffer_overflow_policy_{
+      Server::FileBufferOverflowPolicy::Unbounded};
   std::chrono::seconds drain_time_{600};
   std::chrono::seconds parent_shutdown_time_{900};
   Server::DrainStrategy drain_strategy_{Server::DrainStrategy::Gradual};
@@ -1,5 +1,6 @@
 #include "source/server/server.h"
 
+#include <algorithm>
 #include <csignal>
 #include <cstdint>
 #include <ctime>
@@ -26,7 +27,9 @@
 
 #include "source/common/api/api_impl.h"
 #include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/slice_storage_pool.h"
 #include "source/common/common/enum_to_int.h"
+#include "source/common/common/matchers.h"
 #include "source/common/common/mutex_tracer_impl.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/utility.h"
@@ -41,6 +44,7 @@
 #include "source/common/network/socket_interface.h"
 #include "source/common/network/socket_interface_impl.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/runtime/runtime_impl.h"
 #include "source/common/runtime/runtime_keys.h"
 #include "source/common/signal/fatal_error_handler.h"
@@ -96,8 +100,9 @@ InstanceBase::InstanceBase(Init::Manager& init_manager, const Options& options,
           process_context ? ProcessContextOptRef(std::ref(*process_context)) : absl::nullopt,
           watermark_factory)),
       dispatcher_(api_->allocateDispatcher("main_thread")),
-      access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+      access_log_manager_(options.fileFlushIntervalMsec(), options.fileFlushMinSize(),
+                          options.fileThreadBufferSize(), options.fileBufferOverflowPolicy(), *api_,
+                          *dispatcher_, access_log_lock, store),
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory())),
       handler_(getHandler(*dispatcher_)), worker_factory_(thread_local_, *api_, hooks),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
@@ -165,6 +170,32 @@ void InstanceBase::failHealthcheck(bool fail) {
 MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store,
                                        Upstream::ClusterManager& cluster_manager,
                                        TimeSource& time_source) {
+  snapStore(store);
+
+  Upstream::HostUtility::forEachHostMetric(
+      cluster_manager,
+      [this](Stats::PrimitiveCounterSnapshot&& metric) {
+        host_counters_.emplace_back(std::move(metric));
+      },
+      [this](Stats::PrimitiveGaugeSnapshot&& metric) {
+        host_gauges_.emplace_back(std::move(metric));
+      });
+
+  snapshot_time_ = time_source.systemTime();
+}
+
+MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store,
+                                       std::vector<Stats::PrimitiveCounterSnapshot>&& host_counters,
+                                       std::vector<Stats::PrimitiveGaugeSnapshot>&& host_gauges,
+                                       TimeSource& time_source)
+    : host_counters_(std::move(host_counters)), host_gauges_(std::move(host_gauges)) {
+  snapStore(store);
+  snapshot_time_ = time_source.systemTime();
+}
+
+void MetricSnapshotImpl::snapStore(Stats::Store& store) {
+  // The snapped_* vectors hold a reference to every metric, so the snapshot stays consistent even
+  // if a metric is removed from the store while sinks are still reading it.
   store.forEachSinkedCounter(
       [this](std::size_t size) {
         snapped_counters_.reserve(size);
@@ -204,17 +235,6 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store,
         snapped_text_readouts_.push_back(Stats::TextReadoutSharedPtr(&text_readout));
         text_readouts_.push_back(text_readout);
       });
-
-  Upstream::HostUtility::forEachHostMetric(
-      cluster_manager,
-      [this](Stats::PrimitiveCounterSnapshot&& metric) {
-        host_counters_.emplace_back(std::move(metric));
-      },
-      [this](Stats::PrimitiveGaugeSnapshot&& metric) {
-        host_gauges_.emplace_back(std::move(metric));
-      });
-
-  snapshot_time_ = time_source.systemTime();
 }
 
 void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks, Stats::Store& store,
@@ -237,6 +257,8 @@ void InstanceBase::flushStats() {
   }
 
   stats_flush_in_progress_ = true;
+  stats_flush_timespan_ = std::make_unique<Stats::HistogramCompletableTimespanImpl>(
+      server_stats_->stats_flush_duration_ms_, timeSource());
   ENVOY_LOG(debug, "flushing stats");
   // If Envoy is not fully initialized, workers will not be started and mergeHistograms
   // completion callback is not called immediately. As a result of this server stats will
@@ -279,21 +301,96 @@ void InstanceBase::updateServerStats() {
       enumToInt(Utility::serverState(initManager().state(), healthCheckFailed())));
   server_stats_->stats_recent_lookups_.set(
       stats_store_.symbolTable().getRecentLookups([](absl::string_view, uint64_t) {}));
+  server_stats_->stats_rendered_name_cache_bytes_.set(
+      stats_store_.symbolTable().renderedNameCache().memoryBytes());
+  if (buffer_slice_pool_stats_ != nullptr) {
+    // The pool keeps its own totals, so the counters are brought up to date by adding the
+    // difference since the last update.
+    const Buffer::SliceStoragePool::Stats pool_stats = Buffer::SliceStoragePool::stats();
+    buffer_slice_pool_stats_->hits_.add(pool_stats.hits_ - buffer_slice_pool_stats_->hits_.value());
+    buffer_slice_pool_stats_->misses_.add(pool_stats.misses_ -
+                                          buffer_slice_pool_stats_->misses_.value());
+    buffer_slice_pool_stats_->retained_bytes_.set(pool_stats.retained_bytes_);
+  }
 }
 
 void InstanceBase::flushStatsInternal() {
   updateServerStats();
-  auto& stats_config = config_.statsConfig();
-  InstanceUtil::flushMetricsToSinks(stats_config.sinks(), stats_store_, clusterManager(),
+  if (stats_flush_dispatcher_ != nullptr) {
+    flushStatsOnFlushThread();
+    return;
+  }
+  InstanceUtil::flushMetricsToSinks(config_.statsConfig().sinks(), stats_store_, clusterManager(),
                                     timeSource());
+  finishStatsFlush();
+}
+
+void InstanceBase::flushStatsOnFlushThread() {
+  // Host metrics come from the cluster manager, which may only be read on the main thread. The rest
+  // of the snapshot is built on the flush thread; latching counters there is as good as here.
+  std::vector<Stats::PrimitiveCounterSnapshot> host_counters;
+  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges;
+  Upstream::HostUtility::forEachHostMetric(
+      clusterManager(),
+      [&host_counters](Stats::PrimitiveCounterSnapshot&& metric) {
+        host_counters.emplace_back(std::move(metric));
+      },
+      [&host_gauges](Stats::PrimitiveGaugeSnapshot&& metric) {
+        host_gauges.emplace_back(std::move(metric));
+      });
+
+  stats_flush_dispatcher_->post([this, host_counters = std::move(host_counters),
+                                 host_gauges = std::move(host_gauges)]() mutable {
+    auto snapshot = std::make_shared<MetricSnapshotImpl>(stats_store_, std::move(host_counters),
+                                                         std::move(host_gauges), timeSource());
+    for (const auto& sink : config_.statsConfig().sinks()) {
+      if (sink->flushOffMainThread()) {
+        sink->flush(*snapshot);
+      }
+    }
+    // The remaining sinks are flushed on the main thread, which also drops the snapshot's
+    // references so that any metric released meanwhile is freed there.
+    dispatcher_->post([this, snapshot = std::move(snapshot)]() {
+      for (const auto& sink : config_.statsConfig().sinks()) {
+        if (!sink->flushOffMainThread()) {
+          sink->flush(*snapshot);
+        }
+      }
+      finishStatsFlush();
+    });
+  });
+}
+
+void InstanceBase::finishStatsFlush() {
+  stats_flush_timespan_->complete();
+  stats_flush_timespan_.reset();
   // TODO(ramaraochavali): consider adding different flush interval for histograms.
   if (stat_flush_timer_ != nullptr) {
-    stat_flush_timer_->enableTimer(stats_config.flushInterval());
+    stat_flush_timer_->enableTimer(config_.statsConfig().flushInterval());
   }
 
   stats_flush_in_progress_ = false;
 }
 
+void InstanceBase::startStatsFlushThread() {
+  stats_flush_dispatcher_ = api_->allocateDispatcher("stats_flush");
+  stats_flush_thread_ = api_->threadFactory().createThread(
+      [this]() -> void { stats_flush_dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit); },
+      Thread::Options{"stats_flush"});
+}
+
+void InstanceBase::stopStatsFlushThread() {
+  if (stats_flush_dispatcher_ == nullptr) {
+    return;
+  }
+  stats_flush_dispatcher_->exit();
+  stats_flush_thread_->join();
+  stats_flush_thread_.reset();
+  stats_flush_dispatcher_.reset();
+  // A flush which had not completed is abandoned; flushes from now on run on the main thread.
+  stats_flush_in_progress_ = false;
+}
+
 bool InstanceBase::healthCheckFailed() { return !live_.load(); }
 
 ProcessContextOptRef InstanceBase::processContext() {
@@ -450,6 +547,13 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
     RETURN_IF_NOT_OK(Utility::maybeSetApplicationLogFormat(bootstrap_.application_log_config()));
   }
 
+  if (bootstrap_.has_buffer_slice_pool()) {
+    Buffer::SliceStoragePool::configure(
+        true, PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+                  bootstrap_.buffer_slice_pool(), max_retained_bytes_per_thread,
+                  Buffer::SliceStoragePool::DefaultMaxRetainedBytesPerThread));
+  }
+
 #ifdef ENVOY_PERFETTO
   perfetto::TracingInitArgs args;
   // Include in-process events only.
@@ -512,6 +616,17 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
       bootstrap_.stats_config(), stats_store_.symbolTable(), server_contexts_));
   stats_store_.setHistogramSettings(
       std::make_unique<Stats::HistogramSettingsImpl>(bootstrap_.stats_config(), server_contexts_));
+  if (!bootstrap_.stats_config().sharded_counters().empty()) {
+    auto matchers = std::make_shared<
+        std::vector<Matchers::StringMatcherImpl<envoy::type::matcher::v3::StringMatcher>>>();
+    for (const auto& matcher : bootstrap_.stats_config().sharded_counters()) {
+      matchers->emplace_back(matcher, server_contexts_);
+    }
+    stats_store_.setShardedCounterMatcher([matchers](absl::string_view stat_name) {
+      return std::any_of(matchers->begin(), matchers->end(),
+                         [stat_name](const auto& matcher) { return matcher.match(stat_name); });
+    });
+  }
 
   const std::string server_stats_prefix = "server.";
   const std::string server_compilation_settings_stats_prefix = "server.compilation_settings";
@@ -525,6 +640,13 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
               POOL_COUNTER_PREFIX(stats_store_, server_compilation_settings_stats_prefix),
               POOL_GAUGE_PREFIX(stats_store_, server_compilation_settings_stats_prefix),
               POOL_HISTOGRAM_PREFIX(stats_store_, server_compilation_settings_stats_prefix))});
+  if (bootstrap_.has_buffer_slice_pool()) {
+    const std::string buffer_slice_pool_stats_prefix = "server.buffer_slice_pool.";
+    buffer_slice_pool_stats_ = std::make_unique<BufferSlicePoolStats>(
+        BufferSlicePoolStats{ALL_BUFFER_SLICE_POOL_STATS(
+            POOL_COUNTER_PREFIX(stats_store_, buffer_slice_pool_stats_prefix),
+            POOL_GAUGE_PREFIX(stats_store_, buffer_slice_pool_stats_prefix))});
+  }
   validation_context_.setCounters(server_stats_->static_unknown_fields_,
                                   server_stats_->dynamic_unknown_fields_,
                                   server_stats_->wip_protos_);
@@ -773,6 +895,11 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
   for (const Stats::SinkPtr& sink : stats_config.sinks()) {
     stats_store_.addSink(*sink);
   }
+  if (Runtime::runtimeFeatureEnabled("envoy.restart_features.stats_flush_thread")) {
+    startStatsFlushThread();
+  }
+  stats_store_.symbolTable().renderedNameCache().setEnabled(
+      Runtime::runtimeFeatureEnabled("envoy.restart_features.stats_rendered_name_cache"));
   if (!stats_config.flushOnAdmin()) {
     // Some of the stat sinks may need dispatcher support so don't flush until the main loop starts.
     // Just setup the timer.
@@ -1019,6 +1146,9 @@ void InstanceBase::terminate() {
     listener_manager_->stopWorkers();
   }
 
+  // Stop the stats flush thread first, so that the final flush below completes synchronously.
+  stopStatsFlushThread();
+
   // Only flush if we have not been hot restarted.
   if (stat_flush_timer_) {
     flushStats();
@@ -21,6 +21,7 @@
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/stats/timespan.h"
+#include "envoy/thread/thread.h"
 #include "envoy/tracing/tracer.h"
 
 #include "source/common/access_log/access_log_manager_impl.h"
@@ -86,15 +87,29 @@ struct ServerCompilationSettingsStats {
   GAUGE(parent_connections, Accumulate)                                                            \
   GAUGE(state, NeverImport)                                                                        \
   GAUGE(stats_recent_lookups, NeverImport)                                                         \
+  GAUGE(stats_rendered_name_cache_bytes, NeverImport)                                              \
   GAUGE(total_connections, Accumulate)                                                             \
   GAUGE(uptime, Accumulate)                                                                        \
   GAUGE(version, NeverImport)                                                                      \
-  HISTOGRAM(initialization_time_ms, Milliseconds)
+  HISTOGRAM(initialization_time_ms, Milliseconds)                                                  \
+  HISTOGRAM(stats_flush_duration_ms, Milliseconds)
 
 struct ServerStats {
   ALL_SERVER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
+/**
+ * All buffer slice pool stats. @see stats_macros.h
+ */
+#define ALL_BUFFER_SLICE_POOL_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(hits)                                                                                    \
+  COUNTER(misses)                                                                                  \
+  GAUGE(retained_bytes, NeverImport)
+
+struct BufferSlicePoolStats {
+  ALL_BUFFER_SLICE_POOL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
 /**
  * Interface for creating service components during boot.
  */
@@ -326,6 +341,10 @@ private:
 
   ProtobufTypes::MessagePtr dumpBootstrapConfig();
   void flushStatsInternal();
+  void flushStatsOnFlushThread();
+  void finishStatsFlush();
+  void startStatsFlushThread();
+  void stopStatsFlushThread();
   void updateServerStats();
   // This does most of the work of initialization, but can throw or return errors caught
   // by initialize().
@@ -366,6 +385,8 @@ private:
   time_t original_start_time_;
   Stats::StoreRoot& stats_store_;
   std::unique_ptr<ServerStats> server_stats_;
+  // Only set if the bootstrap enables the buffer slice pool.
+  std::unique_ptr<BufferSlicePoolStats> buffer_slice_pool_stats_;
   std::unique_ptr<CompilationSettings::ServerCompilationSettingsStats>
       server_compilation_settings_stats_;
   Assert::ActionRegistrationPtr assert_action_registration_;
@@ -390,6 +411,12 @@ private:
   Configuration::MainImpl config_;
   Network::DnsResolverSharedPtr dns_resolver_;
   Event::TimerPtr stat_flush_timer_;
+  // Times the flush in progress, from the histogram merge until every sink has been flushed.
+  Stats::TimespanPtr stats_flush_timespan_;
+  // Only set if the envoy.restart_features.stats_flush_thread restart feature is enabled. The
+  // snapshot is then built, and the sinks which allow it flushed, on this thread's dispatcher.
+  Event::DispatcherPtr stats_flush_dispatcher_;
+  Thread::ThreadPtr stats_flush_thread_;
   DrainManagerPtr drain_manager_;
   std::unique_ptr<Upstream::ClusterManagerFactory> cluster_manager_factory_;
   std::unique_ptr<Server::GuardDog> main_thread_guard_dog_;
@@ -443,6 +470,14 @@ class MetricSnapshotImpl : public Stats::MetricSnapshot {
 public:
   explicit MetricSnapshotImpl(Stats::Store& store, Upstream::ClusterManager& cluster_manager,
                               TimeSource& time_source);
+  /**
+   * Snapshots the store's metrics along with host metrics which were already collected, as the
+   * cluster manager they come from may only be read on the main thread.
+   */
+  MetricSnapshotImpl(Stats::Store& store,
+                     std::vector<Stats::PrimitiveCounterSnapshot>&& host_counters,
+                     std::vector<Stats::PrimitiveGaugeSnapshot>&& host_gauges,
+                     TimeSource& time_source);
 
   // Stats::MetricSnapshot
   const std::vector<CounterSnapshot>& counters() override { return counters_; }
@@ -462,6 +497,8 @@ public:
   SystemTime snapshotTime() const override { return snapshot_time_; }
 
 private:
+  void snapStore(Stats::Store& store);
+
   std::vector<Stats::CounterSharedPtr> snapped_counters_;
   std::vector<CounterSnapshot> counters_;
   std::vector<Stats::GaugeSharedPtr> snapped_gauges_;
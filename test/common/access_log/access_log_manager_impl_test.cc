@@ -1,4 +1,6 @@
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "source/common/access_log/access_log_manager_impl.h"
 #include "source/common/filesystem/file_shared_impl.h"
@@ -11,6 +13,10 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/synchronization/notification.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -31,7 +37,9 @@ class AccessLogManagerImplTest : public testing::Test {
 protected:
   AccessLogManagerImplTest()
       : file_(new NiceMock<Filesystem::MockFile>), thread_factory_(Thread::threadFactoryForTest()),
-        access_log_manager_(timeout_40ms_, api_, dispatcher_, lock_, store_) {
+        access_log_manager_(timeout_40ms_, 64 * 1024, 64 * 1024,
+                            Server::FileBufferOverflowPolicy::Unbounded, api_, dispatcher_, lock_,
+                            store_) {
     EXPECT_CALL(file_system_,
                 createFile(testing::Matcher<const Envoy::Filesystem::FilePathAndType&>(
                     Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})))
@@ -55,6 +63,41 @@ protected:
     return TestUtility::waitForGaugeEq(store_, name, value, time_system_);
   }
 
+  // Collects everything written to file_ into written_. With block_first_write, the first write
+  // to the file waits for unblock_write_, which keeps the flush thread from draining the thread
+  // buffers until then.
+  void collectWrites(bool block_first_write) {
+    EXPECT_CALL(*file_, write_(_))
+        .WillRepeatedly(Invoke([this, block_first_write](
+                                   absl::string_view data) -> Api::IoCallSizeResult {
+          if (block_first_write && !write_started_.HasBeenNotified()) {
+            write_started_.Notify();
+            unblock_write_.WaitForNotification();
+          }
+          // MockFile::write() serializes the calls.
+          written_.append(data);
+          return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+        }));
+  }
+
+  // Checks that written_ has num_lines lines "<thread> <index> <padding>" from each of num_threads
+  // threads, with the lines of each thread in order.
+  void expectLinesInOrder(int num_threads, int num_lines) {
+    std::vector<int> next_line(num_threads, 0);
+    for (absl::string_view line : absl::StrSplit(written_, '\n', absl::SkipEmpty())) {
+      const std::vector<absl::string_view> fields = absl::StrSplit(line, ' ');
+      ASSERT_EQ(3U, fields.size());
+      int thread;
+      int index;
+      ASSERT_TRUE(absl::SimpleAtoi(fields[0], &thread));
+      ASSERT_TRUE(absl::SimpleAtoi(fields[1], &index));
+      EXPECT_EQ(next_line[thread]++, index);
+    }
+    for (int thread = 0; thread < num_threads; ++thread) {
+      EXPECT_EQ(num_lines, next_line[thread]);
+    }
+  }
+
   NiceMock<Api::MockApi> api_;
   NiceMock<Filesystem::MockInstance> file_system_;
   NiceMock<Filesystem::MockFile>* file_;
@@ -65,6 +108,9 @@ protected:
   Thread::MutexBasicLockable lock_;
   AccessLogManagerImpl access_log_manager_;
   Event::TestRealTimeSystem time_system_;
+  absl::Notification write_started_;
+  absl::Notification unblock_write_;
+  std::string written_;
 };
 
 TEST_F(AccessLogManagerImplTest, BadFile) {
@@ -526,6 +572,220 @@ TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
       .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+TEST_F(AccessLogManagerImplTest, FlushTimesRecordedByTimer) {
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager_
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+  collectWrites(false);
+
+  log_file->write("test");
+  // Waits for the flush thread, if it is the one writing.
+  log_file->flush();
+  EXPECT_EQ("test", written_);
+  EXPECT_FALSE(store_.histogramRecordedValues("filesystem.flush_time_us"));
+
+  timer->invokeCallback();
+  EXPECT_EQ(1U, store_.histogramValues("filesystem.flush_time_us", false).size());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// Threads with small buffers, so that some writes go through their overflow buffers.
+TEST_F(AccessLogManagerImplTest, ThreadBuffersKeepEachThreadsWritesInOrder) {
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, 1024, 1024,
+                                          Server::FileBufferOverflowPolicy::Unbounded, api_,
+                                          dispatcher_, lock_, store_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+  collectWrites(false);
+
+  constexpr int NumThreads = 4;
+  constexpr int NumLines = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  for (int thread = 0; thread < NumThreads; ++thread) {
+    threads.push_back(thread_factory_.createThread([&log_file, thread]() {
+      for (int i = 0; i < NumLines; ++i) {
+        // Every 100th line does not fit in a thread buffer at all.
+        const std::string padding(i % 100 == 0 ? 2000 : 20, 'x');
+        log_file->write(absl::StrCat(thread, " ", i, " ", padding, "\n"));
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  log_file->flush();
+
+  expectLinesInOrder(NumThreads, NumLines);
+  EXPECT_EQ(uint64_t{NumThreads * NumLines}, store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(0UL,
+            store_.gauge("filesystem.write_total_buffered", Stats::Gauge::ImportMode::Accumulate)
+                .value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, ThreadBufferFullDropsWrites) {
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, 1024, 1024,
+                                          Server::FileBufferOverflowPolicy::Drop, api_,
+                                          dispatcher_, lock_, store_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+  collectWrites(true);
+
+  // The first write of the thread wakes the flush thread, which then waits in the file write.
+  log_file->write("first\n");
+  write_started_.WaitForNotification();
+
+  // 8 lines fill the thread buffer.
+  const std::string line = std::string(127, 'x') + "\n";
+  for (int i = 0; i < 10; ++i) {
+    log_file->write(line);
+  }
+  EXPECT_EQ(2UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(9UL, store_.counter("filesystem.write_buffered").value());
+
+  unblock_write_.Notify();
+  log_file->flush();
+  std::string expected = "first\n";
+  for (int i = 0; i < 8; ++i) {
+    absl::StrAppend(&expected, line);
+  }
+  EXPECT_EQ(expected, written_);
+  EXPECT_EQ(0UL,
+            store_.gauge("filesystem.write_total_buffered", Stats::Gauge::ImportMode::Accumulate)
+                .value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, ThreadBufferFullBlocksWrites) {
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, 1024, 1024,
+                                          Server::FileBufferOverflowPolicy::Block, api_,
+                                          dispatcher_, lock_, store_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+  collectWrites(true);
+
+  log_file->write("first\n");
+  write_started_.WaitForNotification();
+
+  // The writer fills its buffer, and then waits for the flush thread to drain it.
+  const std::string line = std::string(127, 'x') + "\n";
+  Thread::ThreadPtr writer = thread_factory_.createThread([&log_file, &line]() {
+    for (int i = 0; i < 10; ++i) {
+      log_file->write(line);
+    }
+  });
+  EXPECT_TRUE(waitForCounterEq("filesystem.write_blocked", 1));
+
+  unblock_write_.Notify();
+  writer->join();
+  log_file->flush();
+  std::string expected = "first\n";
+  for (int i = 0; i < 10; ++i) {
+    absl::StrAppend(&expected, line);
+  }
+  EXPECT_EQ(expected, written_);
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(11UL, store_.counter("filesystem.write_buffered").value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// A thread that wrote to files which were destroyed keeps no buffers for them.
+TEST_F(AccessLogManagerImplTest, ThreadBuffersOfDestroyedFilesAreDropped) {
+  {
+    AccessLogManagerImpl access_log_manager(timeout_40ms_, 1024, 1024,
+                                            Server::FileBufferOverflowPolicy::Unbounded, api_,
+                                            dispatcher_, lock_, store_);
+    EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+    collectWrites(false);
+    access_log_manager
+        .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+        .value()
+        ->write("foo\n");
+    EXPECT_EQ(1U, AccessLogFileImpl::threadBuffersForTest());
+    EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  }
+  EXPECT_EQ("foo\n", written_);
+
+  EXPECT_CALL(file_system_,
+              createFile(testing::Matcher<const Envoy::Filesystem::FilePathAndType&>(
+                  Filesystem::FilePathAndType{Filesystem::DestinationType::File, "bar"})))
+      .WillRepeatedly(Invoke([](const Envoy::Filesystem::FilePathAndType&) -> Filesystem::FilePtr {
+        NiceMock<Filesystem::MockFile>* file = new NiceMock<Filesystem::MockFile>;
+        EXPECT_CALL(*file, path()).WillRepeatedly(Return("bar"));
+        EXPECT_CALL(*file, open_(_))
+            .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+        EXPECT_CALL(*file, write_(_))
+            .WillRepeatedly(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+              return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+            }));
+        EXPECT_CALL(*file, close_())
+            .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+        return std::unique_ptr<NiceMock<Filesystem::MockFile>>(file);
+      }));
+  for (int i = 0; i < 3; ++i) {
+    AccessLogManagerImpl access_log_manager(timeout_40ms_, 1024, 1024,
+                                            Server::FileBufferOverflowPolicy::Unbounded, api_,
+                                            dispatcher_, lock_, store_);
+    access_log_manager
+        .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "bar"})
+        .value()
+        ->write("bar\n");
+    // The buffers of the files destroyed before are dropped when the thread creates this one.
+    EXPECT_EQ(1U, AccessLogFileImpl::threadBuffersForTest());
+  }
+}
+
+TEST_F(AccessLogManagerImplTest, SharedBufferWithoutThreadBuffers) {
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, 1024, 0,
+                                          Server::FileBufferOverflowPolicy::Drop, api_,
+                                          dispatcher_, lock_, store_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+  collectWrites(false);
+
+  constexpr int NumThreads = 4;
+  constexpr int NumLines = 100;
+  std::vector<Thread::ThreadPtr> threads;
+  for (int thread = 0; thread < NumThreads; ++thread) {
+    threads.push_back(thread_factory_.createThread([&log_file, thread]() {
+      for (int i = 0; i < NumLines; ++i) {
+        log_file->write(absl::StrCat(thread, " ", i, " ", std::string(100, 'x'), "\n"));
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  log_file->flush();
+
+  // The overflow policy only applies to thread buffers.
+  expectLinesInOrder(NumThreads, NumLines);
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_dropped").value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
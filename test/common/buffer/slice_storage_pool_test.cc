@@ -0,0 +1,132 @@
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_storage_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class SliceStoragePoolTest : public testing::Test {
+protected:
+  void TearDown() override { SliceStoragePool::configure(false); }
+
+  // Each thread has a pool of its own, so running on a new thread starts with an empty pool.
+  void runOnNewThread(std::function<void()> fn) {
+    std::thread thread(fn);
+    thread.join();
+  }
+};
+
+TEST_F(SliceStoragePoolTest, DisabledByDefault) {
+  runOnNewThread([]() {
+    const SliceStoragePool::Stats before = SliceStoragePool::stats();
+    SliceStoragePool::release(SliceStoragePool::allocate(16384), 16384);
+    SliceStoragePool::release(SliceStoragePool::allocate(16384), 16384);
+    const SliceStoragePool::Stats after = SliceStoragePool::stats();
+    EXPECT_EQ(after.hits_, before.hits_);
+    EXPECT_EQ(after.misses_, before.misses_);
+    EXPECT_EQ(after.retained_bytes_, before.retained_bytes_);
+  });
+}
+
+TEST_F(SliceStoragePoolTest, ReusesStorageOfTheSameSize) {
+  SliceStoragePool::configure(true);
+  runOnNewThread([]() {
+    const SliceStoragePool::Stats before = SliceStoragePool::stats();
+    uint8_t* first = SliceStoragePool::allocate(16384);
+    SliceStoragePool::release(first, 16384);
+    EXPECT_EQ(SliceStoragePool::stats().retained_bytes_, before.retained_bytes_ + 16384);
+    // A different size class is not satisfied from the free list.
+    uint8_t* other = SliceStoragePool::allocate(4096);
+    EXPECT_NE(other, first);
+    EXPECT_EQ(SliceStoragePool::allocate(16384), first);
+    const SliceStoragePool::Stats after = SliceStoragePool::stats();
+    EXPECT_EQ(after.hits_, before.hits_ + 1);
+    EXPECT_EQ(after.misses_, before.misses_ + 2);
+    EXPECT_EQ(after.retained_bytes_, before.retained_bytes_);
+    SliceStoragePool::release(first, 16384);
+    SliceStoragePool::release(other, 4096);
+  });
+}
+
+TEST_F(SliceStoragePoolTest, RetainedBytesAreBoundedPerThread) {
+  SliceStoragePool::configure(true, 8192);
+  runOnNewThread([]() {
+    const SliceStoragePool::Stats before = SliceStoragePool::stats();
+    uint8_t* a = SliceStoragePool::allocate(4096);
+    uint8_t* b = SliceStoragePool::allocate(4096);
+    uint8_t* c = SliceStoragePool::allocate(4096);
+    SliceStoragePool::release(a, 4096);
+    SliceStoragePool::release(b, 4096);
+    SliceStoragePool::release(c, 4096);
+    EXPECT_EQ(SliceStoragePool::stats().retained_bytes_, before.retained_bytes_ + 8192);
+  });
+}
+
+TEST_F(SliceStoragePoolTest, LargeStorageIsNotPooled) {
+  SliceStoragePool::configure(true);
+  runOnNewThread([]() {
+    const SliceStoragePool::Stats before = SliceStoragePool::stats();
+    const uint64_t size = SliceStoragePool::MaxPooledSize + SliceStoragePool::PageSize;
+    SliceStoragePool::release(SliceStoragePool::allocate(size), size);
+    SliceStoragePool::release(SliceStoragePool::allocate(size), size);
+    const SliceStoragePool::Stats after = SliceStoragePool::stats();
+    EXPECT_EQ(after.hits_, before.hits_);
+    EXPECT_EQ(after.misses_, before.misses_ + 2);
+    EXPECT_EQ(after.retained_bytes_, before.retained_bytes_);
+  });
+}
+
+TEST_F(SliceStoragePoolTest, RetainedStorageIsFreedWhenTheThreadExits) {
+  SliceStoragePool::configure(true);
+  const uint64_t retained_before = SliceStoragePool::stats().retained_bytes_;
+  runOnNewThread([retained_before]() {
+    SliceStoragePool::release(SliceStoragePool::allocate(16384), 16384);
+    EXPECT_EQ(SliceStoragePool::stats().retained_bytes_, retained_before + 16384);
+  });
+  EXPECT_EQ(SliceStoragePool::stats().retained_bytes_, retained_before);
+}
+
+TEST_F(SliceStoragePoolTest, BufferSlicesUseThePool) {
+  SliceStoragePool::configure(true);
+  runOnNewThread([]() {
+    const std::string data(10000, 'a');
+    const SliceStoragePool::Stats before = SliceStoragePool::stats();
+    for (int i = 0; i < 3; i++) {
+      OwnedImpl buffer(data);
+      EXPECT_EQ(buffer.toString(), data);
+    }
+    const SliceStoragePool::Stats after = SliceStoragePool::stats();
+    EXPECT_EQ(after.misses_, before.misses_ + 1);
+    EXPECT_EQ(after.hits_, before.hits_ + 2);
+  });
+}
+
+// A buffer moved to another thread releases its storage into that thread's pool.
+TEST_F(SliceStoragePoolTest, BufferMovedAcrossThreads) {
+  SliceStoragePool::configure(true);
+  runOnNewThread([]() {
+    const std::string data(10000, 'a');
+    auto buffer = std::make_unique<OwnedImpl>(data);
+    const uint64_t retained_before = SliceStoragePool::stats().retained_bytes_;
+    std::thread other([&buffer, &data, retained_before]() {
+      OwnedImpl moved;
+      moved.move(*buffer);
+      EXPECT_EQ(moved.toString(), data);
+      moved.drain(moved.length());
+      EXPECT_EQ(SliceStoragePool::stats().retained_bytes_, retained_before + 12288);
+    });
+    other.join();
+    EXPECT_EQ(SliceStoragePool::stats().retained_bytes_, retained_before);
+    buffer.reset();
+  });
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
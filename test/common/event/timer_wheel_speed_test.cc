@@ -0,0 +1,80 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <chrono>
+#include <vector>
+
+#include "source/common/api/api_impl.h"
+#include "source/common/runtime/runtime_features.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+
+// Re-arms a number of armed timers, as connections and streams reset their idle timeouts on
+// activity. The first argument is whether timers go into the timing wheel, the second the number of
+// timers. Durations are spread between 1s and 5 minutes.
+static void bmTimerRearm(benchmark::State& state) {
+  Runtime::maybeSetRuntimeGuard("envoy.restart_features.dispatcher_timer_wheel", state.range(0));
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  const uint64_t num_timers = state.range(1);
+  std::vector<TimerPtr> timers;
+  std::vector<std::chrono::milliseconds> durations;
+  for (uint64_t i = 0; i < num_timers; i++) {
+    timers.push_back(dispatcher->createTimer([]() {}));
+    durations.push_back(std::chrono::milliseconds(1000 + (i * 7919) % 299000));
+    timers.back()->enableTimer(durations.back());
+  }
+
+  for (auto _ : state) { // NOLINT
+    for (uint64_t i = 0; i < num_timers; i++) {
+      timers[i]->enableTimer(durations[(i + 1) % num_timers]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_timers);
+  timers.clear();
+  Runtime::maybeSetRuntimeGuard("envoy.restart_features.dispatcher_timer_wheel", false);
+}
+BENCHMARK(bmTimerRearm)
+    ->Args({0, 1000})
+    ->Args({1, 1000})
+    ->Args({0, 1000000})
+    ->Args({1, 1000000})
+    ->Unit(benchmark::kMillisecond);
+
+// Arms and then disarms a number of timers, as timeouts which are cancelled before they fire.
+static void bmTimerArmDisarm(benchmark::State& state) {
+  Runtime::maybeSetRuntimeGuard("envoy.restart_features.dispatcher_timer_wheel", state.range(0));
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  const uint64_t num_timers = state.range(1);
+  std::vector<TimerPtr> timers;
+  for (uint64_t i = 0; i < num_timers; i++) {
+    timers.push_back(dispatcher->createTimer([]() {}));
+  }
+
+  for (auto _ : state) { // NOLINT
+    for (uint64_t i = 0; i < num_timers; i++) {
+      timers[i]->enableTimer(std::chrono::milliseconds(1000 + (i * 7919) % 299000));
+    }
+    for (uint64_t i = 0; i < num_timers; i++) {
+      timers[i]->disableTimer();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_timers);
+  timers.clear();
+  Runtime::maybeSetRuntimeGuard("envoy.restart_features.dispatcher_timer_wheel", false);
+}
+BENCHMARK(bmTimerArmDisarm)
+    ->Args({0, 1000})
+    ->Args({1, 1000})
+    ->Args({0, 1000000})
+    ->Args({1, 1000000})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace Event
+} // namespace Envoy
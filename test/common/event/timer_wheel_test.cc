@@ -0,0 +1,181 @@
+#include <chrono>
+
+#include "source/common/api/api_impl.h"
+#include "source/common/event/dispatcher_impl.h"
+#include "source/common/event/timer_wheel.h"
+
+#include "test/mocks/common.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::MockFunction;
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+class TimerWheelTest : public testing::Test {
+protected:
+  TimerWheelTest() {
+    scoped_runtime_.mergeValues({{"envoy.restart_features.dispatcher_timer_wheel", "true"}});
+    api_ = Api::createApiForTest(time_system_);
+    dispatcher_ = api_->allocateDispatcher("test_thread");
+  }
+
+  void advance(std::chrono::milliseconds duration) {
+    time_system_.advanceTimeAndRun(duration, *dispatcher_, Dispatcher::RunType::NonBlock);
+  }
+
+  // Advances time a millisecond at a time until the timer fires, and returns how long it took.
+  std::chrono::milliseconds timeToFire(Timer& timer) {
+    const MonotonicTime start = time_system_.monotonicTime();
+    while (timer.enabled()) {
+      advance(std::chrono::milliseconds(1));
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time_system_.monotonicTime() -
+                                                                  start);
+  }
+
+  TestScopedRuntime scoped_runtime_;
+  SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+};
+
+TEST_F(TimerWheelTest, TimersAreWheelTimers) {
+  TimerPtr timer = dispatcher_->createTimer([]() {});
+  EXPECT_NE(nullptr, dynamic_cast<WheelTimerImpl*>(timer.get()));
+}
+
+TEST(TimerWheelDisabledTest, TimersAreSchedulerTimers) {
+  SimulatedTimeSystem time_system;
+  Api::ApiPtr api = Api::createApiForTest(time_system);
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  TimerPtr timer = dispatcher->createTimer([]() {});
+  EXPECT_EQ(nullptr, dynamic_cast<WheelTimerImpl*>(timer.get()));
+}
+
+// Timers in the wheel fire no earlier than their duration, and at most a tick of 10ms later.
+TEST_F(TimerWheelTest, FiresWithinATick) {
+  MockFunction<void()> cb;
+  TimerPtr timer = dispatcher_->createTimer(cb.AsStdFunction());
+  for (const auto duration : {std::chrono::milliseconds(1000), std::chrono::milliseconds(1234),
+                              std::chrono::milliseconds(59999), std::chrono::milliseconds(61000)}) {
+    timer->enableTimer(duration);
+    EXPECT_TRUE(timer->enabled());
+    EXPECT_CALL(cb, Call());
+    const std::chrono::milliseconds elapsed = timeToFire(*timer);
+    EXPECT_GE(elapsed, duration);
+    EXPECT_LE(elapsed, duration + std::chrono::milliseconds(10));
+    // Start the next timer part way through a tick.
+    advance(std::chrono::milliseconds(3));
+  }
+}
+
+// Timers beyond the range of the lowest levels are cascaded down to them without losing accuracy.
+TEST_F(TimerWheelTest, LongTimers) {
+  MockFunction<void()> cb;
+  TimerPtr timer = dispatcher_->createTimer(cb.AsStdFunction());
+  const std::chrono::milliseconds duration = std::chrono::hours(50);
+  timer->enableTimer(duration);
+  advance(duration - std::chrono::seconds(1));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_CALL(cb, Call());
+  const std::chrono::milliseconds elapsed = timeToFire(*timer);
+  EXPECT_GE(elapsed, std::chrono::seconds(1));
+  EXPECT_LE(elapsed, std::chrono::milliseconds(1010));
+}
+
+TEST_F(TimerWheelTest, DisableAndReenable) {
+  MockFunction<void()> cb1;
+  MockFunction<void()> cb2;
+  TimerPtr timer1 = dispatcher_->createTimer(cb1.AsStdFunction());
+  TimerPtr timer2 = dispatcher_->createTimer(cb2.AsStdFunction());
+  timer1->enableTimer(std::chrono::seconds(2));
+  timer2->enableTimer(std::chrono::seconds(2));
+  timer1->disableTimer();
+  EXPECT_FALSE(timer1->enabled());
+
+  // Re-enabling a timer moves it, earlier or later.
+  timer2->enableTimer(std::chrono::seconds(5));
+  advance(std::chrono::seconds(3));
+  timer1->enableTimer(std::chrono::seconds(1));
+  EXPECT_CALL(cb1, Call());
+  advance(std::chrono::milliseconds(1010));
+  EXPECT_FALSE(timer1->enabled());
+  EXPECT_TRUE(timer2->enabled());
+  EXPECT_CALL(cb2, Call());
+  advance(std::chrono::milliseconds(1000));
+  EXPECT_FALSE(timer2->enabled());
+}
+
+// A timer may re-enable itself, or enable other timers, when it fires.
+TEST_F(TimerWheelTest, EnableFromCallback) {
+  int fired = 0;
+  TimerPtr timer;
+  timer = dispatcher_->createTimer([&]() {
+    if (++fired < 3) {
+      timer->enableTimer(std::chrono::seconds(1));
+    }
+  });
+  timer->enableTimer(std::chrono::seconds(1));
+  for (int i = 1; i <= 3; i++) {
+    EXPECT_LE(timeToFire(*timer), std::chrono::milliseconds(1010));
+    EXPECT_EQ(i, fired);
+  }
+}
+
+// Timers shorter than a second, and high resolution timers, keep the precision of the scheduler.
+TEST_F(TimerWheelTest, ShortTimersUseTheScheduler) {
+  MockFunction<void()> cb;
+  TimerPtr timer = dispatcher_->createTimer(cb.AsStdFunction());
+  timer->enableTimer(std::chrono::seconds(5));
+  timer->enableTimer(std::chrono::milliseconds(50));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_CALL(cb, Call());
+  EXPECT_EQ(std::chrono::milliseconds(50), timeToFire(*timer));
+
+  timer->enableHRTimer(std::chrono::microseconds(500));
+  EXPECT_CALL(cb, Call());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_FALSE(timer->enabled());
+
+  // Moving the timer from the scheduler to the wheel disables it in the scheduler.
+  timer->enableTimer(std::chrono::milliseconds(50));
+  timer->enableTimer(std::chrono::seconds(1));
+  advance(std::chrono::milliseconds(100));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_CALL(cb, Call());
+  advance(std::chrono::seconds(1));
+  EXPECT_FALSE(timer->enabled());
+}
+
+TEST_F(TimerWheelTest, DeleteArmedTimer) {
+  MockFunction<void()> cb;
+  TimerPtr timer = dispatcher_->createTimer(cb.AsStdFunction());
+  timer->enableTimer(std::chrono::seconds(1));
+  timer.reset();
+  EXPECT_CALL(cb, Call()).Times(0);
+  advance(std::chrono::seconds(2));
+}
+
+TEST_F(TimerWheelTest, TimerWithScope) {
+  MockScopeTrackedObject scope;
+  TimerPtr timer = dispatcher_->createTimer([this]() {
+    static_cast<DispatcherImpl*>(dispatcher_.get())->onFatalError(std::cerr);
+  });
+  timer->enableTimer(std::chrono::seconds(1), &scope);
+  // The timer tracks the scope while it runs, so it is dumped on a fatal error.
+  EXPECT_CALL(scope, dumpState(_, _));
+  advance(std::chrono::milliseconds(1010));
+  EXPECT_FALSE(timer->enabled());
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
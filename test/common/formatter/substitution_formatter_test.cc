@@ -31,6 +31,7 @@
 #include "test/test_common/printers.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
@@ -4060,6 +4061,137 @@ TEST(SubstitutionFormatterTest, JsonFormatterWithOrderedPropertiesTest) {
   EXPECT_EQ(out_json, expected);
 }
 
+// The JSON written directly by the formatter is the same JSON as serializing the Struct, for
+// typed and untyped values, nested maps and lists, and with and without omitted empty values.
+TEST(SubstitutionFormatterTest, JsonFormatterWritesSameJsonAsStruct) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"first", "GET \"quoted\" \\"}, {":path", "/"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  HttpFormatterContext formatter_context(&request_header, &response_header, &response_trailer,
+                                         body);
+
+  envoy::config::core::v3::Metadata metadata;
+  populateMetadataTestData(metadata);
+  EXPECT_CALL(Const(stream_info), dynamicMetadata()).WillRepeatedly(ReturnRef(metadata));
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    plain: plain_value
+    number: 3.5
+    header: '%REQ(FIRST)%'
+    missing: '%REQ(MISSING)%'
+    multi: '%PROTOCOL% %REQ(MISSING)%'
+    metadata: '%DYNAMIC_METADATA(com.test)%'
+    missing_metadata: '%DYNAMIC_METADATA(com.missing)%'
+    nested:
+      protocol: '%PROTOCOL%'
+      empty:
+        missing: '%REQ(MISSING)%'
+    list:
+    - '%PROTOCOL%'
+    - '%REQ(MISSING)%'
+    - nested_in_list: '%REQ(FIRST)%'
+  )EOF",
+                            key_mapping);
+
+  for (const bool preserve_types : {false, true}) {
+    for (const bool omit_empty_values : {false, true}) {
+      for (const bool sort_properties : {false, true}) {
+        SCOPED_TRACE(absl::StrCat(preserve_types, omit_empty_values, sort_properties));
+        std::string struct_json;
+        {
+          TestScopedRuntime scoped_runtime;
+          scoped_runtime.mergeValues(
+              {{"envoy.reloadable_features.logging_with_fast_json_formatter", "false"}});
+          JsonFormatterImpl formatter(key_mapping, preserve_types, omit_empty_values,
+                                      sort_properties);
+          struct_json = formatter.formatWithContext(formatter_context, stream_info);
+        }
+        JsonFormatterImpl formatter(key_mapping, preserve_types, omit_empty_values,
+                                    sort_properties);
+        const std::string direct_json = formatter.formatWithContext(formatter_context, stream_info);
+        EXPECT_EQ('\n', direct_json.back());
+        EXPECT_TRUE(TestUtility::jsonStringEqual(direct_json, struct_json))
+            << direct_json << " != " << struct_json;
+      }
+    }
+  }
+}
+
+// Keys are written in sorted order, which satisfies sort_properties without sorting per line.
+TEST(SubstitutionFormatterTest, JsonFormatterWritesSortedKeys) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    b: '%REQ(MISSING)%'
+    a: 1
+    c:
+      z: z
+      y: y
+    d: []
+  )EOF",
+                            key_mapping);
+  JsonFormatterImpl formatter(key_mapping, true, false, true);
+
+  EXPECT_EQ("{\"a\":1,\"b\":null,\"c\":{\"y\":\"y\",\"z\":\"z\"},\"d\":[]}\n",
+            formatter.formatWithContext({}, stream_info));
+}
+
+// Access logs are formatted on worker threads, where strings must be escaped without throwing or
+// asserting: valid utf-8 is written as-is and each byte of invalid utf-8 as a replacement character.
+TEST(SubstitutionFormatterTest, JsonFormatterWritesUtf8OffMainThread) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"user-agent", "na\xc3\xafve \xe2\x98\x83"},
+                                                {"invalid", "a\xff\xc3"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+  HttpFormatterContext formatter_context(&request_header, &response_header, &response_trailer,
+                                         body);
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    agent: '%REQ(USER-AGENT)%'
+    invalid: '%REQ(INVALID)%'
+  )EOF",
+                            key_mapping);
+
+  for (const bool preserve_types : {false, true}) {
+    SCOPED_TRACE(preserve_types);
+    JsonFormatterImpl formatter(key_mapping, preserve_types, false, false);
+    std::string json;
+    Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread(
+        [&]() { json = formatter.formatWithContext(formatter_context, stream_info); });
+    thread->join();
+    EXPECT_EQ("{\"agent\":\"na\xc3\xafve \xe2\x98\x83\","
+              "\"invalid\":\"a\\ufffd\\ufffd\"}\n",
+              json);
+    EXPECT_TRUE(Json::Factory::loadFromStringNoThrow(json).ok()) << json;
+  }
+}
+
+// Only the literals of a text format are copied from the format; a missing value is replaced by
+// the placeholder, or omitted.
+TEST(SubstitutionFormatterTest, FormatterLiteralsAndEmptyValues) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}};
+  HttpFormatterContext formatter_context(&request_header);
+  const std::string literal(100, 'x');
+
+  FormatterImpl formatter(absl::StrCat(literal, "%REQ(FIRST)%|%REQ(MISSING)%|"), false);
+  EXPECT_EQ(absl::StrCat(literal, "GET|-|"),
+            formatter.formatWithContext(formatter_context, stream_info));
+
+  FormatterImpl omitting_formatter(absl::StrCat(literal, "%REQ(FIRST)%|%REQ(MISSING)%|"), true);
+  EXPECT_EQ(absl::StrCat(literal, "GET||"),
+            omitting_formatter.formatWithContext(formatter_context, stream_info));
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
   Http::TestResponseHeaderMapImpl response_header{{"second", "PUT"}, {"test", "test"}};
@@ -0,0 +1,79 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "source/common/http/character_set_validation.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+
+// Scans a header value made of valid token characters, with the kernel given by the first
+// argument. Typical header values are a few dozen bytes; the larger sizes are the long cookies
+// and adversarial headers close to the default header size limits.
+static void bmFindFirstCharNotInSet(benchmark::State& state) {
+  const auto kernel = static_cast<CharacterScanKernel>(state.range(0));
+  if (!characterScanKernelSupported(kernel)) {
+    state.SkipWithError("kernel not supported on this CPU");
+    return;
+  }
+  const std::string value(state.range(1), 'a');
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(findFirstCharNotInSet(kernel, kGenericHeaderNameCharSet, value));
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(bmFindFirstCharNotInSet)
+    ->ArgsProduct({{static_cast<int>(CharacterScanKernel::Scalar),
+                    static_cast<int>(CharacterScanKernel::Sse42),
+                    static_cast<int>(CharacterScanKernel::Avx2)},
+                   {8, 24, 64, 256, 4096, 60 * 1024}});
+
+// Scans strings whose only invalid character is the last one, so every kernel has to look at
+// every character before rejecting them.
+static void bmRejectLastChar(benchmark::State& state) {
+  const auto kernel = static_cast<CharacterScanKernel>(state.range(0));
+  if (!characterScanKernelSupported(kernel)) {
+    state.SkipWithError("kernel not supported on this CPU");
+    return;
+  }
+  std::string value(state.range(1), 'a');
+  value.back() = '\x7f';
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(findFirstCharNotInSet(kernel, kGenericHeaderNameCharSet, value));
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(bmRejectLastChar)
+    ->ArgsProduct({{static_cast<int>(CharacterScanKernel::Scalar),
+                    static_cast<int>(CharacterScanKernel::Sse42),
+                    static_cast<int>(CharacterScanKernel::Avx2)},
+                   {24, 4096, 60 * 1024}});
+
+// Validates a typical set of request header names, as HeaderUtility::headerNameIsValid does for
+// every header, with the kernel selected for this CPU.
+static void bmHeaderNames(benchmark::State& state) {
+  const std::string names[] = {"host",
+                               "user-agent",
+                               "accept",
+                               "accept-language",
+                               "accept-encoding",
+                               "referer",
+                               "cookie",
+                               "x-forwarded-for",
+                               "x-request-id",
+                               "content-type",
+                               "content-length",
+                               "x-custom-application-header"};
+  for (auto _ : state) { // NOLINT
+    for (const std::string& name : names) {
+      benchmark::DoNotOptimize(allCharsInSet(kGenericHeaderNameCharSet, name));
+    }
+  }
+}
+BENCHMARK(bmHeaderNames);
+
+} // namespace Http
+} // namespace Envoy
@@ -1,3 +1,6 @@
+#include <string>
+#include <vector>
+
 #include "source/common/http/character_set_validation.h"
 
 #include "gtest/gtest.h"
@@ -33,5 +36,69 @@ TEST(CharacterSetValidationTest, Test) {
   }
 }
 
+// Every character, in or out of the set, at every offset of strings which are shorter than, the
+// same size as, and longer than the blocks of each kernel.
+class CharacterSetScanTest : public testing::TestWithParam<CharacterScanKernel> {
+protected:
+  void SetUp() override {
+    if (!characterScanKernelSupported(GetParam())) {
+      GTEST_SKIP() << "kernel not supported on this CPU";
+    }
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(Kernels, CharacterSetScanTest,
+                         testing::Values(CharacterScanKernel::Scalar, CharacterScanKernel::Sse42,
+                                         CharacterScanKernel::Avx2));
+
+TEST_P(CharacterSetScanTest, FindFirstCharNotInSet) {
+  // Only the upper half of each row and the first extended row are in the set, so that the set
+  // has characters in and out of it for every nibble.
+  constexpr CharacterSet kSet{{0xffff0000, 0xffff0000, 0xffff0000, 0xffff0000, 0xffff0000, 0,
+                               0xffff0000, 0xffff0000}};
+  std::vector<char> in_set;
+  for (unsigned c = 0; c < 256; ++c) {
+    const bool expected = (c / 32 != 5) && (c % 32) < 16;
+    ASSERT_EQ(expected, kSet.contains(static_cast<char>(c)));
+    if (expected) {
+      in_set.push_back(static_cast<char>(c));
+    }
+  }
+
+  for (const size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65, 100}) {
+    std::string value;
+    for (size_t i = 0; i < size; ++i) {
+      value.push_back(in_set[(i * 7) % in_set.size()]);
+    }
+    EXPECT_EQ(size, findFirstCharNotInSet(GetParam(), kSet, value));
+    EXPECT_EQ(size, findFirstCharNotInSet(kSet, value));
+
+    for (size_t offset = 0; offset < size; ++offset) {
+      for (unsigned c = 0; c < 256; ++c) {
+        std::string modified = value;
+        modified[offset] = static_cast<char>(c);
+        const size_t expected = kSet.contains(static_cast<char>(c)) ? size : offset;
+        ASSERT_EQ(expected, findFirstCharNotInSet(GetParam(), kSet, modified))
+            << "size " << size << " offset " << offset << " character " << c;
+      }
+    }
+  }
+}
+
+TEST(CharacterSetTest, SelectedKernelIsSupported) {
+  EXPECT_TRUE(characterScanKernelSupported(selectedCharacterScanKernel()));
+  EXPECT_TRUE(characterScanKernelSupported(CharacterScanKernel::Scalar));
+}
+
+TEST(CharacterSetTest, AllCharsInSet) {
+  EXPECT_TRUE(allCharsInSet(kGenericHeaderNameCharSet, ""));
+  EXPECT_TRUE(allCharsInSet(kGenericHeaderNameCharSet, "x-forwarded-for"));
+  EXPECT_TRUE(allCharsInSet(kGenericHeaderNameCharSet, "x-a-rather-long-custom-header-name"));
+  EXPECT_FALSE(allCharsInSet(kGenericHeaderNameCharSet, "x-forwarded for"));
+  EXPECT_FALSE(allCharsInSet(kGenericHeaderNameCharSet, "x-a-rather-long-custom-header-name:"));
+  EXPECT_TRUE(allCharsInSet(kUriQueryAndFragmentCharSet, "a=b&c=d/e?f"));
+  EXPECT_FALSE(allCharsInSet(kUriQueryAndFragmentCharSet, "a=b&c=d/e?f#g"));
+}
+
 } // namespace Http
 } // namespace Envoy
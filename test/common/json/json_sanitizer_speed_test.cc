@@ -1,5 +1,7 @@
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/json/json_internal.h"
 #include "source/common/json/json_sanitizer.h"
+#include "source/common/json/json_streamer.h"
 #include "source/common/protobuf/utility.h"
 
 #include "benchmark/benchmark.h"
@@ -8,6 +10,7 @@
 
 constexpr absl::string_view pass_through_encoding = "Now is the time for all good men";
 constexpr absl::string_view escaped_encoding = "Now <is the \"time\"> for all good men";
+constexpr absl::string_view utf8_encoding = "Now is the time, Καλημέρα κόσμε";
 
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_ProtoEncoderNoEscape(benchmark::State& state) {
@@ -50,3 +53,50 @@ static void BM_NlohmannWithEscape(benchmark::State& state) {
   }
 }
 BENCHMARK(BM_NlohmannWithEscape);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SanitizeUtf8(benchmark::State& state) {
+  std::string buffer;
+
+  for (auto _ : state) { // NOLINT
+    Envoy::Json::sanitize(buffer, utf8_encoding);
+  }
+}
+BENCHMARK(BM_SanitizeUtf8);
+
+// Sanitizes a string of the given length with no escapes, or with an escape every 32 characters,
+// as in a JSON access log line or a quoted header value.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SanitizeLong(benchmark::State& state) {
+  std::string str(state.range(0), 'a');
+  if (state.range(1) != 0) {
+    for (size_t i = 31; i < str.size(); i += 32) {
+      str[i] = '"';
+    }
+  }
+  std::string buffer;
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Envoy::Json::sanitize(buffer, str));
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_SanitizeLong)->ArgsProduct({{32, 256, 4096}, {0, 1}});
+
+// Streams a map of string and integer entries resembling a stat in the admin /stats?format=json
+// output.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StreamerMap(benchmark::State& state) {
+  for (auto _ : state) { // NOLINT
+    Envoy::Buffer::OwnedImpl buffer;
+    Envoy::Json::Streamer streamer(buffer);
+    Envoy::Json::Streamer::ArrayPtr array = streamer.makeRootArray();
+    for (uint64_t i = 0; i < 100; ++i) {
+      Envoy::Json::Streamer::MapPtr map = array->addMap();
+      map->addEntries({{"name", "cluster.service_a.upstream_rq_2xx"},
+                       {"value", i * 1000003},
+                       {"tag", "service \"a\""}});
+    }
+  }
+}
+BENCHMARK(BM_StreamerMap);
@@ -133,6 +133,71 @@ TEST_F(JsonSanitizerTest, Interspersed) {
   EXPECT_EQ("\\ra\\f", sanitizeAndCheckAgainstProtobufJson("\ra\f"));
 }
 
+// Strings are scanned in blocks, so escapes are placed at every position of strings spanning a
+// few blocks, including the partial block at the end.
+TEST_F(JsonSanitizerTest, EscapesAtEveryPosition) {
+  for (const char escaped : {'\b', '"', '\\', '\001', '\177'}) {
+    for (size_t size = 1; size <= 50; ++size) {
+      for (size_t pos = 0; pos < size; ++pos) {
+        std::string str(size, 'a');
+        str[pos] = escaped;
+        EXPECT_EQ(pos, firstCharToSanitize(str));
+        sanitizeAndCheckAgainstProtobufJson(str);
+      }
+      EXPECT_EQ(size, firstCharToSanitize(std::string(size, 'a')));
+    }
+  }
+}
+
+TEST_F(JsonSanitizerTest, FirstCharToSanitize) {
+  EXPECT_EQ(0, firstCharToSanitize(""));
+  EXPECT_EQ(3, firstCharToSanitize("abc"));
+  EXPECT_EQ(20, firstCharToSanitize(absl::StrCat(std::string(20, 'a'), LambdaUtf8)));
+  EXPECT_EQ(40, firstCharToSanitize(absl::StrCat(std::string(40, ' '), "\x1f")));
+}
+
+TEST_F(JsonSanitizerTest, SanitizeAscii) {
+  const std::string str = absl::StrCat(std::string(20, 'a'), "\t\"", std::string(20, 'b'), "\x1f");
+  std::string out(str.size() * MaxEscapedCharSize, '\0');
+  const char* end = sanitizeAscii(str, out.data());
+  ASSERT_NE(nullptr, end);
+  EXPECT_EQ(absl::StrCat(std::string(20, 'a'), "\\t\\\"", std::string(20, 'b'), "\\u001f"),
+            absl::string_view(out.data(), end - out.data()));
+
+  // Characters outside 7-bit ASCII are left for sanitize() to validate.
+  EXPECT_EQ(nullptr, sanitizeAscii(absl::StrCat("\t", LambdaUtf8), out.data()));
+  EXPECT_EQ(absl::StrCat("\\t", LambdaUtf8), sanitize(absl::StrCat("\t", LambdaUtf8)));
+}
+
+TEST_F(JsonSanitizerTest, SanitizeUtf8) {
+  auto sanitize_utf8 = [](absl::string_view str) {
+    std::string out(str.size() * MaxEscapedCharSize, '\0');
+    out.resize(sanitizeUtf8(str, out.data()) - out.data());
+    return out;
+  };
+
+  // Valid input is escaped as by sanitize().
+  for (absl::string_view str :
+       {absl::string_view("abc"), absl::string_view("\t\"\\\x1f\x7f"), LambdaUtf8, OmicronUtf8,
+        TrebleClefUtf8}) {
+    const std::string with_text = absl::StrCat(std::string(20, 'a'), str, "\b", str);
+    EXPECT_EQ(sanitize(with_text), sanitize_utf8(with_text));
+  }
+
+  // Each byte which is not part of a valid sequence becomes a replacement character.
+  EXPECT_EQ("\\ufffd", sanitize_utf8(truncate(LambdaUtf8)));
+  EXPECT_EQ("\\ufffd\\ufffd", sanitize_utf8(corruptByte2(LambdaUtf8)));
+  EXPECT_EQ("\\ufffd\\ufffd", sanitize_utf8(truncate(OmicronUtf8)));
+  EXPECT_EQ("Hello, \\ufffd\\ufffd\\ufffd, World!",
+            sanitize_utf8(absl::StrCat("Hello, ", truncate(TrebleClefUtf8), ", World!")));
+  // Overlong encodings, surrogates and code points beyond U+10FFFF are invalid.
+  EXPECT_EQ("\\ufffd\\ufffd", sanitize_utf8("\xc0\xaf"));
+  EXPECT_EQ("\\ufffd\\ufffd\\ufffd", sanitize_utf8("\xe0\x9f\xbf"));
+  EXPECT_EQ("\\ufffd\\ufffd\\ufffd", sanitize_utf8("\xed\xa0\x80"));
+  EXPECT_EQ("\\ufffd\\ufffd\\ufffd\\ufffd", sanitize_utf8("\xf4\x90\x80\x80"));
+  EXPECT_EQ("\\ufffd", sanitize_utf8("\xff"));
+}
+
 TEST_F(JsonSanitizerTest, AllTwoByteUtf8) {
   char buf[2];
   absl::string_view utf8(buf, 2);
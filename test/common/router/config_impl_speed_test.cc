@@ -6,6 +6,7 @@
 
 #include "test/mocks/server/instance.h"
 #include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "benchmark/benchmark.h"
@@ -59,7 +60,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -140,6 +141,123 @@ BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1,
 BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 
+/**
+ * Generates a route table of `n` routes which cycles through the kinds of route common in large
+ * API gateways:
+ * - prefix /shelves/shelf_x/
+ * - exact path /books/book_x
+ * - prefix /authors/author_x/ for requests with the header x-tenant: x
+ * - case insensitive prefix /Publishers/Publisher_x/
+ * followed by a catch-all prefix / route.
+ */
+static RouteConfiguration genMixedRouteConfig(int n) {
+  RouteConfiguration route_config;
+  VirtualHost* v_host = route_config.add_virtual_hosts();
+  v_host->set_name("default");
+  v_host->add_domains("*");
+
+  for (int i = 0; i < n; ++i) {
+    Route* route = v_host->add_routes();
+    route->mutable_direct_response()->set_status(200);
+    RouteMatch* match = route->mutable_match();
+    switch (i % 4) {
+    case 0:
+      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/"));
+      break;
+    case 1:
+      match->set_path(absl::StrCat("/books/book_", i));
+      break;
+    case 2: {
+      match->set_prefix(absl::StrCat("/authors/author_", i, "/"));
+      auto* header = match->add_headers();
+      header->set_name("x-tenant");
+      header->mutable_string_match()->set_exact(absl::StrCat(i));
+      break;
+    }
+    default:
+      match->set_prefix(absl::StrCat("/Publishers/Publisher_", i, "/"));
+      match->mutable_case_sensitive()->set_value(false);
+      break;
+    }
+  }
+  Route* route = v_host->add_routes();
+  route->mutable_direct_response()->set_status(404);
+  route->mutable_match()->set_prefix("/");
+
+  return route_config;
+}
+
+/**
+ * Measure the speed of matching requests against a large mixed route table, with the routes
+ * indexed by path (second argument 1) or evaluated one by one (0). Each iteration routes one
+ * request for each kind of route, all near the end of the table, and one request only the
+ * catch-all route matches.
+ */
+static void bmLargeMixedRouteTable(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.router_path_index", state.range(1) ? "true" : "false"}});
+
+  const int n = state.range(0);
+  ConfigImpl config(genMixedRouteConfig(n), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), true);
+
+  auto headers = [](std::string path) {
+    return Http::TestRequestHeaderMapImpl{{":authority", "www.google.com"},
+                                          {":method", "GET"},
+                                          {":path", std::move(path)},
+                                          {"x-forwarded-proto", "http"}};
+  };
+  // The last route of each kind: n - 4 is a multiple of 4 when n is.
+  std::vector<Http::TestRequestHeaderMapImpl> requests = {
+      headers(absl::StrCat("/shelves/shelf_", n - 4, "/route_1")),
+      headers(absl::StrCat("/books/book_", n - 3)),
+      headers(absl::StrCat("/authors/author_", n - 2, "/books")),
+      headers(absl::StrCat("/publishers/publisher_", n - 1, "/books")),
+      headers("/unknown/path"),
+  };
+  requests[2].addCopy("x-tenant", absl::StrCat(n - 2));
+
+  for (auto _ : state) { // NOLINT
+    for (const auto& request : requests) {
+      benchmark::DoNotOptimize(config.route(request, stream_info, 0));
+    }
+  }
+}
+
+BENCHMARK(bmLargeMixedRouteTable)->ArgsProduct({{100, 1000, 10000}, {0, 1}});
+
+/**
+ * Benchmark the prefix, exact path and regex route tables above at 10k routes, with and without
+ * the path index. Regex routes cannot be indexed, so the regex table is a baseline for both.
+ */
+static void bmLargeRouteTable(benchmark::State& state, RouteMatch::PathSpecifierCase match_type) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.router_path_index", state.range(1) ? "true" : "false"}});
+  bmRouteTableSize(state, match_type);
+}
+
+static void bmLargeRouteTableWithPathPrefixMatch(benchmark::State& state) {
+  bmLargeRouteTable(state, RouteMatch::PathSpecifierCase::kPrefix);
+}
+
+static void bmLargeRouteTableWithExactPathMatch(benchmark::State& state) {
+  bmLargeRouteTable(state, RouteMatch::PathSpecifierCase::kPath);
+}
+
+static void bmLargeRouteTableWithRegexMatch(benchmark::State& state) {
+  bmLargeRouteTable(state, RouteMatch::PathSpecifierCase::kSafeRegex);
+}
+
+BENCHMARK(bmLargeRouteTableWithPathPrefixMatch)->ArgsProduct({{10000}, {0, 1}});
+BENCHMARK(bmLargeRouteTableWithExactPathMatch)->ArgsProduct({{10000}, {0, 1}});
+BENCHMARK(bmLargeRouteTableWithRegexMatch)->ArgsProduct({{10000}, {0, 1}});
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
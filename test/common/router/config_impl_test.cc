@@ -68,6 +68,14 @@ public:
                    validate_clusters_default),
         config_(config) {}
 
+  TestConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
+                 const TestConfigImpl& previous,
+                 Server::Configuration::ServerFactoryContext& factory_context,
+                 bool validate_clusters_default)
+      : ConfigImpl(config, previous.config_, previous, factory_context,
+                   ProtobufMessage::getNullValidationVisitor(), validate_clusters_default),
+        config_(config) {}
+
   void setupRouteConfig(const Http::RequestHeaderMap& headers, uint64_t random_value) const {
     absl::optional<std::string> corpus_path =
         TestEnvironment::getOptionalEnvVar("GENRULE_OUTPUT_DIR");
@@ -347,6 +355,147 @@ class RouteMatcherTest : public testing::Test,
                          public ConfigImplTestBase,
                          public TestScopedRuntime {};
 
+// Virtual hosts with many routes only evaluate the routes whose path match may accept the path,
+// which must not change the route chosen, nor the routes offered to a route callback.
+TEST_F(RouteMatcherTest, PathIndexPreservesFirstMatch) {
+  const std::vector<std::string> route_matches = {
+      R"EOF({ prefix: "/api/v0/users" })EOF",
+      R"EOF({ prefix: "/api/v1/users" })EOF",
+      R"EOF({ prefix: "/api/v2/users" })EOF",
+      R"EOF({ prefix: "/api/v3/users" })EOF",
+      R"EOF({ prefix: "/api", headers: [{ name: "x-canary", present_match: true }] })EOF",
+      R"EOF({ path: "/api/v1/users" })EOF",
+      R"EOF({ prefix: "/Static/", case_sensitive: false })EOF",
+      R"EOF({ safe_regex: { regex: "/api/v[0-9]+/items/[0-9]+" } })EOF",
+      R"EOF({ path_separated_prefix: "/api/v2" })EOF",
+      R"EOF({ path: "/health" })EOF",
+      R"EOF({ path: "/HEALTHZ", case_sensitive: false })EOF",
+      R"EOF({ prefix: "/search", query_parameters: [{ name: "q", present_match: true }] })EOF",
+      R"EOF({ prefix: "/search" })EOF",
+  };
+  const std::vector<std::string> paths = {
+      "/api/v3/users/7", "/api/v1/users", "/API/v1/users", "/api/v1/users;x=y", "/static/app.js",
+      "/STATIC/x",       "/api/v2",       "/api/v2/",      "/api/v2x",          "/api/v7/items/12",
+      "/health",         "/health?x=1",   "/healthz",      "/HealthZ",          "/items/3",
+      "/items/3;v=1",    "/items/30",     "/search?q=1",   "/search",           "/nothing",
+  };
+
+  for (const bool ignore_path_parameters : {false, true}) {
+    envoy::config::route::v3::RouteConfiguration route_config;
+    route_config.set_ignore_path_parameters_in_path_matching(ignore_path_parameters);
+    auto* virtual_host = route_config.add_virtual_hosts();
+    virtual_host->set_name("many");
+    virtual_host->add_domains("*");
+    auto add_route = [virtual_host](const std::string& match) {
+      auto* route = virtual_host->add_routes();
+      TestUtility::loadFromYaml(match, *route->mutable_match());
+      route->mutable_route()->set_cluster(absl::StrCat("c", virtual_host->routes_size() - 1));
+    };
+    for (const std::string& match : route_matches) {
+      add_route(match);
+    }
+    for (int i = 0; i < 20; ++i) {
+      add_route(absl::StrCat(R"EOF({ path: "/items/)EOF", i, R"EOF(" })EOF"));
+    }
+    add_route(R"EOF({ prefix: "/" })EOF");
+    ASSERT_GE(static_cast<uint32_t>(route_config.virtual_hosts(0).routes_size()),
+              VirtualHostImpl::MinRoutesForPathIndex);
+
+    TestConfigImpl indexed(route_config, factory_context_, false);
+    std::unique_ptr<TestConfigImpl> linear;
+    {
+      TestScopedRuntime scoped_runtime;
+      scoped_runtime.mergeValues({{"envoy.reloadable_features.router_path_index", "false"}});
+      linear = std::make_unique<TestConfigImpl>(route_config, factory_context_, false);
+    }
+
+    auto cluster = [](const RouteConstSharedPtr& route) -> std::string {
+      return route != nullptr ? route->routeEntry()->clusterName() : "none";
+    };
+    auto offered_routes = [&cluster](const TestConfigImpl& config,
+                                     const Http::TestRequestHeaderMapImpl& headers) {
+      std::vector<std::pair<std::string, RouteEvalStatus>> offered;
+      config.route(
+          [&](RouteConstSharedPtr route, RouteEvalStatus status) -> RouteMatchStatus {
+            offered.emplace_back(cluster(route), status);
+            return RouteMatchStatus::Continue;
+          },
+          headers);
+      return offered;
+    };
+
+    for (const std::string& path : paths) {
+      for (const bool canary : {false, true}) {
+        Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", path, "GET");
+        if (canary) {
+          headers.addCopy("x-canary", "1");
+        }
+        EXPECT_EQ(cluster(linear->route(headers, 0)), cluster(indexed.route(headers, 0)))
+            << path << " canary " << canary << " ignore parameters " << ignore_path_parameters;
+        EXPECT_EQ(offered_routes(*linear, headers), offered_routes(indexed, headers))
+            << path << " canary " << canary << " ignore parameters " << ignore_path_parameters;
+      }
+    }
+
+    EXPECT_EQ("c3",
+              cluster(indexed.route(genHeaders("www.lyft.com", "/api/v3/users/7", "GET"), 0)));
+    EXPECT_EQ("c7",
+              cluster(indexed.route(genHeaders("www.lyft.com", "/api/v7/items/12", "GET"), 0)));
+    EXPECT_EQ("c16", cluster(indexed.route(genHeaders("www.lyft.com", "/items/3", "GET"), 0)));
+    EXPECT_EQ(ignore_path_parameters ? "c16" : "c33",
+              cluster(indexed.route(genHeaders("www.lyft.com", "/items/3;v=1", "GET"), 0)));
+  }
+}
+
+TEST_F(RouteMatcherTest, UpdatedConfigReusesUnchangedVirtualHosts) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: a
+  domains: ["a.com"]
+  routes:
+  - match: { prefix: "/" }
+    route: { cluster: a }
+- name: b
+  domains: ["b.com"]
+  routes:
+  - match: { prefix: "/" }
+    route: { cluster: b }
+)EOF";
+  factory_context_.cluster_manager_.initializeClusters({"a", "b", "c"}, {});
+  const Http::TestRequestHeaderMapImpl a_headers = genHeaders("a.com", "/", "GET");
+  const Http::TestRequestHeaderMapImpl b_headers = genHeaders("b.com", "/", "GET");
+
+  auto route_config = parseRouteConfigurationFromYaml(yaml);
+  TestConfigImpl first(route_config, factory_context_, false);
+  EXPECT_EQ(2U, first.virtualHostsBuilt());
+  EXPECT_EQ(0U, first.virtualHostsReused());
+
+  route_config.mutable_virtual_hosts(1)->mutable_routes(0)->mutable_route()->set_cluster("c");
+  TestConfigImpl second(route_config, first, factory_context_, false);
+  EXPECT_EQ(1U, second.virtualHostsBuilt());
+  EXPECT_EQ(1U, second.virtualHostsReused());
+  EXPECT_EQ(&first.route(a_headers, 0)->virtualHost(), &second.route(a_headers, 0)->virtualHost());
+  EXPECT_NE(&first.route(b_headers, 0)->virtualHost(), &second.route(b_headers, 0)->virtualHost());
+  EXPECT_EQ("a", second.route(a_headers, 0)->routeEntry()->clusterName());
+  EXPECT_EQ("c", second.route(b_headers, 0)->routeEntry()->clusterName());
+
+  // Virtual hosts refer to the rest of the route configuration, so changing it rebuilds them all.
+  route_config.add_internal_only_headers("x-internal");
+  TestConfigImpl third(route_config, second, factory_context_, false);
+  EXPECT_EQ(2U, third.virtualHostsBuilt());
+  EXPECT_EQ(0U, third.virtualHostsReused());
+  EXPECT_NE(&second.route(a_headers, 0)->virtualHost(), &third.route(a_headers, 0)->virtualHost());
+
+  // Nor are virtual hosts reused when their clusters must be validated again.
+  TestConfigImpl fourth(route_config, third, factory_context_, true);
+  EXPECT_EQ(2U, fourth.virtualHostsBuilt());
+  EXPECT_EQ(0U, fourth.virtualHostsReused());
+
+  TestConfigImpl fifth(route_config, third, factory_context_, false);
+  EXPECT_EQ(0U, fifth.virtualHostsBuilt());
+  EXPECT_EQ(2U, fifth.virtualHostsReused());
+}
+
 TEST_F(RouteMatcherTest, TestConnectRoutes) {
   const std::string yaml = R"EOF(
 virtual_hosts:
@@ -335,6 +335,59 @@ TEST_F(RdsImplTest, Basic) {
   EXPECT_TRUE(scope_.findGaugeByString("foo.rds.foo_route_config.config_reload_time_ms"));
 }
 
+// Virtual hosts which do not change across updates are reused rather than built again.
+TEST_F(RdsImplTest, ReuseUnchangedVirtualHosts) {
+  InSequence s;
+
+  setup();
+
+  const fmt::format_string<const std::string&, const std::string&> response_yaml = R"EOF(
+version_info: "{}"
+resources:
+- "@type": type.googleapis.com/envoy.config.route.v3.RouteConfiguration
+  name: foo_route_config
+  virtual_hosts:
+  - name: a
+    domains: ["a"]
+    routes:
+    - match: {{ prefix: "/" }}
+      route: {{ cluster: a }}
+  - name: b
+    domains: ["b"]
+    routes:
+    - match: {{ prefix: "{}" }}
+      route: {{ cluster: b }}
+)EOF";
+  auto update = [this, &response_yaml](const std::string& version, const std::string& prefix) {
+    auto response = TestUtility::parseYaml<envoy::service::discovery::v3::DiscoveryResponse>(
+        fmt::format(response_yaml, version, prefix));
+    const auto decoded_resources =
+        TestUtility::decodeResources<envoy::config::route::v3::RouteConfiguration>(response);
+    EXPECT_TRUE(
+        rds_callbacks_->onConfigUpdate(decoded_resources.refvec_, response.version_info()).ok());
+  };
+
+  EXPECT_CALL(init_watcher_, ready());
+  update("1", "/");
+  EXPECT_EQ(2UL, scope_.counter("foo.rds.foo_route_config.virtual_hosts_built").value());
+  EXPECT_EQ(0UL, scope_.counter("foo.rds.foo_route_config.virtual_hosts_reused").value());
+  const RouteConstSharedPtr a_route =
+      route(Http::TestRequestHeaderMapImpl{{":authority", "a"}, {":path", "/"}});
+
+  update("2", "/b");
+  EXPECT_EQ(3UL, scope_.counter("foo.rds.foo_route_config.virtual_hosts_built").value());
+  EXPECT_EQ(1UL, scope_.counter("foo.rds.foo_route_config.virtual_hosts_reused").value());
+  EXPECT_EQ(2UL,
+            scope_.histogramValues("foo.rds.foo_route_config.config_build_time_us", false).size());
+  EXPECT_EQ(&a_route->virtualHost(),
+            &route(Http::TestRequestHeaderMapImpl{{":authority", "a"}, {":path", "/"}})
+                 ->virtualHost());
+  EXPECT_EQ(nullptr, route(Http::TestRequestHeaderMapImpl{{":authority", "b"}, {":path", "/"}}));
+  EXPECT_EQ("b", route(Http::TestRequestHeaderMapImpl{{":authority", "b"}, {":path", "/b"}})
+                     ->routeEntry()
+                     ->clusterName());
+}
+
 // validate there will be exception throw when unknown factory found for per virtualhost typed
 // config.
 TEST_F(RdsImplTest, UnknownFacotryForPerVirtualHostTypedConfig) {
@@ -0,0 +1,88 @@
+#include "source/common/router/route_path_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+RoutePathIndex::Candidates findCandidates(const RoutePathIndex& index, absl::string_view path) {
+  RoutePathIndex::Candidates candidates;
+  index.findCandidates(path, candidates);
+  return candidates;
+}
+
+TEST(RoutePathIndexTest, Empty) {
+  RoutePathIndex index;
+  EXPECT_THAT(findCandidates(index, "/foo"), IsEmpty());
+  EXPECT_THAT(findCandidates(index, ""), IsEmpty());
+}
+
+TEST(RoutePathIndexTest, Prefixes) {
+  RoutePathIndex index;
+  index.addPrefix(0, "/foo/bar", false);
+  index.addPrefix(1, "/foo", false);
+  index.addPrefix(2, "/", false);
+  index.addPrefix(3, "", false);
+  index.addPrefix(4, "/foo/baz", false);
+
+  // Routes on longer prefixes which come first are still returned in order.
+  EXPECT_THAT(findCandidates(index, "/foo/bar/baz"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(findCandidates(index, "/foo/baz"), ElementsAre(1, 2, 3, 4));
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(1, 2, 3));
+  EXPECT_THAT(findCandidates(index, "/fo"), ElementsAre(2, 3));
+  EXPECT_THAT(findCandidates(index, "/FOO"), ElementsAre(2, 3));
+  EXPECT_THAT(findCandidates(index, ""), ElementsAre(3));
+}
+
+TEST(RoutePathIndexTest, ExactPaths) {
+  RoutePathIndex index;
+  index.addExact(0, "/foo", false);
+  index.addExact(1, "/foo/bar", false);
+  index.addExact(2, "/foo", false);
+
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(0, 2));
+  EXPECT_THAT(findCandidates(index, "/foo/bar"), ElementsAre(1));
+  EXPECT_THAT(findCandidates(index, "/foo/"), IsEmpty());
+  EXPECT_THAT(findCandidates(index, "/fo"), IsEmpty());
+}
+
+TEST(RoutePathIndexTest, IgnoreCase) {
+  RoutePathIndex index;
+  index.addPrefix(0, "/Foo", true);
+  index.addExact(1, "/foo/BAR", true);
+  index.addPrefix(2, "/foo", false);
+
+  EXPECT_THAT(findCandidates(index, "/FOO/bar"), ElementsAre(0, 1));
+  EXPECT_THAT(findCandidates(index, "/foo/bar"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(findCandidates(index, "/fOo"), ElementsAre(0));
+}
+
+TEST(RoutePathIndexTest, UnindexedRoutesAreAlwaysCandidates) {
+  RoutePathIndex index;
+  index.addUnindexed(0);
+  index.addPrefix(1, "/foo", false);
+  index.addUnindexed(2);
+  index.addExact(3, "/foo", false);
+  index.addUnindexed(4);
+  EXPECT_EQ(3, index.unindexedRoutes());
+
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(0, 1, 2, 3, 4));
+  EXPECT_THAT(findCandidates(index, "/bar"), ElementsAre(0, 2, 4));
+}
+
+TEST(RoutePathIndexTest, CandidatesAreReplaced) {
+  RoutePathIndex index;
+  index.addPrefix(0, "/foo", false);
+  RoutePathIndex::Candidates candidates{7, 8};
+  index.findCandidates("/foo", candidates);
+  EXPECT_THAT(candidates, ElementsAre(0));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -64,6 +64,64 @@ TEST_F(AllocatorImplTest, CountersWithSameName) {
   EXPECT_EQ(2, c2->value());
 }
 
+TEST_F(AllocatorImplTest, ShardedCounter) {
+  StatName counter_name = makeStat("counter.name");
+  CounterSharedPtr c1 = alloc_.makeShardedCounter(counter_name, StatName(), {});
+  EXPECT_FALSE(c1->used());
+  c1->inc();
+  c1->add(4);
+  EXPECT_TRUE(c1->used());
+  EXPECT_EQ(5, c1->value());
+
+  // A counter of the same name is the same object, whichever way it is asked for.
+  CounterSharedPtr c2 = alloc_.makeCounter(counter_name, StatName(), {});
+  EXPECT_EQ(c1.get(), c2.get());
+  c2->inc();
+  EXPECT_EQ(6, c1->value());
+  EXPECT_EQ(6, c1->latch());
+  EXPECT_EQ(0, c1->latch());
+  c1->inc();
+  EXPECT_EQ(1, c1->latch());
+
+  c1->reset();
+  EXPECT_EQ(0, c1->value());
+  EXPECT_EQ(0, c1->latch());
+  EXPECT_TRUE(c1->used());
+
+  // An existing counter is not sharded after the fact.
+  StatName other_name = makeStat("other.name");
+  CounterSharedPtr c3 = alloc_.makeCounter(other_name, StatName(), {});
+  EXPECT_EQ(c3.get(), alloc_.makeShardedCounter(other_name, StatName(), {}).get());
+}
+
+// Increments from many threads are all seen by value() and latch().
+TEST_F(AllocatorImplTest, ShardedCounterMultipleThreads) {
+  CounterSharedPtr counter = alloc_.makeShardedCounter(makeStat("counter.name"), StatName(), {});
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+
+  const uint32_t num_threads = 12;
+  const uint32_t iters = 10000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t i = 0; i < iters; ++i) {
+        counter->inc();
+      }
+    }));
+  }
+  go.Notify();
+  uint64_t latched = 0;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    latched += counter->latch();
+    threads[i]->join();
+  }
+  latched += counter->latch();
+  EXPECT_EQ(num_threads * iters, counter->value());
+  EXPECT_EQ(num_threads * iters, latched);
+}
+
 TEST_F(AllocatorImplTest, GaugesWithSameName) {
   StatName gauge_name = makeStat("gauges.name");
   GaugeSharedPtr g1 = alloc_.makeGauge(gauge_name, StatName(), {}, Gauge::ImportMode::Accumulate);
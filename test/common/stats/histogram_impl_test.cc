@@ -109,5 +109,50 @@ TEST_F(HistogramSettingsImplTest, ScaledPercent) {
   EXPECT_EQ(settings_->buckets("abcd"), ConstSupportedBuckets({0.1, 2}));
 }
 
+// Values falling into a few buckets are kept in the fixed array, and merge into the same
+// histogram as inserting them directly would produce.
+TEST(CompactHistogramTest, MergeMatchesDirectInsert) {
+  CompactHistogram compact;
+  histogram_t* expected = hist_alloc();
+  histogram_t* merged = hist_alloc();
+  for (uint64_t value : {1, 2, 2, 3, 100, 100, 100}) {
+    compact.recordValue(value);
+    hist_insert_intscale(expected, value, 0, 1);
+  }
+  EXPECT_EQ(7, compact.sampleCount());
+  EXPECT_EQ(7, compact.mergeAndClear(merged));
+  EXPECT_EQ(0, compact.sampleCount());
+  EXPECT_EQ(hist_sample_count(expected), hist_sample_count(merged));
+  EXPECT_EQ(hist_bucket_count(expected), hist_bucket_count(merged));
+  EXPECT_DOUBLE_EQ(hist_approx_sum(expected), hist_approx_sum(merged));
+
+  // Merging again adds nothing.
+  EXPECT_EQ(0, compact.mergeAndClear(merged));
+  EXPECT_EQ(hist_sample_count(expected), hist_sample_count(merged));
+  hist_free(expected);
+  hist_free(merged);
+}
+
+// Values spread over more buckets than the fixed array holds spill into the overflow histogram,
+// which is still merged correctly, including after being reused.
+TEST(CompactHistogramTest, Overflow) {
+  CompactHistogram compact;
+  for (int round = 0; round < 2; ++round) {
+    histogram_t* expected = hist_alloc();
+    histogram_t* merged = hist_alloc();
+    for (uint64_t i = 0; i < 4 * CompactHistogram::MaxBuckets; ++i) {
+      const uint64_t value = (i + 1) * 1000;
+      compact.recordValue(value);
+      hist_insert_intscale(expected, value, 0, 1);
+    }
+    EXPECT_EQ(4 * CompactHistogram::MaxBuckets, compact.mergeAndClear(merged));
+    EXPECT_EQ(hist_sample_count(expected), hist_sample_count(merged));
+    EXPECT_EQ(hist_bucket_count(expected), hist_bucket_count(merged));
+    EXPECT_DOUBLE_EQ(hist_approx_sum(expected), hist_approx_sum(merged));
+    hist_free(expected);
+    hist_free(merged);
+  }
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -71,6 +71,42 @@ TEST_F(MetricImplTest, FindTag) {
   EXPECT_FALSE(Utility::findTag(*counter, makeStat("name3")));
 }
 
+TEST_F(MetricImplTest, RenderedNameCache) {
+  RenderedNameCache& cache = symbol_table_.renderedNameCache();
+  cache.setEnabled(true);
+  CounterSharedPtr counter = alloc_.makeCounter(makeStat("counter.name.value"), makeStat("counter"),
+                                                {{makeStat("name"), makeStat("value")}});
+  EXPECT_EQ(0, cache.size());
+
+  // The names are rendered on first use and retained across calls.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ("counter.name.value", counter->name());
+    EXPECT_EQ("counter", counter->tagExtractedName());
+    EXPECT_EQ((TagVector{{"name", "value"}}), counter->tags());
+    EXPECT_EQ(1, cache.size());
+  }
+  const uint64_t bytes = cache.memoryBytes();
+  EXPECT_LT(0, bytes);
+
+  GaugeSharedPtr gauge = alloc_.makeGauge(makeStat("gauge"), StatName(), {},
+                                          Gauge::ImportMode::Accumulate);
+  EXPECT_EQ("gauge", gauge->name());
+  EXPECT_EQ(2, cache.size());
+
+  // Deleting a metric drops its entry, so a metric later allocated at the same
+  // address is rendered afresh.
+  gauge.reset();
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(bytes, cache.memoryBytes());
+
+  // Disabling the cache drops the remaining entries and renders directly.
+  cache.setEnabled(false);
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(0, cache.memoryBytes());
+  EXPECT_EQ("counter.name.value", counter->name());
+  EXPECT_EQ(0, cache.size());
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
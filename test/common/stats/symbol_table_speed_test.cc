@@ -13,6 +13,7 @@
 #include "test/common/stats/make_elements_helper.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -213,3 +214,35 @@ static void bmSetStrings(benchmark::State& state) {
   }
 }
 BENCHMARK(bmSetStrings);
+
+// Renders the name, tag-extracted name and tags of 10k tagged counters, as a
+// stats sink does on each flush. The argument is whether the SymbolTable's
+// rendered-name cache is enabled, in which case only the first iteration
+// decodes the names.
+//
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmRenderMetricNames(benchmark::State& state) {
+  Envoy::Stats::IsolatedStoreImpl store;
+  Envoy::Stats::SymbolTable& symbol_table = store.symbolTable();
+  symbol_table.renderedNameCache().setEnabled(state.range(0));
+  Envoy::Stats::StatNamePool pool(symbol_table);
+  const Envoy::Stats::StatName tag_name = pool.add("envoy.cluster_name");
+  std::vector<Envoy::Stats::Counter*> counters;
+  for (uint32_t i = 0; i < 10 * 1000; ++i) {
+    const Envoy::Stats::StatNameTagVector tags{
+        {tag_name, pool.add(absl::StrCat("cluster_", i % 100))}};
+    counters.push_back(&store.rootScope()->counterFromStatNameWithTags(
+        pool.add(absl::StrCat("cluster.upstream_rq_", i)), tags));
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (const Envoy::Stats::Counter* counter : counters) {
+      benchmark::DoNotOptimize(counter->name());
+      benchmark::DoNotOptimize(counter->tagExtractedName());
+      benchmark::DoNotOptimize(counter->tags());
+    }
+  }
+  state.counters["cache_bytes"] = symbol_table.renderedNameCache().memoryBytes();
+}
+BENCHMARK(bmRenderMetricNames)->Arg(0)->Arg(1);
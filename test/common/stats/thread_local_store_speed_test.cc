@@ -86,6 +86,23 @@ private:
   std::vector<std::unique_ptr<Stats::StatNameManagedStorage>> stat_names_;
 };
 
+// A store holding a single counter, which every benchmark thread increments.
+class CounterIncrementPerf {
+public:
+  explicit CounterIncrementPerf(bool sharded) : alloc_(symbol_table_), store_(alloc_) {
+    store_.setShardedCounterMatcher([sharded](absl::string_view) { return sharded; });
+    counter_ = &store_.rootScope()->counterFromString("http.ingress.downstream_rq_total");
+  }
+
+  Stats::Counter& counter() { return *counter_; }
+
+private:
+  Stats::SymbolTableImpl symbol_table_;
+  Stats::AllocatorImpl alloc_;
+  Stats::ThreadLocalStoreImpl store_;
+  Stats::Counter* counter_;
+};
+
 } // namespace Envoy
 
 // Tests the single-threaded performance of the thread-local-store stats caches
@@ -138,5 +155,25 @@ static void BM_StatsWithTlsAndRejectionsWithoutDot(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
+// Tests how increments of one counter from several threads, as workers do for the per-listener
+// and per-cluster request counters, scale with the number of threads. The argument selects
+// whether the counter is sharded.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CounterIncrement(benchmark::State& state) {
+  static Envoy::CounterIncrementPerf* context;
+  if (state.thread_index() == 0) {
+    context = new Envoy::CounterIncrementPerf(state.range(0) != 0);
+  }
+  // The benchmark loop starts and ends with a barrier across all threads, so the context is
+  // created before any thread uses it and only deleted after they are all done with it.
+  for (auto _ : state) { // NOLINT
+    context->counter().inc();
+  }
+  if (state.thread_index() == 0) {
+    delete context;
+  }
+}
+BENCHMARK(BM_CounterIncrement)->Arg(0)->Arg(1)->ThreadRange(1, 16)->UseRealTime();
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
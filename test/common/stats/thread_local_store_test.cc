@@ -28,11 +28,13 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/match.h"
 #include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::ElementsAre;
 using testing::HasSubstr;
 using testing::InSequence;
 using testing::NiceMock;
@@ -780,6 +782,34 @@ TEST_F(StatsThreadLocalStoreTest, SharedScopes) {
   tls_.shutdownThread();
 }
 
+// The sharded counter matcher is consulted with the full name of each new counter, and counters
+// behave the same whether or not they are sharded.
+TEST_F(StatsThreadLocalStoreTest, ShardedCounters) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+  std::vector<std::string> matched_names;
+  store_->setShardedCounterMatcher([&matched_names](absl::string_view stat_name) {
+    matched_names.emplace_back(stat_name);
+    return absl::EndsWith(stat_name, "_total");
+  });
+
+  ScopeSharedPtr scope = store_->createScope("scope.");
+  Counter& sharded = scope->counterFromString("rq_total");
+  Counter& plain = scope->counterFromString("rq_error");
+  EXPECT_EQ(&sharded, &scope->counterFromString("rq_total"));
+  EXPECT_THAT(matched_names, ElementsAre("scope.rq_total", "scope.rq_error"));
+
+  sharded.add(5);
+  plain.add(5);
+  EXPECT_EQ(5, TestUtility::findCounter(*store_, "scope.rq_total")->value());
+  EXPECT_EQ(5, TestUtility::findCounter(*store_, "scope.rq_error")->value());
+  EXPECT_EQ(5, sharded.latch());
+  EXPECT_EQ(5, plain.latch());
+
+  tls_.shutdownGlobalThreading();
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+}
+
 TEST_F(StatsThreadLocalStoreTest, ExtractAndAppendTagsFixedValue) {
   store_->initializeThreading(main_thread_dispatcher_, tls_);
 
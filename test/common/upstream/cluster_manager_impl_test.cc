@@ -9,6 +9,7 @@
 #include "source/common/network/resolver_impl.h"
 #include "source/common/router/context_impl.h"
 #include "source/common/upstream/load_balancer_factory_base.h"
+#include "source/extensions/load_balancing_policies/common/thread_aware_lb_impl.h"
 #include "source/extensions/load_balancing_policies/subset/subset_lb.h"
 #include "source/extensions/transport_sockets/raw_buffer/config.h"
 
@@ -1217,6 +1218,40 @@ TEST_F(ClusterManagerImplTest, RingHashLoadBalancerInitialization) {
   create(parseBootstrapFromV3Yaml(yaml));
 }
 
+// The initial ring of clusters initialized at startup is built on the load balancer build pool,
+// or on the main thread when that is disabled; either way workers see it.
+TEST_F(ClusterManagerImplTest, RingHashLoadBalancerInitialBuild) {
+  const std::string yaml = R"EOF(
+ static_resources:
+  clusters:
+  - name: cluster_1
+    lb_policy: RING_HASH
+    connect_timeout: 0.250s
+    type: STATIC
+    load_assignment:
+      cluster_name: cluster_1
+      endpoints:
+      - lb_endpoints:
+        - endpoint:
+            address:
+              socket_address:
+                address: 127.0.0.1
+                port_value: 8000
+  )EOF";
+
+  for (const bool build_on_pool : {true, false}) {
+    TestScopedRuntime scoped_runtime;
+    scoped_runtime.mergeValues({{"envoy.reloadable_features.parallel_initial_lb_build",
+                                 build_on_pool ? "true" : "false"}});
+    create(parseBootstrapFromV3Yaml(yaml));
+    HostConstSharedPtr host =
+        cluster_manager_->getThreadLocalCluster("cluster_1")->loadBalancer().chooseHost(nullptr);
+    ASSERT_NE(nullptr, host);
+    EXPECT_EQ("127.0.0.1:8000", host->address()->asString());
+    cluster_manager_.reset();
+  }
+}
+
 TEST_F(ClusterManagerImplTest, RingHashLoadBalancerV2Initialization) {
   const std::string yaml = R"EOF(
   static_resources:
@@ -1377,6 +1412,107 @@ TEST_F(ClusterManagerImplThreadAwareLbTest, MaglevLoadBalancerThreadAwareUpdate)
   doTest("envoy.load_balancing_policies.maglev");
 }
 
+// Records how many initial load balancer builds are running at once. Each build waits a while for
+// another one to start, so builds which can overlap do.
+struct BuildOverlapTracker {
+  absl::Mutex mutex_;
+  uint32_t started_ ABSL_GUARDED_BY(mutex_){};
+  uint32_t overlapped_ ABSL_GUARDED_BY(mutex_){};
+  uint32_t finished_ ABSL_GUARDED_BY(mutex_){};
+};
+
+class OverlapCheckingLoadBalancer : public ThreadAwareLoadBalancerBase {
+public:
+  OverlapCheckingLoadBalancer(const PrioritySet& priority_set, ClusterLbStats& stats,
+                              Runtime::Loader& runtime, Random::RandomGenerator& random,
+                              BuildOverlapTracker& tracker)
+      : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, 50, false),
+        tracker_(tracker) {}
+  ~OverlapCheckingLoadBalancer() override { cancelBuild(); }
+
+private:
+  struct NullHashingLoadBalancer : public HashingLoadBalancer {
+    HostConstSharedPtr chooseHost(uint64_t, uint32_t) const override { return nullptr; }
+  };
+
+  // ThreadAwareLoadBalancerBase
+  HashingLoadBalancerSharedPtr createLoadBalancer(const NormalizedHostWeightVector&, double,
+                                                  double) override {
+    absl::MutexLock lock(&tracker_.mutex_);
+    tracker_.started_++;
+    if (tracker_.mutex_.AwaitWithTimeout(absl::Condition(
+                                             +[](uint32_t* started) { return *started >= 2; },
+                                             &tracker_.started_),
+                                         absl::Seconds(10))) {
+      tracker_.overlapped_++;
+    }
+    tracker_.finished_++;
+    return std::make_shared<NullHashingLoadBalancer>();
+  }
+
+  BuildOverlapTracker& tracker_;
+};
+
+// The initial load balancers of clusters initialized one after another on the main thread are
+// built concurrently on the build pool, and the cluster manager is only reported initialized once
+// all of them are built.
+TEST_F(ClusterManagerImplTest, InitialLoadBalancerBuildsOverlap) {
+  if (std::thread::hardware_concurrency() < 2) {
+    GTEST_SKIP() << "the load balancer build pool has a single thread";
+  }
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.parallel_initial_lb_build", "true"}});
+
+  const std::string json = fmt::sprintf(
+      "{\"static_resources\":{%s}}",
+      clustersJson({defaultStaticClusterJson("cluster_0"), defaultStaticClusterJson("cluster_1")}));
+
+  BuildOverlapTracker tracker;
+  std::vector<std::shared_ptr<MockClusterMockPrioritySet>> clusters;
+  for (const char* name : {"cluster_0", "cluster_1"}) {
+    auto cluster = std::make_shared<NiceMock<MockClusterMockPrioritySet>>();
+    cluster->info_->name_ = name;
+    ON_CALL(*cluster->info_, loadBalancerFactory())
+        .WillByDefault(
+            ReturnRef(Config::Utility::getAndCheckFactoryByName<Upstream::TypedLoadBalancerFactory>(
+                "envoy.load_balancing_policies.cluster_provided")));
+    ON_CALL(*cluster, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+    cluster->prioritySet().getMockHostSet(0)->hosts_ = {
+        makeTestHost(cluster->info_, "tcp://127.0.0.1:80", time_system_)};
+    clusters.push_back(cluster);
+  }
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(
+          clusters[0], new OverlapCheckingLoadBalancer(clusters[0]->prioritySet(),
+                                                       clusters[0]->info_->lb_stats_,
+                                                       factory_.runtime_, factory_.random_,
+                                                       tracker))))
+      .WillOnce(Return(std::make_pair(
+          clusters[1], new OverlapCheckingLoadBalancer(clusters[1]->prioritySet(),
+                                                       clusters[1]->info_->lb_stats_,
+                                                       factory_.runtime_, factory_.random_,
+                                                       tracker))));
+  create(parseBootstrapFromV3Json(json));
+
+  // Neither initialization waits for the build it posts, nor for the worker load balancer which is
+  // created from it.
+  clusters[0]->initialize_callback_();
+  clusters[1]->initialize_callback_();
+
+  bool initialized = false;
+  cluster_manager_->setInitializedCb([&]() {
+    absl::MutexLock lock(&tracker.mutex_);
+    EXPECT_EQ(2, tracker.finished_);
+    initialized = true;
+  });
+  EXPECT_TRUE(initialized);
+  {
+    absl::MutexLock lock(&tracker.mutex_);
+    EXPECT_EQ(2, tracker.overlapped_);
+  }
+  cluster_manager_.reset();
+}
+
 TEST_F(ClusterManagerImplTest, TcpHealthChecker) {
   const std::string yaml = R"EOF(
  static_resources:
@@ -0,0 +1,66 @@
+#include <atomic>
+
+#include "source/common/upstream/load_balancer_build_pool.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+TEST(LoadBalancerBuildPoolTest, NoThreadsUntilTasksArePosted) {
+  LoadBalancerBuildPoolImpl pool(Thread::threadFactoryForTest(), 4);
+  EXPECT_EQ(0U, pool.threads());
+}
+
+TEST(LoadBalancerBuildPoolTest, RunsTasksOnBoundedThreads) {
+  std::atomic<uint32_t> ran{0};
+  absl::Notification release;
+  {
+    LoadBalancerBuildPoolImpl pool(Thread::threadFactoryForTest(), 2);
+    // The first tasks block, so every task posted after them needs a thread of its own, up to the
+    // maximum.
+    for (int i = 0; i < 10; ++i) {
+      pool.post([&ran, &release]() {
+        release.WaitForNotification();
+        ++ran;
+      });
+    }
+    EXPECT_EQ(2U, pool.threads());
+    release.Notify();
+  }
+  // Destroying the pool runs the tasks which are still queued.
+  EXPECT_EQ(10U, ran.load());
+}
+
+TEST(LoadBalancerBuildPoolTest, ReusesIdleThreads) {
+  LoadBalancerBuildPoolImpl pool(Thread::threadFactoryForTest(), 4);
+  for (int i = 0; i < 3; ++i) {
+    absl::Notification done;
+    pool.post([&done]() { done.Notify(); });
+    done.WaitForNotification();
+  }
+  // The thread may not have gone back to waiting for tasks by the time the next one is posted, in
+  // which case another one is started.
+  EXPECT_GE(pool.threads(), 1U);
+  EXPECT_LE(pool.threads(), 3U);
+}
+
+TEST(LoadBalancerBuildPoolTest, WaitsForPostedTasks) {
+  LoadBalancerBuildPoolImpl pool(Thread::threadFactoryForTest(), 2);
+  pool.wait();
+
+  std::atomic<uint32_t> ran{0};
+  for (int i = 0; i < 10; ++i) {
+    pool.post([&ran]() { ++ran; });
+  }
+  pool.wait();
+  EXPECT_EQ(10U, ran.load());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,119 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/data/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/grpc/v3/als.pb.h"
+#include "envoy/service/accesslog/v3/als.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/access_loggers/common/grpc_access_logger.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Common {
+namespace {
+
+using HttpLogProto = envoy::data::accesslog::v3::HTTPAccessLogEntry;
+using TcpLogProto = envoy::data::accesslog::v3::TCPAccessLogEntry;
+using LogRequest = envoy::service::accesslog::v3::StreamAccessLogsMessage;
+using LogResponse = envoy::service::accesslog::v3::StreamAccessLogsResponse;
+
+// Serializes each message as the gRPC clients do, and counts what would have gone on the wire.
+class CountingClient : public GrpcAccessLogClient<LogRequest, LogResponse> {
+public:
+  CountingClient()
+      : GrpcAccessLogClient(nullptr,
+                            *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
+                                "envoy.service.accesslog.v3.AccessLogService.StreamAccessLogs"),
+                            {}) {}
+
+  bool isConnected() override { return true; }
+  bool log(const LogRequest& request) override {
+    benchmark::DoNotOptimize(request.SerializeAsString());
+    messages_++;
+    return true;
+  }
+
+  uint64_t messages_{};
+};
+
+class BenchmarkLogger
+    : public GrpcAccessLogger<HttpLogProto, TcpLogProto, LogRequest, LogResponse> {
+public:
+  BenchmarkLogger(
+      const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config,
+      Event::Dispatcher& dispatcher, Stats::Scope& scope, std::unique_ptr<CountingClient> client)
+      : GrpcAccessLogger(config, dispatcher, scope, absl::nullopt, std::move(client)) {}
+
+private:
+  bool isEmpty() override { return message_.http_logs().log_entry().empty(); }
+  void initMessage() override {}
+  void addEntry(HttpLogProto&& entry) override {
+    message_.mutable_http_logs()->mutable_log_entry()->Add(std::move(entry));
+  }
+  void addEntry(TcpLogProto&&) override {}
+};
+
+HttpLogProto makeEntry() {
+  HttpLogProto entry;
+  auto* common = entry.mutable_common_properties();
+  common->mutable_downstream_remote_address()->mutable_socket_address()->set_address("10.0.0.1");
+  common->mutable_downstream_remote_address()->mutable_socket_address()->set_port_value(43210);
+  common->mutable_start_time()->set_seconds(1700000000);
+  common->set_upstream_cluster("backend");
+  auto* request = entry.mutable_request();
+  request->set_authority("example.com");
+  request->set_path("/api/v1/users/12345/profile?fields=name,email");
+  request->set_user_agent("Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36");
+  request->set_request_id("6d7f1b0c-5a8e-4c1e-9f3b-2a4d6e8f0a1b");
+  entry.mutable_response()->mutable_response_code()->set_value(200);
+  entry.mutable_response()->set_response_body_bytes(1234);
+  return entry;
+}
+
+// Logs one second of entries at 100k logs/s on one worker, ending with the flush timer, with the
+// default 16 KiB batches (first argument) and batches adapting up to the second argument.
+static void bmGrpcAccessLogger(benchmark::State& state) {
+  envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig config;
+  config.mutable_buffer_size_bytes()->set_value(state.range(0));
+  config.mutable_max_buffer_size_bytes()->set_value(state.range(1));
+  NiceMock<Event::MockDispatcher> dispatcher;
+  auto* timer = new NiceMock<Event::MockTimer>(&dispatcher);
+  Stats::IsolatedStoreImpl store;
+  auto client = std::make_unique<CountingClient>();
+  CountingClient& counting_client = *client;
+  BenchmarkLogger logger(config, dispatcher, *store.rootScope(), std::move(client));
+  const HttpLogProto entry = makeEntry();
+
+  constexpr uint64_t LogsPerSecond = 100000;
+  uint64_t seconds = 0;
+  for (auto _ : state) { // NOLINT
+    for (uint64_t i = 0; i < LogsPerSecond; i++) {
+      logger.log(HttpLogProto(entry));
+    }
+    timer->invokeCallback();
+    seconds++;
+  }
+  state.SetItemsProcessed(seconds * LogsPerSecond);
+  state.counters["messages_per_second"] = static_cast<double>(counting_client.messages_) / seconds;
+  state.counters["final_batch_bytes"] = logger.bufferSizeBytes();
+}
+BENCHMARK(bmGrpcAccessLogger)
+    ->Args({16384, 16384})
+    ->Args({16384, 256 * 1024})
+    ->Args({16384, 1024 * 1024})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Common
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -353,6 +353,90 @@ TEST_F(StreamingGrpcAccessLogTest, Flushing) {
   timer_->invokeCallback();
 }
 
+// Test that the batch size grows while batches fill up before the flush interval, and shrinks
+// back when the flush interval elapses on batches less than half full.
+TEST_F(StreamingGrpcAccessLogTest, AdaptiveBatching) {
+  const uint64_t entry_size = mockHttpEntry().ByteSizeLong();
+  config_.mutable_max_buffer_size_bytes()->set_value(8 * entry_size);
+  initLogger(FlushInterval, 2 * entry_size);
+  EXPECT_EQ(2 * entry_size, logger_->bufferSizeBytes());
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+
+  for (const uint64_t batch : {2, 4, 8}) {
+    expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, batch);
+    for (uint64_t i = 0; i < batch; i++) {
+      logger_->log(mockHttpEntry());
+    }
+    EXPECT_EQ(std::min<uint64_t>(2 * batch, 8) * entry_size, logger_->bufferSizeBytes());
+  }
+  EXPECT_EQ(3, logger_->numClears());
+
+  // A batch less than half full when the flush interval elapses halves the batch size.
+  logger_->log(mockHttpEntry());
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 1);
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval, _));
+  timer_->invokeCallback();
+  EXPECT_EQ(4 * entry_size, logger_->bufferSizeBytes());
+
+  // The batch size doesn't shrink below buffer_size_bytes.
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval, _)).Times(2);
+  timer_->invokeCallback();
+  timer_->invokeCallback();
+  EXPECT_EQ(2 * entry_size, logger_->bufferSizeBytes());
+}
+
+// Test that entries are buffered up to max_pending_buffer_bytes while the stream can't take more
+// data, and dropped past it.
+TEST_F(StreamingGrpcAccessLogTest, PendingBufferLimit) {
+  InSequence s;
+  const uint64_t entry_size = mockHttpEntry().ByteSizeLong();
+  config_.mutable_max_pending_buffer_bytes()->set_value(3 * entry_size);
+  initLogger(FlushInterval, entry_size);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+
+  // Every log tries to flush the full batch, and fails.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).Times(3).WillRepeatedly(Return(true));
+  for (int i = 0; i < 3; i++) {
+    logger_->log(mockHttpEntry());
+  }
+  EXPECT_EQ(0, logger_->numClears());
+  EXPECT_EQ(3,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+
+  // The pending entries have reached the limit, so the next HTTP and TCP entries are dropped.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).Times(2).WillRepeatedly(Return(true));
+  logger_->log(mockHttpEntry());
+  logger_->log(ProtobufWkt::Empty());
+  EXPECT_EQ(3,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+  EXPECT_EQ(2,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
+
+  // Once the stream drains, the pending entries go out in one message.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream, sendMessageRaw_(_, false))
+      .WillOnce(Invoke([](Buffer::InstancePtr& request, bool) {
+        ProtobufWkt::Struct message;
+        Buffer::ZeroCopyInputStreamImpl request_stream(std::move(request));
+        EXPECT_TRUE(message.ParseFromZeroCopyStream(&request_stream));
+        EXPECT_EQ(3, message.fields().at(MOCK_HTTP_LOG_FIELD_NAME).number_value());
+      }));
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream, sendMessageRaw_(_, false));
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(2, logger_->numClears());
+  EXPECT_EQ(4,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+  EXPECT_EQ(2,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
+}
+
 class UnaryGrpcAccessLogTest : public testing::Test {
 public:
   using MockAccessLogStream = Grpc::MockAsyncStream;
@@ -13,10 +13,12 @@
 #include "source/common/config/protobuf_link_hacks.h"
 #include "source/common/config/utility.h"
 #include "source/common/singleton/manager_impl.h"
+#include "source/common/upstream/load_balancer_build_pool.h"
 #include "source/extensions/clusters/eds/eds.h"
 #include "source/extensions/config_subscription/grpc/grpc_mux_impl.h"
 #include "source/extensions/config_subscription/grpc/grpc_subscription_impl.h"
 #include "source/extensions/config_subscription/grpc/xds_mux/grpc_mux_impl.h"
+#include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
 #include "source/server/transport_socket_config_impl.h"
 
 #include "test/benchmark/main.h"
@@ -31,6 +33,7 @@
 #include "test/mocks/ssl/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "benchmark/benchmark.h"
@@ -163,6 +166,24 @@ public:
            num_hosts);
   }
 
+  // Creates the Maglev load balancer of the cluster and builds its initial table, as the cluster
+  // manager does once the cluster has initialized: on build_pool if given one, otherwise here.
+  void initializeMaglev(LoadBalancerBuildPool* build_pool) {
+    maglev_lb_ = std::make_unique<MaglevLoadBalancer>(
+        cluster_->prioritySet(), cluster_->info()->lbStats(), scope_,
+        server_context_.runtime_loader_, random_, absl::nullopt, eds_cluster_.common_lb_config());
+    const absl::Status status = build_pool != nullptr
+                                    ? maglev_lb_->initializeWithBuildPool(*build_pool)
+                                    : maglev_lb_->initialize();
+    ASSERT(status.ok());
+  }
+
+  // Creates a worker load balancer, which waits for the initial table to be built.
+  void createMaglevLoadBalancer() {
+    LoadBalancerPtr lb = maglev_lb_->factory()->create({cluster_->prioritySet(), nullptr});
+    benchmark::DoNotOptimize(lb);
+  }
+
   NiceMock<Server::Configuration::MockServerFactoryContext> server_context_;
   Stats::TestUtil::TestStore& stats_ = server_context_.store_;
 
@@ -189,6 +210,7 @@ public:
   Config::GrpcMuxSharedPtr grpc_mux_;
   Config::GrpcSubscriptionImplPtr subscription_;
   NiceMock<AccessLog::MockAccessLogManager> access_log_manager_;
+  std::unique_ptr<MaglevLoadBalancer> maglev_lb_;
 };
 
 } // namespace Upstream
@@ -241,3 +263,46 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
+
+// Measures the startup of EDS clusters using Maglev: each receives its endpoints and has its
+// initial table built, either on the main thread or on a load balancer build pool as the cluster
+// manager does while the server is starting, until every table is ready. As in the cluster
+// manager, a load balancer is created from each cluster as soon as it is initialized.
+static void startupWithMaglev(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  const uint32_t num_clusters = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  const bool build_on_pool = state.range(1);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    std::vector<std::unique_ptr<Envoy::Upstream::EdsSpeedTest>> clusters;
+    for (uint32_t i = 0; i < num_clusters; ++i) {
+      clusters.push_back(std::make_unique<Envoy::Upstream::EdsSpeedTest>(state, false));
+    }
+    state.ResumeTiming();
+
+    std::unique_ptr<Envoy::Upstream::LoadBalancerBuildPoolImpl> build_pool;
+    if (build_on_pool) {
+      build_pool = std::make_unique<Envoy::Upstream::LoadBalancerBuildPoolImpl>(
+          Envoy::Thread::threadFactoryForTest(), 8);
+    }
+    for (auto& cluster : clusters) {
+      cluster->priorityAndLocalityWeightedHelper(true, 100, true);
+      cluster->initializeMaglev(build_pool.get());
+      cluster->createMaglevLoadBalancer();
+    }
+    if (build_pool != nullptr) {
+      build_pool->wait();
+    }
+
+    state.PauseTiming();
+    build_pool.reset();
+    clusters.clear();
+    state.ResumeTiming();
+  }
+}
+
+BENCHMARK(startupWithMaglev)
+    ->ArgsProduct({{1, 16, 64}, {false, true}})
+    ->Unit(benchmark::kMillisecond);
@@ -1,3 +1,5 @@
+#include <sys/mman.h>
+
 #include <future>
 #include <memory>
 #include <string>
@@ -313,6 +315,46 @@ TEST_F(AsyncFileHandleTest, DuplicateCreatesIndependentHandle) {
   close(dup_file);
 }
 
+TEST_F(AsyncFileHandleTest, ReadMappedReturnsFileContents) {
+  // tmpfile is initialized to contain "hello".
+  TestTmpFile tmpfile(tmpdir_);
+
+  auto handle = openExistingFile(tmpfile.name(), AsyncFileManager::Mode::ReadOnly);
+  std::promise<absl::StatusOr<Buffer::InstancePtr>> read_status_promise;
+  // Offsets that are not page aligned are supported.
+  EXPECT_OK(handle->readMapped(1, 3, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    read_status_promise.set_value(std::move(status));
+  }));
+  auto read_status = read_status_promise.get_future().get();
+  // The file is closed before the mapped data is consumed, which must remain valid.
+  close(handle);
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("ell"));
+}
+
+TEST_F(AsyncFileHandleTest, ReadMappedPastEndOfFileReturnsPartialResult) {
+  // tmpfile is initialized to contain "hello".
+  TestTmpFile tmpfile(tmpdir_);
+
+  auto handle = openExistingFile(tmpfile.name(), AsyncFileManager::Mode::ReadOnly);
+  std::promise<absl::StatusOr<Buffer::InstancePtr>> partial_read_promise;
+  EXPECT_OK(handle->readMapped(3, 100, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    partial_read_promise.set_value(std::move(status));
+  }));
+  auto partial_read = partial_read_promise.get_future().get();
+  ASSERT_OK(partial_read);
+  EXPECT_THAT(*partial_read.value(), BufferStringEqual("lo"));
+
+  std::promise<absl::StatusOr<Buffer::InstancePtr>> empty_read_promise;
+  EXPECT_OK(handle->readMapped(10, 5, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    empty_read_promise.set_value(std::move(status));
+  }));
+  auto empty_read = empty_read_promise.get_future().get();
+  ASSERT_OK(empty_read);
+  EXPECT_EQ(0, empty_read.value()->length());
+  close(handle);
+}
+
 TEST_F(AsyncFileHandleWithMockPosixTest, PartialReadReturnsPartialResult) {
   auto handle = createAnonymousFile();
   EXPECT_CALL(mock_posix_file_operations_, pread(_, _, _, _))
@@ -451,6 +493,23 @@ TEST_F(AsyncFileHandleWithMockPosixTest, StatFailureReportsError) {
   close(handle);
 }
 
+TEST_F(AsyncFileHandleWithMockPosixTest, ReadMappedFailureReportsError) {
+  auto handle = createAnonymousFile();
+  EXPECT_CALL(mock_posix_file_operations_, fstat(_, _)).WillOnce([](int, struct stat* buffer) {
+    buffer->st_size = 100;
+    return Api::SysCallIntResult{0, 0};
+  });
+  EXPECT_CALL(mock_posix_file_operations_, mmap(_, _, _, _, _, _))
+      .WillOnce(Return(Api::SysCallPtrResult{MAP_FAILED, ENOMEM}));
+  std::promise<absl::StatusOr<Buffer::InstancePtr>> read_status_promise;
+  EXPECT_OK(handle->readMapped(0, 5, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    read_status_promise.set_value(std::move(status));
+  }));
+  auto read_status = read_status_promise.get_future().get();
+  EXPECT_THAT(read_status, StatusIs(absl::StatusCode::kResourceExhausted));
+  close(handle);
+}
+
 TEST_F(AsyncFileHandleWithMockPosixTest, CloseFailureReportsError) {
   auto handle = createAnonymousFile();
   EXPECT_CALL(mock_posix_file_operations_, close(1))
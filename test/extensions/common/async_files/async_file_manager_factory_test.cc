@@ -57,6 +57,15 @@ TEST_F(AsyncFileManagerFactoryTest, ExceptionIfThreadPoolSelectedAndUnsupported)
                             EnvoyException, "AsyncFileManagerThreadPool not supported");
 }
 
+TEST_F(AsyncFileManagerFactoryTest, ExceptionIfIoUringSelectedAndUnsupported) {
+  envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+  config.mutable_io_uring();
+  EXPECT_CALL(mock_posix_file_operations_, supportsAllPosixFileOperations())
+      .WillRepeatedly(Return(false));
+  EXPECT_THROW_WITH_MESSAGE(factory_->getAsyncFileManager(config, &mock_posix_file_operations_),
+                            EnvoyException, "AsyncFileManagerIoUring not supported");
+}
+
 TEST_F(AsyncFileManagerFactoryTest, ExceptionIfGivenInconsistentConfigForSameManagerId) {
   envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
   config.mutable_thread_pool()->set_thread_count(1);
@@ -0,0 +1,256 @@
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/status_utility.h"
+#include "test/test_common/utility.h"
+
+#include "absl/status/statusor.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+using StatusHelpers::HasStatusCode;
+using StatusHelpers::IsOkAndHolds;
+
+class AsyncFileManagerIoUringTest : public testing::Test {
+public:
+  void SetUp() override {
+    singleton_manager_ = std::make_unique<Singleton::ManagerImpl>(Thread::threadFactoryForTest());
+    factory_ = AsyncFileManagerFactory::singleton(singleton_manager_.get());
+    envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+    // A small ring, so that tests issuing many operations also cover queueing beyond it.
+    config.mutable_io_uring()->set_io_uring_size(8);
+    try {
+      manager_ = factory_->getAsyncFileManager(config);
+    } catch (const EnvoyException& e) {
+      GTEST_SKIP() << e.what();
+    }
+  }
+
+  AsyncFileHandle createAnonymousFile() {
+    std::promise<absl::StatusOr<AsyncFileHandle>> result;
+    manager_->createAnonymousFile(tmpdir_, [&](absl::StatusOr<AsyncFileHandle> handle) {
+      result.set_value(std::move(handle));
+    });
+    return result.get_future().get().value();
+  }
+
+  absl::StatusOr<AsyncFileHandle> openExistingFile(absl::string_view filename,
+                                                   AsyncFileManager::Mode mode) {
+    std::promise<absl::StatusOr<AsyncFileHandle>> result;
+    manager_->openExistingFile(filename, mode, [&](absl::StatusOr<AsyncFileHandle> handle) {
+      result.set_value(std::move(handle));
+    });
+    return result.get_future().get();
+  }
+
+  absl::StatusOr<size_t> write(AsyncFileHandle& handle, absl::string_view contents, off_t offset) {
+    std::promise<absl::StatusOr<size_t>> result;
+    Buffer::OwnedImpl buffer(contents);
+    EXPECT_OK(handle->write(buffer, offset, [&](absl::StatusOr<size_t> written) {
+      result.set_value(std::move(written));
+    }));
+    return result.get_future().get();
+  }
+
+  absl::StatusOr<std::string> read(AsyncFileHandle& handle, off_t offset, size_t length) {
+    std::promise<absl::StatusOr<Buffer::InstancePtr>> result;
+    EXPECT_OK(handle->read(offset, length, [&](absl::StatusOr<Buffer::InstancePtr> buffer) {
+      result.set_value(std::move(buffer));
+    }));
+    auto buffer = result.get_future().get();
+    if (!buffer.ok()) {
+      return buffer.status();
+    }
+    return buffer.value()->toString();
+  }
+
+  absl::StatusOr<struct stat> stat(absl::string_view filename) {
+    std::promise<absl::StatusOr<struct stat>> result;
+    manager_->stat(filename,
+                   [&](absl::StatusOr<struct stat> stat) { result.set_value(std::move(stat)); });
+    return result.get_future().get();
+  }
+
+  void close(AsyncFileHandle& handle) {
+    std::promise<absl::Status> result;
+    EXPECT_OK(handle->close([&](absl::Status status) { result.set_value(status); }));
+    EXPECT_OK(result.get_future().get());
+  }
+
+protected:
+  std::unique_ptr<Singleton::ManagerImpl> singleton_manager_;
+  std::shared_ptr<AsyncFileManagerFactory> factory_;
+  std::shared_ptr<AsyncFileManager> manager_;
+  const char* test_tmpdir = std::getenv("TEST_TMPDIR");
+  std::string tmpdir_ = test_tmpdir ? test_tmpdir : "/tmp";
+};
+
+TEST_F(AsyncFileManagerIoUringTest, Describe) {
+  EXPECT_EQ(manager_->describe(), "io_uring_size = 8");
+}
+
+TEST_F(AsyncFileManagerIoUringTest, WriteReadStatClose) {
+  AsyncFileHandle handle = createAnonymousFile();
+  EXPECT_THAT(write(handle, "hello", 0), IsOkAndHolds(5U));
+  EXPECT_THAT(write(handle, "p!", 3), IsOkAndHolds(2U));
+  EXPECT_THAT(read(handle, 0, 5), IsOkAndHolds("help!"));
+  EXPECT_THAT(read(handle, 2, 3), IsOkAndHolds("lp!"));
+  // Reading past the end of the file gives a short result.
+  EXPECT_THAT(read(handle, 3, 100), IsOkAndHolds("p!"));
+  std::promise<absl::StatusOr<struct stat>> stat_result;
+  EXPECT_OK(handle->stat(
+      [&](absl::StatusOr<struct stat> result) { stat_result.set_value(std::move(result)); }));
+  absl::StatusOr<struct stat> file_stat = stat_result.get_future().get();
+  ASSERT_OK(file_stat);
+  EXPECT_EQ(file_stat.value().st_size, 5);
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, WriteOfManySlicesIsComplete) {
+  AsyncFileHandle handle = createAnonymousFile();
+  // More slices than a single writev accepts, so the remainder takes the fallback path.
+  Buffer::OwnedImpl contents;
+  std::string expected;
+  for (int i = 0; i < 2000; i++) {
+    std::string slice = absl::StrCat(i, ",");
+    expected += slice;
+    contents.appendSliceForTest(slice);
+  }
+  std::promise<absl::StatusOr<size_t>> written;
+  EXPECT_OK(handle->write(contents, 0, [&](absl::StatusOr<size_t> result) {
+    written.set_value(std::move(result));
+  }));
+  EXPECT_THAT(written.get_future().get(), IsOkAndHolds(expected.size()));
+  EXPECT_THAT(read(handle, 0, expected.size()), IsOkAndHolds(expected));
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, LinkOpenStatAndUnlink) {
+  const std::string filename = absl::StrCat(tmpdir_, "/io_uring_link_test");
+  AsyncFileHandle handle = createAnonymousFile();
+  EXPECT_THAT(write(handle, "linked", 0), IsOkAndHolds(6U));
+  std::promise<absl::Status> linked;
+  EXPECT_OK(
+      handle->createHardLink(filename, [&](absl::Status status) { linked.set_value(status); }));
+  EXPECT_OK(linked.get_future().get());
+  close(handle);
+
+  absl::StatusOr<struct stat> file_stat = stat(filename);
+  ASSERT_OK(file_stat);
+  EXPECT_EQ(file_stat.value().st_size, 6);
+
+  absl::StatusOr<AsyncFileHandle> opened =
+      openExistingFile(filename, AsyncFileManager::Mode::ReadOnly);
+  ASSERT_OK(opened);
+  EXPECT_THAT(read(opened.value(), 0, 6), IsOkAndHolds("linked"));
+  close(opened.value());
+
+  std::promise<absl::Status> unlinked;
+  manager_->unlink(filename, [&](absl::Status status) { unlinked.set_value(status); });
+  EXPECT_OK(unlinked.get_future().get());
+  EXPECT_THAT(stat(filename), HasStatusCode(absl::StatusCode::kNotFound));
+  EXPECT_THAT(openExistingFile(filename, AsyncFileManager::Mode::ReadOnly),
+              HasStatusCode(absl::StatusCode::kNotFound));
+}
+
+TEST_F(AsyncFileManagerIoUringTest, SynchronousActionsRunOnRingThread) {
+  AsyncFileHandle handle = createAnonymousFile();
+  EXPECT_THAT(write(handle, "mapped", 0), IsOkAndHolds(6U));
+  std::promise<absl::StatusOr<AsyncFileHandle>> duplicated;
+  EXPECT_OK(handle->duplicate([&](absl::StatusOr<AsyncFileHandle> result) {
+    duplicated.set_value(std::move(result));
+  }));
+  absl::StatusOr<AsyncFileHandle> duplicate = duplicated.get_future().get();
+  ASSERT_OK(duplicate);
+  close(handle);
+  std::promise<absl::StatusOr<Buffer::InstancePtr>> mapped;
+  EXPECT_OK(duplicate.value()->readMapped(0, 100, [&](absl::StatusOr<Buffer::InstancePtr> result) {
+    mapped.set_value(std::move(result));
+  }));
+  absl::StatusOr<Buffer::InstancePtr> mapped_result = mapped.get_future().get();
+  ASSERT_OK(mapped_result);
+  EXPECT_EQ(mapped_result.value()->toString(), "mapped");
+  close(duplicate.value());
+  std::promise<absl::Status> ready;
+  manager_->whenReady([&](absl::Status status) { ready.set_value(status); });
+  EXPECT_OK(ready.get_future().get());
+}
+
+TEST_F(AsyncFileManagerIoUringTest, ManyConcurrentOperationsAllComplete) {
+  AsyncFileHandle handle = createAnonymousFile();
+  EXPECT_THAT(write(handle, std::string(4096, 'x'), 0), IsOkAndHolds(4096U));
+  // Several times as many handles as there are ring entries, each issuing a read from a
+  // different thread, so that actions are both queued and batched.
+  constexpr int kReads = 64;
+  std::vector<AsyncFileHandle> duplicates;
+  for (int i = 0; i < kReads; i++) {
+    std::promise<absl::StatusOr<AsyncFileHandle>> duplicated;
+    EXPECT_OK(handle->duplicate([&](absl::StatusOr<AsyncFileHandle> result) {
+      duplicated.set_value(std::move(result));
+    }));
+    duplicates.push_back(duplicated.get_future().get().value());
+  }
+  std::vector<std::promise<absl::StatusOr<Buffer::InstancePtr>>> reads(kReads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kReads; i++) {
+    threads.emplace_back([&, i]() {
+      EXPECT_OK(duplicates[i]->read(i, 64, [&reads, i](absl::StatusOr<Buffer::InstancePtr> result) {
+        reads[i].set_value(std::move(result));
+      }));
+    });
+  }
+  for (int i = 0; i < kReads; i++) {
+    absl::StatusOr<Buffer::InstancePtr> result = reads[i].get_future().get();
+    ASSERT_OK(result);
+    EXPECT_EQ(result.value()->length(), 64U);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (AsyncFileHandle& duplicate : duplicates) {
+    close(duplicate);
+  }
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, CancelledQueuedActionIsNotCalled) {
+  std::promise<void> ready;
+  std::promise<void> release;
+  // Hold the ring thread in a callback so that the open below is still queued when cancelled.
+  manager_->whenReady([&](absl::Status) {
+    ready.set_value();
+    release.get_future().wait();
+  });
+  ready.get_future().wait();
+  bool called = false;
+  CancelFunction cancel = manager_->createAnonymousFile(
+      tmpdir_, [&](absl::StatusOr<AsyncFileHandle>) { called = true; });
+  cancel();
+  release.set_value();
+  std::promise<void> done;
+  manager_->whenReady([&](absl::Status) { done.set_value(); });
+  done.get_future().wait();
+  EXPECT_FALSE(called);
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,135 @@
+// Compares AsyncFileManagerThreadPool against AsyncFileManagerIoUring when many small reads
+// are outstanding at once, as when many workers are serving cached responses from disk.
+// Each iteration issues a number of concurrent 4KiB reads at scattered offsets and waits for
+// all of them to complete.
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+#include "source/extensions/common/async_files/async_file_manager_thread_pool.h"
+
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/notification.h"
+#include "absl/types/optional.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+namespace {
+
+constexpr size_t FileSize = 16 * 1024 * 1024;
+constexpr size_t ReadSize = 4096;
+
+template <typename T> T waitFor(std::function<void(std::function<void(T)>)> start) {
+  absl::Notification done;
+  absl::optional<T> result;
+  start([&](T value) {
+    result.emplace(std::move(value));
+    done.Notify();
+  });
+  done.WaitForNotification();
+  return std::move(result.value());
+}
+
+class ConcurrentReadFixture {
+public:
+  ConcurrentReadFixture(std::unique_ptr<AsyncFileManager> manager, size_t depth)
+      : manager_(std::move(manager)) {
+    const char* tmpdir = std::getenv("TEST_TMPDIR");
+    file_ = waitFor<absl::StatusOr<AsyncFileHandle>>([&](auto on_complete) {
+              manager_->createAnonymousFile(tmpdir ? tmpdir : "/tmp", on_complete);
+            }).value();
+    Buffer::OwnedImpl contents(std::string(FileSize, 'a'));
+    RELEASE_ASSERT(waitFor<absl::StatusOr<size_t>>([&](auto on_complete) {
+                     RELEASE_ASSERT(file_->write(contents, 0, on_complete).ok(), "");
+                   }).value() == FileSize,
+                   "");
+    // Only one action may be queued per handle at a time, so each concurrent read gets a
+    // handle of its own.
+    readers_.push_back(file_);
+    while (readers_.size() < depth) {
+      readers_.push_back(waitFor<absl::StatusOr<AsyncFileHandle>>([&](auto on_complete) {
+                           RELEASE_ASSERT(file_->duplicate(on_complete).ok(), "");
+                         }).value());
+    }
+  }
+
+  ~ConcurrentReadFixture() {
+    for (const AsyncFileHandle& handle : readers_) {
+      waitFor<absl::Status>(
+          [&](auto on_complete) { RELEASE_ASSERT(handle->close(on_complete).ok(), ""); });
+    }
+  }
+
+  // Issues a read on every handle at once and waits until all have completed.
+  void readConcurrently() {
+    absl::BlockingCounter remaining(readers_.size());
+    for (const AsyncFileHandle& handle : readers_) {
+      next_offset_ = (next_offset_ + 7 * ReadSize) % (FileSize - ReadSize);
+      RELEASE_ASSERT(handle
+                         ->read(next_offset_, ReadSize,
+                                [&remaining](absl::StatusOr<Buffer::InstancePtr> result) {
+                                  RELEASE_ASSERT(result.ok(), "");
+                                  remaining.DecrementCount();
+                                })
+                         .ok(),
+                     "");
+    }
+    remaining.Wait();
+  }
+
+private:
+  std::unique_ptr<AsyncFileManager> manager_;
+  AsyncFileHandle file_;
+  std::vector<AsyncFileHandle> readers_;
+  off_t next_offset_{0};
+};
+
+void readConcurrently(benchmark::State& state, std::unique_ptr<AsyncFileManager> manager) {
+  const size_t depth = state.range(0);
+  ConcurrentReadFixture fixture(std::move(manager), depth);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    fixture.readConcurrently();
+  }
+  state.SetBytesProcessed(state.iterations() * depth * ReadSize);
+}
+
+void bmThreadPool(benchmark::State& state) {
+  envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+  config.mutable_thread_pool()->set_thread_count(4);
+  readConcurrently(state, std::make_unique<AsyncFileManagerThreadPool>(
+                              config, Api::OsSysCallsSingleton::get()));
+}
+
+void bmIoUring(benchmark::State& state) {
+  envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+  config.mutable_io_uring();
+  std::unique_ptr<AsyncFileManager> manager;
+  try {
+    manager = std::make_unique<AsyncFileManagerIoUring>(config, Api::OsSysCallsSingleton::get());
+  } catch (const EnvoyException& e) {
+    state.SkipWithError(e.what());
+    return;
+  }
+  readConcurrently(state, std::move(manager));
+}
+
+BENCHMARK(bmThreadPool)->Arg(1)->Arg(16)->Arg(128)->UseRealTime();
+BENCHMARK(bmIoUring)->Arg(1)->Arg(16)->Arg(128)->UseRealTime();
+
+} // namespace
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,122 @@
+// Compares the cost of serving file contents read with AsyncFileContext::read, which copies
+// them into user space, against AsyncFileContext::readMapped, which maps them. Each iteration
+// reads a range of a file and then writes it out to a sink file, which stands in for the
+// downstream socket: in both cases the kernel copies the data once on the way out.
+
+#include <future>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/extensions/common/async_files/async_file_manager_thread_pool.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+namespace {
+
+constexpr size_t FileSize = 64 * 1024 * 1024;
+
+class ReadBenchmarkFixture {
+public:
+  ReadBenchmarkFixture() : manager_(managerConfig(), Api::OsSysCallsSingleton::get()) {
+    source_ = createFile();
+    sink_ = createFile();
+    Buffer::OwnedImpl contents(std::string(FileSize, 'a'));
+    std::promise<absl::StatusOr<size_t>> written;
+    RELEASE_ASSERT(source_
+                       ->write(contents, 0,
+                               [&written](absl::StatusOr<size_t> result) {
+                                 written.set_value(std::move(result));
+                               })
+                       .ok(),
+                   "");
+    RELEASE_ASSERT(written.get_future().get().value() == FileSize, "");
+  }
+
+  ~ReadBenchmarkFixture() {
+    for (const AsyncFileHandle& handle : {source_, sink_}) {
+      std::promise<void> closed;
+      RELEASE_ASSERT(handle->close([&closed](absl::Status) { closed.set_value(); }).ok(), "");
+      closed.get_future().wait();
+    }
+  }
+
+  // Reads length bytes starting at offset, and writes them to the sink.
+  void serve(bool mapped, off_t offset, size_t length) {
+    std::promise<absl::StatusOr<Buffer::InstancePtr>> read;
+    auto on_read = [&read](absl::StatusOr<Buffer::InstancePtr> result) {
+      read.set_value(std::move(result));
+    };
+    RELEASE_ASSERT((mapped ? source_->readMapped(offset, length, on_read)
+                           : source_->read(offset, length, on_read))
+                       .ok(),
+                   "");
+    Buffer::InstancePtr data = std::move(read.get_future().get().value());
+    std::promise<absl::StatusOr<size_t>> written;
+    RELEASE_ASSERT(sink_
+                       ->write(*data, 0,
+                               [&written](absl::StatusOr<size_t> result) {
+                                 written.set_value(std::move(result));
+                               })
+                       .ok(),
+                   "");
+    RELEASE_ASSERT(written.get_future().get().value() == length, "");
+  }
+
+private:
+  static envoy::extensions::common::async_files::v3::AsyncFileManagerConfig managerConfig() {
+    envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+    config.mutable_thread_pool()->set_thread_count(1);
+    return config;
+  }
+
+  AsyncFileHandle createFile() {
+    const char* tmpdir = std::getenv("TEST_TMPDIR");
+    std::promise<absl::StatusOr<AsyncFileHandle>> created;
+    manager_.createAnonymousFile(tmpdir ? tmpdir : "/tmp",
+                                 [&created](absl::StatusOr<AsyncFileHandle> result) {
+                                   created.set_value(std::move(result));
+                                 });
+    return created.get_future().get().value();
+  }
+
+  AsyncFileManagerThreadPool manager_;
+  AsyncFileHandle source_;
+  AsyncFileHandle sink_;
+};
+
+void serveFromFile(benchmark::State& state, bool mapped) {
+  const size_t length = state.range(0);
+  ReadBenchmarkFixture fixture;
+  off_t offset = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    fixture.serve(mapped, offset, length);
+    offset = (offset + length) % (FileSize - length + 1);
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+}
+
+void bmServeRead(benchmark::State& state) { serveFromFile(state, false); }
+void bmServeReadMapped(benchmark::State& state) { serveFromFile(state, true); }
+
+BENCHMARK(bmServeRead)->Arg(16 * 1024)->Arg(1024 * 1024)->Arg(8 * 1024 * 1024)->UseRealTime();
+BENCHMARK(bmServeReadMapped)
+    ->Arg(16 * 1024)
+    ->Arg(1024 * 1024)
+    ->Arg(8 * 1024 * 1024)
+    ->UseRealTime();
+
+} // namespace
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
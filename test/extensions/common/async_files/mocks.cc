@@ -32,6 +32,12 @@ MockAsyncFileContext::MockAsyncFileContext(std::shared_ptr<MockAsyncFileManager>
         return manager_->enqueue(
             std::shared_ptr<MockAsyncFileAction>(new TypedMockAsyncFileAction(on_complete)));
       });
+  ON_CALL(*this, readMapped(_, _, _))
+      .WillByDefault([this](off_t, size_t,
+                            std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+        return manager_->enqueue(
+            std::shared_ptr<MockAsyncFileAction>(new TypedMockAsyncFileAction(on_complete)));
+      });
   ON_CALL(*this, write(_, _, _))
       .WillByDefault([this](Buffer::Instance&, off_t,
                             std::function<void(absl::StatusOr<size_t>)> on_complete) {
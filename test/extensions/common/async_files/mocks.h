@@ -30,6 +30,9 @@ public:
   MOCK_METHOD(absl::StatusOr<CancelFunction>, read,
               (off_t offset, size_t length,
                std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete));
+  MOCK_METHOD(absl::StatusOr<CancelFunction>, readMapped,
+              (off_t offset, size_t length,
+               std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete));
   MOCK_METHOD(absl::StatusOr<CancelFunction>, write,
               (Buffer::Instance & contents, off_t offset,
                std::function<void(absl::StatusOr<size_t>)> on_complete));
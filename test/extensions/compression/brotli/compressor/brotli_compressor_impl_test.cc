@@ -102,6 +102,60 @@ TEST_F(BrotliCompressorImplTest, CompressWithSmallChunkSize) {
   verifyWithDecompressor(std::move(compressor));
 }
 
+// Compressing content resembling the dictionary with it is smaller than without it, and
+// decompresses with the same dictionary.
+TEST_F(BrotliCompressorImplTest, CompressWithDictionary) {
+  const std::string dictionary =
+      R"({"id": 0, "name": "", "email": "", "created_at": "", "tags": [], "active": false})";
+  const std::string content =
+      R"({"id": 42, "name": "Ada", "email": "ada@example.com", "created_at": "2024-01-01",)"
+      R"( "tags": ["admin"], "active": true})";
+
+  const auto compress = [&content](PreparedDictionarySharedPtr prepared) {
+    BrotliCompressorImpl compressor(default_quality, default_window_bits, default_input_block_bits,
+                                    false, BrotliCompressorImpl::EncoderMode::Default, 4096,
+                                    std::move(prepared));
+    Buffer::OwnedImpl buffer(content);
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    return buffer.toString();
+  };
+  const std::string without_dictionary = compress(nullptr);
+  const std::string with_dictionary =
+      compress(std::make_shared<const PreparedDictionary>(std::string(dictionary), default_quality));
+  EXPECT_LT(with_dictionary.size(), without_dictionary.size());
+
+  Stats::IsolatedStoreImpl stats_store{};
+  Compression::Brotli::Decompressor::BrotliDecompressorImpl decompressor{
+      *stats_store.rootScope(), "test.", 4096, false,
+      std::make_shared<const std::string>(dictionary)};
+  Buffer::OwnedImpl compressed(with_dictionary);
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(compressed, decompressed);
+  EXPECT_EQ(content, decompressed.toString());
+  EXPECT_EQ(0, stats_store.counterFromString("test.brotli_error").value());
+}
+
+TEST_F(BrotliCompressorImplTest, LoadConfigWithDictionary) {
+  envoy::extensions::compression::brotli::compressor::v3::Brotli brotli;
+  TestUtility::loadFromJson(R"EOF({"dictionary": {"inline_string": "dictionary"}})EOF", brotli);
+
+  BrotliCompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Envoy::Compression::Compressor::CompressorFactoryPtr factory =
+      lib_factory.createCompressorFactoryFromProto(brotli, context);
+  Envoy::Compression::Compressor::CompressorPtr compressor = factory->createCompressor();
+  Buffer::OwnedImpl buffer("dictionary dictionary");
+  compressor->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+
+  Stats::IsolatedStoreImpl stats_store{};
+  Compression::Brotli::Decompressor::BrotliDecompressorImpl decompressor{
+      *stats_store.rootScope(), "test.", 4096, false,
+      std::make_shared<const std::string>("dictionary")};
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(buffer, decompressed);
+  EXPECT_EQ("dictionary dictionary", decompressed.toString());
+}
+
 class ConfigTest : public BrotliCompressorImplTest,
                    public testing::WithParamInterface<std::string> {};
 
@@ -1,8 +1,11 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/hex.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/compression/gzip/compressor/config.h"
 #include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
 
+#include "test/mocks/server/overload_manager.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "absl/container/fixed_array.h"
@@ -257,6 +260,131 @@ TEST_F(ZlibCompressorImplTest, CompressWithNotCommonParams) {
   expectValidFinishedBuffer(accumulation_buffer, input_size);
 }
 
+class ZlibCompressorStreamPoolTest : public testing::Test {
+protected:
+  Common::ZStreamPoolPtr makePool(uint64_t max_retained_bytes_per_thread) {
+    return std::make_unique<Common::ZStreamPool>(
+        tls_, overload_manager_, *store_.rootScope(), "pool.", stream_bytes_,
+        [](z_stream& stream) {
+          ASSERT_EQ(Z_OK, deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                                       gzip_window_bits, memory_level, Z_DEFAULT_STRATEGY));
+        },
+        &deflateReset, &deflateEnd, max_retained_bytes_per_thread);
+  }
+
+  std::string compress(Common::ZStreamPool& pool, const std::string& content) {
+    ZlibCompressorImpl compressor(4096, pool);
+    Buffer::OwnedImpl buffer(content);
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    return buffer.toString();
+  }
+
+  uint64_t counter(const std::string& name) { return store_.counterFromString(name).value(); }
+
+  static constexpr int64_t gzip_window_bits{31};
+  static constexpr uint64_t memory_level{8};
+  const uint64_t stream_bytes_{
+      Common::ZStreamPool::deflateStreamBytes(gzip_window_bits, memory_level)};
+
+  testing::NiceMock<ThreadLocal::MockInstance> tls_;
+  testing::NiceMock<Server::MockOverloadManager> overload_manager_;
+  Stats::IsolatedStoreImpl store_;
+};
+
+// Released streams are reset and reused, and produce the same output as new ones.
+TEST_F(ZlibCompressorStreamPoolTest, ReusesResetStreams) {
+  Common::ZStreamPoolPtr pool = makePool(Common::ZStreamPool::DefaultMaxRetainedBytesPerThread);
+  const std::string content(10000, 'a');
+  const std::string first = compress(*pool, content);
+  EXPECT_EQ(1U, pool->pooledStreams());
+  EXPECT_EQ(stream_bytes_, store_.gaugeFromString("pool.retained_bytes",
+                                                  Stats::Gauge::ImportMode::Accumulate)
+                               .value());
+
+  // A stream released before it finished is reset as well.
+  {
+    ZlibCompressorImpl compressor(4096, *pool);
+    Buffer::OwnedImpl buffer(std::string(100, 'b'));
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+  }
+  EXPECT_EQ(first, compress(*pool, content));
+  EXPECT_EQ(1U, pool->pooledStreams());
+  EXPECT_EQ(1U, counter("pool.misses"));
+  EXPECT_EQ(2U, counter("pool.hits"));
+  EXPECT_EQ(0U, counter("pool.discarded"));
+}
+
+// Streams released beyond the per worker cap are freed.
+TEST_F(ZlibCompressorStreamPoolTest, RetainedStreamsAreCapped) {
+  Common::ZStreamPoolPtr pool = makePool(2 * stream_bytes_);
+  std::vector<std::unique_ptr<ZlibCompressorImpl>> compressors;
+  for (int i = 0; i < 4; ++i) {
+    compressors.push_back(std::make_unique<ZlibCompressorImpl>(4096, *pool));
+  }
+  compressors.clear();
+  EXPECT_EQ(2U, pool->pooledStreams());
+  EXPECT_EQ(4U, counter("pool.misses"));
+  EXPECT_EQ(2U, counter("pool.discarded"));
+  EXPECT_EQ(2 * stream_bytes_, store_.gaugeFromString("pool.retained_bytes",
+                                                      Stats::Gauge::ImportMode::Accumulate)
+                                   .value());
+}
+
+// The bytes of the streams still pooled when the pool is destroyed are taken out of the gauge, which
+// other pools in the same scope share.
+TEST_F(ZlibCompressorStreamPoolTest, DestroyedPoolReleasesRetainedBytes) {
+  Common::ZStreamPoolPtr pool = makePool(Common::ZStreamPool::DefaultMaxRetainedBytesPerThread);
+  Common::ZStreamPoolPtr other_pool =
+      makePool(Common::ZStreamPool::DefaultMaxRetainedBytesPerThread);
+  {
+    ZlibCompressorImpl first(4096, *pool);
+    ZlibCompressorImpl second(4096, *pool);
+    ZlibCompressorImpl third(4096, *other_pool);
+  }
+  Stats::Gauge& retained_bytes =
+      store_.gaugeFromString("pool.retained_bytes", Stats::Gauge::ImportMode::Accumulate);
+  EXPECT_EQ(3 * stream_bytes_, retained_bytes.value());
+
+  pool.reset();
+  EXPECT_EQ(stream_bytes_, retained_bytes.value());
+  other_pool.reset();
+  EXPECT_EQ(0U, retained_bytes.value());
+}
+
+// While the shrink heap overload action is saturated, the worker's pooled streams are freed.
+TEST_F(ZlibCompressorStreamPoolTest, ShrinksUnderOverload) {
+  Common::ZStreamPoolPtr pool = makePool(Common::ZStreamPool::DefaultMaxRetainedBytesPerThread);
+  auto first = std::make_unique<ZlibCompressorImpl>(4096, *pool);
+  auto second = std::make_unique<ZlibCompressorImpl>(4096, *pool);
+  first.reset();
+  EXPECT_EQ(1U, pool->pooledStreams());
+
+  const Server::OverloadActionState saturated = Server::OverloadActionState::saturated();
+  EXPECT_CALL(overload_manager_.overload_state_,
+              getState(Server::OverloadActionNames::get().ShrinkHeap))
+      .WillOnce(testing::ReturnRef(saturated));
+  second.reset();
+  EXPECT_EQ(0U, pool->pooledStreams());
+  EXPECT_EQ(2U, counter("pool.discarded"));
+  EXPECT_EQ(0U, store_.gaugeFromString("pool.retained_bytes", Stats::Gauge::ImportMode::Accumulate)
+                    .value());
+}
+
+// The factory hands out compressors backed by its pool when it has one.
+TEST_F(ZlibCompressorStreamPoolTest, FactoryUsesPool) {
+  envoy::extensions::compression::gzip::compressor::v3::Gzip gzip;
+  GzipCompressorFactory factory(gzip, tls_, overload_manager_, *store_.rootScope());
+  for (int i = 0; i < 3; ++i) {
+    Envoy::Compression::Compressor::CompressorPtr compressor = factory.createCompressor();
+    Buffer::OwnedImpl buffer;
+    TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
+    compressor->compress(buffer, Envoy::Compression::Compressor::State::Flush);
+    expectValidFlushedBuffer(buffer);
+  }
+  EXPECT_EQ(1U, counter("gzip.compressor_stream_pool.misses"));
+  EXPECT_EQ(2U, counter("gzip.compressor_stream_pool.hits"));
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace Gzip
@@ -4,6 +4,8 @@
 #include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
 #include "source/extensions/compression/gzip/decompressor/zlib_decompressor_impl.h"
 
+#include "test/mocks/server/overload_manager.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -326,6 +328,47 @@ TEST_F(ZlibDecompressorImplTest, CompressDecompressOfMultipleSlices) {
   EXPECT_EQ(original_text, decompressed_text);
 }
 
+// Decompressors taking their streams from a pool decompress correctly with a reused stream, even
+// when the previous user of the stream stopped part way through its input.
+TEST_F(ZlibDecompressorImplTest, DecompressWithPooledStreams) {
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  testing::NiceMock<Server::MockOverloadManager> overload_manager;
+  Common::ZStreamPool pool(
+      tls, overload_manager, stats_scope_, "pool.",
+      Common::ZStreamPool::inflateStreamBytes(gzip_window_bits),
+      [](z_stream& stream) { ASSERT_EQ(Z_OK, inflateInit2(&stream, gzip_window_bits)); },
+      &inflateReset, &inflateEnd);
+
+  const std::string original_text(10000, 'a');
+  Extensions::Compression::Gzip::Compressor::ZlibCompressorImpl compressor;
+  compressor.init(
+      Extensions::Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+      Extensions::Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard,
+      gzip_window_bits, memory_level);
+  Buffer::OwnedImpl compressed(original_text);
+  compressor.compress(compressed, Envoy::Compression::Compressor::State::Finish);
+  const std::string compressed_text = compressed.toString();
+
+  {
+    ZlibDecompressorImpl decompressor{stats_scope_, "test.", 4096, 100, pool};
+    Buffer::OwnedImpl input(compressed_text.substr(0, compressed_text.size() / 2));
+    Buffer::OwnedImpl output;
+    decompressor.decompress(input, output);
+  }
+  for (int i = 0; i < 2; ++i) {
+    ZlibDecompressorImpl decompressor{stats_scope_, "test.", 4096, 100, pool};
+    Buffer::OwnedImpl input(compressed_text);
+    Buffer::OwnedImpl output;
+    decompressor.decompress(input, output);
+    EXPECT_EQ(original_text, output.toString());
+    EXPECT_EQ(compressor.checksum(), decompressor.checksum());
+    EXPECT_EQ(0, decompressor.decompression_error_);
+  }
+  EXPECT_EQ(1U, pool.pooledStreams());
+  EXPECT_EQ(1U, stats_store_.counterFromString("pool.misses").value());
+  EXPECT_EQ(2U, stats_store_.counterFromString("pool.hits").value());
+}
+
 class ZlibDecompressorStatsTest : public testing::Test {
 protected:
   void chargeErrorStats(const int result) { decompressor_.chargeErrorStats(result); }
@@ -1,3 +1,5 @@
+#include <thread>
+
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/compression/zstd/compressor/config.h"
@@ -105,6 +107,44 @@ TEST_F(ZstdCompressorImplTest, CompressWitHugeBuffer) {
   verifyWithDecompressor(std::move(compressor));
 }
 
+// Contexts of finished streams are kept for later streams on the same thread, and a stream on a
+// reused context compresses exactly as on a new one.
+TEST_F(ZstdCompressorImplTest, ReusesPooledContexts) {
+  using Envoy::Compression::Zstd::Common::ContextPool;
+  std::thread thread([this]() {
+    const auto compress = [this](const std::string& content) {
+      ZstdCompressorImpl compressor(default_compression_level_, true, default_strategy_,
+                                    default_cdict_manager_, 4096);
+      Buffer::OwnedImpl buffer(content);
+      compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+      return buffer.toString();
+    };
+    EXPECT_EQ(0U, ContextPool::pooledCompressionContexts());
+    const std::string first = compress(std::string(1000, 'a'));
+    EXPECT_EQ(1U, ContextPool::pooledCompressionContexts());
+    // A stream which was not finished leaves nothing behind in the context.
+    {
+      ZstdCompressorImpl compressor(default_compression_level_, false, default_strategy_,
+                                    default_cdict_manager_, 4096);
+      EXPECT_EQ(0U, ContextPool::pooledCompressionContexts());
+      Buffer::OwnedImpl buffer(std::string(100, 'b'));
+      compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+    }
+    EXPECT_EQ(first, compress(std::string(1000, 'a')));
+    EXPECT_EQ(1U, ContextPool::pooledCompressionContexts());
+
+    std::vector<std::unique_ptr<ZstdCompressorImpl>> compressors;
+    for (size_t i = 0; i < ContextPool::MaxPooledContexts + 2; ++i) {
+      compressors.push_back(std::make_unique<ZstdCompressorImpl>(
+          default_compression_level_, default_enable_checksum_, default_strategy_,
+          default_cdict_manager_, 4096));
+    }
+    compressors.clear();
+    EXPECT_EQ(ContextPool::MaxPooledContexts, ContextPool::pooledCompressionContexts());
+  });
+  thread.join();
+}
+
 TEST_F(ZstdCompressorImplTest, IllegalConfig) {
   envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
   Zstd::Compressor::ZstdCompressorLibraryFactory lib_factory;
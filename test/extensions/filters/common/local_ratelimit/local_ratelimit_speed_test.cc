@@ -0,0 +1,64 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <limits>
+
+#include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
+
+#include "test/mocks/event/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+
+namespace {
+
+class RequestAllowedPerf {
+public:
+  explicit RequestAllowedPerf(uint32_t token_lease_size)
+      : rate_limiter_(std::chrono::milliseconds(0), std::numeric_limits<uint32_t>::max(), 1,
+                      dispatcher_, descriptors_, true, token_lease_size) {}
+
+  bool requestAllowed() { return rate_limiter_.requestAllowed(request_descriptors_); }
+
+private:
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Protobuf::RepeatedPtrField<envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>
+      descriptors_;
+  std::vector<RateLimit::LocalDescriptor> request_descriptors_;
+  LocalRateLimiterImpl rate_limiter_;
+};
+
+} // namespace
+
+// Tests how requests checked against one token bucket from several threads, as workers do under
+// heavy traffic on one rate limit, scale with the number of threads. The argument is the token
+// lease size, zero to consume tokens from the bucket directly. The bucket holds enough tokens to
+// never run out.
+static void bmRequestAllowed(benchmark::State& state) {
+  static RequestAllowedPerf* context;
+  if (state.thread_index() == 0) {
+    context = new RequestAllowedPerf(state.range(0));
+  }
+  // The benchmark loop starts and ends with a barrier across all threads, so the context is
+  // created before any thread uses it and only deleted after they are all done with it.
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(context->requestAllowed());
+  }
+  if (state.thread_index() == 0) {
+    delete context;
+  }
+}
+BENCHMARK(bmRequestAllowed)->Arg(0)->Arg(16)->Arg(256)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
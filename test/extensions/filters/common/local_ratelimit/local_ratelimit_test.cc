@@ -24,12 +24,13 @@ public:
   }
 
   void initialize(const std::chrono::milliseconds fill_interval, const uint32_t max_tokens,
-                  const uint32_t tokens_per_fill) {
+                  const uint32_t tokens_per_fill, const uint32_t token_lease_size = 0) {
 
     initializeTimer();
 
-    rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(
-        fill_interval, max_tokens, tokens_per_fill, dispatcher_, descriptors_);
+    rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(fill_interval, max_tokens,
+                                                           tokens_per_fill, dispatcher_,
+                                                           descriptors_, true, token_lease_size);
   }
 
   Thread::ThreadSynchronizer& synchronizer() { return rate_limiter_->synchronizer_; }
@@ -208,6 +209,58 @@ TEST_F(LocalRateLimiterImplTest, TokenBucketStatus) {
   EXPECT_EQ(rate_limiter_->remainingFillInterval(route_descriptors_), 3);
 }
 
+// Verify that tokens are leased from the token bucket and consumed from the lease.
+TEST_F(LocalRateLimiterImplTest, TokenLeases) {
+  initialize(std::chrono::milliseconds(200), 10, 10, 4);
+
+  // The first request leases 4 tokens, and the next 3 consume the rest of the lease.
+  EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  EXPECT_EQ(6U, rate_limiter_->remainingTokens(route_descriptors_));
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+  EXPECT_EQ(6U, rate_limiter_->remainingTokens(route_descriptors_));
+
+  // The last lease is smaller than the lease size.
+  for (int i = 0; i < 6; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+  EXPECT_EQ(0U, rate_limiter_->remainingTokens(route_descriptors_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+
+  // 0 -> 10 tokens
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(200), nullptr));
+  fill_timer_->invokeCallback();
+  EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  EXPECT_EQ(6U, rate_limiter_->remainingTokens(route_descriptors_));
+}
+
+// Verify that each thread has a lease of its own, and that leases expire when the bucket is filled.
+TEST_F(LocalRateLimiterImplTest, TokenLeasesPerThread) {
+  initialize(std::chrono::milliseconds(200), 10, 10, 4);
+
+  for (int i = 0; i < 2; i++) {
+    std::thread t([&] { EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_)); });
+    t.join();
+  }
+  EXPECT_EQ(2U, rate_limiter_->remainingTokens(route_descriptors_));
+
+  // This thread leases the last 2 tokens, and is then limited even though the leases of the other
+  // threads still hold 6 tokens.
+  EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+
+  // 0 -> 10 tokens, and the tokens left in leases expire.
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(200), nullptr));
+  fill_timer_->invokeCallback();
+  EXPECT_EQ(10U, rate_limiter_->remainingTokens(route_descriptors_));
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+}
+
 class LocalRateLimiterDescriptorImplTest : public LocalRateLimiterImplTest {
 public:
   void initializeWithDescriptor(const std::chrono::milliseconds fill_interval,
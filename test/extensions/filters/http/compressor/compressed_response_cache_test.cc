@@ -0,0 +1,65 @@
+#include <string>
+
+#include "source/extensions/filters/http/compressor/compressed_response_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+namespace {
+
+TEST(CompressedResponseCacheTest, LookupAndInsert) {
+  CompressedResponseCache cache(1024, 100);
+  EXPECT_EQ(nullptr, cache.lookup("a"));
+  cache.insert("a", "body");
+  ASSERT_NE(nullptr, cache.lookup("a"));
+  EXPECT_EQ("body", *cache.lookup("a"));
+  EXPECT_EQ(5U, cache.bytes());
+
+  // Inserting a key again replaces its body.
+  cache.insert("a", "new body");
+  EXPECT_EQ("new body", *cache.lookup("a"));
+  EXPECT_EQ(9U, cache.bytes());
+}
+
+TEST(CompressedResponseCacheTest, LargeBodiesAreNotStored) {
+  CompressedResponseCache cache(1024, 10);
+  cache.insert("a", std::string(11, 'x'));
+  EXPECT_EQ(nullptr, cache.lookup("a"));
+  EXPECT_EQ(0U, cache.bytes());
+}
+
+// A body which is being sent stays valid after it has been evicted.
+TEST(CompressedResponseCacheTest, BodyOutlivesEviction) {
+  CompressedResponseCache cache(20, 10);
+  cache.insert("a", std::string(10, 'a'));
+  const CompressedResponseCache::Body body = cache.lookup("a");
+  cache.insert("b", std::string(10, 'b'));
+  EXPECT_EQ(nullptr, cache.lookup("a"));
+  EXPECT_EQ(std::string(10, 'a'), *body);
+}
+
+TEST(CompressedResponseCacheTest, EvictsLeastRecentlyUsed) {
+  CompressedResponseCache cache(33, 10);
+  cache.insert("a", std::string(10, 'a'));
+  cache.insert("b", std::string(10, 'b'));
+  cache.insert("c", std::string(10, 'c'));
+  EXPECT_EQ(33U, cache.bytes());
+
+  // Looking up "a" makes "b" the least recently used.
+  EXPECT_NE(nullptr, cache.lookup("a"));
+  cache.insert("d", std::string(10, 'd'));
+  EXPECT_EQ(nullptr, cache.lookup("b"));
+  EXPECT_NE(nullptr, cache.lookup("a"));
+  EXPECT_NE(nullptr, cache.lookup("c"));
+  EXPECT_NE(nullptr, cache.lookup("d"));
+  EXPECT_EQ(33U, cache.bytes());
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
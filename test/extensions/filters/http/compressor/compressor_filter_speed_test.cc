@@ -703,6 +703,93 @@ BENCHMARK(compressChunks1024WithBrotli)
     ->UseManualTime()
     ->Unit(benchmark::kMillisecond);
 
+// Compresses the same response, with a strong etag, on each iteration. The first argument enables
+// the compressed response cache, with which only the first response is compressed.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressRepeatedResponseWithGzip(benchmark::State& state) {
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+  Stats::IsolatedStoreImpl stats;
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  ON_CALL(runtime.snapshot_, featureEnabled("test.filter_enabled", 100))
+      .WillByDefault(Return(true));
+
+  envoy::extensions::filters::http::compressor::v3::Compressor compressor;
+  if (state.range(0) != 0) {
+    compressor.mutable_response_direction_config()->mutable_compressed_response_cache();
+  }
+  const CompressionParams& params = gzip_compression_params[4];
+  CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
+      compressor, "test.", *stats.rootScope(), runtime,
+      std::make_unique<MockGzipCompressorFactory>(
+          static_cast<Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionLevel>(
+              params.level),
+          static_cast<Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy>(
+              params.strategy),
+          params.window_bits, params.memory_level));
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    std::vector<Buffer::OwnedImpl> chunks = generateChunks(1, 122880);
+    state.ResumeTiming();
+
+    CompressorFilter filter(config);
+    filter.setDecoderFilterCallbacks(decoder_callbacks);
+    filter.setEncoderFilterCallbacks(encoder_callbacks);
+    Http::TestRequestHeaderMapImpl headers = {
+        {":authority", "example.com"}, {":path", "/app.js"}, {"accept-encoding", "gzip"}};
+    filter.decodeHeaders(headers, true);
+    Http::TestResponseHeaderMapImpl response_headers = {
+        {":status", "200"},
+        {"content-length", "122880"},
+        {"content-type", "application/javascript"},
+        {"etag", "\"v1\""}};
+    filter.encodeHeaders(response_headers, false);
+    filter.encodeData(chunks[0], true);
+    benchmark::DoNotOptimize(chunks[0].length());
+  }
+}
+BENCHMARK(compressRepeatedResponseWithGzip)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+// Compresses small JSON responses, one stream each, without and with a shared dictionary made of
+// a typical response. The "ratio" counter is the uncompressed size over the compressed size.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressSmallJsonWithBrotli(benchmark::State& state) {
+  const std::string record =
+      R"({"id": 0, "name": "", "email": "", "created_at": "", "tags": [], "active": false})";
+  std::string response = "[";
+  for (int i = 0; i < 40; ++i) {
+    absl::StrAppend(&response, i == 0 ? "" : ",", R"({"id": )", i, R"(, "name": "user)", i,
+                    R"(", "email": "user)", i, R"(@example.com", "created_at": "2024-01-)",
+                    i % 28 + 1, R"(", "tags": ["a", "b"], "active": true})");
+  }
+  response += "]";
+  Compression::Brotli::Compressor::PreparedDictionarySharedPtr dictionary;
+  if (state.range(0) != 0) {
+    dictionary = std::make_shared<const Compression::Brotli::Compressor::PreparedDictionary>(
+        absl::StrCat("[", record, ",", record, "]"),
+        Compression::Brotli::Compressor::DefaultQuality);
+  }
+
+  uint64_t compressed_bytes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Compression::Brotli::Compressor::BrotliCompressorImpl compressor(
+        Compression::Brotli::Compressor::DefaultQuality,
+        Compression::Brotli::Compressor::DefaultWindowBits,
+        Compression::Brotli::Compressor::DefaultInputBlockBits, false,
+        Compression::Brotli::Compressor::BrotliCompressorImpl::EncoderMode::Text,
+        Compression::Brotli::Compressor::DefaultChunkSize, dictionary);
+    Buffer::OwnedImpl data(response);
+    compressor.compress(data, Envoy::Compression::Compressor::State::Finish);
+    compressed_bytes += data.length();
+  }
+  state.counters["ratio"] =
+      static_cast<double>(response.size() * state.iterations()) / compressed_bytes;
+}
+BENCHMARK(compressSmallJsonWithBrotli)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
 } // namespace Compressor
 } // namespace HttpFilters
 } // namespace Extensions
@@ -428,6 +428,140 @@ TEST_F(CompressorFilterTest, EmptyResponse) {
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
 }
 
+class CompressedResponseCacheFilterTest : public CompressorFilterTest {
+public:
+  void SetUp() override {
+    setUpFilter(R"EOF(
+{
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  },
+  "response_direction_config": {
+    "compressed_response_cache": {
+      "max_response_bytes": 2000
+    }
+  }
+}
+)EOF");
+  }
+
+  // Runs a response of body_size random bytes through a new filter sharing the config, and
+  // returns the body sent downstream.
+  std::string doCacheableResponse(Http::TestResponseHeaderMapImpl&& headers,
+                                  const std::string& path = "/app.js",
+                                  uint64_t body_size = 1000) {
+    filter_ = std::make_unique<CompressorFilter>(config_);
+    filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+    filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+    Http::TestRequestHeaderMapImpl request_headers{
+        {":authority", "example.com"}, {":path", path}, {"accept-encoding", "test"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+    EXPECT_EQ("test", headers.get_("content-encoding"));
+    populateBuffer(body_size);
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+    return data_.toString();
+  }
+
+  uint64_t cacheHits() {
+    return stats_.counter("test.compressor.test.test.response.compressed_response_cache_hit")
+        .value();
+  }
+  uint64_t cacheMisses() {
+    return stats_.counter("test.compressor.test.test.response.compressed_response_cache_miss")
+        .value();
+  }
+};
+
+// A response with a strong etag is compressed and stored on the first request, and served from
+// the cache without compressing the upstream body on the next one.
+TEST_F(CompressedResponseCacheFilterTest, ServesCompressedResponseFromCache) {
+  const std::string first = doCacheableResponse(
+      {{":status", "200"}, {"content-length", "1000"}, {"etag", "\"v1\""}});
+  EXPECT_EQ(0U, cacheHits());
+  EXPECT_EQ(1U, cacheMisses());
+
+  compressor_factory_->setExpectedCompressCalls(0);
+  Http::TestResponseHeaderMapImpl headers{
+      {":status", "200"}, {"content-length", "1000"}, {"etag", "\"v1\""}};
+  EXPECT_EQ(first, doCacheableResponse(std::move(headers)));
+  EXPECT_EQ(1U, cacheHits());
+  EXPECT_EQ(1U, cacheMisses());
+  EXPECT_EQ(2U, stats_.counter("test.compressor.test.test.response.compressed").value());
+}
+
+TEST_F(CompressedResponseCacheFilterTest, SetsContentLengthOnHit) {
+  doCacheableResponse({{":status", "200"}, {"etag", "\"v1\""}}, "/app.js", 500);
+  compressor_factory_->setExpectedCompressCalls(0);
+  filter_ = std::make_unique<CompressorFilter>(config_);
+  filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":authority", "example.com"}, {":path", "/app.js"}, {"accept-encoding", "test"}};
+  filter_->decodeHeaders(request_headers, true);
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}, {"etag", "\"v1\""}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_EQ("500", headers.get_("content-length"));
+  EXPECT_EQ("", headers.get_("etag"));
+}
+
+// A cache hit for a response with no data before its trailers still sends the cached body, as its
+// size was advertised in Content-Length.
+TEST_F(CompressedResponseCacheFilterTest, SendsCachedBodyWithTrailersOnly) {
+  const std::string compressed =
+      doCacheableResponse({{":status", "200"}, {"etag", "\"v1\""}}, "/app.js", 500);
+  compressor_factory_->setExpectedCompressCalls(0);
+  filter_ = std::make_unique<CompressorFilter>(config_);
+  filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":authority", "example.com"}, {":path", "/app.js"}, {"accept-encoding", "test"}};
+  filter_->decodeHeaders(request_headers, true);
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}, {"etag", "\"v1\""}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_EQ(absl::StrCat(compressed.size()), headers.get_("content-length"));
+
+  std::string sent;
+  EXPECT_CALL(encoder_callbacks_, addEncodedData(_, true))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) { sent = data.toString(); }));
+  Http::TestResponseTrailerMapImpl trailers;
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->encodeTrailers(trailers));
+  EXPECT_EQ(compressed, sent);
+  EXPECT_EQ(1U, cacheHits());
+}
+
+// Responses to different paths, or with different etags, are cached separately.
+TEST_F(CompressedResponseCacheFilterTest, KeyedOnPathAndEtag) {
+  doCacheableResponse({{":status", "200"}, {"etag", "\"v1\""}});
+  doCacheableResponse({{":status", "200"}, {"etag", "\"v1\""}}, "/other.js");
+  doCacheableResponse({{":status", "200"}, {"etag", "\"v2\""}});
+  EXPECT_EQ(0U, cacheHits());
+  EXPECT_EQ(3U, cacheMisses());
+}
+
+// Responses with a weak or no etag, and partial responses, are not cached.
+TEST_F(CompressedResponseCacheFilterTest, NotCacheable) {
+  for (int i = 0; i < 2; ++i) {
+    doCacheableResponse({{":status", "200"}, {"etag", "W/\"v1\""}});
+    doCacheableResponse({{":status", "200"}});
+    doCacheableResponse({{":status", "206"}, {"etag", "\"v1\""}});
+  }
+  EXPECT_EQ(0U, cacheHits());
+  EXPECT_EQ(0U, cacheMisses());
+}
+
+// Responses larger than max_response_bytes are compressed every time.
+TEST_F(CompressedResponseCacheFilterTest, LargeResponseNotStored) {
+  doCacheableResponse({{":status", "200"}, {"etag", "\"v1\""}}, "/app.js", 3000);
+  doCacheableResponse({{":status", "200"}, {"etag", "\"v1\""}}, "/app.js", 3000);
+  EXPECT_EQ(0U, cacheHits());
+  EXPECT_EQ(2U, cacheMisses());
+  EXPECT_EQ(0U, config_->compressedResponseCache()->bytes());
+}
+
 // Verify removeAcceptEncoding header.
 TEST_F(CompressorFilterTest, RemoveAcceptEncodingHeader) {
   // Filter true, no response direction overrides. Header is removed.
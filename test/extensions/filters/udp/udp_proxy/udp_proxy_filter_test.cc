@@ -17,6 +17,7 @@
 #include "test/extensions/filters/udp/udp_proxy/session_filters/drainer_filter.pb.h"
 #include "test/mocks/api/mocks.h"
 #include "test/mocks/http/stream_encoder.h"
+#include "test/mocks/network/mocks.h"
 #include "test/mocks/network/socket.h"
 #include "test/mocks/server/factory_context.h"
 #include "test/mocks/server/listener_factory_context.h"
@@ -26,11 +27,13 @@
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/load_balancer_context.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/registry.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::Assign;
 using testing::AtLeast;
 using testing::ByMove;
 using testing::DoAll;
@@ -39,6 +42,7 @@ using testing::InSequence;
 using testing::InvokeWithoutArgs;
 using testing::Return;
 using testing::ReturnNew;
+using testing::ReturnPointee;
 using testing::ReturnRef;
 using testing::SaveArg;
 
@@ -1615,6 +1619,222 @@ session_filters:
   EXPECT_THAT(output_.front(), testing::HasSubstr("session_complete"));
 }
 
+// Hands out the packet writer set by the test to the next upstream session.
+class TestUpstreamPacketWriterFactoryFactory : public Network::UdpPacketWriterFactoryFactory {
+public:
+  std::string name() const override { return "envoy.test.upstream_packet_writer"; }
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<ProtobufWkt::Struct>();
+  }
+  Network::UdpPacketWriterFactoryPtr
+  createUdpPacketWriterFactory(const envoy::config::core::v3::TypedExtensionConfig&) override {
+    if (!supported_) {
+      return nullptr;
+    }
+    auto factory = std::make_unique<NiceMock<Network::MockUdpPacketWriterFactory>>();
+    ON_CALL(*factory, createUdpPacketWriter(_, _))
+        .WillByDefault(Invoke([this](Network::IoHandle&, Stats::Scope&)
+                                  -> Network::UdpPacketWriterPtr { return std::move(writer_); }));
+    return factory;
+  }
+
+  bool supported_{true};
+  std::unique_ptr<Network::UdpPacketWriter> writer_;
+};
+
+class UdpProxyFilterPacketWriterTest : public UdpProxyFilterTest {
+public:
+  UdpProxyFilterPacketWriterTest() : registration_(factory_) {}
+
+  void setupWithPacketWriter() {
+    setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.test.upstream_packet_writer
+  typed_config:
+    '@type': type.googleapis.com/google.protobuf.Struct
+    )EOF"));
+  }
+
+  // Creates a session whose datagrams are written through a batching writer.
+  void createBatchingSession() {
+    writer_ = new NiceMock<Network::MockUdpPacketWriter>();
+    factory_.writer_.reset(writer_);
+    ON_CALL(*writer_, isBatchMode()).WillByDefault(Return(true));
+    ON_CALL(*writer_, isWriteBlocked()).WillByDefault(ReturnPointee(&write_blocked_));
+    expectSessionCreate(upstream_address_);
+    flush_callback_ = new Event::MockSchedulableCallback(&callbacks_.udp_listener_.dispatcher_);
+  }
+
+  void expectWritePacket(const std::string& data) {
+    EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, nullptr));
+    EXPECT_CALL(*writer_, writePacket(_, nullptr, _))
+        .WillOnce(Invoke([this, data](const Buffer::Instance& buffer, const Network::Address::Ip*,
+                                      const Network::Address::Instance& peer_address) {
+          EXPECT_EQ(data, buffer.toString());
+          EXPECT_EQ(*upstream_address_, peer_address);
+          return makeNoError(buffer.length());
+        }));
+  }
+
+  uint64_t clusterCounter(const std::string& name) {
+    return TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                        .thread_local_cluster_.cluster_.info_->stats_store_,
+                                    "udp." + name)
+        ->value();
+  }
+
+  TestUpstreamPacketWriterFactoryFactory factory_;
+  Registry::InjectFactory<Network::UdpPacketWriterFactoryFactory> registration_;
+  NiceMock<Network::MockUdpPacketWriter>* writer_{};
+  Event::MockSchedulableCallback* flush_callback_{};
+  bool write_blocked_{};
+};
+
+TEST_F(UdpProxyFilterPacketWriterTest, UnsupportedPacketWriter) {
+  factory_.supported_ = false;
+  EXPECT_THROW_WITH_MESSAGE(
+      setupWithPacketWriter(), EnvoyException,
+      "The upstream packet writer envoy.test.upstream_packet_writer is not supported by this "
+      "build.");
+}
+
+// Datagrams written in the same event loop iteration are flushed as one batch.
+TEST_F(UdpProxyFilterPacketWriterTest, FlushOncePerIteration) {
+  setupWithPacketWriter();
+  createBatchingSession();
+
+  expectWritePacket("hello");
+  EXPECT_CALL(*flush_callback_, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  expectWritePacket("world");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "world");
+  EXPECT_EQ(2, clusterCounter("sess_tx_datagrams"));
+  EXPECT_EQ(0, clusterCounter("sess_tx_batches"));
+
+  EXPECT_CALL(*writer_, flush()).WillOnce(Invoke([]() { return makeNoError(10); }));
+  flush_callback_->invokeCallback();
+  EXPECT_EQ(2, clusterCounter("sess_tx_datagrams"));
+  EXPECT_EQ(1, clusterCounter("sess_tx_batches"));
+
+  // Nothing is left to flush when the session goes away.
+  EXPECT_CALL(*writer_, flush()).Times(0);
+  filter_.reset();
+}
+
+// A blocked writer keeps its datagrams until the socket is writable again, and datagrams written
+// in the meantime are dropped.
+TEST_F(UdpProxyFilterPacketWriterTest, FlushWhenWritable) {
+  setupWithPacketWriter();
+  createBatchingSession();
+
+  expectWritePacket("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+
+  EXPECT_CALL(*writer_, flush()).WillOnce(Invoke([this]() {
+    write_blocked_ = true;
+    return Api::IoCallUint64Result(0, Network::IoSocketError::getIoSocketEagainError());
+  }));
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_,
+              enableFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write));
+  flush_callback_->invokeCallback();
+  EXPECT_EQ(0, clusterCounter("sess_tx_batches"));
+  EXPECT_EQ(0, clusterCounter("sess_tx_errors"));
+
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, nullptr));
+  EXPECT_CALL(*writer_, writePacket(_, _, _)).Times(0);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "world");
+  EXPECT_EQ(1, clusterCounter("sess_tx_errors"));
+
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_,
+              enableFileEvents(Event::FileReadyType::Read));
+  EXPECT_CALL(*writer_, setWritable()).WillOnce(Assign(&write_blocked_, false));
+  EXPECT_CALL(*writer_, flush()).WillOnce(Invoke([]() { return makeNoError(5); }));
+  EXPECT_TRUE(test_sessions_[0].file_event_cb_(Event::FileReadyType::Write).ok());
+  EXPECT_EQ(1, clusterCounter("sess_tx_datagrams"));
+  EXPECT_EQ(1, clusterCounter("sess_tx_batches"));
+}
+
+// Without a batching writer each datagram is its own batch, and each read of the upstream socket
+// is one receive batch.
+TEST_F(UdpProxyFilterTest, BatchStatsWithoutPacketWriter) {
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  test_sessions_[0].expectWriteToUpstream("hello", 0, nullptr, true);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  test_sessions_[0].expectWriteToUpstream("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  test_sessions_[0].recvDataFromUpstream("world");
+
+  Stats::Store& stats_store = factory_context_.server_factory_context_.cluster_manager_
+                                  .thread_local_cluster_.cluster_.info_->stats_store_;
+  EXPECT_EQ(2, TestUtility::findCounter(stats_store, "udp.sess_tx_batches")->value());
+  EXPECT_EQ(1, TestUtility::findCounter(stats_store, "udp.sess_rx_batches")->value());
+}
+
+// Each receive system call which returns datagrams is one receive batch, even when several of
+// them are made for one read event.
+TEST_F(UdpProxyFilterTest, RxBatchPerReceiveCall) {
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  test_sessions_[0].expectWriteToUpstream("hello", 0, nullptr, true);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+
+  TestSession& session = test_sessions_[0];
+  auto return_datagram = [&session](Buffer::RawSlice* slices, const uint64_t, uint32_t,
+                                    Network::IoHandle::RecvMsgOutput& output) {
+    memcpy(slices[0].mem_, "world", 5);
+    output.msg_[0].peer_address_ = session.upstream_address_;
+    return makeNoError(5);
+  };
+  EXPECT_CALL(*session.idle_timer_, enableTimer(_, nullptr));
+  EXPECT_CALL(*session.socket_->io_handle_, recvmsg(_, 1, _, _))
+      .WillOnce(Invoke(return_datagram))
+      .WillOnce(Invoke(return_datagram))
+      .WillOnce(Return(
+          ByMove(Api::IoCallUint64Result(0, Network::IoSocketError::getIoSocketEagainError()))));
+  EXPECT_CALL(callbacks_.udp_listener_, send(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([](const Network::UdpSendData& send_data) {
+        EXPECT_EQ("world", send_data.buffer_.toString());
+        send_data.buffer_.drain(send_data.buffer_.length());
+        return makeNoError(5);
+      }));
+  EXPECT_TRUE(session.file_event_cb_(Event::FileReadyType::Read).ok());
+
+  Stats::Store& stats_store = factory_context_.server_factory_context_.cluster_manager_
+                                  .thread_local_cluster_.cluster_.info_->stats_store_;
+  EXPECT_EQ(2, TestUtility::findCounter(stats_store, "udp.sess_rx_datagrams")->value());
+  EXPECT_EQ(2, TestUtility::findCounter(stats_store, "udp.sess_rx_batches")->value());
+}
+
 class HttpUpstreamImplTest : public testing::Test {
 public:
   struct HeaderToAdd {
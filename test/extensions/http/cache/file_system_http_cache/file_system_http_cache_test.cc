@@ -1247,6 +1247,26 @@ INSTANTIATE_TEST_SUITE_P(FileSystemHttpCacheTest, HttpCacheImplementationTest,
                            return "FileSystemHttpCache";
                          });
 
+class FileSystemHttpCacheMmapTestDelegate : public HttpCacheTestDelegate,
+                                            public FileSystemCacheTestContext {
+public:
+  FileSystemHttpCacheMmapTestDelegate() {
+    ConfigProto cfg = testConfig();
+    cfg.set_mmap_body_reads(true);
+    cache_ = std::dynamic_pointer_cast<FileSystemHttpCache>(
+        http_cache_factory_->getCache(cacheConfig(cfg), context_));
+  }
+  std::shared_ptr<HttpCache> cache() override { return cache_; }
+  bool validationEnabled() const override { return true; }
+};
+
+// The standard cache tests again, serving bodies from memory-mapped cache files.
+INSTANTIATE_TEST_SUITE_P(FileSystemHttpCacheMmapTest, HttpCacheImplementationTest,
+                         testing::Values(std::make_unique<FileSystemHttpCacheMmapTestDelegate>),
+                         [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>&) {
+                           return "FileSystemHttpCacheMmap";
+                         });
+
 TEST(Registration, GetCacheFromFactory) {
   HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
       "envoy.extensions.http.cache.file_system_http_cache.v3.FileSystemHttpCacheConfig");
@@ -0,0 +1,252 @@
+#include <string>
+
+#include "envoy/extensions/http/cache/sharded_lru_http_cache/v3/sharded_lru_http_cache.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/cache/cache_entry_utils.h"
+#include "source/extensions/http/cache/sharded_lru_http_cache/sharded_lru_http_cache.h"
+
+#include "test/extensions/filters/http/cache/http_cache_implementation_test_common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace ShardedLruHttpCache {
+namespace {
+
+class ShardedLruHttpCacheTestDelegate : public HttpCacheTestDelegate {
+public:
+  explicit ShardedLruHttpCacheTestDelegate(const ConfigProto& config = {})
+      : cache_(std::make_shared<ShardedLruHttpCache>(config, *store_.rootScope())) {}
+
+  std::shared_ptr<HttpCache> cache() override { return cache_; }
+  bool validationEnabled() const override { return true; }
+
+  uint64_t counter(absl::string_view name) {
+    return TestUtility::findCounter(store_, absl::StrCat("cache.sharded_lru.", name))->value();
+  }
+  uint64_t gauge(absl::string_view name) {
+    return TestUtility::findGauge(store_, absl::StrCat("cache.sharded_lru.", name))->value();
+  }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  std::shared_ptr<ShardedLruHttpCache> cache_;
+};
+
+INSTANTIATE_TEST_SUITE_P(ShardedLruHttpCacheTest, HttpCacheImplementationTest,
+                         testing::Values(std::make_unique<ShardedLruHttpCacheTestDelegate>),
+                         [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>&) {
+                           return "ShardedLruHttpCache";
+                         });
+
+// A single shard with room for two of the entries inserted by these tests, so that
+// eviction order is deterministic.
+ConfigProto smallCacheConfig() {
+  ConfigProto config;
+  config.mutable_shard_count()->set_value(1);
+  config.mutable_max_cache_size_bytes()->set_value(3000);
+  return config;
+}
+
+class ShardedLruHttpCacheEvictionTest : public HttpCacheImplementationTest {
+protected:
+  ShardedLruHttpCacheTestDelegate& shardedDelegate() {
+    return dynamic_cast<ShardedLruHttpCacheTestDelegate&>(*delegate_);
+  }
+
+  absl::Status insertBody(absl::string_view path, absl::string_view body) {
+    return insert(path, response_headers_, body);
+  }
+
+  bool cached(absl::string_view path) {
+    lookup(path);
+    return lookup_result_.cache_entry_status_ == CacheEntryStatus::Ok;
+  }
+
+  const std::string body_ = std::string(1000, 'x');
+  const Http::TestResponseHeaderMapImpl response_headers_{
+      {":status", "200"},
+      {"date", formatter_.fromTime(time_system_.systemTime())},
+      {"cache-control", "public,max-age=3600"}};
+};
+
+INSTANTIATE_TEST_SUITE_P(ShardedLruHttpCacheEvictionTest, ShardedLruHttpCacheEvictionTest,
+                         testing::Values([]() -> std::unique_ptr<HttpCacheTestDelegate> {
+                           return std::make_unique<ShardedLruHttpCacheTestDelegate>(
+                               smallCacheConfig());
+                         }));
+
+TEST_P(ShardedLruHttpCacheEvictionTest, EvictsUnreferencedEntryFirst) {
+  ASSERT_TRUE(insertBody("/a", body_).ok());
+  ASSERT_TRUE(insertBody("/b", body_).ok());
+  // Entries are inserted unreferenced; looking up /a gives it a second chance.
+  EXPECT_TRUE(cached("/a"));
+  ASSERT_TRUE(insertBody("/c", body_).ok());
+
+  EXPECT_EQ(1, shardedDelegate().counter("evictions"));
+  EXPECT_EQ(2, shardedDelegate().gauge("size_count"));
+  EXPECT_TRUE(cached("/a"));
+  EXPECT_FALSE(cached("/b"));
+  EXPECT_TRUE(cached("/c"));
+}
+
+TEST_P(ShardedLruHttpCacheEvictionTest, EvictsOldestWhenNothingReferenced) {
+  ASSERT_TRUE(insertBody("/a", body_).ok());
+  ASSERT_TRUE(insertBody("/b", body_).ok());
+  ASSERT_TRUE(insertBody("/c", body_).ok());
+
+  EXPECT_EQ(1, shardedDelegate().counter("evictions"));
+  EXPECT_FALSE(cached("/a"));
+  EXPECT_TRUE(cached("/b"));
+  EXPECT_TRUE(cached("/c"));
+}
+
+TEST_P(ShardedLruHttpCacheEvictionTest, ReplacingEntryIsNotEviction) {
+  ASSERT_TRUE(insertBody("/a", body_).ok());
+  ASSERT_TRUE(insertBody("/a", "short").ok());
+
+  EXPECT_EQ(0, shardedDelegate().counter("evictions"));
+  EXPECT_EQ(2, shardedDelegate().counter("inserts"));
+  EXPECT_EQ(1, shardedDelegate().gauge("size_count"));
+  LookupContextPtr context = lookup("/a");
+  EXPECT_TRUE(expectLookupSuccessWithBodyAndTrailers(context.get(), "short"));
+}
+
+TEST_P(ShardedLruHttpCacheEvictionTest, RejectsEntryLargerThanShard) {
+  EXPECT_FALSE(insertBody("/a", std::string(4000, 'x')).ok());
+
+  EXPECT_EQ(1, shardedDelegate().counter("inserts_rejected"));
+  EXPECT_EQ(0, shardedDelegate().counter("inserts"));
+  EXPECT_EQ(0, shardedDelegate().gauge("size_bytes"));
+  EXPECT_FALSE(cached("/a"));
+}
+
+TEST_P(ShardedLruHttpCacheEvictionTest, BodyOutlivesEviction) {
+  ASSERT_TRUE(insertBody("/a", body_).ok());
+  LookupContextPtr context = lookup("/a");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+
+  // Evict /a while the lookup above still holds it.
+  ASSERT_TRUE(insertBody("/b", body_).ok());
+  ASSERT_TRUE(insertBody("/c", body_).ok());
+  ASSERT_TRUE(insertBody("/d", body_).ok());
+  EXPECT_EQ(2, shardedDelegate().counter("evictions"));
+
+  EXPECT_EQ(body_.substr(10, 100), getBody(*context, 10, 110));
+}
+
+TEST_P(ShardedLruHttpCacheEvictionTest, HitAndMissStats) {
+  EXPECT_FALSE(cached("/a"));
+  ASSERT_TRUE(insertBody("/a", body_).ok());
+  EXPECT_TRUE(cached("/a"));
+  EXPECT_TRUE(cached("/a"));
+
+  // The lookup made by insertBody() is also a miss.
+  EXPECT_EQ(2, shardedDelegate().counter("misses"));
+  EXPECT_EQ(2, shardedDelegate().counter("hits"));
+}
+
+// A plain response cached for a request is replaced by the vary marker once the response starts
+// to vary, rather than being served to every variant.
+TEST_P(ShardedLruHttpCacheEvictionTest, VaryResponseReplacesPlainResponse) {
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  ASSERT_TRUE(insertBody("/a", "plain").ok());
+
+  Http::TestResponseHeaderMapImpl varied_headers = response_headers_;
+  varied_headers.setCopy(Http::LowerCaseString("vary"), "accept");
+  ASSERT_TRUE(insert("/a", varied_headers, "varied").ok());
+  LookupContextPtr context = lookup("/a");
+  EXPECT_TRUE(expectLookupSuccessWithBodyAndTrailers(context.get(), "varied"));
+
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  EXPECT_FALSE(cached("/a"));
+}
+
+TEST(ShardedLruHttpCache, MaxEntrySize) {
+  Stats::IsolatedStoreImpl store;
+  ConfigProto config;
+  config.mutable_max_entry_size_bytes()->set_value(100);
+  ShardedLruHttpCache cache(config, *store.rootScope());
+  EXPECT_EQ(16, cache.shardCount());
+
+  Key key;
+  key.set_host("example.com");
+  EXPECT_FALSE(cache.insert(key, Http::createHeaderMap<Http::ResponseHeaderMapImpl>({}), {},
+                            std::string(200, 'x'), nullptr));
+  EXPECT_EQ(1, TestUtility::findCounter(store, "cache.sharded_lru.inserts_rejected")->value());
+}
+
+TEST(ShardedLruHttpCache, StatPrefix) {
+  Stats::IsolatedStoreImpl store;
+  ConfigProto config;
+  config.set_stat_prefix("static_assets");
+  ShardedLruHttpCache cache(config, *store.rootScope());
+
+  Key key;
+  key.set_host("example.com");
+  EXPECT_TRUE(cache.insert(key, Http::createHeaderMap<Http::ResponseHeaderMapImpl>({}), {}, "body",
+                           nullptr));
+  EXPECT_EQ(1,
+            TestUtility::findCounter(store, "cache.sharded_lru.static_assets.inserts")->value());
+}
+
+// Caches with the same stat prefix share their gauges, and each takes only its own entries out
+// of them when it is destroyed.
+TEST(ShardedLruHttpCache, SizeGaugesOnDestruction) {
+  Stats::IsolatedStoreImpl store;
+  Key key;
+  key.set_host("example.com");
+  ConfigProto config;
+  auto cache = std::make_unique<ShardedLruHttpCache>(config, *store.rootScope());
+  config.mutable_shard_count()->set_value(4);
+  auto other_cache = std::make_unique<ShardedLruHttpCache>(config, *store.rootScope());
+  ASSERT_TRUE(cache->insert(key, Http::createHeaderMap<Http::ResponseHeaderMapImpl>({}), {},
+                            "body", nullptr));
+  ASSERT_TRUE(other_cache->insert(key, Http::createHeaderMap<Http::ResponseHeaderMapImpl>({}), {},
+                                  "longer body", nullptr));
+  Stats::Gauge& size_bytes = *TestUtility::findGauge(store, "cache.sharded_lru.size_bytes");
+  Stats::Gauge& size_count = *TestUtility::findGauge(store, "cache.sharded_lru.size_count");
+  const uint64_t total_bytes = size_bytes.value();
+  EXPECT_EQ(2, size_count.value());
+
+  cache.reset();
+  EXPECT_EQ(1, size_count.value());
+  EXPECT_LT(size_bytes.value(), total_bytes);
+  EXPECT_GT(size_bytes.value(), 0);
+
+  other_cache.reset();
+  EXPECT_EQ(0, size_count.value());
+  EXPECT_EQ(0, size_bytes.value());
+}
+
+TEST(Registration, GetFactory) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.http.cache.sharded_lru_http_cache.v3.ShardedLruHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  testing::NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  envoy::extensions::filters::http::cache::v3::CacheConfig config;
+  ConfigProto cache_config;
+  config.mutable_typed_config()->PackFrom(cache_config);
+  std::shared_ptr<HttpCache> cache = factory->getCache(config, factory_context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.sharded_lru");
+
+  // Equivalent configs share a cache, different configs do not.
+  EXPECT_EQ(cache, factory->getCache(config, factory_context));
+  cache_config.mutable_shard_count()->set_value(4);
+  config.mutable_typed_config()->PackFrom(cache_config);
+  EXPECT_NE(cache, factory->getCache(config, factory_context));
+}
+
+} // namespace
+} // namespace ShardedLruHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -78,6 +78,7 @@ BENCHMARK(benchmarkMaglevLoadBalancerBuildTable)
     ->Arg(100)
     ->Arg(200)
     ->Arg(500)
+    ->Arg(5000)
     ->Unit(::benchmark::kMillisecond);
 
 void benchmarkMaglevLoadBalancerHostLoss(::benchmark::State& state) {
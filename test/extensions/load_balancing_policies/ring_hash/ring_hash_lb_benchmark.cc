@@ -51,6 +51,7 @@ BENCHMARK(benchmarkRingHashLoadBalancerBuildRing)
     ->Args({100, 256000})
     ->Args({200, 256000})
     ->Args({500, 256000})
+    ->Args({5000, 1024 * 1024})
     ->Unit(::benchmark::kMillisecond);
 
 void benchmarkRingHashLoadBalancerChooseHost(::benchmark::State& state) {
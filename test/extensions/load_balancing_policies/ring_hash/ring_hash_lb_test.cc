@@ -2,10 +2,12 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/router/router.h"
 
+#include "source/common/config/metadata.h"
 #include "source/common/network/utility.h"
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
@@ -99,6 +101,21 @@ public:
   std::unique_ptr<RingHashLoadBalancer> lb_;
 };
 
+// A build pool which runs the tasks posted to it when the test asks it to.
+class ManualBuildPool : public LoadBalancerBuildPool {
+public:
+  void post(std::function<void()> task) override { tasks_.push_back(std::move(task)); }
+
+  void runTasks() {
+    for (auto& task : tasks_) {
+      task();
+    }
+    tasks_.clear();
+  }
+
+  std::vector<std::function<void()>> tasks_;
+};
+
 // For tests which don't need to be run in both primary and failover modes.
 using RingHashFailoverTest = RingHashLoadBalancerTest;
 
@@ -153,6 +170,127 @@ TEST_P(RingHashLoadBalancerTest, LbDestructedBeforeFactory) {
   EXPECT_NE(nullptr, factory->create(lb_params_));
 }
 
+// The initial ring is built on the build pool. Load balancers created meanwhile are handed out
+// without waiting for it, and wait for it on first use instead.
+TEST_P(RingHashLoadBalancerTest, InitialBuildOnPool) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:93", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:94", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:95", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  lb_ = std::make_unique<RingHashLoadBalancer>(
+      priority_set_, stats_, *stats_store_.rootScope(), runtime_, random_,
+      makeOptRef<const envoy::config::cluster::v3::Cluster::RingHashLbConfig>(config_.value()),
+      common_config_);
+
+  ManualBuildPool pool;
+  EXPECT_TRUE(lb_->initializeWithBuildPool(pool).ok());
+  ASSERT_EQ(1U, pool.tasks_.size());
+  EXPECT_EQ(0, lb_->stats().size_.value());
+
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  ASSERT_NE(nullptr, lb);
+  TestLoadBalancerContext context(0);
+  HostConstSharedPtr host;
+  std::thread worker([&lb, &context, &host]() { host = lb->chooseHost(&context); });
+  pool.runTasks();
+  worker.join();
+
+  EXPECT_EQ(12, lb_->stats().size_.value());
+  EXPECT_EQ(hostSet().hosts_[4], host);
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+}
+
+// A host update before the build on the pool has run is built synchronously, and the build on the
+// pool does not overwrite it.
+TEST_P(RingHashLoadBalancerTest, UpdateBeforeBuildOnPool) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, *stats_store_.rootScope(),
+                                               runtime_, random_, absl::nullopt, common_config_);
+
+  ManualBuildPool pool;
+  EXPECT_TRUE(lb_->initializeWithBuildPool(pool).ok());
+
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:92", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  pool.runTasks();
+
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[0], lb_->factory()->create(lb_params_)->chooseHost(&context));
+}
+
+// Destroying the load balancer before the build on the pool has run cancels the build.
+TEST_P(RingHashLoadBalancerTest, DestroyedBeforeBuildOnPool) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, *stats_store_.rootScope(),
+                                               runtime_, random_, absl::nullopt, common_config_);
+
+  ManualBuildPool pool;
+  EXPECT_TRUE(lb_->initializeWithBuildPool(pool).ok());
+  auto factory = lb_->factory();
+  lb_.reset();
+  pool.runTasks();
+
+  EXPECT_EQ(nullptr, factory->create(lb_params_)->chooseHost(nullptr));
+}
+
+// A refresh only rebuilds the rings of the priorities whose hosts, weights or hash keys changed.
+// The ring size stat is set by the ring built last, which tells which rings were rebuilt.
+TEST_P(RingHashFailoverTest, RebuildOnlyChangedPriorities) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  failover_host_set_.hosts_ = {
+      makeTestHostWithHashKey(info_, "91", "tcp://127.0.0.1:91", simTime()),
+      makeTestHostWithHashKey(info_, "92", "tcp://127.0.0.1:92", simTime())};
+  failover_host_set_.healthy_hosts_ = failover_host_set_.hosts_;
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(1001);
+  init();
+  EXPECT_EQ(1002, lb_->stats().size_.value());
+
+  // Only the ring of priority 0 is rebuilt.
+  host_set_.hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:93", simTime()));
+  host_set_.hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:94", simTime()));
+  host_set_.hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:95", simTime()));
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(1004, lb_->stats().size_.value());
+
+  // A host's hash key changing rebuilds the ring of its priority.
+  envoy::config::core::v3::Metadata metadata;
+  Config::Metadata::mutableMetadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
+                                         Config::MetadataEnvoyLbKeys::get().HASH_KEY)
+      .set_string_value("93");
+  failover_host_set_.hosts_[0]->metadata(
+      std::make_shared<const envoy::config::core::v3::Metadata>(metadata));
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(1002, lb_->stats().size_.value());
+
+  // Nothing is rebuilt when nothing changed.
+  stats_store_.gaugeFromString("ring_hash_lb.size", Stats::Gauge::ImportMode::Accumulate).set(0);
+  failover_host_set_.runCallbacks({}, {});
+  EXPECT_EQ(0, lb_->stats().size_.value());
+
+  // Rings which are reused still serve their priority.
+  host_set_.healthy_hosts_.clear();
+  host_set_.runCallbacks({}, {});
+  TestLoadBalancerContext context(0);
+  const HostConstSharedPtr host = lb_->factory()->create(lb_params_)->chooseHost(&context);
+  EXPECT_TRUE(host == failover_host_set_.hosts_[0] || host == failover_host_set_.hosts_[1]);
+}
+
 // Given minimum_ring_size > maximum_ring_size, expect an exception.
 TEST_P(RingHashLoadBalancerTest, BadRingSizeBounds) {
   config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
@@ -207,6 +207,54 @@ TEST_F(TcpStatsdSinkTest, WithCustomPrefix) {
   sink_->flush(snapshot_);
 }
 
+// In the batched mode the prefixed names of counters and gauges are cached until a flush no longer
+// includes their metric.
+TEST_F(TcpStatsdSinkTest, BatchedWrites) {
+  sink_ = std::make_unique<TcpStatsdSink>(
+      local_info_, "fake_cluster", tls_, cluster_manager_,
+      *(cluster_manager_.active_clusters_["fake_cluster"]->info_->stats_store_.rootScope()),
+      "test_prefix", true);
+  InSequence s;
+
+  NiceMock<Stats::MockCounter> counter;
+  counter.name_ = "test_counter";
+  counter.used_ = true;
+  snapshot_.counters_.push_back({1, counter});
+
+  NiceMock<Stats::MockGauge> gauge;
+  gauge.name_ = "test_gauge";
+  gauge.value_ = 2;
+  gauge.used_ = true;
+  snapshot_.gauges_.push_back(gauge);
+
+  Stats::PrimitiveCounter host_counter;
+  host_counter.add(3);
+  Stats::PrimitiveCounterSnapshot host_counter_snap(host_counter);
+  host_counter_snap.setName("test_host_counter");
+  snapshot_.host_counters_.push_back(host_counter_snap);
+
+  expectCreateConnection();
+  for (int flush = 0; flush < 2; ++flush) {
+    EXPECT_CALL(*connection_, write(BufferStringEqual("test_prefix.test_counter:1|c\n"
+                                                      "test_prefix.test_host_counter:3|c\n"
+                                                      "test_prefix.test_gauge:2|g\n"),
+                                    _));
+    sink_->flush(snapshot_);
+    EXPECT_EQ(2, sink_->cachedMetricsForTest());
+  }
+
+  // Metrics which are no longer flushed are dropped from the cache.
+  snapshot_.counters_.clear();
+  EXPECT_CALL(*connection_, write(BufferStringEqual("test_prefix.test_host_counter:3|c\n"
+                                                    "test_prefix.test_gauge:2|g\n"),
+                                  _));
+  sink_->flush(snapshot_);
+  EXPECT_EQ(1, sink_->cachedMetricsForTest());
+
+  EXPECT_CALL(*connection_, close(Network::ConnectionCloseType::NoFlush));
+  tls_.shutdownThread();
+}
+
 TEST_F(TcpStatsdSinkTest, BufferReallocate) {
   InSequence s;
 
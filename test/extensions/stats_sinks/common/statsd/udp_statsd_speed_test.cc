@@ -0,0 +1,75 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/stat_sinks/common/statsd/statsd.h"
+
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/network_utility.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace Common {
+namespace Statsd {
+
+// Flushes a snapshot of counters and gauges with tags to a UDP address, as a DogStatsD sink does.
+// The first argument is whether the sink uses batched writes, the second the number of metrics,
+// half of which are counters and half gauges. Datagrams are 1432 bytes either way.
+static void bmUdpStatsdFlush(benchmark::State& state) {
+  const bool batched = state.range(0);
+  const uint64_t num_metrics = state.range(1);
+  Stats::IsolatedStoreImpl store;
+  testing::NiceMock<Stats::MockMetricSnapshot> snapshot;
+  for (uint64_t i = 0; i < num_metrics / 2; ++i) {
+    const std::string tag_value = absl::StrCat("cluster_", i % 1000);
+    Stats::StatNameManagedStorage tag_name("envoy.cluster_name", store.symbolTable());
+    Stats::StatNameManagedStorage tag_value_name(tag_value, store.symbolTable());
+    const Stats::StatNameTagVector tags{{tag_name.statName(), tag_value_name.statName()}};
+    Stats::StatNameManagedStorage counter_name(absl::StrCat("upstream_rq_", i),
+                                               store.symbolTable());
+    Stats::Counter& counter =
+        store.rootScope()->counterFromStatNameWithTags(counter_name.statName(), tags);
+    counter.inc();
+    snapshot.counters_.push_back({i, counter});
+    Stats::StatNameManagedStorage gauge_name(absl::StrCat("upstream_cx_active_", i),
+                                             store.symbolTable());
+    Stats::Gauge& gauge = store.rootScope()->gaugeFromStatNameWithTags(
+        gauge_name.statName(), tags, Stats::Gauge::ImportMode::Accumulate);
+    gauge.set(i);
+    snapshot.gauges_.push_back(gauge);
+  }
+
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  // The peer is never read from; datagrams which do not fit in its receive buffer are dropped.
+  Network::Test::UdpSyncPeer server(Network::Address::IpVersion::v4);
+  UdpStatsdSink sink(tls, server.localAddress(), true, getDefaultPrefix(),
+                     DatagramBatchWriter::DefaultMaxDatagramSize, getDefaultTagFormat(), batched);
+
+  for (auto _ : state) { // NOLINT
+    sink.flush(snapshot);
+  }
+  state.SetItemsProcessed(state.iterations() * num_metrics);
+  tls.shutdownThread();
+}
+BENCHMARK(bmUdpStatsdFlush)
+    ->Args({0, 1000})
+    ->Args({1, 1000})
+    ->Args({0, 1000000})
+    ->Args({1, 1000000})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace Statsd
+} // namespace Common
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
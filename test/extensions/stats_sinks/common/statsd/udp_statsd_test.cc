@@ -567,6 +567,124 @@ TEST(UdpStatsdSinkWithTagsTest, GraphiteTagSyntax) {
   tls_.shutdownThread();
 }
 
+// In the batched mode counters and gauges are formatted into datagrams of up to the configured
+// size, and the lines of each metric are cached until a flush no longer includes it.
+TEST_P(UdpStatsdSinkTest, BatchedWrites) {
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  Network::Test::UdpSyncPeer server(GetParam());
+  UdpStatsdSink sink(tls_, server.localAddress(), false, getDefaultPrefix(), 50,
+                     getDefaultTagFormat(), true);
+  EXPECT_TRUE(sink.getBatchedWritesForTest());
+  EXPECT_TRUE(sink.flushOffMainThread());
+
+  std::vector<std::unique_ptr<NiceMock<Stats::MockCounter>>> counters;
+  for (int i = 1; i <= 3; ++i) {
+    counters.push_back(std::make_unique<NiceMock<Stats::MockCounter>>());
+    counters.back()->name_ = absl::StrCat("test_counter_", i);
+    counters.back()->used_ = true;
+    snapshot.counters_.push_back({static_cast<uint64_t>(i), *counters.back()});
+  }
+
+  NiceMock<Stats::MockGauge> gauge;
+  gauge.name_ = "test_gauge";
+  gauge.value_ = 7;
+  gauge.used_ = true;
+  snapshot.gauges_.push_back(gauge);
+
+  Stats::PrimitiveGauge host_gauge;
+  host_gauge.add(4);
+  Stats::PrimitiveGaugeSnapshot host_gauge_snap(host_gauge);
+  host_gauge_snap.setName("test_host_gauge");
+  snapshot.host_gauges_.push_back(host_gauge_snap);
+
+  for (int flush = 0; flush < 2; ++flush) {
+    sink.flush(snapshot);
+    const std::vector<std::string> expected = {
+        "envoy.test_counter_1:1|c\nenvoy.test_counter_2:2|c",
+        "envoy.test_counter_3:3|c\nenvoy.test_gauge:7|g",
+        "envoy.test_host_gauge:4|g",
+    };
+    for (const std::string& datagram : expected) {
+      Network::UdpRecvData data;
+      server.recv(data);
+      EXPECT_EQ(datagram, data.buffer_->toString());
+    }
+    EXPECT_EQ(4, sink.cachedMetricsForTest());
+  }
+
+  // Metrics which are no longer flushed are dropped from the cache.
+  snapshot.counters_.clear();
+  sink.flush(snapshot);
+  {
+    Network::UdpRecvData data;
+    server.recv(data);
+    EXPECT_EQ("envoy.test_gauge:7|g\nenvoy.test_host_gauge:4|g", data.buffer_->toString());
+  }
+  EXPECT_EQ(1, sink.cachedMetricsForTest());
+
+  tls_.shutdownThread();
+}
+
+TEST_P(UdpStatsdSinkTest, BatchedWritesWithTags) {
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  Network::Test::UdpSyncPeer server(GetParam());
+  UdpStatsdSink sink(tls_, server.localAddress(), true, getDefaultPrefix(), absl::nullopt,
+                     getGraphiteTagFormat(), true);
+
+  NiceMock<Stats::MockCounter> counter;
+  counter.name_ = "test_counter";
+  counter.used_ = true;
+  counter.setTags({Stats::Tag{"key1", "value1"}, Stats::Tag{"key2", "value2"}});
+  snapshot.counters_.push_back({1, counter});
+
+  sink.flush(snapshot);
+  Network::UdpRecvData data;
+  server.recv(data);
+  EXPECT_EQ("envoy.test_counter;key1=value1;key2=value2:1|c", data.buffer_->toString());
+
+  tls_.shutdownThread();
+}
+
+// A line longer than a datagram is sent on its own, after the lines written before it.
+TEST_P(UdpStatsdSinkTest, DatagramBatchWriterOversizedLine) {
+  Network::Test::UdpSyncPeer server(GetParam());
+  DatagramBatchWriter writer(server.localAddress(), 10);
+
+  writer.writeLine("abc", "1", "|c", "");
+  writer.writeLine("0123456789", "1", "|c", "");
+  writer.writeLine("d", "2", "|g", "");
+  writer.flush();
+  for (absl::string_view expected : {"abc1|c", "01234567891|c", "d2|g"}) {
+    Network::UdpRecvData data;
+    server.recv(data);
+    EXPECT_EQ(expected, data.buffer_->toString());
+  }
+  EXPECT_EQ(3, writer.datagramsSent());
+}
+
+// Lines beyond a full batch of datagrams go into the next batch.
+TEST_P(UdpStatsdSinkTest, DatagramBatchWriterFullBatch) {
+  Network::Test::UdpSyncPeer server(GetParam());
+  DatagramBatchWriter writer(server.localAddress(), 4);
+
+  const uint32_t lines = DatagramBatchWriter::MaxDatagramsPerBatch + 2;
+  for (uint32_t i = 0; i < lines; ++i) {
+    writer.writeLine("a", absl::StrCat(i % 10), "|c", "");
+  }
+  writer.flush();
+  for (uint32_t i = 0; i < lines; ++i) {
+    Network::UdpRecvData data;
+    server.recv(data);
+    EXPECT_EQ(absl::StrCat("a", i % 10, "|c"), data.buffer_->toString());
+  }
+  EXPECT_EQ(lines, writer.datagramsSent());
+  if (Api::OsSysCallsSingleton::get().supportsMmsg()) {
+    EXPECT_EQ(2, writer.sendCalls());
+  }
+}
+
 } // namespace
 } // namespace Statsd
 } // namespace Common
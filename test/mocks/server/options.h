@@ -42,6 +42,9 @@ public:
   MOCK_METHOD(const std::string&, logPath, (), (const));
   MOCK_METHOD(uint64_t, restartEpoch, (), (const));
   MOCK_METHOD(std::chrono::milliseconds, fileFlushIntervalMsec, (), (const));
+  MOCK_METHOD(uint64_t, fileFlushMinSize, (), (const));
+  MOCK_METHOD(uint64_t, fileThreadBufferSize, (), (const));
+  MOCK_METHOD(Server::FileBufferOverflowPolicy, fileBufferOverflowPolicy, (), (const));
   MOCK_METHOD(Mode, mode, (), (const));
   MOCK_METHOD(const std::string&, serviceClusterName, (), (const));
   MOCK_METHOD(const std::string&, serviceNodeName, (), (const));
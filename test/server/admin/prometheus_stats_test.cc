@@ -101,6 +101,23 @@ protected:
 
   Stats::StatName makeStat(absl::string_view name) { return pool_.add(name); }
 
+  // Streams out a request, returning its output, and counting the calls to nextChunk.
+  std::string render(Admin::Request& request, uint32_t& num_chunks) {
+    Http::TestResponseHeaderMapImpl response_headers;
+    EXPECT_EQ(Http::Code::OK, request.start(response_headers));
+    Buffer::OwnedImpl data;
+    std::string output;
+    bool more;
+    num_chunks = 0;
+    do {
+      more = request.nextChunk(data);
+      output += data.toString();
+      data.drain(data.length());
+      ++num_chunks;
+    } while (more);
+    return output;
+  }
+
   // Format tags into the name to create a unique stat_name for each name:tag combination.
   // If the same stat_name is passed to makeGauge() or makeCounter(), even with different
   // tags, a copy of the previous metric will be returned.
@@ -346,24 +363,69 @@ envoy_cluster_default_total_match_count{envoy_cluster_name="a"} 0
 envoy_cluster_default_total_match_count{envoy_cluster_name="x"} 0
 )EOF";
 
-  // Note: in the version of prometheus_stats_test.cc that works with the
-  // streaming GroupedStatsRequest, the test code is slightly different;
-  // it's based on the local 'store' object rather than being based on
-  // the counters_ member variable.
-  //    StatsParams params;
-  //    params.type_ = StatsType::Counters;
-  //    params.format_ = StatsFormat::Prometheus;
-  //    auto request = std::make_unique<GroupedStatsRequest>(store, params, custom_namespaces_);
-  //    EXPECT_EQ(expected_output, response(*request));
-  // This code is left here so that we can verify the bug is fixed if we decide to
-  // re-try the streaming Prometheus implementation.
-
   Buffer::OwnedImpl response;
   const uint64_t size = PrometheusStatsFormatter::statsAsPrometheus(
       counters_, gauges_, histograms_, textReadouts_, endpoints_helper_->cm_, response,
       StatsParams(), custom_namespaces);
   EXPECT_EQ(1, size);
   EXPECT_EQ(expected_output, response.toString());
+
+  // The streaming request groups stats across all the scopes before rendering any of them.
+  PrometheusStatsRequest request(store, StatsParams(), custom_namespaces, endpoints_helper_->cm_);
+  request.setChunkSize(1);
+  uint32_t num_chunks;
+  EXPECT_EQ(expected_output, render(request, num_chunks));
+}
+
+TEST_F(PrometheusStatsFormatterTest, StreamingRequest) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+  Stats::ThreadLocalStoreImpl store(alloc_);
+  envoy::config::metrics::v3::StatsConfig stats_config;
+  const Stats::TagVector tags;
+  store.setTagProducer(Stats::TagProducerImpl::createTagProducer(stats_config, tags).value());
+  Stats::StatName upstream_rq = pool_.add("upstream_rq");
+
+  // Scopes with the same prefix share their stats, which are only rendered once.
+  Stats::ScopeSharedPtr scope_a1 = store.rootScope()->createScope("cluster.a");
+  Stats::ScopeSharedPtr scope_a2 = store.rootScope()->createScope("cluster.a");
+  Stats::ScopeSharedPtr scope_b = store.rootScope()->createScope("cluster.b");
+  scope_a1->counterFromStatName(upstream_rq).add(1);
+  scope_a2->counterFromStatName(upstream_rq);
+  scope_b->counterFromStatName(upstream_rq).add(2);
+  store.rootScope()->counterFromString("requests.total").add(3);
+  store.rootScope()->gaugeFromString("active", Stats::Gauge::ImportMode::Accumulate).set(4);
+  store.rootScope()->textReadoutFromString("version").set("1.2.3");
+
+  constexpr absl::string_view expected_output =
+      R"EOF(# TYPE envoy_cluster_upstream_rq counter
+envoy_cluster_upstream_rq{envoy_cluster_name="a"} 1
+envoy_cluster_upstream_rq{envoy_cluster_name="b"} 2
+# TYPE envoy_requests_total counter
+envoy_requests_total{} 3
+# TYPE envoy_active gauge
+envoy_active{} 4
+)EOF";
+
+  uint32_t num_chunks;
+  PrometheusStatsRequest request(store, StatsParams(), custom_namespaces, endpoints_helper_->cm_);
+  EXPECT_EQ(expected_output, render(request, num_chunks));
+  EXPECT_EQ(1, num_chunks);
+
+  // With the smallest chunk size, each family of stats goes into its own chunk.
+  PrometheusStatsRequest chunked_request(store, StatsParams(), custom_namespaces,
+                                         endpoints_helper_->cm_);
+  chunked_request.setChunkSize(1);
+  EXPECT_EQ(expected_output, render(chunked_request, num_chunks));
+  EXPECT_EQ(4, num_chunks);
+
+  StatsParams params;
+  params.prometheus_text_readouts_ = true;
+  PrometheusStatsRequest text_readouts_request(store, params, custom_namespaces,
+                                               endpoints_helper_->cm_);
+  EXPECT_EQ(absl::StrCat(expected_output, R"EOF(# TYPE envoy_version gauge
+envoy_version{text_value="1.2.3"} 0
+)EOF"),
+            render(text_readouts_request, num_chunks));
 }
 
 TEST_F(PrometheusStatsFormatterTest, HistogramWithNonDefaultBuckets) {
@@ -194,11 +194,10 @@ public:
    */
   uint64_t handlerStats(const StatsParams& params) {
     Buffer::OwnedImpl data;
-    if (params.format_ == StatsFormat::Prometheus) {
-      StatsHandler::prometheusRender(*store_, custom_namespaces_, cm_, params, data);
-      return data.length();
-    }
-    Admin::RequestPtr request = StatsHandler::makeRequest(*store_, params, cm_);
+    Admin::RequestPtr request =
+        params.format_ == StatsFormat::Prometheus
+            ? StatsHandler::makePrometheusRequest(*store_, params, custom_namespaces_, cm_)
+            : StatsHandler::makeRequest(*store_, params, cm_);
     auto response_headers = Http::ResponseHeaderMapImpl::create();
     request->start(*response_headers);
     uint64_t count = 0;
@@ -447,3 +446,23 @@ BENCHMARK_CAPTURE(BM_HistogramsJson, per_endpoint_stats_disabled, false)
     ->Unit(benchmark::kMillisecond);
 BENCHMARK_CAPTURE(BM_HistogramsJson, per_endpoint_stats_enabled, true)
     ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramsPrometheus(benchmark::State& state, bool per_endpoint_stats) {
+  Envoy::Server::StatsHandlerTest& test_context = testContext(per_endpoint_stats);
+  Envoy::Server::StatsParams params;
+  Envoy::Buffer::OwnedImpl response;
+  params.parse("?format=prometheus&filter=^h", response);
+
+  uint64_t count;
+  for (auto _ : state) { // NOLINT
+    count = test_context.handlerStats(params);
+    RELEASE_ASSERT(count > 50000 && count < 100000,
+                   absl::StrCat("count=", count, ", expected > 50K"));
+  }
+
+  auto label = absl::StrCat("output per iteration: ", count);
+  state.SetLabel(label);
+}
+BENCHMARK_CAPTURE(BM_HistogramsPrometheus, per_endpoint_stats_disabled, false)
+    ->Unit(benchmark::kMillisecond);
@@ -66,6 +66,11 @@ TEST_F(OptionsImplTest, InvalidCommandLine) {
                           "Couldn't find match for argument");
 }
 
+TEST_F(OptionsImplTest, InvalidFileBufferOverflow) {
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy --file-buffer-overflow bogus"),
+                          MalformedArgvException, "error: unknown file-buffer-overflow 'bogus'");
+}
+
 TEST_F(OptionsImplTest, InvalidSocketMode) {
   EXPECT_THROW_WITH_REGEX(
       createOptionsImpl("envoy --socket-path /foo/envoy_domain_socket --socket-mode foo"),
@@ -96,6 +101,7 @@ TEST_F(OptionsImplTest, All) {
       "--local-address-ip-version v6 -l info --component-log-level upstream:debug,connection:trace "
       "--service-cluster cluster --service-node node --service-zone zone "
       "--file-flush-interval-msec 9000 "
+      "--file-flush-min-size-kb 128 --file-thread-buffer-size-kb 256 --file-buffer-overflow drop "
       "--skip-hot-restart-on-no-parent "
       "--skip-hot-restart-parent-stats "
       "--drain-time-s 60 --log-format [%v] --enable-fine-grain-logging --parent-shutdown-time-s 90 "
@@ -124,6 +130,9 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ("node", options->serviceNodeName());
   EXPECT_EQ("zone", options->serviceZone());
   EXPECT_EQ(std::chrono::milliseconds(9000), options->fileFlushIntervalMsec());
+  EXPECT_EQ(128U * 1024, options->fileFlushMinSize());
+  EXPECT_EQ(256U * 1024, options->fileThreadBufferSize());
+  EXPECT_EQ(Server::FileBufferOverflowPolicy::Drop, options->fileBufferOverflowPolicy());
   EXPECT_EQ(std::chrono::seconds(60), options->drainTime());
   EXPECT_EQ(std::chrono::seconds(90), options->parentShutdownTime());
   EXPECT_TRUE(options->hotRestartDisabled());
@@ -252,6 +261,11 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->restartEpoch(), command_line_options->restart_epoch());
   EXPECT_EQ(options->fileFlushIntervalMsec().count() / 1000,
             command_line_options->file_flush_interval().seconds());
+  EXPECT_EQ(options->fileFlushMinSize() / 1024, command_line_options->file_flush_min_size_kb());
+  EXPECT_EQ(options->fileThreadBufferSize() / 1024,
+            command_line_options->file_thread_buffer_size_kb());
+  EXPECT_EQ(envoy::admin::v3::CommandLineOptions::Drop,
+            command_line_options->file_buffer_overflow());
   EXPECT_EQ(envoy::admin::v3::CommandLineOptions::Validate, command_line_options->mode());
   EXPECT_EQ(options->serviceClusterName(), command_line_options->service_cluster());
   EXPECT_EQ(options->serviceNodeName(), command_line_options->service_node());
@@ -500,6 +514,10 @@ TEST_F(OptionsImplTest, SaneTestConstructor) {
   EXPECT_EQ(regular_options_impl->mode(), test_options_impl.mode());
   EXPECT_EQ(regular_options_impl->fileFlushIntervalMsec(),
             test_options_impl.fileFlushIntervalMsec());
+  EXPECT_EQ(regular_options_impl->fileFlushMinSize(), test_options_impl.fileFlushMinSize());
+  EXPECT_EQ(regular_options_impl->fileThreadBufferSize(), test_options_impl.fileThreadBufferSize());
+  EXPECT_EQ(regular_options_impl->fileBufferOverflowPolicy(),
+            test_options_impl.fileBufferOverflowPolicy());
   EXPECT_EQ(regular_options_impl->hotRestartDisabled(), test_options_impl.hotRestartDisabled());
   EXPECT_EQ(regular_options_impl->cpusetThreadsEnabled(), test_options_impl.cpusetThreadsEnabled());
 }
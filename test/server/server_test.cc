@@ -905,6 +905,29 @@ TEST_P(ServerInstanceImplTest, FlushStatsOnAdmin) {
   server_thread->join();
 }
 
+// With the stats flush thread enabled, a flush completes asynchronously: the snapshot is built on
+// the flush thread and the sink, which does not allow flushing off the main thread, is flushed back
+// on the main thread.
+TEST_P(ServerInstanceImplTest, FlushStatsOnFlushThread) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.restart_features.stats_flush_thread", "true"}});
+  CustomStatsSinkFactory factory;
+  Registry::InjectFactory<Server::Configuration::StatsSinkFactory> registered(factory);
+  auto server_thread =
+      startTestServer("test/server/test_data/server/stats_sink_manual_flush_bootstrap.yaml", true);
+
+  server_->dispatcher().post([&] { server_->flushStats(); });
+  EXPECT_TRUE(TestUtility::waitForCounterEq(stats_store_, "stats.flushed", 1, time_system_));
+
+  // The first flush has finished, so a second one is not dropped.
+  server_->dispatcher().post([&] { server_->flushStats(); });
+  EXPECT_TRUE(TestUtility::waitForCounterEq(stats_store_, "stats.flushed", 2, time_system_));
+  EXPECT_EQ(0L, TestUtility::findCounter(stats_store_, "server.dropped_stat_flushes")->value());
+
+  server_->dispatcher().post([&] { server_->shutdown(); });
+  server_thread->join();
+}
+
 TEST_P(ServerInstanceImplTest, ConcurrentFlushes) {
   CustomStatsSinkFactory factory;
   Registry::InjectFactory<Server::Configuration::StatsSinkFactory> registered(factory);